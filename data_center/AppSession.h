@@ -9,6 +9,7 @@
 #pragma once
 #include "DataContext.h"
 #include "TopologyData.h"
+#include "ConnectivityStore.h"
 #include <simdroid/SimdroidInspector.h>
 
 /**
@@ -34,6 +35,10 @@ struct AppSession {
         if (data.registry.ctx().contains<std::unique_ptr<TopologyData>>()) {
             data.registry.ctx().erase<std::unique_ptr<TopologyData>>();
         }
+        // The flat connectivity store refers to the entities being destroyed
+        if (data.registry.ctx().contains<ConnectivityStore>()) {
+            data.registry.ctx().erase<ConnectivityStore>();
+        }
         
         // Clear all entities and components
         data.clear();
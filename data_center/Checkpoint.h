@@ -0,0 +1,75 @@
+// Checkpoint.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstdint>
+#include "EnergyBalance.h"
+
+/**
+ * @brief 检查点文件中的数组段
+ * @details 节点段按 NodalState 的稠密节点编号存放（3 分量段 xyz 交错）；
+ * 单元段按 ConnectivityStore 的连接块顺序拼接。
+ */
+enum class CheckpointSection : uint32_t {
+    Position = 0,       ///< x (3n)
+    InitialPosition,    ///< x0 (3n)
+    Displacement,       ///< u (3n)
+    Velocity,           ///< v (3n，半步速度)
+    Acceleration,       ///< a (3n)
+    Mass,               ///< 集中质量 (n，含质量缩放附加质量)
+    InverseMass,        ///< 质量倒数 (n)
+    WaveSpeed,          ///< 单元膨胀波速（已含质量缩放），StableTimeStep::wave_speed；可为空
+    ElementMass,        ///< 质量缩放的单元当前质量，MassScaling::element_mass；可为空
+    Count
+};
+
+/**
+ * @brief 时间步循环的标量状态：重启后从下一步继续所需的全部计数与时刻
+ */
+struct CheckpointRunState {
+    double time = 0.0;                  ///< 物理时间
+    double dt = 0.0;                    ///< 当前时间步长
+    uint64_t step = 0;                  ///< 已完成的步数
+    uint64_t last_dt_update = 0;        ///< 上次更新时间步的步数
+    uint64_t last_mass_rescale = 0;     ///< 上次质量缩放的步数
+    int64_t output_index = 0;           ///< 最后写出的 VTU 帧编号
+    double next_output_time = 0.0;
+    double next_history_time = 0.0;
+    double next_checkpoint_time = 0.0;
+    uint64_t history_bytes = 0;         ///< 历史文件长度（HistoryWriter::size），重启时截断到此长度
+    EnergyBalance energy;               ///< 累计能量平衡（外力功、沙漏耗散等）
+};
+
+/**
+ * @brief 检查点文件头（版本化的二进制格式）
+ * @details
+ *   - 文件 = 文件头 + 各数组段；每段起始位置按 64 字节对齐，内存映射后可直接按 double 数组读取
+ *   - 按本机字节序写出；byte_order 写入 kCheckpointByteOrder，读取时不一致即拒绝
+ *   - 布局变化时递增 kCheckpointVersion，旧版本文件会被拒绝而不是错误解读
+ */
+struct CheckpointHeader {
+    char magic[8];                       ///< "HFEMCKPT"
+    uint32_t version;                    ///< kCheckpointVersion
+    uint32_t byte_order;                 ///< kCheckpointByteOrder
+    uint64_t header_bytes;               ///< sizeof(CheckpointHeader)
+    uint64_t file_bytes;                 ///< 文件总长度，用于发现截断的文件
+    uint64_t num_nodes;
+    uint64_t num_elements;
+    CheckpointRunState run;
+    double physical_mass;                ///< MassScaling::physical_mass
+    double added_mass;                   ///< MassScaling::added_mass
+    double dt_target;                    ///< MassScaling::dt_target
+    double dt_previous;                  ///< NodalState::dt_previous（变步长的速度更新）
+    uint64_t section_offset[static_cast<uint32_t>(CheckpointSection::Count)];  ///< 字节偏移
+    uint64_t section_count[static_cast<uint32_t>(CheckpointSection::Count)];   ///< double 个数
+};
+
+inline constexpr char kCheckpointMagic[8] = {'H', 'F', 'E', 'M', 'C', 'K', 'P', 'T'};
+inline constexpr uint32_t kCheckpointVersion = 3;
+inline constexpr uint32_t kCheckpointByteOrder = 0x01020304u;
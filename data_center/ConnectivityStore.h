@@ -0,0 +1,139 @@
+// ConnectivityStore.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "entt/entt.hpp"
+
+/**
+ * @brief 同类型、同属性、同材料单元的连接块 (Connectivity Block)
+ * @details
+ *   - 一个块只包含一种单元类型，每个单元的节点数固定为 nodes_per_element
+ *   - 块内单元共享同一个属性实体和材料实体，数值核按块解析一次属性/材料，
+ *     单元循环中不再逐单元查找 PropertyRef / MaterialRef
+ *   - 第 k 个单元的节点为 node_indices[k * nodes_per_element .. (k+1) * nodes_per_element)
+ *   - 节点以 32 位稠密索引存储（与 NodalState 的节点编号一致），
+ *     而不是 64 位的 entt::entity
+ */
+struct ConnectivityBlock {
+    /**
+     * @brief 单元类型 ID（如 308 = Hexa8）
+     */
+    int type_id = 0;
+
+    /**
+     * @brief 每个单元的节点数
+     */
+    int nodes_per_element = 0;
+
+    /**
+     * @brief 块内单元共享的属性实体（单元无 PropertyRef 时为 entt::null）
+     */
+    entt::entity property_entity = entt::null;
+
+    /**
+     * @brief 块内单元共享的材料实体（属性无 MaterialRef 时为 entt::null）
+     */
+    entt::entity material_entity = entt::null;
+
+    /**
+     * @brief 块内单元对应的实体（用于查找属性、材料等）
+     */
+    std::vector<entt::entity> elements;
+
+    /**
+     * @brief 扁平的节点稠密索引，长度为 elements.size() * nodes_per_element
+     */
+    std::vector<uint32_t> node_indices;
+
+    /**
+     * @brief 块内单元数量
+     */
+    size_t num_elements() const {
+        return elements.size();
+    }
+
+    /**
+     * @brief 块内第 k 个单元的节点索引首地址
+     */
+    const uint32_t* nodes_of(size_t k) const {
+        return node_indices.data() + k * static_cast<size_t>(nodes_per_element);
+    }
+};
+
+/**
+ * @brief 扁平连接关系存储 (Connectivity Store)
+ * @details
+ *   - 存储在 registry.ctx() (Context) 中，由 ConnectivitySystem::build() 在解析完成后构建一次
+ *   - Component::Connectivity 为每个单元持有一个堆分配的 std::vector<entt::entity>
+ *     （ENTT_ID_TYPE = uint64_t 时每个节点句柄 8 字节），数值计算中每访问一个单元
+ *     都要多一次指针跳转；本结构按 (单元类型, 属性, 材料) 分块，节点索引连续存放且只占 4 字节
+ *   - 节点编号按 view<Position> 的顺序，NodalStateSystem 复用同一编号，
+ *     因此块中的索引可以直接用于 NodalState 的数组
+ *   - 网格（节点或单元）发生增删后需要重新构建
+ */
+struct ConnectivityStore {
+    /**
+     * @brief 稠密节点索引 -> 节点实体
+     */
+    std::vector<entt::entity> node_entities;
+
+    /**
+     * @brief 节点实体 ID -> 稠密节点索引（-1 表示不是节点）
+     * @details 索引为实体编号 entt::to_entity(entity)（不含版本位）
+     */
+    std::vector<int> entity_to_index;
+
+    /**
+     * @brief 按 (单元类型, 属性, 材料) 划分的连接块
+     */
+    std::vector<ConnectivityBlock> blocks;
+
+    /**
+     * @brief 节点数量
+     */
+    size_t num_nodes() const {
+        return node_entities.size();
+    }
+
+    /**
+     * @brief 所有块的单元总数
+     */
+    size_t num_elements() const {
+        size_t count = 0;
+        for (const auto& block : blocks) {
+            count += block.num_elements();
+        }
+        return count;
+    }
+
+    /**
+     * @brief 节点实体的稠密索引，不是节点时返回 -1
+     */
+    int index_of(entt::entity node_entity) const {
+        const size_t entity_id = static_cast<size_t>(entt::to_entity(node_entity));
+        if (entity_id >= entity_to_index.size()) {
+            return -1;
+        }
+        // 同一编号的其它版本（已销毁后回收的实体）不是该节点
+        const int index = entity_to_index[entity_id];
+        return (index >= 0 && node_entities[index] == node_entity) ? index : -1;
+    }
+
+    /**
+     * @brief 清空所有数据
+     */
+    void clear() {
+        node_entities.clear();
+        entity_to_index.clear();
+        blocks.clear();
+    }
+};
@@ -0,0 +1,58 @@
+// ElementColoring.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 单元着色表 (Element Coloring)
+ * @details
+ *   - 存储在 registry.ctx() (Context) 中，由 ElementColoringSystem::build() 在求解前构建一次
+ *   - 同一颜色内任意两个单元不共享节点，因此同色单元可以并行计算并直接
+ *     scatter 到节点数组，无需原子操作或线程私有缓冲
+ *   - 颜色按顺序依次处理，颜色之间需要同步
+ *   - 按 ConnectivityStore 的连接块分别着色，每种颜色只属于一个块
+ *
+ * 存储格式（CSR）：颜色 c 的单元为块 color_block[c] 中的
+ * elements[color_offsets[c] .. color_offsets[c+1])
+ */
+struct ElementColoring {
+    /**
+     * @brief 按颜色分组排列的单元（块内单元序号，对应 ConnectivityBlock::elements 的下标）
+     */
+    std::vector<uint32_t> elements;
+
+    /**
+     * @brief 每种颜色在 elements 中的起始偏移，长度为 num_colors() + 1
+     */
+    std::vector<size_t> color_offsets;
+
+    /**
+     * @brief 每种颜色所属的连接块（ConnectivityStore::blocks 的下标），长度为 num_colors()
+     */
+    std::vector<uint32_t> color_block;
+
+    /**
+     * @brief 颜色数量
+     */
+    size_t num_colors() const {
+        return color_offsets.empty() ? 0 : color_offsets.size() - 1;
+    }
+
+    /**
+     * @brief 清空所有数据
+     */
+    void clear() {
+        elements.clear();
+        color_offsets.clear();
+        color_block.clear();
+    }
+};
@@ -19,6 +19,38 @@ struct ElementProperties {
     std::string name;
 };
 
+// 编译期单元类型表：ElementRegistry 与 ElementTraits（模板化单元核）共用同一份数据
+struct ElementTypeInfo {
+    int type_id;
+    int num_nodes;
+    int dimension;
+    int num_faces;   // 拓扑面（2D 单元为边，1D 单元为端点）数量，与 TopologySystems 一致
+    const char* name;
+};
+
+inline constexpr ElementTypeInfo kElementTypeTable[] = {
+    {102,  2, 1, 2, "Line2"},
+    {103,  3, 1, 2, "Line3"},
+    {203,  3, 2, 3, "Triangle3"},
+    {204,  4, 2, 4, "Quad4"},
+    {208,  8, 2, 4, "Quad8"},
+    {304,  4, 3, 4, "Tetra4"},
+    {306,  6, 3, 5, "Penta6"}, // 注意：306通常是三棱柱(Wedge/Penta)，不是金字塔
+    {308,  8, 3, 6, "Hexa8"},
+    {310, 10, 3, 4, "Tetra10"},
+    {320, 20, 3, 6, "Hexa20"},
+};
+
+// 编译期查找单元类型，未知类型返回 nullptr
+constexpr const ElementTypeInfo* find_element_type_info(int typeId) {
+    for (const auto& info : kElementTypeTable) {
+        if (info.type_id == typeId) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
 // 使用类和静态成员实现单例模式，确保注册表全局唯一
 class ElementRegistry {
 public:
@@ -43,18 +75,11 @@ private:
         initialize();
     }
 
-    // 初始化函数，填充所有支持的单元类型
+    // 初始化函数，由编译期单元类型表填充所有支持的单元类型
     void initialize() {
-        propertiesMap[102] = {2, 1, "Line2"};
-        propertiesMap[103] = {3, 1, "Line3"};
-        propertiesMap[203] = {3, 2, "Triangle3"};
-        propertiesMap[204] = {4, 2, "Quad4"};
-        propertiesMap[208] = {8, 2, "Quad8"};
-        propertiesMap[304] = {4, 3, "Tetra4"};
-        propertiesMap[306] = {6, 3, "Penta6"}; // 注意：306通常是三棱柱(Wedge/Penta)，不是金字塔
-        propertiesMap[308] = {8, 3, "Hexa8"};
-        propertiesMap[310] = {10, 3, "Tetra10"};
-        propertiesMap[320] = {20, 3, "Hexa20"};
+        for (const auto& info : kElementTypeTable) {
+            propertiesMap[info.type_id] = {info.num_nodes, info.dimension, info.name};
+        }
     }
 
     // 禁止拷贝和赋值
@@ -0,0 +1,86 @@
+// EnergyBalance.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+/**
+ * @brief 单元循环中融合计算的能量部分和 (Element Energy)
+ * @details 由内力核在计算单元内力的同时累加，不需要额外的单元遍历：
+ *   - 线弹性小应变下单元内力 f = K u 关于位移线性，因此应变能为 ½ f·u
+ *   - 弹性沙漏形式（stiffness / eas）的沙漏能同样为 ½ f_hg·u
+ *   - 粘性沙漏形式只能耗散能量，记录其功率 f_hg·v，由时间积分累加
+ */
+struct alignas(64) ElementEnergy {
+    double strain = 0.0;           ///< 应变能 Σ ½ f·u（不含沙漏）
+    double hourglass = 0.0;        ///< 弹性沙漏能 Σ ½ f_hg·u
+    double hourglass_power = 0.0;  ///< 粘性沙漏功率 Σ f_hg·v
+
+    ElementEnergy& operator+=(const ElementEnergy& other) {
+        strain += other.strain;
+        hourglass += other.hourglass;
+        hourglass_power += other.hourglass_power;
+        return *this;
+    }
+
+    void clear() {
+        strain = 0.0;
+        hourglass = 0.0;
+        hourglass_power = 0.0;
+    }
+};
+
+/**
+ * @brief 节点循环（时间积分）中融合计算的能量部分和 (Nodal Energy)
+ * @details 由 ExplicitSolver::integrate 在更新速度的同一循环中累加：
+ *   - 动能使用 t_n 时刻的速度 v_n = (v_{n-1/2} + v_{n+1/2}) / 2，与单元在 x_n 上的应变能同一时刻
+ *   - 外力功率分别对更新前后的半步速度计算，用于梯形积分外力功
+ */
+struct NodalEnergy {
+    double kinetic = 0.0;        ///< 动能 Σ ½ m v_n²
+    double power_before = 0.0;   ///< f_ext,n · v_{n-1/2}
+    double power_after = 0.0;    ///< f_ext,n · v_{n+1/2}
+    double mass = 0.0;           ///< 模型总质量（含质量缩放附加质量）
+
+    void clear() {
+        kinetic = 0.0;
+        power_before = 0.0;
+        power_after = 0.0;
+        mass = 0.0;
+    }
+};
+
+/**
+ * @brief 全局能量平衡 (Energy Balance)，对应 Simdroid History.GlobalFields
+ * @details
+ *   - 由 EnergyBalanceSystem::update() 每步更新，HistoryWriter 按 HistoryOutTimeInterval 输出
+ *   - Ext-Work 用梯形公式累加：W_n = W_{n-1} + ½ dt_{n-1} (f_{n-1}·v_{n-1/2} + f_n·v_{n-1/2})
+ *   - Error 为能量平衡的相对误差 |TOT - E0 - W| / max(|E0 + W|, TOT)，
+ *     失稳时应变能与动能迅速增长而外力功不变，误差随之增大（StopEnergyErr 判据）
+ */
+struct EnergyBalance {
+    double kinetic = 0.0;              ///< K-Energy-TOT
+    double internal = 0.0;             ///< I-Energy（应变能）
+    double hourglass = 0.0;            ///< HG-Energy（弹性沙漏能 + 累计粘性沙漏耗散）
+    double external_work = 0.0;        ///< Ext-Work
+    double total = 0.0;                ///< TOT-Energy = K + I + HG
+    double error = 0.0;                ///< Error
+    double mass = 0.0;                 ///< Total-Mass
+
+    double initial_total = 0.0;        ///< 第一次更新时的总能量 E0
+    double hourglass_dissipated = 0.0; ///< 累计粘性沙漏耗散
+    double last_power_after = 0.0;     ///< 上一步的 f_ext·v_{n+1/2}
+    double last_dt = 0.0;              ///< 上一步的时间步长
+    bool initialized = false;
+
+    /**
+     * @brief 清空所有数据
+     */
+    void clear() {
+        *this = EnergyBalance{};
+    }
+};
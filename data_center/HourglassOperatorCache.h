@@ -0,0 +1,64 @@
+// HourglassOperatorCache.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief 单个连接块的 EAS 沙漏算子（双精度，按单元连续）
+ * @details 布局与 ReferenceElementFields 的 hourglass_gamma / hourglass_stiffness 相同；
+ *          退化单元的数据为 0（不产生沙漏力，与逐步计算时跳过一致）
+ */
+struct HourglassOperatorBlock {
+    /**
+     * @brief 沙漏形状向量 Gamma，第 k 个单元为 [32k, 32k + 32)：gamma[模态 i][节点 A]；为空表示该块不使用
+     */
+    std::vector<double> gamma;
+
+    /**
+     * @brief EAS 模态刚度，第 k 个单元为 [144k, 144k + 144)：K[i][j][a][b]
+     */
+    std::vector<double> stiffness;
+
+    size_t num_elements() const {
+        return gamma.size() / 32;
+    }
+};
+
+/**
+ * @brief 未进入参考构型缓存的 C3D8R 块的 EAS 沙漏算子 (Hourglass Operator Cache)
+ * @details
+ *   - EAS 沙漏力为全拉格朗日形式 f = Gamma K Gamma^T u，Gamma 和 K 只依赖初始构型，
+ *     与 ElementCache 选项无关，因此在准备阶段计算一次，每步只剩收集位移和两次小矩阵乘
+ *   - 存储在 registry.ctx() (Context) 中，由 ReferenceElementCacheSystem::build() 为未缓存的
+ *     EAS 块构建（ElementCache = Off 时即全部 EAS 块）；已缓存的块使用 ReferenceElementCache 中的算子
+ *   - blocks[b] 对应 store.blocks[b]；网格、属性或材料变化后需要重建
+ */
+struct HourglassOperatorCache {
+    std::vector<HourglassOperatorBlock> blocks;
+
+    /**
+     * @brief 算子占用的内存（字节）
+     */
+    size_t memory_bytes() const {
+        size_t bytes = 0;
+        for (const auto& block : blocks) {
+            bytes += (block.gamma.size() + block.stiffness.size()) * sizeof(double);
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief 清空所有数据
+     */
+    void clear() {
+        blocks.clear();
+    }
+};
@@ -0,0 +1,53 @@
+// KernelPrecision.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief 单元内力核的计算精度（分析级选项 ElementPrecision）
+ * @details 存储在 registry.ctx() 中，由 InternalForceSystem::set_precision() 设置
+ */
+enum class KernelPrecision {
+    Double,  ///< 全双精度（默认）
+    Mixed    ///< 单点积分 Hexa8 单元核在 float32 中计算（坐标、位移、D、梯度、应力），
+             ///< 节点坐标、时间积分和内力散射累加保持 fp64；SIMD 宽度加倍
+};
+
+/**
+ * @brief 混合精度单元内力相对 fp64 路径的偏差（同一节点状态上两种核的比较）
+ * @details 由 InternalForceSystem::compare_precision() 计算：
+ *   - 能量：两条路径各自融合计算的应变能 + 弹性沙漏能
+ *   - 内力：max_i |f_mixed - f_fp64| / max_i |f_fp64|（按分量）
+ */
+struct PrecisionDeviation {
+    double energy_double = 0.0;   ///< fp64 路径的内能（应变能 + 弹性沙漏能）
+    double energy_mixed = 0.0;    ///< 混合精度路径的内能
+    double force_error = 0.0;     ///< 内力的相对最大偏差
+
+    /**
+     * @brief 内能的相对偏差 |E_mixed - E_fp64| / |E_fp64|
+     */
+    double energy_error() const {
+        const double scale = std::abs(energy_double);
+        return scale > 0.0 ? std::abs(energy_mixed - energy_double) / scale : 0.0;
+    }
+
+    /**
+     * @brief 记录逐次比较中的最大偏差
+     */
+    void take_max(const PrecisionDeviation& other) {
+        if (other.energy_error() >= energy_error()) {
+            energy_double = other.energy_double;
+            energy_mixed = other.energy_mixed;
+        }
+        force_error = std::max(force_error, other.force_error);
+    }
+};
@@ -0,0 +1,66 @@
+// LoadProgram.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "entt/entt.hpp"
+#include "components/load_components.h"
+
+/**
+ * @brief 编译后的节点载荷程序 (Compiled Nodal Load Program)
+ * @details
+ *   - 存储在 registry.ctx() (Context) 中，由 LoadSystem::compile_nodal_loads() 在求解前构建一次
+ *   - 将 AppliedLoadRef / NodalLoad / CurveRef 展平为 (节点索引, DOF 掩码, 基准值, 曲线槽位) 记录
+ *   - 每个时间步：每条不同的曲线只求值一次写入 slot_values，再做一次紧凑的 scatter 循环
+ *
+ * 槽位约定：
+ *   - 槽位 0 保留给"无曲线"载荷，其值恒为 1.0
+ *   - 槽位 k >= 1 对应 curves[k] / curve_entities[k]
+ */
+struct LoadProgram {
+    /**
+     * @brief 单条载荷记录
+     */
+    struct Record {
+        uint32_t node_index;   ///< 稠密节点索引（与 NodalState 一致）
+        uint8_t dof_mask;      ///< 平动自由度掩码（bit 0 = x, bit 1 = y, bit 2 = z）
+        uint32_t curve_slot;   ///< 曲线槽位，0 表示不随时间缩放
+        double base_value;     ///< 载荷基准值
+    };
+
+    std::vector<Record> records;
+
+    /**
+     * @brief 曲线槽位 -> 曲线实体（槽位 0 为 entt::null）
+     */
+    std::vector<entt::entity> curve_entities;
+
+    /**
+     * @brief 曲线槽位 -> 曲线定义副本（槽位 0 为空曲线）
+     * @details 复制曲线数据，使时间步循环无需再访问 registry
+     */
+    std::vector<Component::Curve> curves;
+
+    /**
+     * @brief 当前时间步各槽位的曲线值（由 LoadSystem 每步刷新）
+     */
+    std::vector<double> slot_values;
+
+    /**
+     * @brief 清空所有数据
+     */
+    void clear() {
+        records.clear();
+        curve_entities.clear();
+        curves.clear();
+        slot_values.clear();
+    }
+};
@@ -0,0 +1,68 @@
+// MassScaling.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief 选择性质量缩放状态 (Selective Mass Scaling)
+ * @details
+ *   - 存储在 registry.ctx() (Context) 中，由 MassScalingSystem::apply() 构建和更新
+ *   - 只对临界时间步小于目标值的单元增加质量：单元密度放大 f 倍时波速缩小 sqrt(f) 倍，
+ *     因此取 f = (dt_target / (DtScale * dt_e))^2 即可使该单元的时间步恰好达到目标
+ *   - 附加质量 m_e * (f - 1) 平均分配到单元的各个节点
+ *   - 按 ConnectivityStore 的连接块存储，element_mass[b][k] 对应块 b 中第 k 个单元
+ *   - 周期性重缩放时在当前（已缩放的）单元质量上继续放大，附加质量只增不减
+ */
+struct MassScaling {
+    /**
+     * @brief 每个单元的当前质量（含附加质量），0 表示该单元不参与缩放
+     */
+    std::vector<std::vector<double>> element_mass;
+
+    /**
+     * @brief 模型物理质量（缩放前所有参与单元质量之和）
+     */
+    double physical_mass = 0.0;
+
+    /**
+     * @brief 累计附加质量
+     */
+    double added_mass = 0.0;
+
+    /**
+     * @brief 最近一次缩放实际使用的目标时间步（已乘 DtScale）
+     * @details 当附加质量比例达到上限时，目标值会小于 Dtmin
+     */
+    double dt_target = 0.0;
+
+    /**
+     * @brief 最近一次缩放中增加了质量的单元数量
+     */
+    size_t scaled_elements = 0;
+
+    /**
+     * @brief 附加质量比例 added_mass / physical_mass
+     */
+    double added_mass_ratio() const {
+        return (physical_mass > 0.0) ? added_mass / physical_mass : 0.0;
+    }
+
+    /**
+     * @brief 清空所有数据
+     */
+    void clear() {
+        element_mass.clear();
+        physical_mass = 0.0;
+        added_mass = 0.0;
+        dt_target = 0.0;
+        scaled_elements = 0;
+    }
+};
@@ -0,0 +1,100 @@
+// MeshPartition.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 网格划分方法
+ */
+enum class PartitionMethod {
+    RCB,    ///< 递归坐标二分：沿单元形心包围盒的最长轴按权重中位数切分
+    RIB,    ///< 递归惯性二分：沿形心加权惯性张量的主轴按权重中位数切分
+    Graph   ///< 多级图二分：在单元对偶图（共享面相邻）上粗化、初始二分、逐级 FM 细化
+};
+
+/**
+ * @brief 网格划分结果 (Mesh Partition)
+ * @details
+ *   - 存储在 registry.ctx() (Context) 中，由 PartitionSystem::partition() 生成
+ *   - 单元按 ConnectivityStore 的编号（各块依次拼接）排列：
+ *     element_part[i] 为第 i 个单元所属的分区
+ *   - 每个单元实体同时附加 Component::PartitionID
+ *   - 网格（节点或单元）发生增删后失效，需要重新划分
+ */
+struct MeshPartition {
+    /**
+     * @brief 使用的划分方法
+     */
+    PartitionMethod method = PartitionMethod::RCB;
+
+    /**
+     * @brief 分区数量
+     */
+    int num_parts = 0;
+
+    /**
+     * @brief 每个单元所属的分区（ConnectivityStore 单元编号）
+     */
+    std::vector<int> element_part;
+
+    /**
+     * @brief 每个分区的单元数量
+     */
+    std::vector<size_t> part_elements;
+
+    /**
+     * @brief 每个分区的计算量（单元代价权重之和）
+     */
+    std::vector<double> part_weights;
+
+    /**
+     * @brief 每个分区的 halo 节点数：本分区单元使用、同时也被其它分区单元使用的节点
+     */
+    std::vector<size_t> part_halo;
+
+    /**
+     * @brief 切边数：两侧单元属于不同分区的内部面数量（对偶图的割边）
+     */
+    size_t edge_cut = 0;
+
+    /**
+     * @brief 分区界面节点总数（被两个及以上分区的单元使用的节点）
+     */
+    size_t shared_nodes = 0;
+
+    /**
+     * @brief 负载不平衡度：最大分区权重 / 平均分区权重（1.0 为完全平衡）
+     */
+    double imbalance = 0.0;
+
+    /**
+     * @brief 最大的分区 halo 节点数
+     */
+    size_t max_halo() const {
+        return part_halo.empty() ? 0 : *std::max_element(part_halo.begin(), part_halo.end());
+    }
+
+    /**
+     * @brief 清空所有数据
+     */
+    void clear() {
+        num_parts = 0;
+        element_part.clear();
+        part_elements.clear();
+        part_weights.clear();
+        part_halo.clear();
+        edge_cut = 0;
+        shared_nodes = 0;
+        imbalance = 0.0;
+    }
+};
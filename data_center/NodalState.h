@@ -0,0 +1,98 @@
+// NodalState.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "entt/entt.hpp"
+#include "ConnectivityStore.h"
+
+/**
+ * @brief 显式求解节点状态块 (Nodal State Block, Structure-of-Arrays)
+ * @details
+ *   - 存储在 registry.ctx() (Context) 中，由 NodalStateSystem::build() 在时间积分前构建一次
+ *   - 节点按稠密索引 [0, num_nodes) 连续编号，每个物理量占用一段连续数组
+ *   - 矢量量按 xyz 交错存储：x[3*i + d]，d = 0(x), 1(y), 2(z)
+ *   - 节点编号与 ConnectivityStore 共用：本结构只引用连接存储中的
+ *     node_entities / entity_to_index，不另存副本
+ *   - 时间步循环只读写本结构；ECS 组件（Position/Velocity/...）仅在输出或导出
+ *     需要时由 NodalStateSystem::sync_to_registry() 回写
+ *
+ * 架构优势：
+ *   - 性能：热循环中无 per-entity 哈希查找、无组件存在性检查、无 emplace
+ *   - 缓存：连续数组可被编译器向量化，按单元 gather/scatter 只需一次间接寻址
+ */
+struct NodalState {
+    /**
+     * @brief 提供节点编号的连接存储（registry.ctx() 中的 ConnectivityStore）
+     * @details 稠密索引 <-> 节点实体的映射只保存在连接存储中；
+     *          ctx 中的对象地址稳定，重建连接存储后本指针仍然有效
+     */
+    const ConnectivityStore* nodes = nullptr;
+
+    // --- 矢量量 (3 * num_nodes, xyz 交错) ---
+    std::vector<double> x;      ///< 当前坐标
+    std::vector<double> x0;     ///< 初始坐标
+    std::vector<double> u;      ///< 位移
+    std::vector<double> v;      ///< 速度 (半步)
+    std::vector<double> a;      ///< 加速度
+    std::vector<double> f_int;  ///< 内力（融合时间步 ExplicitSolver::integrate_fused 使用后清零）
+    std::vector<double> f_ext;  ///< 外力
+
+    // --- 标量量 (num_nodes) ---
+    std::vector<double> mass;      ///< 集中质量
+    std::vector<double> inv_mass;  ///< 质量倒数；零质量节点为 0（加速度恒为 0）
+
+    /**
+     * @brief 上一步的时间步长（0 表示尚未积分）
+     * @details 半步速度的更新量为 a * (dt_previous + dt) / 2，时间步变化时保持二阶精度；
+     *          由 ExplicitSolver::integrate / integrate_fused 更新，随检查点保存
+     */
+    double dt_previous = 0.0;
+
+    /**
+     * @brief 节点数量
+     */
+    size_t num_nodes() const {
+        return mass.size();
+    }
+
+    /**
+     * @brief 稠密索引 -> 节点实体
+     */
+    entt::entity node_entity(size_t index) const {
+        return nodes->node_entities[index];
+    }
+
+    /**
+     * @brief 获取节点实体的稠密索引（带边界检查）
+     * @return 稠密索引，不存在时返回 -1
+     */
+    int index_of(entt::entity entity) const {
+        return (nodes != nullptr) ? nodes->index_of(entity) : -1;
+    }
+
+    /**
+     * @brief 清空所有数据
+     */
+    void clear() {
+        nodes = nullptr;
+        x.clear();
+        x0.clear();
+        u.clear();
+        v.clear();
+        a.clear();
+        f_int.clear();
+        f_ext.clear();
+        mass.clear();
+        inv_mass.clear();
+        dt_previous = 0.0;
+    }
+};
@@ -0,0 +1,138 @@
+// ReferenceElementCache.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <Eigen/Dense>
+
+/**
+ * @brief 参考构型单元缓存的精度模式（分析级选项 ElementCache）
+ */
+enum class ReferenceCacheMode {
+    Off,     ///< 不缓存：每步在当前构型上重新计算 B-bar 梯度和体积（默认，适用于大转动）
+    Double,  ///< 参考构型缓存，双精度：与当前构型结果相差 O(|u| / L)，每单元约 200 字节
+    Float    ///< 参考构型缓存，梯度和沙漏向量用单精度存储：内存约减半，相对误差约 1e-7
+};
+
+/**
+ * @brief 缓存的沙漏项形式
+ */
+enum class ReferenceHourglassTerm {
+    None,           ///< 无沙漏控制
+    ScalarOnDisp,   ///< f += s * Gamma Gamma^T u（FB stiffness）
+    ScalarOnVel,    ///< f += s * Gamma Gamma^T v（FB viscous）
+    ModeMatrix      ///< f += Gamma K Gamma^T u（Puso EAS，K 为 4x4 个 3x3 模态刚度块）
+};
+
+/**
+ * @brief 单个连接块的参考构型数据（按字段分开存储的 SoA，每个字段内按单元连续）
+ * @tparam Real 梯度、沙漏向量和模态刚度的存储类型（double 或 float）
+ */
+template <typename Real>
+struct ReferenceElementFields {
+    /**
+     * @brief 参考构型的非归一化 B-bar 梯度 BiI，第 k 个单元为 [24k, 24k + 24)：bx[8], by[8], bz[8]
+     */
+    std::vector<Real> gradients;
+
+    /**
+     * @brief 沙漏形状向量 Gamma，第 k 个单元为 [32k, 32k + 32)：gamma[模态 i][节点 A]
+     */
+    std::vector<Real> hourglass_gamma;
+
+    /**
+     * @brief EAS 模态刚度，第 k 个单元为 [144k, 144k + 144)：K[i][j][a][b]
+     */
+    std::vector<Real> hourglass_stiffness;
+
+    size_t memory_bytes() const {
+        return (gradients.size() + hourglass_gamma.size() + hourglass_stiffness.size()) * sizeof(Real);
+    }
+
+    void clear() {
+        gradients.clear();
+        hourglass_gamma.clear();
+        hourglass_stiffness.clear();
+    }
+};
+
+/**
+ * @brief 单个连接块的参考构型缓存
+ * @details 块内单元共享属性和材料，因此 D 矩阵和沙漏形式按块存储一次
+ */
+struct ReferenceElementBlock {
+    /**
+     * @brief 该块是否使用缓存（目前只缓存单点积分 Hexa8 块）
+     */
+    bool cached = false;
+
+    /**
+     * @brief 块的材料 D 矩阵（指向材料实体上的 LinearElasticMatrix）
+     */
+    const Eigen::Matrix<double, 6, 6>* D = nullptr;
+
+    /**
+     * @brief 沙漏项形式
+     */
+    ReferenceHourglassTerm hourglass = ReferenceHourglassTerm::None;
+
+    /**
+     * @brief 体积倒数 1 / V0；退化单元为 0（计算时跳过）
+     */
+    std::vector<double> inv_volume;
+
+    /**
+     * @brief 标量沙漏系数（ScalarOnDisp 为 kappa，ScalarOnVel 为 c_v）
+     */
+    std::vector<double> hourglass_scale;
+
+    ReferenceElementFields<double> fp64;  ///< Double 模式的数据
+    ReferenceElementFields<float> fp32;   ///< Float 模式的数据
+
+    size_t num_elements() const {
+        return inv_volume.size();
+    }
+};
+
+/**
+ * @brief 小应变显式分析的参考构型单元缓存 (Reference Element Cache)
+ * @details
+ *   - 存储在 registry.ctx() (Context) 中，由 ReferenceElementCacheSystem::build() 在准备阶段构建一次
+ *   - 线弹性小应变下 B-bar 梯度、体积和沙漏算子只依赖初始构型，缓存后每步只剩
+ *     收集位移、应变/应力计算和散射，不再重复计算梯度
+ *   - 按 ConnectivityStore 的连接块存储，blocks[b] 对应 store.blocks[b]，块内第 k 个单元
+ *     对应块的第 k 个单元；网格或块划分变化后需要重建
+ *   - 属性（沙漏控制）或材料在构建后被修改时需要重建
+ */
+struct ReferenceElementCache {
+    ReferenceCacheMode mode = ReferenceCacheMode::Off;
+
+    std::vector<ReferenceElementBlock> blocks;
+
+    /**
+     * @brief 缓存占用的内存（字节）
+     */
+    size_t memory_bytes() const {
+        size_t bytes = 0;
+        for (const auto& block : blocks) {
+            bytes += (block.inv_volume.size() + block.hourglass_scale.size()) * sizeof(double);
+            bytes += block.fp64.memory_bytes() + block.fp32.memory_bytes();
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief 清空所有数据
+     */
+    void clear() {
+        mode = ReferenceCacheMode::Off;
+        blocks.clear();
+    }
+};
@@ -0,0 +1,49 @@
+// SpcTable.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 编译后的单点约束表 (Compiled SPC Table)
+ * @details
+ *   - 存储在 registry.ctx() (Context) 中，由 BoundarySystem::compile_spc() 在求解前构建一次
+ *   - 将 AppliedBoundaryRef / BoundarySPC 的 dof 字符串编译为每节点 3 位掩码
+ *     以及一个扁平的受约束自由度索引列表
+ *   - 时间步循环中只需遍历 constrained_dofs 将加速度置零，无字符串处理、无分支
+ *
+ * 索引约定：与 NodalState 一致，自由度索引 = 3 * 稠密节点索引 + 方向 (0=x, 1=y, 2=z)
+ */
+struct SpcTable {
+    /**
+     * @brief 每个稠密节点的约束掩码（bit 0 = x, bit 1 = y, bit 2 = z，见 DofMask）
+     */
+    std::vector<uint8_t> node_mask;
+
+    /**
+     * @brief 所有受约束自由度的扁平索引列表（升序、无重复）
+     */
+    std::vector<uint32_t> constrained_dofs;
+
+    /**
+     * @brief 受约束节点数量（掩码非零的节点）
+     */
+    size_t num_constrained_nodes = 0;
+
+    /**
+     * @brief 清空所有数据
+     */
+    void clear() {
+        node_mask.clear();
+        constrained_dofs.clear();
+        num_constrained_nodes = 0;
+    }
+};
@@ -0,0 +1,67 @@
+// StableTimeStep.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief 单元稳定时间步表 (Element Stable Time Step)
+ * @details
+ *   - 存储在 registry.ctx() (Context) 中，由 ExplicitSolver::compute_stable_timestep() 构建和更新
+ *   - 单元临界时间步 dt_e = L_c / c，其中
+ *       L_c = V / A_max（单元体积 / 最大面面积）
+ *       c   = sqrt((lambda + 2 mu) / rho)（膨胀波速）
+ *   - 按 ConnectivityStore 的连接块存储，element_dt[b][k] 对应块 b 中第 k 个单元
+ *   - 波速只与材料有关，首次计算后缓存；之后每次更新只重新计算几何量
+ *   - 不支持的单元类型不参与计算，其 dt 为 +inf
+ *   - 翻转 / 零体积单元以及没有有效材料（波速为 0）的单元 dt 记为 0，
+ *     此时 dt_critical = 0、critical_* 指向第一个这样的单元，求解器应中止
+ */
+struct StableTimeStep {
+    /**
+     * @brief 每个单元的临界时间步（未乘 DtScale）
+     */
+    std::vector<std::vector<double>> element_dt;
+
+    /**
+     * @brief 每个单元的膨胀波速，0 表示该单元没有有效材料
+     */
+    std::vector<std::vector<double>> wave_speed;
+
+    /**
+     * @brief 所有单元临界时间步的最小值（未乘 DtScale）
+     */
+    double dt_critical = std::numeric_limits<double>::infinity();
+
+    /**
+     * @brief 控制时间步的单元（块下标、块内序号）
+     */
+    uint32_t critical_block = 0;
+    uint32_t critical_element = 0;
+
+    /**
+     * @brief 没有有效临界时间步（dt = 0）的单元数量
+     */
+    size_t num_invalid_elements = 0;
+
+    /**
+     * @brief 清空所有数据
+     */
+    void clear() {
+        element_dt.clear();
+        wave_speed.clear();
+        dt_critical = std::numeric_limits<double>::infinity();
+        critical_block = 0;
+        critical_element = 0;
+        num_invalid_elements = 0;
+    }
+};
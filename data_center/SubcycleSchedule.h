@@ -0,0 +1,95 @@
+// SubcycleSchedule.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ElementColoring.h"
+
+/**
+ * @brief 多时间步子循环调度表 (Subcycling Schedule)
+ * @details
+ *   - 存储在 registry.ctx() (Context) 中，由 SubcycleSystem::build() 构建
+ *   - 单元按临界时间步分为 2 的幂次级别：级别 l 的单元每 2^l 个基准步计算一次内力，
+ *     其中 l = floor(log2(dt_e / dt_crit))，不超过 num_levels - 1
+ *   - 内力以冲量形式施加：级别 l 的单元内力在其更新步上乘以权重 2^l，
+ *     其他基准步不施加（多时间步冲量法，r-RESPA）。每个单元的内力总是
+ *     同时、等权重地作用在它的所有节点上，因此动量守恒
+ *   - 界面处理：节点级别取其所连单元级别的最小值，单元的更新级别再取其节点级别的最小值，
+ *     因此与小单元相连的界面单元按小步长计算，大单元的冲量不会直接作用在小步长节点上
+ */
+struct SubcycleSchedule {
+    /**
+     * @brief 级别数量（1 表示不做子循环）
+     */
+    int num_levels = 1;
+
+    /**
+     * @brief 每个单元的更新级别，element_level[b][k] 对应块 b 中第 k 个单元
+     */
+    std::vector<std::vector<uint8_t>> element_level;
+
+    /**
+     * @brief 每个稠密节点的级别（所连单元原始级别的最小值）
+     */
+    std::vector<uint8_t> node_level;
+
+    /**
+     * @brief 每个级别的单元着色表（同一级别内同色单元不共享节点）
+     */
+    std::vector<ElementColoring> level_coloring;
+
+    /**
+     * @brief 按所连单元最高更新级别降序排列的稠密节点
+     * @details 前 level_node_end[l] 个节点至少连有一个更新级别 >= l 的单元。
+     *          自上而下累加各级别内力时，计算级别 l 之前只有前 level_node_end[l + 1]
+     *          个节点的内力非零，加倍只需遍历这些节点
+     */
+    std::vector<uint32_t> level_nodes;
+    std::vector<size_t> level_node_end;
+
+    /**
+     * @brief 级别 l 在基准步 step 是否需要更新
+     * @details 若级别 l 需要更新，则所有更低级别也需要更新
+     */
+    static bool is_active(int level, size_t step) {
+        return (step & ((size_t(1) << level) - 1)) == 0;
+    }
+
+    /**
+     * @brief 基准步 step 需要计算的单元数量
+     */
+    size_t num_active_elements(size_t step) const {
+        size_t count = 0;
+        for (int level = 0; level < num_levels && is_active(level, step); ++level) {
+            count += level_coloring[level].elements.size();
+        }
+        return count;
+    }
+
+    /**
+     * @brief 一个完整子循环包含的基准步数 2^(num_levels - 1)
+     */
+    size_t cycle_length() const {
+        return size_t(1) << (num_levels - 1);
+    }
+
+    /**
+     * @brief 清空所有数据
+     */
+    void clear() {
+        num_levels = 1;
+        element_level.clear();
+        node_level.clear();
+        level_coloring.clear();
+        level_nodes.clear();
+        level_node_end.clear();
+    }
+};
@@ -19,7 +19,7 @@ using AnalysisID = int;
  * @namespace Component
  * @brief Contains all ECS components for analysis representation
  * @details Components are organized by domain:
- *   - Analysis components: AnalysisType, EndTime, FixedTimeStep   
+ *   - Analysis components: AnalysisType, EndTime, FixedTimeStep, TimeStepControl, ElementCache, HistoryOutput
  */
 namespace Component {
 
@@ -58,6 +58,87 @@ namespace Component {
         double value;
     };
 
+    /**
+     * @brief Explicit time step control (Simdroid AnalysisControl.TimeStepControl)
+     * @details Attached to the analysis entity. When present, the explicit solver
+     *          uses the element CFL time step scaled by dt_scale instead of FixedTimeStep.
+     *          With control_type "MassScaling" and dt_min > 0, elements whose scaled
+     *          time step is below dt_min receive added mass (see MassScalingSystem).
+     */
+    struct TimeStepControl {
+        double dt_scale = 0.9;              ///< DtScale: safety factor on the critical time step
+        double dt_min = 0.0;                ///< Dtmin: smallest admissible time step
+        std::string control_type;           ///< DtControlType (e.g. "MassScaling")
+        double init_mass_scale_ratio = 0.0; ///< InitMassScalRatio: added-mass ratio limit of the initial scaling (0 = no limit)
+        double max_mass_scale_ratio = 0.0;  ///< MaxMassScalRatio: added-mass ratio limit over the run (0 = no limit)
+        int mass_scale_interval = 0;        ///< MassScalInterval: rescale every N steps (0 = initial scaling only)
+        int subcycle_levels = 1;            ///< SubcycleLevels: power-of-two time step levels (1 = no subcycling)
+        double stop_energy_error = 0.0;     ///< StopEnergyErr (0 = never stop)
+        int update_interval = 10;           ///< Re-evaluate the stable time step every N steps
+    };
+
+    /**
+     * @brief Reference-configuration element cache option (Simdroid AnalysisControl.ElementCache)
+     * @details Attached to the analysis entity. "Reference" / "Double" caches the
+     *          C3D8R gradients, volumes and hourglass operators of the initial
+     *          configuration in double precision, "Float" stores them in single
+     *          precision (about half the memory), "Off" keeps the current-configuration
+     *          kernels. Only valid for linear small-strain analysis.
+     */
+    struct ElementCache {
+        std::string mode = "Off";
+    };
+
+    /**
+     * @brief Element kernel precision option (Simdroid AnalysisControl.ElementPrecision)
+     * @details Attached to the analysis entity. "Mixed" evaluates the one-point
+     *          hexahedron kernel in float32 while nodal coordinates, time
+     *          integration and force accumulation stay in double; "Double" (default)
+     *          keeps the fp64 kernels. With "Mixed" the explicit solver reports the
+     *          energy / force deviation against the fp64 kernel every
+     *          check_interval steps.
+     */
+    struct ElementPrecision {
+        std::string mode = "Double";
+        int check_interval = 1000;
+    };
+
+    /**
+     * @brief Domain partition option (Simdroid AnalysisControl.Partition)
+     * @details Attached to the analysis entity. With num_parts > 1 the explicit
+     *          solver partitions the elements once at setup (PartitionSystem, method
+     *          "RCB", "RIB" or "Graph"), logs the edge cut / halo / imbalance and
+     *          writes the PartitionID of every element as a VTU cell field.
+     */
+    struct DomainPartition {
+        int num_parts = 1;
+        std::string method = "RCB";
+    };
+
+    /**
+     * @brief Global history output (Simdroid History)
+     * @details Attached to the analysis entity, independent of the VTU output entity.
+     *          The explicit solver writes the requested GlobalFields (Time, Cycle,
+     *          Time-Step, K-Energy-TOT, I-Energy, HG-Energy, Ext-Work, TOT-Energy,
+     *          Error, Total-Mass) to result/history.dat every interval_time
+     *          (0 = every step).
+     */
+    struct HistoryOutput {
+        std::vector<std::string> global_fields;
+        double interval_time = 0.0;
+        std::string format = "ASCII";
+    };
+
+    /**
+     * @brief Checkpoint control (top-level "Checkpoint" section)
+     * @details The explicit solver writes a restart checkpoint to `file` every
+     *          interval_time (0 = only when the run receives SIGTERM).
+     */
+    struct CheckpointControl {
+        double interval_time = 0.0;
+        std::string file = "result/checkpoint.hfc";
+    };
+
     /**
      * @brief Node output component
      * @details Attached to entities representing output
@@ -74,6 +155,17 @@ namespace Component {
         double interval_time;
     };  
 
+    /**
+     * @brief Field output file format (top-level "Output" "Format")
+     * @details "ASCII" (default), "Binary" (raw appended VTU data) or "Base64"
+     *          (inline base64 VTU data). pieces > 1 splits every frame into that
+     *          many .vtu pieces written concurrently, referenced by a .pvtu file.
+     */
+    struct OutputFormat {
+        std::string value = "ASCII";
+        int pieces = 1;
+    };
+
     // [新增] Output control (e.g. d3plot interval)
     struct OutputControl {
         double interval;
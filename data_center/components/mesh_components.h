@@ -87,6 +87,25 @@ namespace Component {
         std::vector<entt::entity> nodes;  // Direct handles to node entities
     };
 
+    /**
+     * @brief Partition (subdomain) an element belongs to
+     * @details Attached to element entities by PartitionSystem::partition().
+     * Values are 0 .. num_parts-1; see MeshPartition in registry.ctx().
+     */
+    struct PartitionID {
+        int value;
+    };
+
+    /**
+     * @brief User-defined computational cost of an element
+     * @details Optional, attached to element entities. Overrides the cost that
+     * PartitionSystem estimates from the element type and integration rule,
+     * e.g. for elements with an expensive material model.
+     */
+    struct ElementCost {
+        double value;
+    };
+
     // ===================================================================
     // Set-Related Components
     // ===================================================================
@@ -33,7 +33,8 @@ namespace Component {
     struct SolidProperty {
         int type_id;                    // 来自 JSON 的 "typeid"
         int integration_network;        // 积分网络参数，如 "integration_network": 2
-        std::string hourglass_control;  // 沙漏控制方法，如 "hourglass_control": "eas"
+        std::string hourglass_control;  // 沙漏控制方法，如 "hourglass_control": "eas"（viscous / stiffness / eas / null）
+        double hourglass_coefficient = 0.1;  // 沙漏系数 QH（viscous / stiffness 使用，eas 不需要），如 "hourglass_coefficient": 0.1
     };
 
     /**
@@ -8,12 +8,42 @@
  */
 #include "AssemblySystem.h"
 #include "../element/c3d8r/C3D8RStiffnessMatrix.h"
+#include "../element/ElementBlock.h"
+#include "../element/ElementTraits.h"
 #include "../../data_center/DofMap.h"
+#include "../mesh/ConnectivitySystem.h"
 #include "../../data_center/components/mesh_components.h"
 #include "../../data_center/components/property_components.h"
 #include "../../data_center/components/material_components.h"
 #include "spdlog/spdlog.h"
 
+namespace {
+    // 同一连接块内的单元刚度矩阵核（按单元 traits 特化；目前 Hexa8 的所有积分规则
+    // 均使用 C3D8R + EAS 沙漏刚度，与逐单元 dispatcher 一致）
+    template <typename Traits>
+    bool compute_block_element_stiffness(
+        const uint32_t* nodes,
+        const std::vector<double>& node_coords,
+        const Eigen::Matrix<double, 6, 6>& D,
+        Eigen::MatrixXd& Ke_buffer
+    ) {
+        static_assert(Traits::type_id == 308, "Only Hexa8 stiffness kernels are available");
+        Eigen::Matrix<double, Traits::num_nodes, 3> coords;
+        for (int i = 0; i < Traits::num_nodes; ++i) {
+            coords(i, 0) = node_coords[3*nodes[i] + 0];
+            coords(i, 1) = node_coords[3*nodes[i] + 1];
+            coords(i, 2) = node_coords[3*nodes[i] + 2];
+        }
+        try {
+            compute_c3d8r_stiffness_matrix(coords, D, Ke_buffer);
+            return true;
+        } catch (const std::exception& e) {
+            spdlog::error("Error computing C3D8R stiffness matrix: {}", e.what());
+            return false;
+        }
+    }
+}
+
 // -------------------------------------------------------------------
 // **Dispatcher：根据单元类型分发到相应的刚度矩阵计算函数（高性能版本）**
 // -------------------------------------------------------------------
@@ -32,34 +62,13 @@ bool AssemblySystem::compute_element_stiffness_dispatcher(
 
     // B. 准备数据：获取 D 矩阵（避免在 Kernel 中重复查找）
     // -----------------------------------------------------
-    if (!registry.all_of<Component::PropertyRef>(element_entity)) {
-        spdlog::error("Element entity missing PropertyRef component");
-        return false;
-    }
-    
-    auto prop_entity = registry.get<Component::PropertyRef>(element_entity).property_entity;
-    
-    if (!registry.all_of<Component::MaterialRef>(prop_entity)) {
-        spdlog::error("Property entity missing MaterialRef component");
-        return false;
-    }
-    
-    auto mat_entity = registry.get<Component::MaterialRef>(prop_entity).material_entity;
-    
-    if (!registry.all_of<Component::LinearElasticMatrix>(mat_entity)) {
-        spdlog::error("Material entity missing LinearElasticMatrix component. "
-                     "Please call LinearElasticMatrixSystem::compute_linear_elastic_matrix() first.");
-        return false;
-    }
-    
-    const auto& material_matrix = registry.get<Component::LinearElasticMatrix>(mat_entity);
-    if (!material_matrix.is_initialized) {
-        spdlog::error("Material D matrix not initialized. "
-                     "Please call LinearElasticMatrixSystem::compute_linear_elastic_matrix() first.");
+    const Eigen::Matrix<double, 6, 6>* D_ptr = find_material_matrix(registry, element_entity);
+    if (D_ptr == nullptr) {
+        spdlog::error("Element material D matrix unavailable (PropertyRef/MaterialRef missing or "
+                      "LinearElasticMatrixSystem::compute_linear_elastic_matrix() not called)");
         return false;
     }
-    
-    const Eigen::Matrix<double, 6, 6>& D = material_matrix.D;
+    const Eigen::Matrix<double, 6, 6>& D = *D_ptr;
 
     // C. switch-case 分发（传入 D 矩阵，避免重复查找）
     // -----------------------------------------------------
@@ -87,6 +96,37 @@ bool AssemblySystem::compute_element_stiffness_dispatcher(
     }
 }
 
+// -------------------------------------------------------------------
+// **Dispatcher：连接块版本（坐标来自稠密数组，不访问节点组件）**
+// -------------------------------------------------------------------
+bool AssemblySystem::compute_element_stiffness_dispatcher(
+    const entt::registry& registry,
+    const ConnectivityBlock& block,
+    size_t k,
+    const std::vector<double>& node_coords,
+    Eigen::MatrixXd& Ke_buffer
+) {
+    // 块内单元共享材料：直接使用块的材料实体
+    const ElementBlockData data = resolve_element_block(registry, block);
+    if (data.D == nullptr) {
+        spdlog::error("Element block missing initialized LinearElasticMatrix. "
+                     "Please call LinearElasticMatrixSystem::compute_linear_elastic_matrix() first.");
+        return false;
+    }
+    
+    bool computed = false;
+    const bool supported = dispatch_element_traits(block, data.integration_points,
+        [&]<typename Traits>() {
+            computed = compute_block_element_stiffness<Traits>(block.nodes_of(k), node_coords, *data.D, Ke_buffer);
+        });
+    if (!supported) {
+        spdlog::error("AssemblySystem: no stiffness kernel for element block (type {}, property {}, "
+                      "integration_network {})", block.type_id, data.property_id, data.integration_points);
+        return false;
+    }
+    return computed;
+}
+
 // -------------------------------------------------------------------
 // **Assembly Loop：统一的组装循环**
 // -------------------------------------------------------------------
@@ -124,62 +164,83 @@ void AssemblySystem::assemble_stiffness(
     // 最大可能是 60x60（20 节点六面体），预留足够空间
     Eigen::MatrixXd Ke_buffer;
     
-    // 4. 获取 DOF 映射数组的指针（直接数组访问，极快）
-    const int* dof_array_ptr = dof_map.get_dof_array_ptr();
+    // 4. 从 ConnectivityStore 获取扁平连接关系（32 位稠密节点索引），
+    //    并把节点坐标和起始 DOF 按稠密编号收集一次
+    const ConnectivityStore& store = ConnectivitySystem::get_or_build(registry);
+    const size_t num_nodes = store.num_nodes();
     
-    // 5. 遍历所有单元（不管类型，统一遍历）
-    auto view = registry.view<Component::Connectivity, Component::ElementType>();
+    std::vector<double> node_coords(3 * num_nodes);
+    std::vector<int> node_dof(num_nodes);
+    for (size_t n = 0; n < num_nodes; ++n) {
+        const entt::entity node_entity = store.node_entities[n];
+        const auto& pos = registry.get<Component::Position>(node_entity);
+        node_coords[3*n + 0] = pos.x;
+        node_coords[3*n + 1] = pos.y;
+        node_coords[3*n + 2] = pos.z;
+        node_dof[n] = dof_map.get_dof_index(node_entity, 0);
+    }
     
+    // 5. 按连接块遍历所有单元
     size_t element_count = 0;
     size_t skipped_count = 0;
+    const int num_dofs_per_node = 3;  // 假设全是 3D 实体单元
     
-    for (auto entity : view) {
-        element_count++;
+    for (const auto& block : store.blocks) {
+        const int element_dofs = block.nodes_per_element * num_dofs_per_node;
+        element_count += block.num_elements();
         
-        // --- Step 1: 调用 Dispatcher 计算单元刚度矩阵到缓冲区 ---
-        if (!compute_element_stiffness_dispatcher(registry, entity, Ke_buffer)) {
-            skipped_count++;
-            continue;  // 跳过不支持的单元
-        }
-        
-        // --- Step 2: 统一组装逻辑 ---
-        const auto& conn = view.get<Component::Connectivity>(entity);
-        int num_nodes = static_cast<int>(conn.nodes.size());
-        int num_dofs_per_node = 3;  // 假设全是 3D 实体单元
-        int element_dofs = num_nodes * num_dofs_per_node;
-        
-        // 验证单元刚度矩阵大小
-        if (Ke_buffer.rows() != element_dofs || Ke_buffer.cols() != element_dofs) {
-            spdlog::warn("Element stiffness matrix size mismatch: expected {}x{}, got {}x{}",
-                        element_dofs, element_dofs, Ke_buffer.rows(), Ke_buffer.cols());
-            skipped_count++;
+        // --- Step 0: 块内单元共享属性和材料，D 矩阵按块查找一次 ---
+        const ElementBlockData data = resolve_element_block(registry, block);
+        if (data.D == nullptr) {
+            spdlog::error("Element block of type {} ({} elements) missing initialized LinearElasticMatrix. "
+                         "Please call LinearElasticMatrixSystem::compute_linear_elastic_matrix() first.",
+                         block.type_id, block.num_elements());
+            skipped_count += block.num_elements();
             continue;
         }
         
-        // 双层循环填坑：遍历单元刚度矩阵的每个元素
-        // 【性能优化】使用直接数组访问，跳过边界检查
-        for (int i = 0; i < element_dofs; ++i) {
-            // 计算局部节点和自由度索引
-            int local_node_i = i / num_dofs_per_node;
-            int local_dof_i = i % num_dofs_per_node;
-            
-            // 【关键优化】直接数组访问，O(1) 复杂度，无函数调用和边界检查开销
-            uint32_t entity_id_i = static_cast<uint32_t>(conn.nodes[local_node_i]);
-            int global_row = dof_array_ptr[entity_id_i] + local_dof_i;
-            
-            for (int j = 0; j < element_dofs; ++j) {
-                int local_node_j = j / num_dofs_per_node;
-                int local_dof_j = j % num_dofs_per_node;
-                
-                uint32_t entity_id_j = static_cast<uint32_t>(conn.nodes[local_node_j]);
-                int global_col = dof_array_ptr[entity_id_j] + local_dof_j;
-                
-                // 只添加非零元素（过滤极小的数值误差）
-                double value = Ke_buffer(i, j);
-                if (std::abs(value) > 1.0e-15) {
-                    triplets.emplace_back(global_row, global_col, value);
+        // 按 (类型, 积分规则) 分发一次，块内循环调用特化的单元核
+        const bool supported = dispatch_element_traits(block, data.integration_points,
+            [&]<typename Traits>() {
+                for (size_t k = 0; k < block.num_elements(); ++k) {
+                    // --- Step 1: 计算单元刚度矩阵到缓冲区 ---
+                    if (!compute_block_element_stiffness<Traits>(block.nodes_of(k), node_coords, *data.D, Ke_buffer)) {
+                        skipped_count++;
+                        continue;
+                    }
+                    
+                    // 验证单元刚度矩阵大小
+                    if (Ke_buffer.rows() != element_dofs || Ke_buffer.cols() != element_dofs) {
+                        spdlog::warn("Element stiffness matrix size mismatch: expected {}x{}, got {}x{}",
+                                    element_dofs, element_dofs, Ke_buffer.rows(), Ke_buffer.cols());
+                        skipped_count++;
+                        continue;
+                    }
+                    
+                    // --- Step 2: 统一组装逻辑 ---
+                    // 双层循环填坑：遍历单元刚度矩阵的每个元素
+                    // 【性能优化】节点起始 DOF 直接由稠密索引查表
+                    const uint32_t* nodes = block.nodes_of(k);
+                    for (int i = 0; i < element_dofs; ++i) {
+                        int global_row = node_dof[nodes[i / num_dofs_per_node]] + i % num_dofs_per_node;
+                        
+                        for (int j = 0; j < element_dofs; ++j) {
+                            int global_col = node_dof[nodes[j / num_dofs_per_node]] + j % num_dofs_per_node;
+                            
+                            // 只添加非零元素（过滤极小的数值误差）
+                            double value = Ke_buffer(i, j);
+                            if (std::abs(value) > 1.0e-15) {
+                                triplets.emplace_back(global_row, global_col, value);
+                            }
+                        }
+                    }
                 }
-            }
+            });
+        if (!supported) {
+            spdlog::error("AssemblySystem: no stiffness kernel for element block (type {}, property {}, "
+                          "integration_network {}); {} element(s) not assembled",
+                          block.type_id, data.property_id, data.integration_points, block.num_elements());
+            skipped_count += block.num_elements();
         }
     }
     
@@ -11,6 +11,8 @@
 #include "entt/entt.hpp"
 #include <Eigen/Sparse>
 #include <Eigen/Dense>
+#include <vector>
+#include "../../data_center/ConnectivityStore.h"
 
 // -------------------------------------------------------------------
 // **组装系统 (Assembly System)**
@@ -41,12 +43,31 @@ public:
         Eigen::MatrixXd& Ke_buffer
     );
 
+    /**
+     * @brief [Dispatcher] 连接块版本：计算块内第 k 个单元的刚度矩阵
+     * @param registry EnTT registry（仅用于查找块的材料）
+     * @param block ConnectivityStore 中的连接块（块内单元共享属性和材料）
+     * @param k 块内单元序号
+     * @param node_coords 按稠密节点编号排列的坐标（xyz 交错）
+     * @param Ke_buffer 输出的单元刚度矩阵缓冲区
+     * @return true 如果成功计算，false 如果不支持的单元类型或数据缺失
+     */
+    static bool compute_element_stiffness_dispatcher(
+        const entt::registry& registry,
+        const ConnectivityBlock& block,
+        size_t k,
+        const std::vector<double>& node_coords,
+        Eigen::MatrixXd& Ke_buffer
+    );
+
     /**
      * @brief [Assembly] 组装全局刚度矩阵
      * @param registry EnTT registry
      * @param K_global 输出的全局刚度矩阵（稀疏矩阵）
      * @details 
-     *   - 遍历所有单元，调用 dispatcher 获取单元刚度矩阵
+     *   - 按 ConnectivityStore 的连接块遍历所有单元（不存在时先构建）；
+     *     每个块只查找一次 D 矩阵，并按 ElementTraits 分发一次单元核，
+     *     块内循环没有类型分支和组件查找
      *   - 将单元刚度矩阵组装到全局矩阵中
      *   - 使用 registry.ctx<DofMap>() 中的映射（需要先运行 DofNumberingSystem）
      * 
@@ -0,0 +1,80 @@
+// BoundarySystem.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "BoundarySystem.h"
+#include "../../data_center/components/load_components.h"
+#include "../dof/DofMask.h"
+#include "spdlog/spdlog.h"
+
+SpcTable& BoundarySystem::compile_spc(entt::registry& registry, const NodalState& state) {
+    SpcTable* spc_ptr = nullptr;
+    if (registry.ctx().contains<SpcTable>()) {
+        spc_ptr = &registry.ctx().get<SpcTable>();
+        spc_ptr->clear();
+    } else {
+        spc_ptr = &registry.ctx().emplace<SpcTable>();
+    }
+    auto& spc = *spc_ptr;
+
+    spc.node_mask.assign(state.num_nodes(), 0);
+
+    // 1. OR all SPC masks attached to each node
+    size_t ignored_spcs = 0;
+    auto boundary_view = registry.view<Component::AppliedBoundaryRef>();
+    for (auto node_entity : boundary_view) {
+        const int i = state.index_of(node_entity);
+        if (i < 0) {
+            continue;
+        }
+
+        const auto& boundary_ref = registry.get<Component::AppliedBoundaryRef>(node_entity);
+        for (const auto boundary_entity : boundary_ref.boundary_entities) {
+            if (!registry.valid(boundary_entity) || !registry.all_of<Component::BoundarySPC>(boundary_entity)) {
+                continue;
+            }
+
+            const uint8_t mask = DofMask::from_string(registry.get<Component::BoundarySPC>(boundary_entity).dof);
+            if (mask == 0) {
+                // Rotational DOFs have no counterpart in the translational explicit solver
+                ignored_spcs++;
+                continue;
+            }
+            spc.node_mask[static_cast<size_t>(i)] |= mask;
+        }
+    }
+
+    // 2. Flatten masks into a sorted list of constrained DOF indices
+    for (size_t i = 0; i < spc.node_mask.size(); ++i) {
+        const uint8_t mask = spc.node_mask[i];
+        if (mask == 0) {
+            continue;
+        }
+        spc.num_constrained_nodes++;
+        for (int d = 0; d < 3; ++d) {
+            if (DofMask::has(mask, d)) {
+                spc.constrained_dofs.push_back(static_cast<uint32_t>(3 * i + d));
+            }
+        }
+    }
+
+    spdlog::info("BoundarySystem: Compiled SPCs on {} nodes ({} constrained DOFs).",
+                 spc.num_constrained_nodes, spc.constrained_dofs.size());
+    if (ignored_spcs > 0) {
+        spdlog::debug("BoundarySystem: Ignored {} non-translational SPC entries.", ignored_spcs);
+    }
+
+    return spc;
+}
+
+void BoundarySystem::apply_spc(const SpcTable& spc, double* values) {
+    const uint32_t* dofs = spc.constrained_dofs.data();
+    const size_t n = spc.constrained_dofs.size();
+    for (size_t k = 0; k < n; ++k) {
+        values[dofs[k]] = 0.0;
+    }
+}
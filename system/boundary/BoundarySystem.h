@@ -0,0 +1,38 @@
+// BoundarySystem.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include "entt/entt.hpp"
+#include "../../data_center/NodalState.h"
+#include "../../data_center/SpcTable.h"
+
+/**
+ * @class BoundarySystem
+ * @brief System for compiling and applying single point constraints (SPC)
+ * @details BoundarySPC definitions referenced by AppliedBoundaryRef are compiled
+ *          once into an SpcTable (per-node DOF mask + flat constrained DOF list).
+ *          The time loop then only walks the flat list.
+ */
+class BoundarySystem {
+public:
+    /**
+     * @brief Compile SPC definitions into the SpcTable stored in registry.ctx()
+     * @param registry EnTT registry
+     * @param state Nodal state providing the dense node numbering
+     * @return Reference to the compiled SpcTable
+     */
+    static SpcTable& compile_spc(entt::registry& registry, const NodalState& state);
+
+    /**
+     * @brief Zero the constrained entries of a nodal vector (e.g. acceleration)
+     * @param spc Compiled SPC table
+     * @param values Nodal vector with 3 * num_nodes entries (xyz interleaved)
+     */
+    static void apply_spc(const SpcTable& spc, double* values);
+};
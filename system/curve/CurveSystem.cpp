@@ -19,8 +19,10 @@ double CurveSystem::evaluate_curve(entt::registry& registry, entt::entity curve_
         return 1.0;
     }
 
-    const auto& curve = registry.get<Component::Curve>(curve_entity);
+    return evaluate_curve(registry.get<Component::Curve>(curve_entity), t);
+}
 
+double CurveSystem::evaluate_curve(const Component::Curve& curve, double t) {
     // Check if curve data is valid
     if (curve.x.empty() || curve.y.empty() || curve.x.size() != curve.y.size()) {
         spdlog::warn("Invalid curve data. Returning 1.0.");
@@ -43,25 +45,20 @@ double CurveSystem::evaluate_curve(entt::registry& registry, entt::entity curve_
             return y.back();
         }
 
-        // Find the interval containing t
-        for (size_t i = 0; i < x.size() - 1; ++i) {
-            if (t >= x[i] && t <= x[i + 1]) {
-                // Linear interpolation: y = y0 + (y1 - y0) * (t - x0) / (x1 - x0)
-                double x0 = x[i];
-                double x1 = x[i + 1];
-                double y0 = y[i];
-                double y1 = y[i + 1];
-                
-                if (std::abs(x1 - x0) < 1e-12) {
-                    return y0;  // Avoid division by zero
-                }
-                
-                return y0 + (y1 - y0) * (t - x0) / (x1 - x0);
-            }
+        // Find the interval [x[i], x[i+1]] containing t (first point with x >= t)
+        const size_t i = static_cast<size_t>(std::lower_bound(x.begin(), x.end(), t) - x.begin()) - 1;
+
+        // Linear interpolation: y = y0 + (y1 - y0) * (t - x0) / (x1 - x0)
+        double x0 = x[i];
+        double x1 = x[i + 1];
+        double y0 = y[i];
+        double y1 = y[i + 1];
+
+        if (std::abs(x1 - x0) < 1e-12) {
+            return y0;  // Avoid division by zero
         }
 
-        // Should not reach here, but return last value as fallback
-        return y.back();
+        return y0 + (y1 - y0) * (t - x0) / (x1 - x0);
     } else {
         spdlog::warn("Unknown curve type: '{}'. Returning 1.0.", curve.type);
         return 1.0;
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "entt/entt.hpp"
+#include "../../data_center/components/load_components.h"
 
 /**
  * @class CurveSystem
@@ -26,4 +27,14 @@ public:
      * @details Returns 1.0 if curve is invalid or time is out of range
      */
     static double evaluate_curve(entt::registry& registry, entt::entity curve_entity, double t);
+
+    /**
+     * @brief Evaluate a curve definition at given time
+     * @param curve Curve definition
+     * @param t Time point
+     * @return Curve value at time t (scaling factor)
+     * @details Interval lookup is a binary search over curve.x, so the cost is
+     *          O(log n) in the number of curve points.
+     */
+    static double evaluate_curve(const Component::Curve& curve, double t);
 };
@@ -0,0 +1,54 @@
+// DofMask.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief 平动自由度位掩码 (Translational DOF Bit Mask)
+ * @details
+ *   - bit 0 = x, bit 1 = y, bit 2 = z
+ *   - 由载荷/约束中的 dof 字符串（"all", "x", "xy", ...）在求解前编译一次得到
+ *   - 转动自由度（"rx", "ry", "rz"）在当前显式求解器中没有对应 DOF，编译为 0
+ */
+namespace DofMask {
+    constexpr uint8_t X = 0x1;
+    constexpr uint8_t Y = 0x2;
+    constexpr uint8_t Z = 0x4;
+    constexpr uint8_t XYZ = X | Y | Z;
+
+    /**
+     * @brief 将 dof 字符串解析为平动自由度掩码（大小写不敏感）
+     * @param dof 自由度字符串："all", "xyz", "x", "y", "z", "xy", "yx", "xz", "zx", "yz", "zy"
+     * @return 掩码；无法识别或仅含转动自由度时返回 0
+     */
+    inline uint8_t from_string(const std::string& dof) {
+        std::string key = dof;
+        std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+
+        if (key == "all" || key == "xyz") return XYZ;
+        if (key == "x") return X;
+        if (key == "y") return Y;
+        if (key == "z") return Z;
+        if (key == "xy" || key == "yx") return X | Y;
+        if (key == "xz" || key == "zx") return X | Z;
+        if (key == "yz" || key == "zy") return Y | Z;
+        return 0;
+    }
+
+    /**
+     * @brief 掩码中是否包含方向 d (0=x, 1=y, 2=z)
+     */
+    inline bool has(uint8_t mask, int d) {
+        return (mask >> d) & 0x1;
+    }
+}
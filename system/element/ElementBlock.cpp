@@ -0,0 +1,53 @@
+// ElementBlock.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "ElementBlock.h"
+#include "../../data_center/components/material_components.h"
+
+ElementBlockData resolve_element_block(const entt::registry& registry, const ConnectivityBlock& block) {
+    ElementBlockData data;
+
+    if (registry.valid(block.property_entity)) {
+        data.solid = registry.try_get<Component::SolidProperty>(block.property_entity);
+        if (data.solid != nullptr) {
+            data.integration_points = data.solid->integration_network;
+        }
+        if (const auto* property_id = registry.try_get<Component::PropertyID>(block.property_entity)) {
+            data.property_id = property_id->value;
+        }
+    }
+
+    if (registry.valid(block.material_entity)) {
+        const auto* material_matrix = registry.try_get<Component::LinearElasticMatrix>(block.material_entity);
+        if (material_matrix != nullptr && material_matrix->is_initialized) {
+            data.D = &material_matrix->D;
+        }
+        if (const auto* elastic = registry.try_get<Component::LinearElasticParams>(block.material_entity)) {
+            data.rho = elastic->rho;
+            data.has_density = true;
+        }
+    }
+
+    return data;
+}
+
+const Eigen::Matrix<double, 6, 6>* find_material_matrix(const entt::registry& registry, entt::entity element_entity) {
+    const auto* property_ref = registry.try_get<Component::PropertyRef>(element_entity);
+    if (property_ref == nullptr || !registry.valid(property_ref->property_entity)) {
+        return nullptr;
+    }
+    const auto* material_ref = registry.try_get<Component::MaterialRef>(property_ref->property_entity);
+    if (material_ref == nullptr || !registry.valid(material_ref->material_entity)) {
+        return nullptr;
+    }
+    const auto* material_matrix = registry.try_get<Component::LinearElasticMatrix>(material_ref->material_entity);
+    if (material_matrix == nullptr || !material_matrix->is_initialized) {
+        return nullptr;
+    }
+    return &material_matrix->D;
+}
@@ -0,0 +1,51 @@
+// ElementBlock.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include "entt/entt.hpp"
+#include <Eigen/Dense>
+#include "../../data_center/ConnectivityStore.h"
+#include "../../data_center/components/property_components.h"
+
+/**
+ * @brief Property and material data shared by all elements of a connectivity block
+ * @details ConnectivityStore blocks are homogeneous in (type, property, material),
+ *          so the PropertyRef -> MaterialRef chain is walked once per block instead
+ *          of once per element. Pointers refer to components in the registry and
+ *          stay valid while those components are not removed.
+ */
+struct ElementBlockData {
+    const Component::SolidProperty* solid = nullptr;         ///< nullptr if the property is not a SolidProperty
+    const Eigen::Matrix<double, 6, 6>* D = nullptr;          ///< nullptr if LinearElasticMatrix is missing or not initialized
+    double rho = 0.0;                                        ///< Density (LinearElasticParams::rho)
+    bool has_density = false;                                ///< Whether the material has LinearElasticParams
+    int integration_points = 1;                              ///< SolidProperty::integration_network (1 without SolidProperty)
+    int property_id = -1;                                    ///< PropertyID of the block (-1 if unavailable), for messages
+};
+
+/**
+ * @brief Resolve the property and material data of a block
+ * @param registry EnTT registry
+ * @param block Connectivity block (property_entity / material_entity set by ConnectivitySystem)
+ * @return Resolved data; missing components leave the defaults
+ * @details Reads the current components on every call (cheap: a few lookups per
+ *          block), so changes to SolidProperty or the material between steps are
+ *          picked up without rebuilding the store.
+ */
+ElementBlockData resolve_element_block(const entt::registry& registry, const ConnectivityBlock& block);
+
+/**
+ * @brief Resolve the material D matrix of a single element
+ * @param registry EnTT registry
+ * @param element_entity Element entity (PropertyRef -> MaterialRef -> LinearElasticMatrix)
+ * @return Pointer to D, or nullptr if a link is missing or the matrix is not initialized
+ * @details Per-element counterpart of resolve_element_block for the component-based
+ *          paths; callers decide whether a missing matrix is an error worth logging.
+ */
+const Eigen::Matrix<double, 6, 6>* find_material_matrix(const entt::registry& registry, entt::entity element_entity);
@@ -0,0 +1,80 @@
+// ElementTraits.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include "../../data_center/ConnectivityStore.h"
+#include "../../data_center/ElementRegistry.h"
+#include <cassert>
+#include <utility>
+
+/**
+ * @brief Compile-time description of an element type and integration rule
+ * @tparam TypeId Element type ID of ElementRegistry (e.g. 308 = Hexa8)
+ * @tparam NGP Gauss points per direction (SolidProperty::integration_network)
+ * @details Node count, dimension and face count come from the constexpr
+ *          kElementTypeTable, so kernels templated on the traits see them as
+ *          literal constants and ElementRegistry cannot drift from them.
+ */
+template <int TypeId, int NGP>
+struct ElementTraits {
+    static_assert(find_element_type_info(TypeId) != nullptr, "Unknown element type ID");
+
+    static constexpr int type_id = TypeId;
+    static constexpr int num_nodes = find_element_type_info(TypeId)->num_nodes;
+    static constexpr int dimension = find_element_type_info(TypeId)->dimension;
+    static constexpr int num_faces = find_element_type_info(TypeId)->num_faces;
+    static constexpr int integration_points = NGP;
+    static constexpr bool reduced_integration = (NGP == 1);
+};
+
+namespace element_traits_detail {
+    // Block node count must match the kernel's compile-time node count; ConnectivitySystem
+    // guarantees this, so a mismatch is a programming error (asserted) and is refused in release
+    template <typename Traits, typename F>
+    bool invoke(int nodes_per_element, F&& f) {
+        assert(nodes_per_element == Traits::num_nodes && "block nodes_per_element does not match element traits");
+        if (nodes_per_element != Traits::num_nodes) {
+            return false;
+        }
+        std::forward<F>(f).template operator()<Traits>();
+        return true;
+    }
+}
+
+/**
+ * @brief Invoke f.template operator()<ElementTraits<...>>() for a block's (type, rule) pair
+ * @param block Connectivity block (type_id and nodes_per_element are used)
+ * @param integration_points Gauss points per direction of the block's SolidProperty
+ * @param f Callable with a template call operator, e.g. []<typename Traits>() { ... }
+ * @return false if no kernel is instantiated for the pair or the block's node count
+ *         differs from Traits::num_nodes (f is not called)
+ * @details Called once per element block; the element loop inside f is then
+ *          fully specialized on the traits. New element kernels are enabled by
+ *          adding their (type, rule) cases here.
+ */
+template <typename F>
+bool dispatch_element_traits(const ConnectivityBlock& block, int integration_points, F&& f) {
+    using element_traits_detail::invoke;
+    switch (block.type_id) {
+        case 308:  // Hexa8: C3D8R (1) and fully integrated C3D8 (2, 3)
+            switch (integration_points) {
+                case 1:
+                    return invoke<ElementTraits<308, 1>>(block.nodes_per_element, std::forward<F>(f));
+                case 2:
+                    return invoke<ElementTraits<308, 2>>(block.nodes_per_element, std::forward<F>(f));
+                case 3:
+                    return invoke<ElementTraits<308, 3>>(block.nodes_per_element, std::forward<F>(f));
+                default:
+                    return false;
+            }
+
+        default:
+            return false;
+    }
+}
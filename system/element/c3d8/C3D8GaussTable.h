@@ -0,0 +1,102 @@
+// C3D8GaussTable.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <array>
+
+/**
+ * @brief Compile-time Gauss rules and shape function derivative tables of the 8-node hexahedron
+ * @details C3D8GaussRule<NGP> holds the NGP x NGP x NGP tensor-product rule on [-1, 1]^3
+ *          together with the natural derivatives dN_A/dxi of the trilinear shape
+ *          functions at every point. All tables are constexpr, so a kernel templated
+ *          on NGP sees them as literal constants and its point loop unrolls completely.
+ *
+ *          Node order follows C3D8R (XiI of the stiffness matrix):
+ *            0 (-1,-1,-1)  1 (1,-1,-1)  2 (1,1,-1)  3 (-1,1,-1)
+ *            4 (-1,-1, 1)  5 (1,-1, 1)  6 (1,1, 1)  7 (-1,1, 1)
+ *          Points are ordered with zeta fastest, like GaussIntegration::get_3d_hex_gauss_points.
+ */
+namespace c3d8_gauss {
+    /// Natural coordinates of the 8 nodes
+    inline constexpr double kNodeXi[8][3] = {
+        {-1.0, -1.0, -1.0}, { 1.0, -1.0, -1.0}, { 1.0,  1.0, -1.0}, {-1.0,  1.0, -1.0},
+        {-1.0, -1.0,  1.0}, { 1.0, -1.0,  1.0}, { 1.0,  1.0,  1.0}, {-1.0,  1.0,  1.0}
+    };
+
+    /// 1D Gauss-Legendre abscissae and weights (std::sqrt is not constexpr, so the roots are literals)
+    template <int NGP>
+    struct Gauss1D;
+
+    template <>
+    struct Gauss1D<1> {
+        static constexpr std::array<double, 1> points = {0.0};
+        static constexpr std::array<double, 1> weights = {2.0};
+    };
+
+    template <>
+    struct Gauss1D<2> {
+        static constexpr double a = 0.57735026918962576451;  // 1/sqrt(3)
+        static constexpr std::array<double, 2> points = {-a, a};
+        static constexpr std::array<double, 2> weights = {1.0, 1.0};
+    };
+
+    template <>
+    struct Gauss1D<3> {
+        static constexpr double a = 0.77459666924148337704;  // sqrt(3/5)
+        static constexpr std::array<double, 3> points = {-a, 0.0, a};
+        static constexpr std::array<double, 3> weights = {5.0 / 9.0, 8.0 / 9.0, 5.0 / 9.0};
+    };
+
+    /**
+     * @brief Tensor-product hexahedron rule with shape function derivative tables
+     * @tparam NGP Points per direction (1, 2 or 3)
+     */
+    template <int NGP>
+    struct C3D8GaussRule {
+        static constexpr int num_points = NGP * NGP * NGP;
+
+        struct Table {
+            double xi[num_points][3];        ///< Natural coordinates of the points
+            double weight[num_points];       ///< Weights (sum 8)
+            double dN[num_points][3][8];     ///< dN_A/dxi_d at point q: dN[q][d][A]
+        };
+
+        static constexpr Table build() {
+            Table t{};
+            int q = 0;
+            for (int i = 0; i < NGP; ++i) {
+                for (int j = 0; j < NGP; ++j) {
+                    for (int k = 0; k < NGP; ++k) {
+                        const double p[3] = {Gauss1D<NGP>::points[i], Gauss1D<NGP>::points[j],
+                                             Gauss1D<NGP>::points[k]};
+                        t.xi[q][0] = p[0];
+                        t.xi[q][1] = p[1];
+                        t.xi[q][2] = p[2];
+                        t.weight[q] = Gauss1D<NGP>::weights[i] * Gauss1D<NGP>::weights[j] *
+                                      Gauss1D<NGP>::weights[k];
+                        // N_A = (1 + xi_A xi)(1 + eta_A eta)(1 + zeta_A zeta) / 8
+                        for (int A = 0; A < 8; ++A) {
+                            const double* a = kNodeXi[A];
+                            const double f0 = 1.0 + a[0] * p[0];
+                            const double f1 = 1.0 + a[1] * p[1];
+                            const double f2 = 1.0 + a[2] * p[2];
+                            t.dN[q][0][A] = 0.125 * a[0] * f1 * f2;
+                            t.dN[q][1][A] = 0.125 * f0 * a[1] * f2;
+                            t.dN[q][2][A] = 0.125 * f0 * f1 * a[2];
+                        }
+                        q++;
+                    }
+                }
+            }
+            return t;
+        }
+
+        static constexpr Table table = build();
+    };
+}
@@ -0,0 +1,170 @@
+// C3D8RGradient.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <type_traits>
+
+/**
+ * @brief Matrix-free C3D8R B-bar operators working directly on the 8x3 gradient table
+ * @details The one-point B-bar operator of C3D8R is fully described by the nodal
+ *          gradients BiI (8 nodes x 3 directions). The dense 6x24 B matrix is
+ *          75% zeros, so strain, nodal forces and stiffness blocks are evaluated
+ *          from the gradients alone:
+ *            strain = sum_I B_I u_I            (Voigt xx, yy, zz, xy, yz, xz)
+ *            f_I    = B_I^T sigma
+ *            K_IJ   = B_I^T D B_J              (3x3 block)
+ *          with B_I the 6x3 nodal block built from (bx, by, bz) of node I.
+ *
+ *          All helpers are templated on the scalar type T so the same code is
+ *          used by the scalar element routines (T = double) and the lane-parallel
+ *          batch kernels (T = SimdPack<W>).
+ */
+namespace c3d8r_gradient {
+    template <typename T>
+    inline T splat(double s) {
+        if constexpr (std::is_same_v<T, double>) {
+            return s;
+        } else {
+            return T::broadcast(s);
+        }
+    }
+
+    /**
+     * @brief One direction of the B-bar gradients (FORTRAN CALC_B_BAR)
+     * @param y Coordinates of the 8 nodes in the first cyclic direction
+     * @param z Coordinates of the 8 nodes in the second cyclic direction
+     * @param BiI Output: unnormalized gradients of the 8 nodes
+     * @details calc(y, z) gives the x gradients, calc(z, x) the y gradients and
+     *          calc(x, y) the z gradients.
+     */
+    template <typename T>
+    inline void calc_b_bar_component(const T* y, const T* z, T* BiI) {
+        const T twelve = splat<T>(12.0);
+
+        BiI[0] = -(y[1]*(z[2]+z[3]-z[4]-z[5])+y[2]*(-z[1]+z[3])
+                 +y[3]*(-z[1]-z[2]+z[4]+z[7])+y[4]*(z[1]-z[3]+z[5]-z[7])
+                 +y[5]*(z[1]-z[4])+y[7]*(-z[3]+z[4]))/twelve;
+
+        BiI[1] = (y[0]*(z[2]+z[3]-z[4]-z[5])+y[2]*(-z[0]-z[3]+z[5]+z[6])
+                 +y[3]*(-z[0]+z[2])+y[4]*(z[0]-z[5])
+                 +y[5]*(z[0]-z[2]+z[4]-z[6])+y[6]*(-z[2]+z[5]))/twelve;
+
+        BiI[2] = -(y[0]*(z[1]-z[3])+y[1]*(-z[0]-z[3]+z[5]+z[6])
+                 +y[3]*(z[0]+z[1]-z[6]-z[7])+y[5]*(-z[1]+z[6])
+                 +y[6]*(-z[1]+z[3]-z[5]+z[7])+y[7]*(z[3]-z[6]))/twelve;
+
+        BiI[3] = -(y[0]*(z[1]+z[2]-z[4]-z[7])+y[1]*(-z[0]+z[2])
+                 +y[2]*(-z[0]-z[1]+z[6]+z[7])+y[4]*(z[0]-z[7])
+                 +y[6]*(-z[2]+z[7])+y[7]*(z[0]-z[2]+z[4]-z[6]))/twelve;
+
+        BiI[4] = (y[0]*(z[1]-z[3]+z[5]-z[7])+y[1]*(-z[0]+z[5])
+                 +y[3]*(z[0]-z[7])+y[5]*(-z[0]-z[1]+z[6]+z[7])
+                 +y[6]*(-z[5]+z[7])+y[7]*(z[0]+z[3]-z[5]-z[6]))/twelve;
+
+        BiI[5] = (y[0]*(z[1]-z[4])+y[1]*(-z[0]+z[2]-z[4]+z[6])
+                 +y[2]*(-z[1]+z[6])+y[4]*(z[0]+z[1]-z[6]-z[7])
+                 +y[6]*(-z[1]-z[2]+z[4]+z[7])+y[7]*(z[4]-z[6]))/twelve;
+
+        BiI[6] = (y[1]*(z[2]-z[5])+y[2]*(-z[1]+z[3]-z[5]+z[7])
+                 +y[3]*(-z[2]+z[7])+y[4]*(z[5]-z[7])
+                 +y[5]*(z[1]+z[2]-z[4]-z[7])+y[7]*(-z[2]-z[3]+z[4]+z[5]))/twelve;
+
+        BiI[7] = -(y[0]*(z[3]-z[4])+y[2]*(-z[3]+z[6])
+                 +y[3]*(-z[0]+z[2]-z[4]+z[6])+y[4]*(z[0]+z[3]-z[5]-z[6])
+                 +y[5]*(z[4]-z[6])+y[6]*(-z[2]-z[3]+z[4]+z[5]))/twelve;
+    }
+
+    /**
+     * @brief Unnormalized B-bar gradients of all three directions and the element volume
+     * @param x, y, z Nodal coordinates (8 each)
+     * @param bx, by, bz Output: unnormalized gradients (8 each)
+     * @return B-bar element volume (sum_I x_I * bx_I)
+     */
+    template <typename T>
+    inline T calc_b_bar(const T* x, const T* y, const T* z, T* bx, T* by, T* bz) {
+        calc_b_bar_component(y, z, bx);
+        calc_b_bar_component(z, x, by);
+        calc_b_bar_component(x, y, bz);
+
+        T vol = x[0] * bx[0];
+        for (int i = 1; i < 8; ++i) {
+            vol = vol + x[i] * bx[i];
+        }
+        return vol;
+    }
+
+    /**
+     * @brief Strain-like sum over nodes: e = sum_I B_I u_I (engineering shear)
+     * @details With unnormalized gradients the result is strain * volume; callers
+     *          scale by 1/VOL. Voigt order xx, yy, zz, xy, yz, xz.
+     */
+    template <typename T>
+    inline void gradient_strain(const T* bx, const T* by, const T* bz,
+                                const T* ux, const T* uy, const T* uz, T* strain) {
+        T exx = bx[0] * ux[0];
+        T eyy = by[0] * uy[0];
+        T ezz = bz[0] * uz[0];
+        T gxy = by[0] * ux[0] + bx[0] * uy[0];
+        T gyz = bz[0] * uy[0] + by[0] * uz[0];
+        T gxz = bz[0] * ux[0] + bx[0] * uz[0];
+        for (int i = 1; i < 8; ++i) {
+            exx = exx + bx[i] * ux[i];
+            eyy = eyy + by[i] * uy[i];
+            ezz = ezz + bz[i] * uz[i];
+            gxy = gxy + by[i] * ux[i] + bx[i] * uy[i];
+            gyz = gyz + bz[i] * uy[i] + by[i] * uz[i];
+            gxz = gxz + bz[i] * ux[i] + bx[i] * uz[i];
+        }
+        strain[0] = exx;
+        strain[1] = eyy;
+        strain[2] = ezz;
+        strain[3] = gxy;
+        strain[4] = gyz;
+        strain[5] = gxz;
+    }
+
+    /**
+     * @brief Nodal forces f_I = B_I^T sigma (Voigt stress)
+     * @details With unnormalized gradients this is the B^T sigma VOL internal force.
+     */
+    template <typename T>
+    inline void gradient_forces(const T* bx, const T* by, const T* bz,
+                                const T* stress, T* fx, T* fy, T* fz) {
+        for (int i = 0; i < 8; ++i) {
+            fx[i] = bx[i] * stress[0] + by[i] * stress[3] + bz[i] * stress[5];
+            fy[i] = by[i] * stress[1] + bx[i] * stress[3] + bz[i] * stress[4];
+            fz[i] = bz[i] * stress[2] + by[i] * stress[4] + bx[i] * stress[5];
+        }
+    }
+
+    /**
+     * @brief 3x3 stiffness block K_IJ = B_I^T D B_J
+     * @param gi Gradients (x, y, z) of node I
+     * @param gj Gradients (x, y, z) of node J
+     * @param D Material matrix accessor, D(r, c) for r, c in [0, 6)
+     * @param K Output block, K[a][b] couples dof a of node I with dof b of node J
+     * @details D B_J has only 18 nonzero products instead of the 6x6x3 of a dense
+     *          multiply; the left multiply by B_I^T likewise touches 3 rows per column.
+     */
+    template <typename T, typename DMatrix>
+    inline void gradient_stiffness_block(const T* gi, const T* gj, const DMatrix& D, T K[3][3]) {
+        // D B_J (6x3), column b = response to unit displacement of dof b of node J
+        T DB[6][3];
+        for (int r = 0; r < 6; ++r) {
+            DB[r][0] = D(r, 0) * gj[0] + D(r, 3) * gj[1] + D(r, 5) * gj[2];
+            DB[r][1] = D(r, 1) * gj[1] + D(r, 3) * gj[0] + D(r, 4) * gj[2];
+            DB[r][2] = D(r, 2) * gj[2] + D(r, 4) * gj[1] + D(r, 5) * gj[0];
+        }
+        for (int b = 0; b < 3; ++b) {
+            K[0][b] = gi[0] * DB[0][b] + gi[1] * DB[3][b] + gi[2] * DB[5][b];
+            K[1][b] = gi[1] * DB[1][b] + gi[0] * DB[3][b] + gi[2] * DB[4][b];
+            K[2][b] = gi[2] * DB[2][b] + gi[1] * DB[4][b] + gi[0] * DB[5][b];
+        }
+    }
+}
@@ -7,6 +7,7 @@
  * Author: Xiaotong Wang (or hyperFEM Team)
  */
 #include "C3D8RStiffnessMatrix.h"
+#include "C3D8RGradient.h"
 #include "../../../data_center/components/mesh_components.h"
 #include "../../../data_center/components/property_components.h"
 #include "../../../data_center/components/material_components.h"
@@ -43,51 +44,6 @@ namespace {
     static constexpr double WG = 8.0;
 }
 
-// -------------------------------------------------------------------
-// **辅助函数：计算 B-bar 向量的一个分量**
-// 参考 FORTRAN 代码中的 CALC_B_BAR 子程序
-// 注意：FORTRAN 索引从 1 开始，C++ 从 0 开始
-// -------------------------------------------------------------------
-static void calc_b_bar_component(
-    const double* y,  // 8个节点的 y 坐标（索引 0-7）
-    const double* z,  // 8个节点的 z 坐标（索引 0-7）
-    double* BiI       // 输出：8个节点的 B-bar 值（索引 0-7）
-) {
-    // FORTRAN 代码中的 CALC_B_BAR 逻辑（已转换为 C++ 索引）
-    // FORTRAN BiI(1) 对应 C++ BiI[0]，FORTRAN y(1) 对应 C++ y[0]
-    BiI[0] = -(y[1]*(z[2]+z[3]-z[4]-z[5])+y[2]*(-z[1]+z[3])
-             +y[3]*(-z[1]-z[2]+z[4]+z[7])+y[4]*(z[1]-z[3]+z[5]-z[7])
-             +y[5]*(z[1]-z[4])+y[7]*(-z[3]+z[4]))/12.0;
-    
-    BiI[1] = (y[0]*(z[2]+z[3]-z[4]-z[5])+y[2]*(-z[0]-z[3]+z[5]+z[6])
-             +y[3]*(-z[0]+z[2])+y[4]*(z[0]-z[5])
-             +y[5]*(z[0]-z[2]+z[4]-z[6])+y[6]*(-z[2]+z[5]))/12.0;
-    
-    BiI[2] = -(y[0]*(z[1]-z[3])+y[1]*(-z[0]-z[3]+z[5]+z[6])
-             +y[3]*(z[0]+z[1]-z[6]-z[7])+y[5]*(-z[1]+z[6])
-             +y[6]*(-z[1]+z[3]-z[5]+z[7])+y[7]*(z[3]-z[6]))/12.0;
-    
-    BiI[3] = -(y[0]*(z[1]+z[2]-z[4]-z[7])+y[1]*(-z[0]+z[2])
-             +y[2]*(-z[0]-z[1]+z[6]+z[7])+y[4]*(z[0]-z[7])
-             +y[6]*(-z[2]+z[7])+y[7]*(z[0]-z[2]+z[4]-z[6]))/12.0;
-    
-    BiI[4] = (y[0]*(z[1]-z[3]+z[5]-z[7])+y[1]*(-z[0]+z[5])
-             +y[3]*(z[0]-z[7])+y[5]*(-z[0]-z[1]+z[6]+z[7])
-             +y[6]*(-z[5]+z[7])+y[7]*(z[0]+z[3]-z[5]-z[6]))/12.0;
-    
-    BiI[5] = (y[0]*(z[1]-z[4])+y[1]*(-z[0]+z[2]-z[4]+z[6])
-             +y[2]*(-z[1]+z[6])+y[4]*(z[0]+z[1]-z[6]-z[7])
-             +y[6]*(-z[1]-z[2]+z[4]+z[7])+y[7]*(z[4]-z[6]))/12.0;
-    
-    BiI[6] = (y[1]*(z[2]-z[5])+y[2]*(-z[1]+z[3]-z[5]+z[7])
-             +y[3]*(-z[2]+z[7])+y[4]*(z[5]-z[7])
-             +y[5]*(z[1]+z[2]-z[4]-z[7])+y[7]*(-z[2]-z[3]+z[4]+z[5]))/12.0;
-    
-    BiI[7] = -(y[0]*(z[3]-z[4])+y[2]*(-z[3]+z[6])
-             +y[3]*(-z[0]+z[2]-z[4]+z[6])+y[4]*(z[0]+z[3]-z[5]-z[6])
-             +y[5]*(z[4]-z[6])+y[6]*(-z[2]-z[3]+z[4]+z[5]))/12.0;
-}
-
 // -------------------------------------------------------------------
 // **辅助函数：计算单元中心处的雅可比矩阵**
 // 参考 FORTRAN 代码中的 JACOBIAN_CENTER 子程序
@@ -95,16 +51,18 @@ static void calc_b_bar_component(
 // -------------------------------------------------------------------
 static Eigen::Matrix3d jacobian_center(const Eigen::Matrix<double, 8, 3>& coords) {
     // FORTRAN 代码中的 XiI 矩阵（单元中心处的等参坐标导数）
-    // FORTRAN reshape 按列填充（列主序），对应单元中心 (0, 0, 0)
-    // XiI(8,3) = reshape([第一列8个值, 第二列8个值, 第三列8个值], [8,3])
+    // FORTRAN reshape 按列填充（列主序），而 Eigen 的逗号初始化按行填充，
+    // 因此这里逐行（逐节点）写出：第 K 行 = 节点 K 的 (xi, eta, zeta) 导数
     static const double one_over_eight = 1.0 / 8.0;
     static const Eigen::Matrix<double, 8, 3> XiI = (Eigen::Matrix<double, 8, 3>() <<
-        // 第一列 (xi 导数)
-        -1.0,  1.0,  1.0, -1.0, -1.0,  1.0,  1.0, -1.0,
-        // 第二列 (eta 导数)
-        -1.0, -1.0,  1.0,  1.0, -1.0, -1.0,  1.0,  1.0,
-        // 第三列 (zeta 导数)
-        -1.0, -1.0, -1.0, -1.0,  1.0,  1.0,  1.0,  1.0
+        -1.0, -1.0, -1.0,
+         1.0, -1.0, -1.0,
+         1.0,  1.0, -1.0,
+        -1.0,  1.0, -1.0,
+        -1.0, -1.0,  1.0,
+         1.0, -1.0,  1.0,
+         1.0,  1.0,  1.0,
+        -1.0,  1.0,  1.0
     ).finished();
     
     // FORTRAN: JAC = matmul(transpose(XiI), COORD) * one_over_eight
@@ -126,66 +84,6 @@ static double jacobian_determinant(const Eigen::Matrix3d& JAC) {
            JAC(0,2)*(JAC(1,0)*JAC(2,1)-JAC(1,1)*JAC(2,0));
 }
 
-// -------------------------------------------------------------------
-// **辅助函数：计算单元体积（B-bar 方法）**
-// 参考 FORTRAN 代码中的 CALC_VOL_BBAR
-// -------------------------------------------------------------------
-static double calc_vol_bbar(const double* BiI, const double* X) {
-    double V = 0.0;
-    for (int i = 0; i < 8; ++i) {
-        V += X[i] * BiI[i];
-    }
-    return V;
-}
-
-// -------------------------------------------------------------------
-// **辅助函数：构建 B 矩阵（6x24）**
-// 参考 FORTRAN 代码中的 FORM_B_MATRIX
-// 
-// [UPDATED] 现在的顺序与 Abaqus/Fortran 保持一致:
-// Index: 0->XX, 1->YY, 2->ZZ, 3->XY, 4->YZ, 5->XZ
-// -------------------------------------------------------------------
-static Eigen::Matrix<double, 6, 24> form_b_matrix(
-    const Eigen::Matrix<double, 8, 3>& BiI  // 8x3 的 B-bar 矩阵
-) {
-    Eigen::Matrix<double, 6, 24> B = Eigen::Matrix<double, 6, 24>::Zero();
-    
-    for (int K = 0; K < 8; ++K) {
-        // FORTRAN: B(1,3*K-2)=BiI(K,1) → C++: B(0, 3*K+0) = BiI(K, 0) [XX]
-        B(0, 3*K + 0) = BiI(K, 0);
-        
-        // FORTRAN: B(2,3*K-1)=BiI(K,2) → C++: B(1, 3*K+1) = BiI(K, 1) [YY]
-        B(1, 3*K + 1) = BiI(K, 1);
-        
-        // FORTRAN: B(3,3*K)=BiI(K,3) → C++: B(2, 3*K+2) = BiI(K, 2) [ZZ]
-        B(2, 3*K + 2) = BiI(K, 2);
-        
-        // -------------------------------------------------------------
-        // UPDATE: 适配 Abaqus 顺序 (XY, YZ, XZ)
-        // -------------------------------------------------------------
-
-        // Row 3 -> XY (对应 Fortran B(4))
-        // xy = ∂v/∂x + ∂u/∂y
-        // FORTRAN B(4,3*K-2)=BiI(K,2), B(4,3*K-1)=BiI(K,1)
-        B(3, 3*K + 0) = BiI(K, 1);  // u 对 y 的导数 (BiI(:,1))
-        B(3, 3*K + 1) = BiI(K, 0);  // v 对 x 的导数 (BiI(:,0))
-
-        // Row 4 -> YZ (对应 Fortran B(5))
-        // yz = ∂w/∂y + ∂v/∂z
-        // FORTRAN B(5,3*K-1)=BiI(K,3), B(5,3*K)=BiI(K,2)
-        B(4, 3*K + 1) = BiI(K, 2);  // v 对 z 的导数 (BiI(:,2))
-        B(4, 3*K + 2) = BiI(K, 1);  // w 对 y 的导数 (BiI(:,1))
-
-        // Row 5 -> XZ (对应 Fortran B(6))
-        // xz = ∂w/∂x + ∂u/∂z
-        // FORTRAN B(6,3*K-2)=BiI(K,3), B(6,3*K)=BiI(K,1)
-        B(5, 3*K + 0) = BiI(K, 2);  // u 对 z 的导数 (BiI(:,2))
-        B(5, 3*K + 2) = BiI(K, 0);  // w 对 x 的导数 (BiI(:,0))
-    }
-    
-    return B;
-}
-
 // ===================================================================
 // **第一阶段：极分解与旋转工具 (Polar Decomposition & Rotation)**
 // ===================================================================
@@ -516,26 +414,28 @@ static void calc_k_matrices(
 // ===================================================================
 
 /**
- * @brief 计算沙漏刚度矩阵（24x24）- 优化版本
- * 这是主要的沙漏控制函数，对应 VUEL 中的 Step 2 全部逻辑
+ * @brief 计算凝聚后的沙漏模态刚度核 K_mode[i][j]（3x3，4x4 个模态对）
+ * 对应 VUEL 中 Step 2 的 Gamma / C_tilde / K 矩阵 / 静力凝聚部分
+ * 
+ * 沙漏刚度矩阵与模态刚度核的关系：
+ *   Ke_hg(3A+a, 3B+b) = Σ_ij gammas(A,i) * gammas(B,j) * K_mode[i][j](a,b)
+ * 显式内力路径直接使用模态形式，无需组装 24x24 矩阵
  * 
  * 优化点：
- * - 使用 Block 操作代替逐元素循环（利用 SIMD）
  * - 预计算 FJAC 转置，避免循环内重复计算
  * - 预计算 K_au^T * K_aa_inv，减少矩阵乘法次数
  * - 使用 noalias() 避免临时矩阵分配
- * - 稀疏优化：跳过极小的 gamma 值
  */
-static void compute_hourglass_stiffness(
+static void compute_hourglass_modes(
     const Eigen::Matrix<double, 8, 3>& coords,
     const Eigen::Matrix<double, 8, 3>& BiI,
     const Eigen::Matrix3d& FJAC,
     const Eigen::Matrix<double, 6, 6>& D_mat,
     double vol,
-    Eigen::Matrix<double, 24, 24>& Ke_hg_out
+    Eigen::Matrix<double, 8, 4>& gammas,
+    Eigen::Matrix3d K_mode[4][4]
 ) {
     // 1. 计算 Gamma 向量 (8x4)
-    Eigen::Matrix<double, 8, 4> gammas;
     compute_hourglass_shape_vectors(BiI, coords, gammas);
     
     // 2. 计算旋转后的材料矩阵 C_tilde (6x6)
@@ -563,15 +463,13 @@ static void compute_hourglass_stiffness(
         }
     }
     
-    // 5. 静力凝聚并转换回物理空间 (24x24)
-    Ke_hg_out.setZero();
-    
+    // 5. 静力凝聚并转换回物理空间，同时乘以体积因子和缩放
     // 预计算 FJAC 的转置，避免在循环中重复计算
     const Eigen::Matrix3d FJAC_T = FJAC.transpose();
+    const double scale = (vol / 8.0) * SCALE_HOURGLASS;
     
-    // 临时变量放在循环外（优化点 B：减少临时分配）
+    // 临时变量放在循环外（减少临时分配）
     Eigen::Matrix3d K_cond;
-    Eigen::Matrix3d K_cond_transformed;
     
     // 循环 4x4 模式
     for (int i = 0; i < 4; ++i) {
@@ -588,13 +486,39 @@ static void compute_hourglass_stiffness(
             
             // B. 坐标变换：J * K_cond * J^T 
             // CRITICAL FIX: 使用 FJAC (J) 而不是 J0_T (J^T)
-            K_cond_transformed.noalias() = FJAC * K_cond * FJAC_T;
-            
-            // C. 组装到 24x24 矩阵 (Kronecker Product 优化 - 优化点 A)
-            // 原理：Ke_block_AB += gamma(A,i)*gamma(B,j) * K_transformed
+            K_mode[i][j].noalias() = FJAC * K_cond * FJAC_T;
+            K_mode[i][j] *= scale;
+        }
+    }
+}
+
+/**
+ * @brief 计算沙漏刚度矩阵（24x24）- 优化版本
+ * 这是主要的沙漏控制函数，对应 VUEL 中的 Step 2 全部逻辑
+ * 
+ * 优化点：
+ * - 模态刚度核由 compute_hourglass_modes 计算（与显式内力路径共用）
+ * - 使用 Block 操作代替逐元素循环（利用 SIMD）
+ * - 稀疏优化：跳过极小的 gamma 值
+ */
+static void compute_hourglass_stiffness(
+    const Eigen::Matrix<double, 8, 3>& coords,
+    const Eigen::Matrix<double, 8, 3>& BiI,
+    const Eigen::Matrix3d& FJAC,
+    const Eigen::Matrix<double, 6, 6>& D_mat,
+    double vol,
+    Eigen::Matrix<double, 24, 24>& Ke_hg_out
+) {
+    Eigen::Matrix<double, 8, 4> gammas;
+    Eigen::Matrix3d K_mode[4][4];
+    compute_hourglass_modes(coords, BiI, FJAC, D_mat, vol, gammas, K_mode);
+    
+    Ke_hg_out.setZero();
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            // 组装到 24x24 矩阵 (Kronecker Product 优化)
+            // 原理：Ke_block_AB += gamma(A,i)*gamma(B,j) * K_mode[i][j]
             // 利用 Block 操作代替逐元素循环，利用 SIMD 指令
-            
-            // 提取第 i 列和第 j 列 gamma（8x1 向量）
             auto gamma_i = gammas.col(i); 
             auto gamma_j = gammas.col(j);
             
@@ -605,17 +529,46 @@ static void compute_hourglass_stiffness(
 
                 for (int B = 0; B < 8; ++B) {
                     double coef = g_Ai * gamma_j(B);
-                    
-                    // 利用 Eigen 的 block 操作直接加上 3x3 矩阵
-                    // 这比逐元素加法快得多，因为利用了 SIMD
-                    Ke_hg_out.block<3, 3>(3 * A, 3 * B).noalias() += coef * K_cond_transformed;
+                    Ke_hg_out.block<3, 3>(3 * A, 3 * B).noalias() += coef * K_mode[i][j];
                 }
             }
         }
     }
-    
-    // 应用体积因子和缩放
-    Ke_hg_out *= (vol / 8.0) * SCALE_HOURGLASS;
+}
+
+// -------------------------------------------------------------------
+// **模态形式的沙漏刚度核（供显式内力路径使用）**
+// -------------------------------------------------------------------
+bool compute_c3d8r_hourglass_modes(
+    const Eigen::Matrix<double, 8, 3>& coords,
+    const Eigen::Matrix<double, 6, 6>& D,
+    Eigen::Matrix<double, 8, 4>& gammas,
+    Eigen::Matrix3d K_mode[4][4]
+) {
+    double x[8], y[8], z[8];
+    for (int i = 0; i < 8; ++i) {
+        x[i] = coords(i, 0);
+        y[i] = coords(i, 1);
+        z[i] = coords(i, 2);
+    }
+
+    // 归一化 B-bar 与单元中心雅可比（与 compute_c3d8r_stiffness_matrix 相同）
+    Eigen::Matrix<double, 8, 3> BiI;
+    const double VOL = c3d8r_gradient::calc_b_bar(x, y, z,
+                                                  BiI.data() + 0*8, BiI.data() + 1*8, BiI.data() + 2*8);
+    if (std::abs(VOL) < 1.0e-20) {
+        return false;
+    }
+    BiI /= VOL;
+
+    const Eigen::Matrix3d JAC = jacobian_center(coords);
+    const double DETJ = jacobian_determinant(JAC);
+    if (std::abs(DETJ) < 1.0e-20) {
+        return false;
+    }
+
+    compute_hourglass_modes(coords, BiI, JAC, D, DETJ * WG, gammas, K_mode);
+    return true;
 }
 
 // -------------------------------------------------------------------
@@ -650,7 +603,18 @@ void compute_c3d8r_stiffness_matrix(
         coords(i, 2) = pos.z;
     }
     
-    // 4. 计算 B-bar 矩阵（D 矩阵已由调用者传入，无需查找）
+    compute_c3d8r_stiffness_matrix(coords, D, Ke_output);
+}
+
+// -------------------------------------------------------------------
+// **主函数：由节点坐标计算 C3D8R 单元刚度矩阵**
+// -------------------------------------------------------------------
+void compute_c3d8r_stiffness_matrix(
+    const Eigen::Matrix<double, 8, 3>& coords,
+    const Eigen::Matrix<double, 6, 6>& D,
+    Eigen::MatrixXd& Ke_output
+) {
+    // 4. 计算 B-bar 梯度（D 矩阵已由调用者传入，无需查找）
     Eigen::Matrix<double, 8, 3> BiI;
     
     // 提取坐标分量（注意 FORTRAN 代码中的顺序）
@@ -662,13 +626,9 @@ void compute_c3d8r_stiffness_matrix(
         z[i] = coords(i, 2);
     }
     
-    // 计算三个分量的 B-bar
-    calc_b_bar_component(y, z, BiI.data() + 0*8);  // x 分量（对应 BiI(:,1)）
-    calc_b_bar_component(z, x, BiI.data() + 1*8);  // y 分量（对应 BiI(:,2)）
-    calc_b_bar_component(x, y, BiI.data() + 2*8);  // z 分量（对应 BiI(:,3)）
-    
-    // 6. 计算单元体积
-    double VOL = calc_vol_bbar(BiI.data() + 0*8, x);  // 使用第一个分量
+    // 5/6. 三个分量的 B-bar（BiI(:,1..3)）与单元体积
+    double VOL = c3d8r_gradient::calc_b_bar(x, y, z,
+                                            BiI.data() + 0*8, BiI.data() + 1*8, BiI.data() + 2*8);
     
     // 7. 归一化 B-bar 矩阵（除以体积）
     if (std::abs(VOL) < 1.0e-20) {
@@ -684,22 +644,26 @@ void compute_c3d8r_stiffness_matrix(
         throw std::runtime_error("Jacobian determinant is zero or too small");
     }
     
-    // 9. 构建 B 矩阵（6x24）
-    Eigen::Matrix<double, 6, 24> B = form_b_matrix(BiI);
-    
-    // 10. 计算体积刚度矩阵（优化点 D：使用 noalias 和优化乘法顺序）
-    // K_vol = B^T * D * B * detJ * WG
-    // 优化：先计算 D * B (6x24)，再计算 B^T * (D*B) (24x24)
-    // 这样比 B^T * D (24x6) * B (6x24) 要快，因为中间矩阵更小且更利于缓存
+    // 9/10. 计算体积刚度矩阵 K_vol = B^T * D * B * detJ * WG
+    // 不显式构造 6x24 的 B 矩阵（75% 为零），直接由 BiI 逐块计算
+    // K_IJ = B_I^T * D * B_J（3x3），并利用对称性只计算 J >= I 的块
     double scale_vol = DETJ * WG;
     Eigen::Matrix<double, 24, 24> K_total;
     
-    // Step 1: DB = D * B (6x24)
-    Eigen::Matrix<double, 6, 24> DB;
-    DB.noalias() = D * B;
-    
-    // Step 2: K_vol = B^T * DB * scale_vol
-    K_total.noalias() = B.transpose() * DB * scale_vol;
+    for (int I = 0; I < 8; ++I) {
+        const double gi[3] = {BiI(I, 0), BiI(I, 1), BiI(I, 2)};
+        for (int J = I; J < 8; ++J) {
+            const double gj[3] = {BiI(J, 0), BiI(J, 1), BiI(J, 2)};
+            double K_IJ[3][3];
+            c3d8r_gradient::gradient_stiffness_block(gi, gj, D, K_IJ);
+            for (int a = 0; a < 3; ++a) {
+                for (int b = 0; b < 3; ++b) {
+                    K_total(3*I + a, 3*J + b) = K_IJ[a][b] * scale_vol;
+                    K_total(3*J + b, 3*I + a) = K_IJ[a][b] * scale_vol;
+                }
+            }
+        }
+    }
     
     // 11. 计算沙漏刚度矩阵（Puso EAS 方法）
     // 直接累加到 K_total 上，避免创建额外的 K_hg 矩阵（内存优化）
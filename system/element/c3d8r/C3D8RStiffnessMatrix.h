@@ -14,7 +14,7 @@
 // -------------------------------------------------------------------
 // **C3D8R 单元刚度矩阵计算**
 // 这是一个纯计算函数，用于计算 C3D8R（8节点六面体）单元的刚度矩阵。
-// 使用 B-bar 方法和单点积分（简化版本，暂不考虑沙漏控制）。
+// 使用 B-bar 方法和单点积分，沙漏刚度采用 Puso EAS 方法。
 // -------------------------------------------------------------------
 
 /**
@@ -38,6 +38,21 @@ void compute_c3d8r_stiffness_matrix(
     Eigen::MatrixXd& Ke_output
 );
 
+/**
+ * @brief 计算 C3D8R 单元的刚度矩阵（直接给定节点坐标，不访问 registry）
+ * @param coords 8 个节点的坐标 (8x3)
+ * @param D 材料的本构矩阵 (6x6)
+ * @param Ke_output 输出的刚度矩阵缓冲区（会被 resize 为 24x24）
+ * @details 供 ConnectivityStore 组装路径使用，坐标由调用者从稠密数组中收集
+ * 
+ * @throws std::runtime_error 如果单元体积或雅可比行列式过小
+ */
+void compute_c3d8r_stiffness_matrix(
+    const Eigen::Matrix<double, 8, 3>& coords,
+    const Eigen::Matrix<double, 6, 6>& D,
+    Eigen::MatrixXd& Ke_output
+);
+
 /**
  * @brief 计算 C3D8R 单元的刚度矩阵（旧版接口，向后兼容）
  * @deprecated 使用输出参数版本以获得更好性能
@@ -47,3 +62,22 @@ Eigen::Matrix<double, 24, 24> compute_c3d8r_stiffness_matrix(
     entt::entity element_entity
 );
 
+
+/**
+ * @brief 计算 C3D8R 的 Puso EAS 沙漏模态刚度核（不组装 24x24 矩阵）
+ * @param coords 8 个节点的坐标 (8x3)
+ * @param D 材料的本构矩阵 (6x6)
+ * @param gammas 输出：沙漏形状向量 Γ (8x4)
+ * @param K_mode 输出：静力凝聚并变换到物理空间的模态刚度核（已乘 vol/8）
+ * @return 单元体积或雅可比行列式过小时返回 false（不抛出异常）
+ * @details 与刚度矩阵中的沙漏部分完全一致：
+ *            Ke_hg(3A+a, 3B+b) = Σ_ij Γ(A,i) * Γ(B,j) * K_mode[i][j](a,b)
+ *          显式内力路径以模态形式计算沙漏力：
+ *            q_j = Σ_B Γ(B,j) u_B,  f_A = Σ_i Γ(A,i) Σ_j K_mode[i][j] q_j
+ */
+bool compute_c3d8r_hourglass_modes(
+    const Eigen::Matrix<double, 8, 3>& coords,
+    const Eigen::Matrix<double, 6, 6>& D,
+    Eigen::Matrix<double, 8, 4>& gammas,
+    Eigen::Matrix3d K_mode[4][4]
+);
@@ -0,0 +1,412 @@
+// CheckpointSystem.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "CheckpointSystem.h"
+#include "../../data_center/NodalState.h"
+#include "../../data_center/ConnectivityStore.h"
+#include "../../data_center/StableTimeStep.h"
+#include "../../data_center/MassScaling.h"
+#include "../../data_center/components/mesh_components.h"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr uint64_t kSectionAlignment = 64;
+    constexpr size_t kNumSections = static_cast<size_t>(CheckpointSection::Count);
+
+    volatile std::sig_atomic_t g_termination_requested = 0;
+    using SignalHandler = void (*)(int);
+    SignalHandler g_previous_handler = SIG_DFL;
+
+    void on_termination_signal(int) {
+        g_termination_requested = 1;
+    }
+
+    uint64_t align_up(uint64_t offset) {
+        return (offset + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment;
+    }
+
+    /**
+     * @brief One section to be written: either a flat array or a list of per-block arrays
+     */
+    struct SectionSource {
+        const std::vector<double>* flat = nullptr;
+        const std::vector<std::vector<double>>* blocks = nullptr;
+
+        uint64_t count() const {
+            if (flat != nullptr) {
+                return flat->size();
+            }
+            uint64_t n = 0;
+            if (blocks != nullptr) {
+                for (const auto& block : *blocks) {
+                    n += block.size();
+                }
+            }
+            return n;
+        }
+    };
+
+    bool write_zeros(std::FILE* file, uint64_t n) {
+        static const char zeros[kSectionAlignment] = {};
+        return n == 0 || std::fwrite(zeros, 1, n, file) == n;
+    }
+
+    bool write_doubles(std::FILE* file, const std::vector<double>& values) {
+        return values.empty() || std::fwrite(values.data(), sizeof(double), values.size(), file) == values.size();
+    }
+
+    /**
+     * @brief Split a flattened element section back into the block layout of the store
+     */
+    void unflatten(const double* data, const ConnectivityStore& store, std::vector<std::vector<double>>& blocks) {
+        blocks.resize(store.blocks.size());
+        size_t offset = 0;
+        for (size_t b = 0; b < store.blocks.size(); ++b) {
+            const size_t n = store.blocks[b].num_elements();
+            blocks[b].assign(data + offset, data + offset + n);
+            offset += n;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// CheckpointFile
+// ---------------------------------------------------------------------------
+
+CheckpointFile::~CheckpointFile() {
+    close();
+}
+
+void CheckpointFile::close() {
+#ifdef _WIN32
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_ != nullptr) {
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+    }
+    if (file_handle_ != nullptr && file_handle_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(static_cast<HANDLE>(file_handle_));
+    }
+    mapping_handle_ = nullptr;
+    file_handle_ = nullptr;
+#else
+    if (data_ != nullptr) {
+        munmap(data_, size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool CheckpointFile::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        spdlog::error("Checkpoint: cannot open '{}'.", path);
+        return false;
+    }
+    file_handle_ = file;
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0) {
+        spdlog::error("Checkpoint: '{}' is empty.", path);
+        close();
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        spdlog::error("Checkpoint: cannot map '{}'.", path);
+        close();
+        return false;
+    }
+    mapping_handle_ = mapping;
+    data_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    size_ = static_cast<size_t>(file_size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        spdlog::error("Checkpoint: cannot open '{}'.", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        spdlog::error("Checkpoint: '{}' is empty.", path);
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping keeps the file alive
+    if (mapped != MAP_FAILED) {
+        data_ = mapped;
+        size_ = static_cast<size_t>(st.st_size);
+    }
+#endif
+    if (data_ == nullptr) {
+        spdlog::error("Checkpoint: cannot map '{}'.", path);
+        close();
+        return false;
+    }
+
+    const auto fail = [&](const char* reason) {
+        spdlog::error("Checkpoint: '{}' rejected: {}.", path, reason);
+        close();
+        return false;
+    };
+    if (size_ < sizeof(CheckpointHeader)) {
+        return fail("file too small");
+    }
+    const CheckpointHeader& h = header();
+    if (std::memcmp(h.magic, kCheckpointMagic, sizeof(kCheckpointMagic)) != 0) {
+        return fail("not a hyperFEM checkpoint");
+    }
+    if (h.byte_order != kCheckpointByteOrder) {
+        return fail("written on a machine with a different byte order");
+    }
+    if (h.version != kCheckpointVersion || h.header_bytes != sizeof(CheckpointHeader)) {
+        spdlog::error("Checkpoint: '{}' has format version {}, this build reads version {}.", path, h.version,
+                      kCheckpointVersion);
+        close();
+        return false;
+    }
+    if (h.file_bytes != size_) {
+        return fail("file is truncated");
+    }
+    for (size_t s = 0; s < kNumSections; ++s) {
+        const uint64_t bytes = h.section_count[s] * sizeof(double);
+        if (h.section_offset[s] % kSectionAlignment != 0 || h.section_offset[s] > size_ ||
+            bytes > size_ - h.section_offset[s]) {
+            return fail("section table out of range");
+        }
+    }
+    return true;
+}
+
+const double* CheckpointFile::section(CheckpointSection s) const {
+    return reinterpret_cast<const double*>(static_cast<const char*>(data_) +
+                                           header().section_offset[static_cast<size_t>(s)]);
+}
+
+size_t CheckpointFile::count(CheckpointSection s) const {
+    return static_cast<size_t>(header().section_count[static_cast<size_t>(s)]);
+}
+
+// ---------------------------------------------------------------------------
+// CheckpointSystem
+// ---------------------------------------------------------------------------
+
+bool CheckpointSystem::write(const std::string& path, const CheckpointRunState& run, const NodalState& state,
+                             const StableTimeStep* stable, const MassScaling* scaling) {
+    SectionSource sources[kNumSections];
+    sources[static_cast<size_t>(CheckpointSection::Position)].flat = &state.x;
+    sources[static_cast<size_t>(CheckpointSection::InitialPosition)].flat = &state.x0;
+    sources[static_cast<size_t>(CheckpointSection::Displacement)].flat = &state.u;
+    sources[static_cast<size_t>(CheckpointSection::Velocity)].flat = &state.v;
+    sources[static_cast<size_t>(CheckpointSection::Acceleration)].flat = &state.a;
+    sources[static_cast<size_t>(CheckpointSection::Mass)].flat = &state.mass;
+    sources[static_cast<size_t>(CheckpointSection::InverseMass)].flat = &state.inv_mass;
+    if (stable != nullptr) {
+        sources[static_cast<size_t>(CheckpointSection::WaveSpeed)].blocks = &stable->wave_speed;
+    }
+    if (scaling != nullptr) {
+        sources[static_cast<size_t>(CheckpointSection::ElementMass)].blocks = &scaling->element_mass;
+    }
+
+    // Value-initialization zero-fills the header, padding included, so the bytes are deterministic
+    CheckpointHeader header{};
+    std::memcpy(header.magic, kCheckpointMagic, sizeof(kCheckpointMagic));
+    header.version = kCheckpointVersion;
+    header.byte_order = kCheckpointByteOrder;
+    header.header_bytes = sizeof(CheckpointHeader);
+    header.num_nodes = state.num_nodes();
+    header.run = run;
+    header.dt_previous = state.dt_previous;
+    if (scaling != nullptr) {
+        header.physical_mass = scaling->physical_mass;
+        header.added_mass = scaling->added_mass;
+        header.dt_target = scaling->dt_target;
+    }
+    uint64_t offset = align_up(sizeof(CheckpointHeader));
+    for (size_t s = 0; s < kNumSections; ++s) {
+        header.section_offset[s] = offset;
+        header.section_count[s] = sources[s].count();
+        offset = align_up(offset + header.section_count[s] * sizeof(double));
+    }
+    header.file_bytes = offset;
+    if (stable != nullptr) {
+        header.num_elements = header.section_count[static_cast<size_t>(CheckpointSection::WaveSpeed)];
+    }
+
+    const std::string tmp_path = path + ".tmp";
+    std::FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    if (file == nullptr) {
+        spdlog::error("Checkpoint: cannot write '{}'.", tmp_path);
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    uint64_t position = sizeof(CheckpointHeader);
+    for (size_t s = 0; ok && s < kNumSections; ++s) {
+        ok = write_zeros(file, header.section_offset[s] - position);
+        if (sources[s].flat != nullptr) {
+            ok = ok && write_doubles(file, *sources[s].flat);
+        } else if (sources[s].blocks != nullptr) {
+            for (const auto& block : *sources[s].blocks) {
+                ok = ok && write_doubles(file, block);
+            }
+        }
+        position = header.section_offset[s] + header.section_count[s] * sizeof(double);
+    }
+    ok = ok && write_zeros(file, header.file_bytes - position);
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        spdlog::error("Checkpoint: write to '{}' failed.", tmp_path);
+        std::filesystem::remove(tmp_path);
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        // Some platforms refuse to rename over an existing file
+        std::filesystem::remove(path, ec);
+        std::filesystem::rename(tmp_path, path, ec);
+    }
+    if (ec) {
+        spdlog::error("Checkpoint: cannot move '{}' to '{}': {}", tmp_path, path, ec.message());
+        return false;
+    }
+    spdlog::info("Checkpoint written: {} (t = {:.6e} s, step {}, {:.1f} MB)", path, run.time, run.step,
+                 static_cast<double>(header.file_bytes) / (1024.0 * 1024.0));
+    return true;
+}
+
+bool CheckpointSystem::restore_nodal_mass(const CheckpointFile& file, entt::registry& registry,
+                                          const ConnectivityStore& store) {
+    const size_t n = store.num_nodes();
+    if (file.header().num_nodes != n || file.count(CheckpointSection::Mass) != n) {
+        spdlog::error("Checkpoint: {} nodal masses in the checkpoint, {} nodes in the model.",
+                      file.count(CheckpointSection::Mass), n);
+        return false;
+    }
+    const double* mass = file.section(CheckpointSection::Mass);
+    for (size_t i = 0; i < n; ++i) {
+        registry.emplace_or_replace<Component::Mass>(store.node_entities[i], mass[i]);
+    }
+    return true;
+}
+
+bool CheckpointSystem::restore_nodal_state(const CheckpointFile& file, NodalState& state) {
+    const CheckpointHeader& h = file.header();
+    const size_t n = state.num_nodes();
+    if (h.num_nodes != n) {
+        spdlog::error("Checkpoint: {} nodes in the checkpoint, {} in the model.", h.num_nodes, n);
+        return false;
+    }
+    auto copy = [&](CheckpointSection s, std::vector<double>& target, size_t expected) {
+        if (file.count(s) != expected) {
+            spdlog::error("Checkpoint: section {} has {} values, expected {}.", static_cast<uint32_t>(s),
+                          file.count(s), expected);
+            return false;
+        }
+        const double* data = file.section(s);
+        target.assign(data, data + expected);
+        return true;
+    };
+    state.dt_previous = h.dt_previous;
+    return copy(CheckpointSection::Position, state.x, 3 * n) &&
+           copy(CheckpointSection::InitialPosition, state.x0, 3 * n) &&
+           copy(CheckpointSection::Displacement, state.u, 3 * n) &&
+           copy(CheckpointSection::Velocity, state.v, 3 * n) &&
+           copy(CheckpointSection::Acceleration, state.a, 3 * n) &&
+           copy(CheckpointSection::Mass, state.mass, n) &&
+           copy(CheckpointSection::InverseMass, state.inv_mass, n);
+}
+
+bool CheckpointSystem::restore_element_state(const CheckpointFile& file, entt::registry& registry,
+                                             const ConnectivityStore& store) {
+    const CheckpointHeader& h = file.header();
+    const size_t num_elements = store.num_elements();
+    const size_t wave_speeds = file.count(CheckpointSection::WaveSpeed);
+    const size_t element_masses = file.count(CheckpointSection::ElementMass);
+    if ((wave_speeds != 0 && wave_speeds != num_elements) || (element_masses != 0 && element_masses != num_elements)) {
+        spdlog::error("Checkpoint: element state for {} elements, the model has {}.",
+                      std::max(wave_speeds, element_masses), num_elements);
+        return false;
+    }
+
+    if (wave_speeds != 0) {
+        StableTimeStep* stable_ptr = nullptr;
+        if (registry.ctx().contains<StableTimeStep>()) {
+            stable_ptr = &registry.ctx().get<StableTimeStep>();
+            stable_ptr->clear();
+        } else {
+            stable_ptr = &registry.ctx().emplace<StableTimeStep>();
+        }
+        unflatten(file.section(CheckpointSection::WaveSpeed), store, stable_ptr->wave_speed);
+        stable_ptr->element_dt.resize(store.blocks.size());
+        for (size_t b = 0; b < store.blocks.size(); ++b) {
+            stable_ptr->element_dt[b].assign(store.blocks[b].num_elements(), std::numeric_limits<double>::infinity());
+        }
+    }
+
+    if (element_masses != 0) {
+        MassScaling* scaling_ptr = nullptr;
+        if (registry.ctx().contains<MassScaling>()) {
+            scaling_ptr = &registry.ctx().get<MassScaling>();
+            scaling_ptr->clear();
+        } else {
+            scaling_ptr = &registry.ctx().emplace<MassScaling>();
+        }
+        unflatten(file.section(CheckpointSection::ElementMass), store, scaling_ptr->element_mass);
+        scaling_ptr->physical_mass = h.physical_mass;
+        scaling_ptr->added_mass = h.added_mass;
+        scaling_ptr->dt_target = h.dt_target;
+    }
+    return true;
+}
+
+void CheckpointSystem::install_termination_handler() {
+    g_termination_requested = 0;
+    g_previous_handler = std::signal(SIGTERM, on_termination_signal);
+    if (g_previous_handler == SIG_ERR) {
+        g_previous_handler = SIG_DFL;
+    }
+}
+
+void CheckpointSystem::remove_termination_handler() {
+    std::signal(SIGTERM, g_previous_handler);
+    g_previous_handler = SIG_DFL;
+}
+
+bool CheckpointSystem::termination_requested() {
+    return g_termination_requested != 0;
+}
@@ -0,0 +1,139 @@
+// CheckpointSystem.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "entt/entt.hpp"
+#include "../../data_center/Checkpoint.h"
+
+struct NodalState;
+struct ConnectivityStore;
+struct StableTimeStep;
+struct MassScaling;
+
+/**
+ * @class CheckpointFile
+ * @brief Read-only memory mapping of a checkpoint file
+ * @details The header and all sections are validated on open(); the sections
+ *          are then read in place from the mapping without parsing or copying.
+ */
+class CheckpointFile {
+public:
+    CheckpointFile() = default;
+    ~CheckpointFile();
+
+    CheckpointFile(const CheckpointFile&) = delete;
+    CheckpointFile& operator=(const CheckpointFile&) = delete;
+
+    /**
+     * @brief Map a checkpoint file and validate its header
+     * @param path Checkpoint file
+     * @return false (with an error logged) if the file cannot be mapped, is truncated,
+     *         or has a different magic, version or byte order
+     */
+    bool open(const std::string& path);
+
+    bool is_open() const {
+        return data_ != nullptr;
+    }
+
+    const CheckpointHeader& header() const {
+        return *static_cast<const CheckpointHeader*>(data_);
+    }
+
+    /**
+     * @brief Start of a section inside the mapping
+     */
+    const double* section(CheckpointSection s) const;
+
+    /**
+     * @brief Number of doubles in a section
+     */
+    size_t count(CheckpointSection s) const;
+
+    /**
+     * @brief Release the mapping
+     */
+    void close();
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#endif
+};
+
+/**
+ * @class CheckpointSystem
+ * @brief Binary checkpoint / restart of the explicit solver state
+ * @details A checkpoint holds the scalar loop state (time, step, dt, counters,
+ *          energy balance), the nodal state block (x, x0, u, v, a, mass,
+ *          inverse mass) and the element state (mass-scaled wave speeds and
+ *          element masses). The model definition itself (mesh, materials,
+ *          boundary conditions, loads) is still read from the input file.
+ */
+class CheckpointSystem {
+public:
+    /**
+     * @brief Write a checkpoint
+     * @param path Target file; written to "<path>.tmp" first and renamed, so an
+     *             interrupted write never replaces a valid checkpoint
+     * @param run Scalar loop state
+     * @param state Nodal state block
+     * @param stable Element stable time steps (wave speeds are stored), may be null
+     * @param scaling Selective mass scaling state, may be null
+     * @return true on success
+     */
+    static bool write(const std::string& path, const CheckpointRunState& run, const NodalState& state,
+                      const StableTimeStep* stable, const MassScaling* scaling);
+
+    /**
+     * @brief Write the checkpoint masses back to the node Mass components
+     * @details Replaces MassSystem::compute_lumped_mass() on restart, so the node
+     *          group and NodalStateSystem::build() see the masses of the run
+     *          (including mass-scaling added mass).
+     * @return false if the node count does not match the model
+     */
+    static bool restore_nodal_mass(const CheckpointFile& file, entt::registry& registry,
+                                   const ConnectivityStore& store);
+
+    /**
+     * @brief Copy the nodal arrays and the previous time step of a checkpoint into the nodal state block
+     * @return false if the node count does not match the model
+     */
+    static bool restore_nodal_state(const CheckpointFile& file, NodalState& state);
+
+    /**
+     * @brief Restore the element state into registry.ctx()
+     * @details The wave speeds are installed in StableTimeStep, so the next
+     *          ExplicitSolver::compute_stable_timestep() call only re-evaluates the
+     *          geometry; element masses go to MassScaling when mass scaling was active.
+     * @return false if the element count does not match the model
+     */
+    static bool restore_element_state(const CheckpointFile& file, entt::registry& registry,
+                                      const ConnectivityStore& store);
+
+    /**
+     * @brief Install a SIGTERM handler that only raises a flag for the time loop
+     */
+    static void install_termination_handler();
+
+    /**
+     * @brief Restore the SIGTERM handler that was active before install_termination_handler()
+     */
+    static void remove_termination_handler();
+
+    /**
+     * @brief true once SIGTERM has been received
+     */
+    static bool termination_requested();
+};
@@ -0,0 +1,49 @@
+// EnergyBalanceSystem.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "EnergyBalanceSystem.h"
+#include <algorithm>
+#include <cmath>
+
+void EnergyBalanceSystem::update(EnergyBalance& balance, const ElementEnergy& element, const NodalEnergy& nodal,
+                                 double dt) {
+    if (balance.initialized) {
+        // W_n = W_{n-1} + dt_{n-1} / 2 * (f_{n-1} + f_n) . v_{n-1/2}
+        balance.external_work += 0.5 * balance.last_dt * (balance.last_power_after + nodal.power_before);
+    }
+    balance.hourglass_dissipated += element.hourglass_power * dt;
+
+    balance.kinetic = nodal.kinetic;
+    balance.internal = element.strain;
+    balance.hourglass = element.hourglass + balance.hourglass_dissipated;
+    balance.total = balance.kinetic + balance.internal + balance.hourglass;
+    balance.mass = nodal.mass;
+
+    if (!balance.initialized) {
+        balance.initial_total = balance.total;
+        balance.initialized = true;
+    }
+
+    const double expected = balance.initial_total + balance.external_work;
+    const double scale = std::max({std::abs(expected), std::abs(balance.total), 1.0e-30});
+    balance.error = std::abs(balance.total - expected) / scale;
+
+    balance.last_power_after = nodal.power_after;
+    balance.last_dt = dt;
+}
+
+bool EnergyBalanceSystem::should_stop(const EnergyBalance& balance, double stop_error) {
+    if (stop_error <= 0.0 || !balance.initialized) {
+        return false;
+    }
+    // A diverging run may already have overflowed to inf / nan
+    if (!std::isfinite(balance.total) || !std::isfinite(balance.error)) {
+        return true;
+    }
+    return balance.error > stop_error;
+}
@@ -0,0 +1,44 @@
+// EnergyBalanceSystem.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include "../../data_center/EnergyBalance.h"
+
+/**
+ * @class EnergyBalanceSystem
+ * @brief Global energy balance of the explicit time loop
+ * @details Combines the partial sums collected inside the element pass
+ *          (InternalForceSystem) and the node pass (ExplicitSolver::integrate):
+ *          no extra sweep over elements or nodes is needed. All energies refer
+ *          to t_n, the instant the internal forces were evaluated at.
+ */
+class EnergyBalanceSystem {
+public:
+    /**
+     * @brief Advance the energy balance by one step
+     * @param balance Energy balance updated in place
+     * @param element Element energies of step n (strain, hourglass, viscous hourglass power)
+     * @param nodal Nodal energies of step n (kinetic, external power, mass)
+     * @param dt Time step size of step n
+     * @details
+     *   - Ext-Work: trapezoidal rule over [t_{n-1}, t_n] with the velocity v_{n-1/2}
+     *   - viscous hourglass dissipation is integrated with the power at t_n
+     *   - the first call records the initial total energy E0 (initial velocities)
+     *   - Error = |TOT - E0 - W| / max(|E0 + W|, TOT)
+     */
+    static void update(EnergyBalance& balance, const ElementEnergy& element, const NodalEnergy& nodal, double dt);
+
+    /**
+     * @brief Check the StopEnergyErr criterion
+     * @param balance Current energy balance
+     * @param stop_error StopEnergyErr (0 or negative disables the check)
+     * @return true if the relative energy error exceeds stop_error
+     */
+    static bool should_stop(const EnergyBalance& balance, double stop_error);
+};
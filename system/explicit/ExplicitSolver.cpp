@@ -9,62 +9,97 @@
 #include "ExplicitSolver.h"
 #include "../../data_center/components/mesh_components.h"
 #include "../../data_center/components/load_components.h"
+#include "../boundary/BoundarySystem.h"
+#include "../dof/DofMask.h"
+#include "../../data_center/components/property_components.h"
+#include "../../data_center/components/material_components.h"
+#include "../../data_center/StableTimeStep.h"
+#include "../element/c3d8r/C3D8RGradient.h"
+#include "../mesh/ConnectivitySystem.h"
+#include "../mesh/NodeGroupSystem.h"
+#include "../parallel/ThreadPool.h"
 #include "spdlog/spdlog.h"
 #include <algorithm>
-#include <cctype>
+#include <cassert>
 #include <cmath>
+#include <limits>
 
-void ExplicitSolver::integrate(entt::registry& registry, double dt) {
-    // Step 1: Compute acceleration: a = M^-1 * (f_ext - f_int)
-    auto node_view = registry.view<Component::Position>();
-    
-    for (auto node_entity : node_view) {
-        // Ensure all required components exist
-        if (!registry.all_of<Component::Mass>(node_entity)) {
-            continue;  // Skip nodes without mass
-        }
+namespace {
+    // Faces of the 8-node hexahedron (nodes 0-3 bottom, 4-7 top)
+    constexpr int kHexFaces[6][4] = {
+        {0, 1, 2, 3}, {4, 5, 6, 7}, {0, 1, 5, 4},
+        {1, 2, 6, 5}, {2, 3, 7, 6}, {3, 0, 4, 7}
+    };
 
-        const auto& mass = registry.get<Component::Mass>(node_entity);
-        if (std::abs(mass.value) < 1.0e-20) {
-            continue;  // Skip nodes with zero mass
+    // Characteristic length L_c = V / A_max of a hexahedron (0 for an inverted or zero-volume element)
+    double hex_characteristic_length(const uint32_t* nodes, const double* x) {
+        double cx[8], cy[8], cz[8];
+        for (int i = 0; i < 8; ++i) {
+            cx[i] = x[3*nodes[i] + 0];
+            cy[i] = x[3*nodes[i] + 1];
+            cz[i] = x[3*nodes[i] + 2];
         }
 
-        double inv_mass = 1.0 / mass.value;
-
-        // Get forces (default to zero if not present)
-        double fx_net = 0.0;
-        double fy_net = 0.0;
-        double fz_net = 0.0;
-
-        if (registry.all_of<Component::ExternalForce>(node_entity)) {
-            const auto& ext_force = registry.get<Component::ExternalForce>(node_entity);
-            fx_net += ext_force.fx;
-            fy_net += ext_force.fy;
-            fz_net += ext_force.fz;
+        double bx[8], by[8], bz[8];
+        const double volume = c3d8r_gradient::calc_b_bar(cx, cy, cz, bx, by, bz);
+        if (volume <= 0.0) {
+            return 0.0;
         }
 
-        if (registry.all_of<Component::InternalForce>(node_entity)) {
-            const auto& int_force = registry.get<Component::InternalForce>(node_entity);
-            fx_net -= int_force.fx;  // Internal force opposes motion
-            fy_net -= int_force.fy;
-            fz_net -= int_force.fz;
+        // Quadrilateral area = |d1 x d2| / 2 with the face diagonals d1, d2
+        double max_area = 0.0;
+        for (const auto& face : kHexFaces) {
+            const double d1[3] = {cx[face[2]] - cx[face[0]], cy[face[2]] - cy[face[0]], cz[face[2]] - cz[face[0]]};
+            const double d2[3] = {cx[face[3]] - cx[face[1]], cy[face[3]] - cy[face[1]], cz[face[3]] - cz[face[1]]};
+            const double nx = d1[1]*d2[2] - d1[2]*d2[1];
+            const double ny = d1[2]*d2[0] - d1[0]*d2[2];
+            const double nz = d1[0]*d2[1] - d1[1]*d2[0];
+            max_area = std::max(max_area, 0.5 * std::sqrt(nx*nx + ny*ny + nz*nz));
         }
 
-        // Compute acceleration
-        double ax = fx_net * inv_mass;
-        double ay = fy_net * inv_mass;
-        double az = fz_net * inv_mass;
+        return (max_area > 0.0) ? volume / max_area : 0.0;
+    }
 
-        // Ensure Acceleration component exists
-        if (!registry.all_of<Component::Acceleration>(node_entity)) {
-            registry.emplace<Component::Acceleration>(node_entity, 0.0, 0.0, 0.0);
+    // Dilatational wave speed c = sqrt((lambda + 2 mu) / rho) of an element's material (0 if unavailable)
+    double dilatational_wave_speed(const entt::registry& registry, entt::entity element_entity) {
+        const auto* property_ref = registry.try_get<Component::PropertyRef>(element_entity);
+        if (property_ref == nullptr) {
+            return 0.0;
+        }
+        const auto* material_ref = registry.try_get<Component::MaterialRef>(property_ref->property_entity);
+        if (material_ref == nullptr) {
+            return 0.0;
+        }
+        const auto* params = registry.try_get<Component::LinearElasticParams>(material_ref->material_entity);
+        if (params == nullptr || params->rho <= 0.0 || params->E <= 0.0 || params->nu >= 0.5) {
+            return 0.0;
         }
 
-        auto& acceleration = registry.get<Component::Acceleration>(node_entity);
-        acceleration.ax = ax;
-        acceleration.ay = ay;
-        acceleration.az = az;
+        // lambda + 2 mu = E (1 - nu) / ((1 + nu)(1 - 2 nu))
+        const double modulus = params->E * (1.0 - params->nu) / ((1.0 + params->nu) * (1.0 - 2.0 * params->nu));
+        return std::sqrt(modulus / params->rho);
     }
+}
+
+void ExplicitSolver::integrate(entt::registry& registry, const NodalGroup& nodes, double dt) {
+    // All node components live in the owning group built by NodeGroupSystem::build(),
+    // so each step walks packed arrays instead of probing the pools per entity
+    assert(nodes.size() == registry.storage<Component::Position>().size() &&
+           "every node must be in the node group (NodeGroupSystem::build)");
+
+    // Step 1: Compute acceleration: a = M^-1 * (f_ext - f_int)
+    NodeGroupSystem::for_each_span(registry, nodes, [](const NodalSpans& span) {
+        for (size_t k = 0; k < span.count; ++k) {
+            const double m = span.mass[k].value;
+            if (std::abs(m) < 1.0e-20) {
+                continue;  // Skip nodes with zero mass
+            }
+            const double inv_mass = 1.0 / m;
+            span.acceleration[k].ax = (span.external_force[k].fx - span.internal_force[k].fx) * inv_mass;
+            span.acceleration[k].ay = (span.external_force[k].fy - span.internal_force[k].fy) * inv_mass;
+            span.acceleration[k].az = (span.external_force[k].fz - span.internal_force[k].fz) * inv_mass;
+        }
+    });
 
     // Step 2: Apply boundary conditions (SPC) - set constrained accelerations to 0
     auto boundary_view = registry.view<Component::AppliedBoundaryRef>();
@@ -86,76 +121,292 @@ void ExplicitSolver::integrate(entt::registry& registry, double dt) {
 
             const auto& boundary_spc = registry.get<Component::BoundarySPC>(boundary_entity);
 
-            // Convert dof string to lowercase
-            std::string dof = boundary_spc.dof;
-            std::transform(dof.begin(), dof.end(), dof.begin(), ::tolower);
-
             // Apply constraints (set acceleration to 0 for constrained DOFs)
             // Note: current explicit solver only has translational DOFs (x,y,z).
-            if (dof == "all" || dof == "xyz") {
-                acceleration.ax = 0.0;
-                acceleration.ay = 0.0;
-                acceleration.az = 0.0;
-            } else if (dof == "x") {
-                acceleration.ax = 0.0;
-            } else if (dof == "y") {
-                acceleration.ay = 0.0;
-            } else if (dof == "z") {
-                acceleration.az = 0.0;
-            } else if (dof == "xy" || dof == "yx") {
-                acceleration.ax = 0.0;
-                acceleration.ay = 0.0;
-            } else if (dof == "xz" || dof == "zx") {
-                acceleration.ax = 0.0;
-                acceleration.az = 0.0;
-            } else if (dof == "yz" || dof == "zy") {
-                acceleration.ay = 0.0;
-                acceleration.az = 0.0;
-            }
+            const uint8_t mask = DofMask::from_string(boundary_spc.dof);
+            if (DofMask::has(mask, 0)) acceleration.ax = 0.0;
+            if (DofMask::has(mask, 1)) acceleration.ay = 0.0;
+            if (DofMask::has(mask, 2)) acceleration.az = 0.0;
         }
     }
 
     // Step 3: Update velocity (half-step): v_{t+1/2} = v_{t-1/2} + a_t * dt
-    // Step 4: Update position: x_{t+1} = x_t + v_{t+1/2} * dt
-    for (auto node_entity : node_view) {
-        if (!registry.all_of<Component::Acceleration>(node_entity)) {
-            continue;
+    // Step 4: Update displacement and position: x_{t+1} = x_t + v_{t+1/2} * dt
+    NodeGroupSystem::for_each_span(registry, nodes, [dt](const NodalSpans& span) {
+        for (size_t k = 0; k < span.count; ++k) {
+            auto& velocity = span.velocity[k];
+            velocity.vx += span.acceleration[k].ax * dt;
+            velocity.vy += span.acceleration[k].ay * dt;
+            velocity.vz += span.acceleration[k].az * dt;
+
+            span.displacement[k].dx += velocity.vx * dt;
+            span.displacement[k].dy += velocity.vy * dt;
+            span.displacement[k].dz += velocity.vz * dt;
+
+            span.position[k].x += velocity.vx * dt;
+            span.position[k].y += velocity.vy * dt;
+            span.position[k].z += velocity.vz * dt;
         }
+    });
+}
 
-        const auto& acceleration = registry.get<Component::Acceleration>(node_entity);
+namespace {
+    // Velocity step of the central difference scheme: the half-step velocities live at
+    // t_{n-1/2} and t_{n+1/2}, so a changed dt advances them by (dt_prev + dt) / 2
+    // (the first step, without a previous dt, uses dt)
+    double velocity_step(const NodalState& state, double dt) {
+        return (state.dt_previous > 0.0) ? 0.5 * (state.dt_previous + dt) : dt;
+    }
 
-        // Ensure Velocity component exists
-        if (!registry.all_of<Component::Velocity>(node_entity)) {
-            registry.emplace<Component::Velocity>(node_entity, 0.0, 0.0, 0.0);
+    // Central difference update; with WithEnergy the kinetic energy and external
+    // power are accumulated in the velocity loop instead of a separate node pass
+    template <bool WithEnergy>
+    void integrate_nodal_state(NodalState& state, const SpcTable& spc, double dt, NodalEnergy* energy) {
+        const size_t num_nodes = state.num_nodes();
+        double* a = state.a.data();
+        double* v = state.v.data();
+        double* u = state.u.data();
+        double* x = state.x.data();
+        const double* f_int = state.f_int.data();
+        const double* f_ext = state.f_ext.data();
+        const double* inv_mass = state.inv_mass.data();
+        const double dt_v = velocity_step(state, dt);
+
+        // Step 1: Compute acceleration: a = M^-1 * (f_ext - f_int)
+        for (size_t i = 0; i < num_nodes; ++i) {
+            const double m_inv = inv_mass[i];
+            a[3*i + 0] = (f_ext[3*i + 0] - f_int[3*i + 0]) * m_inv;
+            a[3*i + 1] = (f_ext[3*i + 1] - f_int[3*i + 1]) * m_inv;
+            a[3*i + 2] = (f_ext[3*i + 2] - f_int[3*i + 2]) * m_inv;
         }
 
-        auto& velocity = registry.get<Component::Velocity>(node_entity);
+        // Step 2: Apply boundary conditions (SPC) - zero the precompiled constrained DOFs
+        BoundarySystem::apply_spc(spc, a);
+
+        // Step 3: Update velocity (half-step): v_{t+1/2} = v_{t-1/2} + a_t * (dt_{t-1/2} + dt_{t+1/2}) / 2
+        // Step 4: Update displacement and position: x_{t+1} = x_t + v_{t+1/2} * dt
+        if constexpr (!WithEnergy) {
+            for (size_t k = 0; k < 3 * num_nodes; ++k) {
+                v[k] += a[k] * dt_v;
+                u[k] += v[k] * dt;
+                x[k] += v[k] * dt;
+            }
+        } else {
+            const double* mass = state.mass.data();
+            double kinetic = 0.0;
+            double power_before = 0.0;
+            double power_after = 0.0;
+            double total_mass = 0.0;
+            for (size_t i = 0; i < num_nodes; ++i) {
+                double v_sq = 0.0;
+                for (int d = 0; d < 3; ++d) {
+                    const size_t k = 3*i + d;
+                    const double v_old = v[k];
+                    v[k] += a[k] * dt_v;
+                    u[k] += v[k] * dt;
+                    x[k] += v[k] * dt;
+
+                    // Kinetic energy at t_n from the mean of the two half-step velocities
+                    const double v_n = 0.5 * (v_old + v[k]);
+                    v_sq += v_n * v_n;
+                    power_before += f_ext[k] * v_old;
+                    power_after += f_ext[k] * v[k];
+                }
+                kinetic += 0.5 * mass[i] * v_sq;
+                total_mass += mass[i];
+            }
+            energy->kinetic = kinetic;
+            energy->power_before = power_before;
+            energy->power_after = power_after;
+            energy->mass = total_mass;
+        }
+        state.dt_previous = dt;
+    }
+}
 
-        // Update velocity (half-step)
-        velocity.vx += acceleration.ax * dt;
-        velocity.vy += acceleration.ay * dt;
-        velocity.vz += acceleration.az * dt;
+namespace {
+    // Fused node pass: acceleration, SPC (per-node mask), central difference update
+    // and f_int reset for the next element loop, one sweep over the node arrays
+    template <bool WithEnergy>
+    void integrate_fused_nodal_state(NodalState& state, const SpcTable& spc, double dt, NodalEnergy* energy) {
+        const size_t num_nodes = state.num_nodes();
+        double* a = state.a.data();
+        double* v = state.v.data();
+        double* u = state.u.data();
+        double* x = state.x.data();
+        double* f_int = state.f_int.data();
+        const double* f_ext = state.f_ext.data();
+        const double* inv_mass = state.inv_mass.data();
+        const double* mass = state.mass.data();
+        const uint8_t* node_mask = (spc.node_mask.size() == num_nodes) ? spc.node_mask.data() : nullptr;
+        const double dt_v = velocity_step(state, dt);
 
-        // Update displacement (before position)
-        if (!registry.all_of<Component::Displacement>(node_entity)) {
-            registry.emplace<Component::Displacement>(node_entity, 0.0, 0.0, 0.0);
+        double kinetic = 0.0;
+        double power_before = 0.0;
+        double power_after = 0.0;
+        double total_mass = 0.0;
+        for (size_t i = 0; i < num_nodes; ++i) {
+            const double m_inv = inv_mass[i];
+            const uint8_t mask = (node_mask != nullptr) ? node_mask[i] : 0;
+            double v_sq = 0.0;
+            for (int d = 0; d < 3; ++d) {
+                const size_t k = 3*i + d;
+                const double acc = DofMask::has(mask, d) ? 0.0 : (f_ext[k] - f_int[k]) * m_inv;
+                f_int[k] = 0.0;
+                a[k] = acc;
+                const double v_old = v[k];
+                v[k] += acc * dt_v;
+                u[k] += v[k] * dt;
+                x[k] += v[k] * dt;
+                if constexpr (WithEnergy) {
+                    const double v_n = 0.5 * (v_old + v[k]);
+                    v_sq += v_n * v_n;
+                    power_before += f_ext[k] * v_old;
+                    power_after += f_ext[k] * v[k];
+                }
+            }
+            if constexpr (WithEnergy) {
+                kinetic += 0.5 * mass[i] * v_sq;
+                total_mass += mass[i];
+            }
+        }
+        if constexpr (WithEnergy) {
+            energy->kinetic = kinetic;
+            energy->power_before = power_before;
+            energy->power_after = power_after;
+            energy->mass = total_mass;
         }
-        auto& displacement = registry.get<Component::Displacement>(node_entity);
-        displacement.dx += velocity.vx * dt;
-        displacement.dy += velocity.vy * dt;
-        displacement.dz += velocity.vz * dt;
+        state.dt_previous = dt;
+    }
+}
 
-        // Update position
-        auto& position = registry.get<Component::Position>(node_entity);
-        position.x += velocity.vx * dt;
-        position.y += velocity.vy * dt;
-        position.z += velocity.vz * dt;
+void ExplicitSolver::integrate(NodalState& state, const SpcTable& spc, double dt) {
+    integrate_nodal_state<false>(state, spc, dt, nullptr);
+}
+
+void ExplicitSolver::integrate_fused(NodalState& state, const SpcTable& spc, double dt, NodalEnergy* energy) {
+    if (energy != nullptr) {
+        integrate_fused_nodal_state<true>(state, spc, dt, energy);
+    } else {
+        integrate_fused_nodal_state<false>(state, spc, dt, nullptr);
     }
 }
 
+void ExplicitSolver::integrate(NodalState& state, const SpcTable& spc, double dt, NodalEnergy& energy) {
+    integrate_nodal_state<true>(state, spc, dt, &energy);
+}
+
 double ExplicitSolver::compute_stable_timestep(entt::registry& registry) {
-    // Placeholder implementation for CFL-based time step calculation
-    // This would typically compute: dt = CFL * min_element_size / wave_speed
-    // For now, return a conservative default
-    return 1.0e-6;
+    const ConnectivityStore& store = ConnectivitySystem::get_or_build(registry);
+
+    std::vector<double> x(3 * store.num_nodes());
+    for (size_t n = 0; n < store.num_nodes(); ++n) {
+        const auto& pos = registry.get<Component::Position>(store.node_entities[n]);
+        x[3*n + 0] = pos.x;
+        x[3*n + 1] = pos.y;
+        x[3*n + 2] = pos.z;
+    }
+
+    ThreadPool pool(1);
+    return compute_stable_timestep(registry, store, x, pool);
+}
+
+double ExplicitSolver::compute_stable_timestep(entt::registry& registry, const ConnectivityStore& store,
+                                               const std::vector<double>& x, ThreadPool& pool) {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+
+    StableTimeStep* stable_ptr = nullptr;
+    if (registry.ctx().contains<StableTimeStep>()) {
+        stable_ptr = &registry.ctx().get<StableTimeStep>();
+    } else {
+        stable_ptr = &registry.ctx().emplace<StableTimeStep>();
+    }
+    auto& stable = *stable_ptr;
+
+    // Wave speeds depend on the material only: evaluate once per store layout
+    bool layout_matches = stable.wave_speed.size() == store.blocks.size();
+    for (size_t b = 0; layout_matches && b < store.blocks.size(); ++b) {
+        layout_matches = stable.wave_speed[b].size() == store.blocks[b].num_elements();
+    }
+    if (!layout_matches) {
+        stable.clear();
+        stable.wave_speed.resize(store.blocks.size());
+        stable.element_dt.resize(store.blocks.size());
+        for (size_t b = 0; b < store.blocks.size(); ++b) {
+            const ConnectivityBlock& block = store.blocks[b];
+            stable.wave_speed[b].assign(block.num_elements(), 0.0);
+            stable.element_dt[b].assign(block.num_elements(), inf);
+            for (size_t k = 0; k < block.num_elements(); ++k) {
+                stable.wave_speed[b][k] = dilatational_wave_speed(registry, block.elements[k]);
+            }
+        }
+    }
+
+    // Per-thread minima, reduced in thread order so the critical element is deterministic.
+    // Inverted / zero-volume elements and elements without a wave speed get dt = 0: the run
+    // cannot continue, and the first such element becomes the critical one
+    struct ThreadMin {
+        double dt = inf;
+        uint32_t block = 0;
+        uint32_t element = 0;
+        size_t invalid = 0;
+    };
+    std::vector<ThreadMin> thread_min;
+
+    stable.dt_critical = inf;
+    stable.num_invalid_elements = 0;
+    for (size_t b = 0; b < store.blocks.size(); ++b) {
+        const ConnectivityBlock& block = store.blocks[b];
+        if (block.type_id != 308 || block.nodes_per_element != 8) {
+            continue;
+        }
+        const std::vector<double>& wave_speed = stable.wave_speed[b];
+        std::vector<double>& element_dt = stable.element_dt[b];
+
+        thread_min.assign(pool.size(), ThreadMin{});
+        pool.parallel_for(0, block.num_elements(), [&](size_t begin, size_t end, unsigned thread_index) {
+            ThreadMin local;
+            for (size_t k = begin; k < end; ++k) {
+                const double length = (wave_speed[k] > 0.0)
+                    ? hex_characteristic_length(block.nodes_of(k), x.data()) : 0.0;
+                const double dt = (length > 0.0) ? length / wave_speed[k] : 0.0;
+                element_dt[k] = dt;
+                if (dt == 0.0) {
+                    ++local.invalid;
+                }
+                if (dt < local.dt) {
+                    local.dt = dt;
+                    local.block = static_cast<uint32_t>(b);
+                    local.element = static_cast<uint32_t>(k);
+                }
+            }
+            thread_min[thread_index] = local;
+        });
+
+        for (const auto& local : thread_min) {
+            stable.num_invalid_elements += local.invalid;
+            if (local.dt < stable.dt_critical) {
+                stable.dt_critical = local.dt;
+                stable.critical_block = local.block;
+                stable.critical_element = local.element;
+            }
+        }
+    }
+
+    if (stable.num_invalid_elements > 0) {
+        const ConnectivityBlock& block = store.blocks[stable.critical_block];
+        const size_t k = stable.critical_element;
+        const entt::entity element = block.elements[k];
+        const auto* element_id = registry.try_get<Component::ElementID>(element);
+        spdlog::error("ExplicitSolver: {} element(s) have no stable time step; first: element {} "
+                      "(block {}, type {}, index {}): {}",
+                      stable.num_invalid_elements,
+                      (element_id != nullptr) ? element_id->value : static_cast<int>(entt::to_entity(element)),
+                      stable.critical_block, block.type_id, k,
+                      (stable.wave_speed[stable.critical_block][k] > 0.0)
+                          ? "inverted or zero-volume geometry"
+                          : "no valid material (PropertyRef/MaterialRef/LinearElasticParams with rho > 0)");
+    }
+
+    return stable.dt_critical;
 }
@@ -9,6 +9,14 @@
 #pragma once
 
 #include "entt/entt.hpp"
+#include "../../data_center/NodalState.h"
+#include "../../data_center/SpcTable.h"
+#include "../../data_center/ConnectivityStore.h"
+#include "../../data_center/EnergyBalance.h"
+#include "../mesh/NodeGroupSystem.h"
+#include <vector>
+
+class ThreadPool;
 
 /**
  * @class ExplicitSolver
@@ -16,22 +24,84 @@
  * @details Implements central difference method for explicit dynamics:
  *   1. Compute acceleration: a = M^-1 * (f_ext - f_int)
  *   2. Apply boundary conditions (SPC): set constrained accelerations to 0
- *   3. Update velocity (half-step): v_{t+1/2} = v_{t-1/2} + a_t * dt
- *   4. Update position: x_{t+1} = x_t + v_{t+1/2} * dt
+ *   3. Update velocity (half-step): v_{t+1/2} = v_{t-1/2} + a_t * (dt_{t-1/2} + dt_{t+1/2}) / 2
+ *   4. Update position: x_{t+1} = x_t + v_{t+1/2} * dt_{t+1/2}
  */
 class ExplicitSolver {
 public:
     /**
      * @brief Perform one time step integration
      * @param registry EnTT registry
+     * @param nodes Owning node group returned by NodeGroupSystem::build() at setup;
+     *        it must contain every node (checked by an assertion)
+     * @param dt Time step size
+     * @details Walks the packed arrays of the group.
+     *          Keeps no previous time step: the velocity advances by a * dt, which
+     *          matches the NodalState overloads only for a constant dt.
+     */
+    static void integrate(entt::registry& registry, const NodalGroup& nodes, double dt);
+
+    /**
+     * @brief Perform one time step integration on the SoA nodal state block
+     * @param state Nodal state holding forces, mass and kinematics
+     * @param spc Compiled SPC table (see BoundarySystem::compile_spc)
+     * @param dt Time step size
+     * @details Same update as the component based overload, but reads and writes
+     *          only the contiguous arrays of the NodalState. The velocity advances by
+     *          a * (state.dt_previous + dt) / 2, and state.dt_previous is set to dt.
+     */
+    static void integrate(NodalState& state, const SpcTable& spc, double dt);
+
+    /**
+     * @brief Perform one time step integration and collect the nodal energies
+     * @param state Nodal state holding forces, mass and kinematics
+     * @param spc Compiled SPC table
+     * @param dt Time step size
+     * @param energy Receives the kinetic energy at t_n, the external power before
+     *        and after the velocity update and the total mass
+     * @details Fused into the velocity update loop, so the energy channel costs
+     *          no extra pass over the nodes.
+     */
+    static void integrate(NodalState& state, const SpcTable& spc, double dt, NodalEnergy& energy);
+
+    /**
+     * @brief Single-pass time step integration for the fused explicit step
+     * @param state Nodal state; f_int is consumed and left zeroed
+     * @param spc Compiled SPC table (the per-node mask is used)
      * @param dt Time step size
+     * @param energy Optional; receives the nodal energies as in the overload above
+     * @details Acceleration, SPC, velocity / displacement / position update and
+     *          the reset of f_int for the next element loop are done in one sweep
+     *          over the node arrays, instead of the separate f_int fill, acceleration
+     *          pass, SPC scatter and update pass. Results are bitwise identical to
+     *          integrate(). The element loop of the next step must accumulate into
+     *          f_int without zeroing it (InternalForceSystem::accumulate_internal_forces).
      */
-    static void integrate(entt::registry& registry, double dt);
+    static void integrate_fused(NodalState& state, const SpcTable& spc, double dt, NodalEnergy* energy = nullptr);
 
     /**
-     * @brief Compute stable time step (optional, for future use)
+     * @brief Compute the critical (CFL) time step from node Position components
      * @param registry EnTT registry
-     * @return Estimated stable time step based on CFL condition
+     * @return Smallest element time step L_c / c (not scaled by DtScale)
+     * @details Convenience overload running on one thread; see the overload below.
      */
     static double compute_stable_timestep(entt::registry& registry);
+
+    /**
+     * @brief Compute the critical (CFL) time step of the current configuration
+     * @param registry EnTT registry (materials; owns the StableTimeStep in ctx)
+     * @param store Connectivity blocks
+     * @param x Current nodal coordinates, xyz interleaved in store numbering
+     * @param pool Thread pool for the element loop
+     * @return Smallest element time step L_c / c (not scaled by DtScale)
+     * @details
+     *   - L_c = V / A_max from the B-bar volume and the largest face area
+     *   - c = sqrt((lambda + 2 mu) / rho) from LinearElasticParams, cached per element
+     *   - Per-element values are stored in the StableTimeStep in registry.ctx()
+     *   - The minimum is reduced per thread and then over threads in thread order
+     *   - Inverted or zero-volume elements and elements without a valid material get
+     *     dt = 0; the first one is logged and the returned value is 0 so the caller aborts
+     */
+    static double compute_stable_timestep(entt::registry& registry, const ConnectivityStore& store,
+                                          const std::vector<double>& x, ThreadPool& pool);
 };
@@ -0,0 +1,127 @@
+// NodalStateSystem.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "NodalStateSystem.h"
+#include "../../data_center/components/mesh_components.h"
+#include "../mesh/ConnectivitySystem.h"
+#include "../mesh/NodeGroupSystem.h"
+#include "spdlog/spdlog.h"
+#include <cassert>
+#include <cmath>
+
+NodalState& NodalStateSystem::build(entt::registry& registry) {
+    NodalState* state_ptr = nullptr;
+    if (registry.ctx().contains<NodalState>()) {
+        state_ptr = &registry.ctx().get<NodalState>();
+        state_ptr->clear();
+    } else {
+        state_ptr = &registry.ctx().emplace<NodalState>();
+    }
+    auto& state = *state_ptr;
+
+    // Dense node numbering is shared with the connectivity store so that its
+    // 32-bit element node indices address the state arrays directly
+    const ConnectivityStore& store = ConnectivitySystem::get_or_build(registry);
+    const size_t num_nodes = store.num_nodes();
+
+    state.nodes = &store;
+    state.x.assign(3 * num_nodes, 0.0);
+    state.x0.assign(3 * num_nodes, 0.0);
+    state.u.assign(3 * num_nodes, 0.0);
+    state.v.assign(3 * num_nodes, 0.0);
+    state.a.assign(3 * num_nodes, 0.0);
+    state.f_int.assign(3 * num_nodes, 0.0);
+    state.f_ext.assign(3 * num_nodes, 0.0);
+    state.mass.assign(num_nodes, 0.0);
+    state.inv_mass.assign(num_nodes, 0.0);
+
+    size_t massless_nodes = 0;
+    for (size_t i = 0; i < num_nodes; ++i) {
+        const entt::entity node_entity = store.node_entities[i];
+
+        const auto& pos = registry.get<Component::Position>(node_entity);
+        state.x[3*i + 0] = pos.x;
+        state.x[3*i + 1] = pos.y;
+        state.x[3*i + 2] = pos.z;
+
+        if (const auto* pos0 = registry.try_get<Component::InitialPosition>(node_entity)) {
+            state.x0[3*i + 0] = pos0->x0;
+            state.x0[3*i + 1] = pos0->y0;
+            state.x0[3*i + 2] = pos0->z0;
+        } else {
+            state.x0[3*i + 0] = pos.x;
+            state.x0[3*i + 1] = pos.y;
+            state.x0[3*i + 2] = pos.z;
+        }
+
+        if (const auto* disp = registry.try_get<Component::Displacement>(node_entity)) {
+            state.u[3*i + 0] = disp->dx;
+            state.u[3*i + 1] = disp->dy;
+            state.u[3*i + 2] = disp->dz;
+        }
+
+        if (const auto* vel = registry.try_get<Component::Velocity>(node_entity)) {
+            state.v[3*i + 0] = vel->vx;
+            state.v[3*i + 1] = vel->vy;
+            state.v[3*i + 2] = vel->vz;
+        }
+
+        if (const auto* acc = registry.try_get<Component::Acceleration>(node_entity)) {
+            state.a[3*i + 0] = acc->ax;
+            state.a[3*i + 1] = acc->ay;
+            state.a[3*i + 2] = acc->az;
+        }
+
+        // Nodes without (or with zero) mass keep zero acceleration, as in the
+        // component based ExplicitSolver::integrate
+        if (const auto* mass = registry.try_get<Component::Mass>(node_entity)) {
+            state.mass[i] = mass->value;
+            if (std::abs(mass->value) >= 1.0e-20) {
+                state.inv_mass[i] = 1.0 / mass->value;
+            }
+        }
+        if (state.inv_mass[i] == 0.0) {
+            massless_nodes++;
+        }
+    }
+
+    spdlog::info("NodalStateSystem: Nodal state built for {} nodes.", num_nodes);
+    if (massless_nodes > 0) {
+        spdlog::warn("NodalStateSystem: {} nodes have no mass and will not accelerate.", massless_nodes);
+    }
+
+    return state;
+}
+
+void NodalStateSystem::sync_to_registry(entt::registry& registry, const NodalGroup& nodes) {
+    if (!registry.ctx().contains<NodalState>()) {
+        spdlog::warn("NodalStateSystem: No nodal state to synchronize.");
+        return;
+    }
+    const auto& state = registry.ctx().get<NodalState>();
+
+    // Write through the packed arrays of the node group; the group order differs
+    // from the dense state numbering, so each node is mapped by its entity id
+    assert(nodes.size() == registry.storage<Component::Position>().size() &&
+           "every node must be in the node group (NodeGroupSystem::build)");
+    NodeGroupSystem::for_each_span(registry, nodes, [&state](const NodalSpans& span) {
+        for (size_t k = 0; k < span.count; ++k) {
+            const int index = state.index_of(span.entities[k]);
+            if (index < 0) {
+                continue;
+            }
+            const size_t i = static_cast<size_t>(index);
+            span.position[k] = {state.x[3*i + 0], state.x[3*i + 1], state.x[3*i + 2]};
+            span.displacement[k] = {state.u[3*i + 0], state.u[3*i + 1], state.u[3*i + 2]};
+            span.velocity[k] = {state.v[3*i + 0], state.v[3*i + 1], state.v[3*i + 2]};
+            span.acceleration[k] = {state.a[3*i + 0], state.a[3*i + 1], state.a[3*i + 2]};
+            span.internal_force[k] = {state.f_int[3*i + 0], state.f_int[3*i + 1], state.f_int[3*i + 2]};
+            span.external_force[k] = {state.f_ext[3*i + 0], state.f_ext[3*i + 1], state.f_ext[3*i + 2]};
+        }
+    });
+}
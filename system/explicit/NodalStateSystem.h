@@ -0,0 +1,45 @@
+// NodalStateSystem.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include "entt/entt.hpp"
+#include "../../data_center/NodalState.h"
+#include "../mesh/NodeGroupSystem.h"
+
+/**
+ * @class NodalStateSystem
+ * @brief Builds the SoA nodal state block used by the explicit time loop
+ * @details The explicit step loop reads and writes only the NodalState stored in
+ *          registry.ctx(). Node components are copied in once before the loop and
+ *          written back only when an exporter actually needs them.
+ */
+class NodalStateSystem {
+public:
+    /**
+     * @brief Build (or rebuild) the NodalState from node components
+     * @param registry EnTT registry
+     * @return Reference to the NodalState stored in registry.ctx()
+     * @details
+     *   - Every entity with Position becomes a dense node index; the numbering is
+     *     taken from the ConnectivityStore (built here if missing)
+     *   - InitialPosition, Displacement, Velocity, Acceleration and Mass are copied
+     *     when present, otherwise default to Position / zero
+     *   - Should run after MassSystem::compute_lumped_mass
+     */
+    static NodalState& build(entt::registry& registry);
+
+    /**
+     * @brief Write the nodal state back to ECS components
+     * @param registry EnTT registry
+     * @param nodes Owning node group returned by NodeGroupSystem::build() at setup
+     * @details Updates Position, Displacement, Velocity, Acceleration, InternalForce
+     *          and ExternalForce of every node through the node group spans.
+     */
+    static void sync_to_registry(entt::registry& registry, const NodalGroup& nodes);
+};
@@ -0,0 +1,219 @@
+// SubcycleSystem.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "SubcycleSystem.h"
+#include "../../data_center/StableTimeStep.h"
+#include "../force/InternalForceSystem.h"
+#include "../parallel/ElementColoringSystem.h"
+#include "../parallel/ThreadPool.h"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <cmath>
+
+SubcycleSchedule& SubcycleSystem::build(entt::registry& registry, const ConnectivityStore& store, int max_levels) {
+    SubcycleSchedule* schedule_ptr = nullptr;
+    if (registry.ctx().contains<SubcycleSchedule>()) {
+        schedule_ptr = &registry.ctx().get<SubcycleSchedule>();
+        schedule_ptr->clear();
+    } else {
+        schedule_ptr = &registry.ctx().emplace<SubcycleSchedule>();
+    }
+    auto& schedule = *schedule_ptr;
+
+    max_levels = std::clamp(max_levels, 1, 16);
+    const StableTimeStep* stable = registry.ctx().contains<StableTimeStep>()
+                                       ? &registry.ctx().get<StableTimeStep>() : nullptr;
+    const bool have_dt = stable != nullptr && stable->element_dt.size() == store.blocks.size() &&
+                         std::isfinite(stable->dt_critical) && stable->dt_critical > 0.0;
+    if (!have_dt && max_levels > 1) {
+        spdlog::warn("SubcycleSystem: No stable time step available. Subcycling disabled.");
+    }
+
+    // 1. Element levels from the ratio to the critical time step
+    std::vector<std::vector<uint8_t>>& element_level = schedule.element_level;
+    element_level.resize(store.blocks.size());
+    for (size_t b = 0; b < store.blocks.size(); ++b) {
+        const size_t num_elements = store.blocks[b].num_elements();
+        element_level[b].assign(num_elements, 0);
+        if (!have_dt || max_levels == 1) {
+            continue;
+        }
+        for (size_t k = 0; k < num_elements; ++k) {
+            const double ratio = stable->element_dt[b][k] / stable->dt_critical;
+            if (!std::isfinite(ratio) || ratio < 2.0) {
+                continue;
+            }
+            const int level = std::min(static_cast<int>(std::floor(std::log2(ratio))), max_levels - 1);
+            element_level[b][k] = static_cast<uint8_t>(level);
+        }
+    }
+
+    // 2. Node level = lowest level of the attached elements (nodes without elements: level 0)
+    constexpr uint8_t unassigned = 0xFF;
+    schedule.node_level.assign(store.num_nodes(), unassigned);
+    for (size_t b = 0; b < store.blocks.size(); ++b) {
+        const ConnectivityBlock& block = store.blocks[b];
+        for (size_t k = 0; k < block.num_elements(); ++k) {
+            const uint32_t* nodes = block.nodes_of(k);
+            for (int i = 0; i < block.nodes_per_element; ++i) {
+                schedule.node_level[nodes[i]] = std::min(schedule.node_level[nodes[i]], element_level[b][k]);
+            }
+        }
+    }
+    int top_level = 0;
+    for (uint8_t& level : schedule.node_level) {
+        if (level == unassigned) {
+            level = 0;
+        }
+        top_level = std::max(top_level, static_cast<int>(level));
+    }
+    schedule.num_levels = top_level + 1;
+    // Interface elements are updated with their fastest node
+    for (size_t b = 0; b < store.blocks.size(); ++b) {
+        const ConnectivityBlock& block = store.blocks[b];
+        for (size_t k = 0; k < block.num_elements(); ++k) {
+            const uint32_t* nodes = block.nodes_of(k);
+            for (int i = 0; i < block.nodes_per_element; ++i) {
+                element_level[b][k] = std::min(element_level[b][k], schedule.node_level[nodes[i]]);
+            }
+        }
+    }
+
+    // 3. Nodes ordered by the highest update level of their elements, so the
+    //    force doubling between levels only visits the nodes that carry force
+    std::vector<uint8_t> node_top_level(store.num_nodes(), 0);
+    for (size_t b = 0; b < store.blocks.size(); ++b) {
+        const ConnectivityBlock& block = store.blocks[b];
+        for (size_t k = 0; k < block.num_elements(); ++k) {
+            const uint32_t* nodes = block.nodes_of(k);
+            for (int i = 0; i < block.nodes_per_element; ++i) {
+                node_top_level[nodes[i]] = std::max(node_top_level[nodes[i]], element_level[b][k]);
+            }
+        }
+    }
+    schedule.level_node_end.assign(schedule.num_levels, 0);
+    for (uint8_t level : node_top_level) {
+        schedule.level_node_end[level]++;
+    }
+    for (int level = schedule.num_levels - 2; level >= 0; --level) {
+        schedule.level_node_end[level] += schedule.level_node_end[level + 1];
+    }
+    std::vector<size_t> fill(schedule.num_levels, 0);
+    for (int level = 0; level + 1 < schedule.num_levels; ++level) {
+        fill[level] = schedule.level_node_end[level + 1];
+    }
+    schedule.level_nodes.resize(store.num_nodes());
+    for (size_t n = 0; n < store.num_nodes(); ++n) {
+        schedule.level_nodes[fill[node_top_level[n]]++] = static_cast<uint32_t>(n);
+    }
+
+    // 4. One coloring per level
+    schedule.level_coloring.assign(schedule.num_levels, ElementColoring{});
+    std::vector<size_t> level_elements(schedule.num_levels, 0);
+    std::vector<uint32_t> slots;
+    for (int level = 0; level < schedule.num_levels; ++level) {
+        ElementColoring& coloring = schedule.level_coloring[level];
+        for (size_t b = 0; b < store.blocks.size(); ++b) {
+            slots.clear();
+            for (size_t k = 0; k < store.blocks[b].num_elements(); ++k) {
+                if (schedule.element_level[b][k] == level) {
+                    slots.push_back(static_cast<uint32_t>(k));
+                }
+            }
+            if (!slots.empty()) {
+                ElementColoringSystem::append_colors(store, b, slots, coloring);
+                level_elements[level] += slots.size();
+            }
+        }
+        if (coloring.color_offsets.empty()) {
+            coloring.color_offsets.push_back(0);
+        }
+    }
+
+    // Element evaluations per base step relative to updating every element every step
+    double evaluations = 0.0;
+    for (int level = 0; level < schedule.num_levels; ++level) {
+        evaluations += static_cast<double>(level_elements[level]) / static_cast<double>(size_t(1) << level);
+        spdlog::info("SubcycleSystem: level {} (dt x {}): {} elements.", level, size_t(1) << level,
+                     level_elements[level]);
+    }
+    if (store.num_elements() > 0) {
+        spdlog::info("SubcycleSystem: {} level(s), element evaluations reduced to {:.1f}%.",
+                     schedule.num_levels, 100.0 * evaluations / static_cast<double>(store.num_elements()));
+    }
+
+    return schedule;
+}
+
+bool SubcycleSystem::is_stable(const entt::registry& registry, const SubcycleSchedule& schedule) {
+    if (!registry.ctx().contains<StableTimeStep>()) {
+        return false;
+    }
+    const StableTimeStep& stable = registry.ctx().get<StableTimeStep>();
+    if (stable.element_dt.size() != schedule.element_level.size()) {
+        return false;
+    }
+    for (size_t b = 0; b < stable.element_dt.size(); ++b) {
+        const std::vector<double>& element_dt = stable.element_dt[b];
+        const std::vector<uint8_t>& element_level = schedule.element_level[b];
+        if (element_dt.size() != element_level.size()) {
+            return false;
+        }
+        for (size_t k = 0; k < element_dt.size(); ++k) {
+            const double dt_level = stable.dt_critical * static_cast<double>(size_t(1) << element_level[k]);
+            if (element_level[k] > 0 && element_dt[k] < dt_level) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void SubcycleSystem::compute_internal_forces(const entt::registry& registry, const ConnectivityStore& store,
+                                             NodalState& state, const SubcycleSchedule& schedule, size_t step,
+                                             ThreadPool& pool, std::vector<ElementEnergy>* level_energy) {
+    // Levels due at a step are always 0..top; evaluate top-down and double the
+    // running sum before each lower level, so level l ends up weighted by 2^l
+    int top = 0;
+    while (top + 1 < schedule.num_levels && SubcycleSchedule::is_active(top + 1, step)) {
+        top++;
+    }
+
+    if (level_energy != nullptr) {
+        // Levels not due keep their last strain / hourglass energy but apply no
+        // viscous impulse at this step
+        level_energy->resize(static_cast<size_t>(schedule.num_levels));
+        for (ElementEnergy& e : *level_energy) {
+            e.hourglass_power = 0.0;
+        }
+    }
+
+    std::fill(state.f_int.begin(), state.f_int.end(), 0.0);
+    double* f_int = state.f_int.data();
+    for (int level = top; level >= 0; --level) {
+        if (level < top) {
+            // Only nodes of elements above this level carry force so far
+            const uint32_t* nodes = schedule.level_nodes.data();
+            pool.parallel_for(0, schedule.level_node_end[level + 1], [&](size_t begin, size_t end, unsigned) {
+                for (size_t i = begin; i < end; ++i) {
+                    const size_t n = nodes[i];
+                    f_int[3*n + 0] *= 2.0;
+                    f_int[3*n + 1] *= 2.0;
+                    f_int[3*n + 2] *= 2.0;
+                }
+            });
+        }
+        ElementEnergy* energy = (level_energy != nullptr) ? &(*level_energy)[level] : nullptr;
+        InternalForceSystem::accumulate_internal_forces(registry, store, state, schedule.level_coloring[level], pool,
+                                                        energy);
+        if (energy != nullptr) {
+            // The viscous force of level l is applied with weight 2^l
+            energy->hourglass_power *= static_cast<double>(size_t{1} << level);
+        }
+    }
+}
@@ -0,0 +1,76 @@
+// SubcycleSystem.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include "entt/entt.hpp"
+#include "../../data_center/ConnectivityStore.h"
+#include "../../data_center/NodalState.h"
+#include "../../data_center/SubcycleSchedule.h"
+#include "../../data_center/EnergyBalance.h"
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @class SubcycleSystem
+ * @brief Multi-time-step subcycling of the explicit element loop
+ * @details Elements are binned into power-of-two time step levels from their
+ *          stable time step, so regions of small elements no longer force the
+ *          whole mesh onto the smallest increment:
+ *   - level l elements are evaluated every 2^l base steps and their forces are
+ *     applied as an impulse with weight 2^l (multiple time stepping, r-RESPA);
+ *     the nodal update itself is the ordinary ExplicitSolver::integrate
+ *   - each element force acts on all its nodes at the same instant with the same
+ *     weight, so linear momentum is conserved
+ *   - interface handling: an element is evaluated at the level of its fastest
+ *     node (lowest level among the elements sharing its nodes), so elements
+ *     touching the small-step region run on the small step
+ */
+class SubcycleSystem {
+public:
+    /**
+     * @brief Build the SubcycleSchedule stored in registry.ctx()
+     * @param registry EnTT registry (owns the ctx storage and a current StableTimeStep)
+     * @param store Connectivity blocks
+     * @param max_levels Maximum number of levels (1 disables subcycling)
+     * @return Reference to the SubcycleSchedule
+     * @details Level of element e: floor(log2(dt_e / dt_critical)), clamped to
+     *          max_levels - 1; elements without a stable time step go to level 0.
+     *          Node levels follow from the element levels, then each element is
+     *          lowered to the level of its fastest node. Each level gets its own
+     *          element coloring for the parallel loop.
+     */
+    static SubcycleSchedule& build(entt::registry& registry, const ConnectivityStore& store, int max_levels);
+
+    /**
+     * @brief Check whether the levels are still stable for the current StableTimeStep
+     * @param registry EnTT registry holding the StableTimeStep
+     * @param schedule Subcycling schedule
+     * @return true if every element of level l satisfies 2^l * dt_critical <= dt_e
+     * @details Called after the stable time step is re-evaluated; the schedule
+     *          only has to be rebuilt when this returns false.
+     */
+    static bool is_stable(const entt::registry& registry, const SubcycleSchedule& schedule);
+
+    /**
+     * @brief Evaluate the internal forces of the levels due at a base step
+     * @param registry EnTT registry (read only during the element loop)
+     * @param store Connectivity blocks the schedule was built from
+     * @param state Nodal state; f_int receives the sum of 2^l times the forces of the levels due
+     * @param schedule Subcycling schedule
+     * @param step Base step index since the schedule was built
+     * @param pool Thread pool for the colored element loops
+     * @param level_energy Optional per-level element energies, kept between steps:
+     *        levels due are overwritten, the others keep their last strain and
+     *        hourglass energy; their sum is the energy of the whole mesh
+     */
+    static void compute_internal_forces(const entt::registry& registry, const ConnectivityStore& store,
+                                        NodalState& state, const SubcycleSchedule& schedule, size_t step,
+                                        ThreadPool& pool, std::vector<ElementEnergy>* level_energy = nullptr);
+};
@@ -8,9 +8,151 @@
  */
 #include "InternalForceSystem.h"
 #include "../../data_center/components/mesh_components.h"
-#include "../../data_center/components/property_components.h"
 #include "c3d8r/C3D8RInternalForce.h"
+#include "c3d8r/C3D8RReferenceForce.h"
+#include "c3d8/C3D8InternalForce.h"
+#include "ReferenceElementCacheSystem.h"
+#include "../element/ElementBlock.h"
+#include "../element/ElementTraits.h"
+#include "../parallel/ThreadPool.h"
+#include "../mesh/ConnectivitySystem.h"
 #include "spdlog/spdlog.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <vector>
+
+namespace {
+    // Elements per energy partial of the colored loop (a multiple of every SIMD batch width)
+    constexpr size_t kEnergyChunk = 256;
+
+    // Block-wide kernel inputs, resolved once per block (or color) outside the element loop
+    struct BlockKernelData {
+        ElementBlockData element;
+        C3D8RHourglassParams hourglass;
+        const ReferenceElementBlock* reference = nullptr;  // cached reference data, if any
+        KernelPrecision precision = KernelPrecision::Double;
+    };
+
+    BlockKernelData resolve_block(const entt::registry& registry, const ConnectivityBlock& block,
+                                  const ReferenceElementCache* cache, const HourglassOperatorCache* operators,
+                                  size_t block_index, KernelPrecision precision) {
+        BlockKernelData data;
+        data.precision = precision;
+        if (cache != nullptr && cache->blocks[block_index].cached) {
+            data.reference = &cache->blocks[block_index];
+            return data;
+        }
+        data.element = resolve_element_block(registry, block);
+        data.hourglass = get_c3d8r_hourglass_params(data.element.solid, data.element.rho);
+        // EAS operators precomputed on x0 at setup replace the per-step evaluation
+        if (data.hourglass.control == HourglassControl::EAS && operators != nullptr &&
+            !operators->blocks[block_index].gamma.empty()) {
+            data.hourglass.eas_gamma = operators->blocks[block_index].gamma.data();
+            data.hourglass.eas_stiffness = operators->blocks[block_index].stiffness.data();
+        }
+        return data;
+    }
+
+    // Elements of one connectivity block: the kernel specialized on the block's
+    // element traits runs the whole span without per-element lookups.
+    // Returns the number of elements the kernel skipped (degenerate geometry).
+    size_t compute_block_internal_forces(const BlockKernelData& data, const ConnectivityBlock& block,
+                                         const uint32_t* slots, size_t count, NodalState& state,
+                                         ElementEnergy* energy) {
+        if (data.reference != nullptr) {
+            return count - compute_c3d8r_internal_forces_cached(block, *data.reference, slots, count, state, energy);
+        }
+        if (data.element.D == nullptr) {
+            return 0;
+        }
+        const Eigen::Matrix<double, 6, 6>& D = *data.element.D;
+        size_t computed = count;
+        dispatch_element_traits(block, data.element.integration_points, [&]<typename Traits>() {
+            if constexpr (Traits::reduced_integration) {
+                if (data.precision == KernelPrecision::Mixed) {
+                    computed = compute_c3d8r_internal_forces_mixed(block, slots, count, D, data.hourglass, state,
+                                                                   energy);
+                } else {
+                    computed = compute_c3d8r_internal_forces_batched(block, slots, count, D, data.hourglass, state,
+                                                                     energy);
+                }
+            } else {
+                computed = compute_c3d8_internal_forces_block<Traits::integration_points>(block, slots, count, D,
+                                                                                          state, energy);
+            }
+        });
+        return count - computed;
+    }
+
+    // Skipped elements are counted per thread inside the loop and reported once afterwards
+    void report_skipped_elements(const std::vector<size_t>& skipped) {
+        size_t total = 0;
+        for (size_t n : skipped) {
+            total += n;
+        }
+        if (total > 0) {
+            spdlog::warn("InternalForceSystem: {} element(s) with degenerate geometry skipped.", total);
+        }
+    }
+
+    // Colored element loop with an explicit kernel precision (the public entry points
+    // take it from registry.ctx())
+    void accumulate_colored(const entt::registry& registry, const ConnectivityStore& store, NodalState& state,
+                            const ElementColoring& coloring, ThreadPool& pool, ElementEnergy* energy,
+                            KernelPrecision precision) {
+        const ReferenceElementCache* cache = ReferenceElementCacheSystem::find(registry, store);
+        const HourglassOperatorCache* operators = ReferenceElementCacheSystem::find_hourglass_operators(registry, store);
+        std::vector<size_t> skipped(pool.size(), 0);
+        if (energy == nullptr) {
+            for (size_t c = 0; c < coloring.num_colors(); ++c) {
+                const ConnectivityBlock& block = store.blocks[coloring.color_block[c]];
+                const BlockKernelData data = resolve_block(registry, block, cache, operators,
+                                                           coloring.color_block[c], precision);
+                pool.parallel_for(coloring.color_offsets[c], coloring.color_offsets[c + 1],
+                    [&](size_t begin, size_t end, unsigned thread_index) {
+                        skipped[thread_index] += compute_block_internal_forces(
+                            data, block, coloring.elements.data() + begin, end - begin, state, nullptr);
+                    });
+            }
+            report_skipped_elements(skipped);
+            return;
+        }
+
+        // Energies are summed over fixed chunks of kEnergyChunk elements, not over the
+        // per-thread ranges: the partials and their order depend only on the coloring,
+        // so the energies are bitwise identical for any thread count (the forces already
+        // are: elements of one color share no node)
+        size_t max_chunks = 0;
+        for (size_t c = 0; c < coloring.num_colors(); ++c) {
+            const size_t n = coloring.color_offsets[c + 1] - coloring.color_offsets[c];
+            max_chunks = std::max(max_chunks, (n + kEnergyChunk - 1) / kEnergyChunk);
+        }
+        std::vector<ElementEnergy> partial(max_chunks);
+        energy->clear();
+        for (size_t c = 0; c < coloring.num_colors(); ++c) {
+            const ConnectivityBlock& block = store.blocks[coloring.color_block[c]];
+            const BlockKernelData data = resolve_block(registry, block, cache, operators,
+                                                       coloring.color_block[c], precision);
+            const size_t offset = coloring.color_offsets[c];
+            const size_t n = coloring.color_offsets[c + 1] - offset;
+            const size_t num_chunks = (n + kEnergyChunk - 1) / kEnergyChunk;
+            pool.parallel_for(0, num_chunks, [&](size_t chunk_begin, size_t chunk_end, unsigned thread_index) {
+                for (size_t chunk = chunk_begin; chunk < chunk_end; ++chunk) {
+                    const size_t begin = chunk * kEnergyChunk;
+                    const size_t end = std::min(begin + kEnergyChunk, n);
+                    partial[chunk].clear();
+                    skipped[thread_index] += compute_block_internal_forces(
+                        data, block, coloring.elements.data() + offset + begin, end - begin, state, &partial[chunk]);
+                }
+            });
+            for (size_t chunk = 0; chunk < num_chunks; ++chunk) {
+                *energy += partial[chunk];
+            }
+        }
+        report_skipped_elements(skipped);
+    }
+}
 
 void InternalForceSystem::reset_internal_forces(entt::registry& registry) {
     auto node_view = registry.view<Component::InternalForce>();
@@ -26,57 +168,129 @@ void InternalForceSystem::compute_internal_forces(entt::registry& registry) {
     // Reset internal forces first
     reset_internal_forces(registry);
 
-    // Traverse all elements
-    auto element_view = registry.view<Component::Connectivity, Component::ElementType>();
+    // Traverse the homogeneous element blocks; the kernel is chosen once per block
+    const ConnectivityStore& store = ConnectivitySystem::get_or_build(registry);
     size_t element_count = 0;
 
-    for (auto element_entity : element_view) {
-        const auto& element_type = registry.get<Component::ElementType>(element_entity);
-
-        // switch-case dispatch based on element type
-        switch (element_type.type_id) {
-            case 308: {  // C3D8 (8-node hexahedron)
-                // Get integration points from SolidProperty
-                int n_integration_points = 1;  // Default to reduced integration
-                
-                if (registry.all_of<Component::PropertyRef>(element_entity)) {
-                    const auto& property_ref = registry.get<Component::PropertyRef>(element_entity);
-                    entt::entity property_entity = property_ref.property_entity;
-                    
-                    if (registry.all_of<Component::SolidProperty>(property_entity)) {
-                        const auto& solid_prop = registry.get<Component::SolidProperty>(property_entity);
-                        n_integration_points = solid_prop.integration_network;
+    for (const auto& block : store.blocks) {
+        const ElementBlockData data = resolve_element_block(registry, block);
+        if (data.D == nullptr) {
+            continue;
+        }
+        const C3D8RHourglassParams hourglass = get_c3d8r_hourglass_params(data.solid, data.rho);
+        const bool supported = dispatch_element_traits(block, data.integration_points,
+            [&]<typename Traits>() {
+                for (entt::entity element_entity : block.elements) {
+                    bool computed = false;
+                    if constexpr (Traits::reduced_integration) {
+                        computed = compute_c3d8r_internal_forces(registry, element_entity, *data.D, hourglass);
                     } else {
-                        spdlog::warn("Property missing SolidProperty component. Using default integration points = 1.");
+                        computed = compute_c3d8_internal_forces(registry, element_entity,
+                                                                Traits::integration_points);
                     }
-                } else {
-                    spdlog::warn("Element missing PropertyRef component. Using default integration points = 1.");
-                }
-                
-                // Only call C3D8R (reduced integration) if integration points = 1
-                if (n_integration_points == 1) {
-                    if (compute_c3d8r_internal_forces(registry, element_entity)) {
+                    if (computed) {
                         element_count++;
                     }
-                } else {
-                    // TODO: Implement full integration internal force calculation for n_integration_points > 1
-                    spdlog::warn("Internal force calculation with {} integration points is not yet implemented. Skipping element.", n_integration_points);
                 }
-                break;
-            }
+            });
+        if (!supported && block.type_id == 308) {
+            spdlog::warn("Internal force calculation with {} integration points is not supported. Skipping {} element(s).",
+                         data.integration_points, block.num_elements());
+        }
+    }
+
+    (void)element_count; // reserved for future logging/statistics
+}
 
-            // Future element types can be added here:
-            // case 304: {  // Tetra4
-            //     if (compute_tet4_internal_forces(registry, element_entity)) {
-            //         element_count++;
-            //     }
-            //     break;
-            // }
+void InternalForceSystem::compute_internal_forces(entt::registry& registry, NodalState& state,
+                                                  ElementEnergy* energy) {
+    std::fill(state.f_int.begin(), state.f_int.end(), 0.0);
 
-            default:
-                break;
+    const ConnectivityStore& store = ConnectivitySystem::get_or_build(registry);
+    const ReferenceElementCache* cache = ReferenceElementCacheSystem::find(registry, store);
+    const HourglassOperatorCache* operators = ReferenceElementCacheSystem::find_hourglass_operators(registry, store);
+    if (energy != nullptr) {
+        energy->clear();
+    }
+    std::vector<uint32_t> slots;
+    std::vector<size_t> skipped(1, 0);
+    for (size_t b = 0; b < store.blocks.size(); ++b) {
+        const ConnectivityBlock& block = store.blocks[b];
+        slots.resize(block.num_elements());
+        for (size_t k = 0; k < slots.size(); ++k) {
+            slots[k] = static_cast<uint32_t>(k);
         }
+        skipped[0] += compute_block_internal_forces(
+            resolve_block(registry, block, cache, operators, b, precision(registry)),
+            block, slots.data(), slots.size(), state, energy);
     }
+    report_skipped_elements(skipped);
+}
 
-    (void)element_count; // reserved for future logging/statistics
+void InternalForceSystem::compute_internal_forces(const entt::registry& registry, const ConnectivityStore& store,
+                                                  NodalState& state, const ElementColoring& coloring,
+                                                  ThreadPool& pool, ElementEnergy* energy) {
+    std::fill(state.f_int.begin(), state.f_int.end(), 0.0);
+    accumulate_internal_forces(registry, store, state, coloring, pool, energy);
+}
+
+void InternalForceSystem::accumulate_internal_forces(const entt::registry& registry, const ConnectivityStore& store,
+                                                     NodalState& state, const ElementColoring& coloring,
+                                                     ThreadPool& pool, ElementEnergy* energy) {
+    accumulate_colored(registry, store, state, coloring, pool, energy, precision(registry));
+}
+
+KernelPrecision InternalForceSystem::parse_precision(const std::string& name) {
+    std::string key = name;
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (key == "mixed" || key == "single" || key == "float" || key == "float32") {
+        return KernelPrecision::Mixed;
+    }
+    return KernelPrecision::Double;
+}
+
+void InternalForceSystem::set_precision(entt::registry& registry, KernelPrecision precision) {
+    if (registry.ctx().contains<KernelPrecision>()) {
+        registry.ctx().get<KernelPrecision>() = precision;
+    } else {
+        registry.ctx().emplace<KernelPrecision>(precision);
+    }
+}
+
+KernelPrecision InternalForceSystem::precision(const entt::registry& registry) {
+    if (!registry.ctx().contains<KernelPrecision>()) {
+        return KernelPrecision::Double;
+    }
+    return registry.ctx().get<KernelPrecision>();
+}
+
+PrecisionDeviation InternalForceSystem::compare_precision(const entt::registry& registry,
+                                                          const ConnectivityStore& store, NodalState& state,
+                                                          const ElementColoring& coloring, ThreadPool& pool) {
+    // Both passes run on the current state with f_int set aside and restored afterwards
+    std::vector<double> f_saved(state.f_int.size(), 0.0);
+    f_saved.swap(state.f_int);
+
+    ElementEnergy energy_mixed;
+    accumulate_colored(registry, store, state, coloring, pool, &energy_mixed, KernelPrecision::Mixed);
+    std::vector<double> f_mixed(state.f_int.size(), 0.0);
+    f_mixed.swap(state.f_int);
+
+    ElementEnergy energy_double;
+    accumulate_colored(registry, store, state, coloring, pool, &energy_double, KernelPrecision::Double);
+
+    PrecisionDeviation deviation;
+    deviation.energy_double = energy_double.strain + energy_double.hourglass;
+    deviation.energy_mixed = energy_mixed.strain + energy_mixed.hourglass;
+    double max_force = 0.0;
+    double max_diff = 0.0;
+    for (size_t k = 0; k < f_mixed.size(); ++k) {
+        max_force = std::max(max_force, std::abs(state.f_int[k]));
+        max_diff = std::max(max_diff, std::abs(f_mixed[k] - state.f_int[k]));
+    }
+    deviation.force_error = max_force > 0.0 ? max_diff / max_force : 0.0;
+
+    state.f_int.swap(f_saved);
+    return deviation;
 }
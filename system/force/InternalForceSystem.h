@@ -9,6 +9,14 @@
 #pragma once
 
 #include "entt/entt.hpp"
+#include <string>
+#include "../../data_center/NodalState.h"
+#include "../../data_center/ElementColoring.h"
+#include "../../data_center/ConnectivityStore.h"
+#include "../../data_center/EnergyBalance.h"
+#include "../../data_center/KernelPrecision.h"
+
+class ThreadPool;
 
 /**
  * @class InternalForceSystem
@@ -18,6 +26,19 @@
  *   2. Computing stress (D * strain)
  *   3. Computing element internal forces (B^T * stress * V)
  *   4. Scattering to nodes
+ *   Hexahedra with integration_network = 1 use the one-point C3D8R kernel,
+ *   2 and 3 the fully integrated C3D8 kernel (2x2x2 / 3x3x3 Gauss rule).
+ *   Elements are processed per ConnectivityStore block: property and material
+ *   are resolved once per block and dispatch_element_traits selects the kernel
+ *   specialized on ElementTraits<type, rule>, so the element loop itself has no
+ *   type switch or component lookups.
+ *   The NodalState paths use the ReferenceElementCache when one is active
+ *   (ReferenceElementCacheSystem::build): cached C3D8R blocks then skip the
+ *   gradient evaluation on the current coordinates. Uncached EAS blocks apply
+ *   the operator of the HourglassOperatorCache built by the same call.
+ *   With KernelPrecision::Mixed in registry.ctx() (set_precision) the uncached
+ *   C3D8R blocks run the float32 batch kernel; fully integrated and cached
+ *   blocks keep their kernels, and f_int is always accumulated in double.
  */
 class InternalForceSystem {
 public:
@@ -33,4 +54,78 @@ public:
      * @details Computes internal forces based on current node positions
      */
     static void compute_internal_forces(entt::registry& registry);
+
+    /**
+     * @brief Compute internal forces for all elements into the nodal state block
+     * @param registry EnTT registry (elements, properties and materials)
+     * @param state Nodal state; f_int is zeroed and then accumulated
+     * @param energy Optional; receives the element energies computed in the same loop
+     * @details Serial loop over the ConnectivityStore blocks (built if missing);
+     *          node components are not touched.
+     */
+    static void compute_internal_forces(entt::registry& registry, NodalState& state,
+                                        ElementEnergy* energy = nullptr);
+
+    /**
+     * @brief Compute internal forces in parallel, one element color at a time
+     * @param registry EnTT registry (read only during the element loop)
+     * @param store Connectivity blocks the coloring was built from
+     * @param state Nodal state; f_int is zeroed and then accumulated
+     * @param coloring Element coloring (see ElementColoringSystem::build)
+     * @param pool Thread pool running each color's elements
+     * @param energy Optional; receives the element energies computed in the same loop
+     * @details Elements of one color share no node, so every thread scatters
+     *          directly into NodalState::f_int without atomics. C3D8R elements
+     *          are evaluated kSimdLanes at a time by the batched SIMD kernel.
+     *          Energies are accumulated into partials over fixed chunks of each
+     *          color and summed in chunk order, so no atomics are needed either.
+     *          Every node receives its contributions in color order and the
+     *          energy partials do not depend on the thread split: f_int and the
+     *          energies are bitwise identical for any pool size.
+     */
+    static void compute_internal_forces(const entt::registry& registry, const ConnectivityStore& store,
+                                        NodalState& state, const ElementColoring& coloring, ThreadPool& pool,
+                                        ElementEnergy* energy = nullptr);
+
+    /**
+     * @brief Add the internal forces of the colored elements to NodalState::f_int
+     * @details Same loop as the colored compute_internal_forces without zeroing
+     *          f_int first; used to evaluate a subset of the elements (one
+     *          subcycling level) on top of forces already accumulated. energy, if
+     *          given, is overwritten with the energies of these elements only.
+     */
+    static void accumulate_internal_forces(const entt::registry& registry, const ConnectivityStore& store,
+                                           NodalState& state, const ElementColoring& coloring, ThreadPool& pool,
+                                           ElementEnergy* energy = nullptr);
+
+    /**
+     * @brief Map an ElementPrecision option to a precision (case-insensitive)
+     * @details "mixed" / "single" / "float" / "float32" -> Mixed, anything else -> Double.
+     */
+    static KernelPrecision parse_precision(const std::string& name);
+
+    /**
+     * @brief Select the element kernel precision used by the NodalState paths
+     */
+    static void set_precision(entt::registry& registry, KernelPrecision precision);
+
+    /**
+     * @brief The selected element kernel precision (Double when none was set)
+     */
+    static KernelPrecision precision(const entt::registry& registry);
+
+    /**
+     * @brief Evaluate the element loop in both precisions on the current state
+     * @param registry EnTT registry (read only)
+     * @param store Connectivity blocks the coloring was built from
+     * @param state Nodal state; f_int is restored before returning
+     * @param coloring Element coloring
+     * @param pool Thread pool running the element loops
+     * @return Internal energy of both passes and the relative force deviation
+     * @details Costs two extra element passes; meant to be called every few
+     *          hundred steps to judge whether the Mixed precision is safe for a model.
+     */
+    static PrecisionDeviation compare_precision(const entt::registry& registry, const ConnectivityStore& store,
+                                                NodalState& state, const ElementColoring& coloring,
+                                                ThreadPool& pool);
 };
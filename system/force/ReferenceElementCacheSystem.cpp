@@ -0,0 +1,267 @@
+// ReferenceElementCacheSystem.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "ReferenceElementCacheSystem.h"
+#include "c3d8r/C3D8RHourglass.h"
+#include "../element/ElementBlock.h"
+#include "../element/c3d8r/C3D8RGradient.h"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace {
+    ReferenceHourglassTerm hourglass_term(HourglassControl control) {
+        switch (control) {
+            case HourglassControl::Viscous:
+                return ReferenceHourglassTerm::ScalarOnVel;
+            case HourglassControl::Stiffness:
+                return ReferenceHourglassTerm::ScalarOnDisp;
+            case HourglassControl::EAS:
+                return ReferenceHourglassTerm::ModeMatrix;
+            case HourglassControl::None:
+            default:
+                return ReferenceHourglassTerm::None;
+        }
+    }
+
+    // Fill the per-element fields of one block in the storage precision Real
+    template <typename Real>
+    void fill_block(const ConnectivityBlock& block, const NodalState& state, const C3D8RHourglassParams& params,
+                    ReferenceElementBlock& cached, ReferenceElementFields<Real>& fields) {
+        const size_t n = block.num_elements();
+        cached.inv_volume.assign(n, 0.0);
+        fields.gradients.assign(24 * n, Real(0));
+        if (cached.hourglass != ReferenceHourglassTerm::None) {
+            fields.hourglass_gamma.assign(32 * n, Real(0));
+        }
+        if (cached.hourglass == ReferenceHourglassTerm::ScalarOnDisp ||
+            cached.hourglass == ReferenceHourglassTerm::ScalarOnVel) {
+            cached.hourglass_scale.assign(n, 0.0);
+        }
+        if (cached.hourglass == ReferenceHourglassTerm::ModeMatrix) {
+            fields.hourglass_stiffness.assign(144 * n, Real(0));
+        }
+
+        size_t degenerate = 0;
+        for (size_t k = 0; k < n; ++k) {
+            const uint32_t* nodes = block.nodes_of(k);
+            double x0[3][8];
+            for (int i = 0; i < 8; ++i) {
+                for (int d = 0; d < 3; ++d) {
+                    x0[d][i] = state.x0[3*static_cast<size_t>(nodes[i]) + d];
+                }
+            }
+
+            double b[3][8];
+            const double VOL = c3d8r_gradient::calc_b_bar(x0[0], x0[1], x0[2], b[0], b[1], b[2]);
+            if (std::abs(VOL) < 1.0e-20) {
+                degenerate++;
+                continue;
+            }
+            cached.inv_volume[k] = 1.0 / VOL;
+            Real* g = fields.gradients.data() + 24 * k;
+            for (int d = 0; d < 3; ++d) {
+                for (int i = 0; i < 8; ++i) {
+                    g[8*d + i] = static_cast<Real>(b[d][i]);
+                }
+            }
+
+            if (cached.hourglass == ReferenceHourglassTerm::None) {
+                continue;
+            }
+            C3D8RHourglassOperator op;
+            if (!compute_c3d8r_hourglass_operator(params, *cached.D, x0, op)) {
+                continue;  // gamma stays zero: no hourglass force, like the uncached kernel
+            }
+            Real* gamma = fields.hourglass_gamma.data() + 32 * k;
+            for (int m = 0; m < 4; ++m) {
+                for (int i = 0; i < 8; ++i) {
+                    gamma[8*m + i] = static_cast<Real>(op.gamma[m][i]);
+                }
+            }
+            if (cached.hourglass == ReferenceHourglassTerm::ModeMatrix) {
+                Real* K = fields.hourglass_stiffness.data() + 144 * k;
+                for (int m = 0; m < 4; ++m) {
+                    for (int j = 0; j < 4; ++j) {
+                        for (int a = 0; a < 3; ++a) {
+                            for (int c = 0; c < 3; ++c) {
+                                K[36*m + 9*j + 3*a + c] = static_cast<Real>(op.K[m][j][a][c]);
+                            }
+                        }
+                    }
+                }
+            } else {
+                cached.hourglass_scale[k] = op.scale;
+            }
+        }
+
+        if (degenerate > 0) {
+            spdlog::warn("ReferenceElementCacheSystem: {} degenerate element(s) of type {} will be skipped.",
+                         degenerate, block.type_id);
+        }
+    }
+
+    // EAS operators of one uncached block on x0 (zero for degenerate elements)
+    void fill_hourglass_operators(const ConnectivityBlock& block, const NodalState& state,
+                                  const C3D8RHourglassParams& params, const Eigen::Matrix<double, 6, 6>& D,
+                                  HourglassOperatorBlock& operators) {
+        const size_t n = block.num_elements();
+        operators.gamma.assign(32 * n, 0.0);
+        operators.stiffness.assign(144 * n, 0.0);
+        for (size_t k = 0; k < n; ++k) {
+            const uint32_t* nodes = block.nodes_of(k);
+            double x0[3][8];
+            for (int i = 0; i < 8; ++i) {
+                for (int d = 0; d < 3; ++d) {
+                    x0[d][i] = state.x0[3*static_cast<size_t>(nodes[i]) + d];
+                }
+            }
+            C3D8RHourglassOperator op;
+            if (!compute_c3d8r_hourglass_operator(params, D, x0, op)) {
+                continue;
+            }
+            std::copy(&op.gamma[0][0], &op.gamma[0][0] + 32, operators.gamma.data() + 32 * k);
+            std::copy(&op.K[0][0][0][0], &op.K[0][0][0][0] + 144, operators.stiffness.data() + 144 * k);
+        }
+    }
+
+    // Rebuild the HourglassOperatorCache for the blocks the reference cache does not cover
+    void build_hourglass_operators(entt::registry& registry, const ConnectivityStore& store,
+                                   const NodalState& state, const ReferenceElementCache& cache) {
+        HourglassOperatorCache* operators_ptr = nullptr;
+        if (registry.ctx().contains<HourglassOperatorCache>()) {
+            operators_ptr = &registry.ctx().get<HourglassOperatorCache>();
+            operators_ptr->clear();
+        } else {
+            operators_ptr = &registry.ctx().emplace<HourglassOperatorCache>();
+        }
+        auto& operators = *operators_ptr;
+        operators.blocks.resize(store.blocks.size());
+
+        size_t eas_elements = 0;
+        for (size_t b = 0; b < store.blocks.size(); ++b) {
+            const ConnectivityBlock& block = store.blocks[b];
+            if (b < cache.blocks.size() && cache.blocks[b].cached) {
+                continue;
+            }
+            const ElementBlockData data = resolve_element_block(registry, block);
+            if (block.type_id != 308 || block.nodes_per_element != 8 || data.integration_points != 1 ||
+                data.D == nullptr) {
+                continue;
+            }
+            const C3D8RHourglassParams params = get_c3d8r_hourglass_params(data.solid, data.rho);
+            if (params.control != HourglassControl::EAS) {
+                continue;
+            }
+            fill_hourglass_operators(block, state, params, *data.D, operators.blocks[b]);
+            eas_elements += block.num_elements();
+        }
+
+        if (eas_elements > 0) {
+            spdlog::info("ReferenceElementCacheSystem: EAS hourglass operators for {} element(s), {:.2f} MB.",
+                         eas_elements, static_cast<double>(operators.memory_bytes()) / (1024.0 * 1024.0));
+        }
+    }
+}
+
+ReferenceCacheMode ReferenceElementCacheSystem::parse_mode(const std::string& name) {
+    std::string key = name;
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (key == "reference" || key == "double" || key == "on") {
+        return ReferenceCacheMode::Double;
+    }
+    if (key == "float" || key == "compact" || key == "reference_float") {
+        return ReferenceCacheMode::Float;
+    }
+    return ReferenceCacheMode::Off;
+}
+
+ReferenceElementCache& ReferenceElementCacheSystem::build(entt::registry& registry, const ConnectivityStore& store,
+                                                          const NodalState& state, ReferenceCacheMode mode) {
+    ReferenceElementCache* cache_ptr = nullptr;
+    if (registry.ctx().contains<ReferenceElementCache>()) {
+        cache_ptr = &registry.ctx().get<ReferenceElementCache>();
+        cache_ptr->clear();
+    } else {
+        cache_ptr = &registry.ctx().emplace<ReferenceElementCache>();
+    }
+    auto& cache = *cache_ptr;
+    cache.mode = mode;
+    if (mode == ReferenceCacheMode::Off) {
+        build_hourglass_operators(registry, store, state, cache);
+        return cache;
+    }
+
+    cache.blocks.resize(store.blocks.size());
+    size_t cached_elements = 0;
+    for (size_t b = 0; b < store.blocks.size(); ++b) {
+        const ConnectivityBlock& block = store.blocks[b];
+        ReferenceElementBlock& cached = cache.blocks[b];
+
+        const ElementBlockData data = resolve_element_block(registry, block);
+        if (block.type_id != 308 || block.nodes_per_element != 8 || data.integration_points != 1 ||
+            data.D == nullptr) {
+            continue;
+        }
+
+        const C3D8RHourglassParams params = get_c3d8r_hourglass_params(data.solid, data.rho);
+        cached.cached = true;
+        cached.D = data.D;
+        cached.hourglass = hourglass_term(params.control);
+        if (mode == ReferenceCacheMode::Float) {
+            fill_block(block, state, params, cached, cached.fp32);
+        } else {
+            fill_block(block, state, params, cached, cached.fp64);
+        }
+        cached_elements += block.num_elements();
+    }
+
+    spdlog::info("ReferenceElementCacheSystem: cached {} of {} elements ({}), {:.2f} MB.",
+                 cached_elements, store.num_elements(),
+                 mode == ReferenceCacheMode::Float ? "float" : "double",
+                 static_cast<double>(cache.memory_bytes()) / (1024.0 * 1024.0));
+    build_hourglass_operators(registry, store, state, cache);
+    return cache;
+}
+
+const ReferenceElementCache* ReferenceElementCacheSystem::find(const entt::registry& registry,
+                                                               const ConnectivityStore& store) {
+    if (!registry.ctx().contains<ReferenceElementCache>()) {
+        return nullptr;
+    }
+    const auto& cache = registry.ctx().get<ReferenceElementCache>();
+    if (cache.mode == ReferenceCacheMode::Off || cache.blocks.size() != store.blocks.size()) {
+        return nullptr;
+    }
+    for (size_t b = 0; b < store.blocks.size(); ++b) {
+        if (cache.blocks[b].cached && cache.blocks[b].num_elements() != store.blocks[b].num_elements()) {
+            return nullptr;
+        }
+    }
+    return &cache;
+}
+
+const HourglassOperatorCache* ReferenceElementCacheSystem::find_hourglass_operators(const entt::registry& registry,
+                                                                                   const ConnectivityStore& store) {
+    if (!registry.ctx().contains<HourglassOperatorCache>()) {
+        return nullptr;
+    }
+    const auto& operators = registry.ctx().get<HourglassOperatorCache>();
+    if (operators.blocks.size() != store.blocks.size()) {
+        return nullptr;
+    }
+    for (size_t b = 0; b < store.blocks.size(); ++b) {
+        const HourglassOperatorBlock& block = operators.blocks[b];
+        if (!block.gamma.empty() && block.num_elements() != store.blocks[b].num_elements()) {
+            return nullptr;
+        }
+    }
+    return &operators;
+}
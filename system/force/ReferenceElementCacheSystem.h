@@ -0,0 +1,66 @@
+// ReferenceElementCacheSystem.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include "entt/entt.hpp"
+#include <string>
+#include "../../data_center/ConnectivityStore.h"
+#include "../../data_center/NodalState.h"
+#include "../../data_center/HourglassOperatorCache.h"
+#include "../../data_center/ReferenceElementCache.h"
+
+/**
+ * @class ReferenceElementCacheSystem
+ * @brief Builds the reference-configuration element cache for small-strain explicit runs
+ * @details With the cache active, InternalForceSystem evaluates cached C3D8R blocks
+ *          with compute_c3d8r_internal_forces_cached instead of recomputing the
+ *          B-bar gradients on the current coordinates every step. This is exact for
+ *          linear small-strain analysis only: the current-configuration kernel picks
+ *          up geometric changes (rigid rotations), the cached one does not.
+ */
+class ReferenceElementCacheSystem {
+public:
+    /**
+     * @brief Map an ElementCache option to a mode (case-insensitive)
+     * @details "off" / "none" / "" -> Off, "reference" / "double" / "on" -> Double,
+     *          "float" / "compact" / "reference_float" -> Float. Unknown names map to Off.
+     */
+    static ReferenceCacheMode parse_mode(const std::string& name);
+
+    /**
+     * @brief Build (or rebuild) the ReferenceElementCache in registry.ctx()
+     * @param registry EnTT registry (properties and materials; D matrices must be computed)
+     * @param store Connectivity blocks the cache is laid out on
+     * @param state Nodal state; x0 is the reference configuration
+     * @param mode Storage precision; Off clears the cache
+     * @return The cache
+     * @details Only reduced-integration hexahedron blocks with an initialized D
+     *          matrix are cached; other blocks keep the regular kernels. Per element
+     *          the unnormalized gradients, 1/V0 and the hourglass operator
+     *          (compute_c3d8r_hourglass_operator on x0) are stored. For every mode,
+     *          including Off, the HourglassOperatorCache is rebuilt as well: EAS
+     *          blocks left uncached get their total Lagrangian operator on x0, so
+     *          the step never re-evaluates it.
+     */
+    static ReferenceElementCache& build(entt::registry& registry, const ConnectivityStore& store,
+                                        const NodalState& state, ReferenceCacheMode mode);
+
+    /**
+     * @brief The active cache if it exists, is enabled and matches the store layout
+     * @return nullptr otherwise
+     */
+    static const ReferenceElementCache* find(const entt::registry& registry, const ConnectivityStore& store);
+
+    /**
+     * @brief The EAS operators of uncached blocks if they exist and match the store layout
+     * @return nullptr otherwise (the kernels then evaluate the operator every step)
+     */
+    static const HourglassOperatorCache* find_hourglass_operators(const entt::registry& registry,
+                                                                  const ConnectivityStore& store);
+};
@@ -0,0 +1,268 @@
+// C3D8InternalForce.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "C3D8InternalForce.h"
+#include "../../../data_center/components/mesh_components.h"
+#include "../../../data_center/components/property_components.h"
+#include "../../../data_center/components/material_components.h"
+#include "../../element/c3d8/C3D8GaussTable.h"
+#include "../../element/ElementBlock.h"
+#include "../../element/c3d8r/C3D8RGradient.h"
+#include <cmath>
+#include <utility>
+
+namespace {
+    // Contribution of Gauss point Q of rule NGP; returns false for a non-positive Jacobian
+    template <int NGP, int Q>
+    inline bool accumulate_point(const double coords[3][8], const double u[3][8],
+                                 const Eigen::Matrix<double, 6, 6>& D, double f[3][8]) {
+        constexpr const auto& table = c3d8_gauss::C3D8GaussRule<NGP>::table;
+        constexpr const auto& dN = table.dN[Q];
+
+        // J[i][j] = dx_j / dxi_i
+        double J[3][3];
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                double s = 0.0;
+                for (int A = 0; A < 8; ++A) {
+                    s += dN[i][A] * coords[j][A];
+                }
+                J[i][j] = s;
+            }
+        }
+        const double c00 = J[1][1]*J[2][2] - J[1][2]*J[2][1];
+        const double c01 = J[1][2]*J[2][0] - J[1][0]*J[2][2];
+        const double c02 = J[1][0]*J[2][1] - J[1][1]*J[2][0];
+        const double detJ = J[0][0]*c00 + J[0][1]*c01 + J[0][2]*c02;
+        if (!(detJ > 1.0e-20)) {
+            return false;
+        }
+
+        // Physical gradients g = J^-1 dN/dxi, pre-scaled by detJ (adjugate form)
+        const double adj[3][3] = {
+            {c00, J[0][2]*J[2][1] - J[0][1]*J[2][2], J[0][1]*J[1][2] - J[0][2]*J[1][1]},
+            {c01, J[0][0]*J[2][2] - J[0][2]*J[2][0], J[0][2]*J[1][0] - J[0][0]*J[1][2]},
+            {c02, J[0][1]*J[2][0] - J[0][0]*J[2][1], J[0][0]*J[1][1] - J[0][1]*J[1][0]}
+        };
+        double g[3][8];
+        for (int A = 0; A < 8; ++A) {
+            for (int j = 0; j < 3; ++j) {
+                g[j][A] = adj[j][0]*dN[0][A] + adj[j][1]*dN[1][A] + adj[j][2]*dN[2][A];
+            }
+        }
+
+        // strain * detJ, stress, then f_A += g_A^T sigma * w (g already carries detJ)
+        double strain[6];
+        c3d8r_gradient::gradient_strain(g[0], g[1], g[2], u[0], u[1], u[2], strain);
+        const double inv_det = 1.0 / detJ;
+        for (double& e : strain) {
+            e *= inv_det;
+        }
+        double stress[6];
+        for (int r = 0; r < 6; ++r) {
+            stress[r] = 0.0;
+            for (int c = 0; c < 6; ++c) {
+                stress[r] += D(r, c) * strain[c];
+            }
+            stress[r] *= table.weight[Q];
+        }
+        double fq[3][8];
+        c3d8r_gradient::gradient_forces(g[0], g[1], g[2], stress, fq[0], fq[1], fq[2]);
+        for (int d = 0; d < 3; ++d) {
+            for (int A = 0; A < 8; ++A) {
+                f[d][A] += fq[d][A];
+            }
+        }
+        return true;
+    }
+
+    // Rule-specialized element kernel; the point loop is a fold over the constexpr point indices
+    template <int NGP>
+    bool element_force(const double coords[3][8], const double u[3][8],
+                       const Eigen::Matrix<double, 6, 6>& D, double f[3][8]) {
+        for (int d = 0; d < 3; ++d) {
+            for (int A = 0; A < 8; ++A) {
+                f[d][A] = 0.0;
+            }
+        }
+        return [&]<int... Q>(std::integer_sequence<int, Q...>) {
+            return (accumulate_point<NGP, Q>(coords, u, D, f) && ...);
+        }(std::make_integer_sequence<int, c3d8_gauss::C3D8GaussRule<NGP>::num_points>{});
+    }
+}
+
+bool is_c3d8_rule_supported(int n_integration_points) {
+    return n_integration_points == 2 || n_integration_points == 3;
+}
+
+bool compute_c3d8_element_force(const double coords[3][8], const double u[3][8],
+                                const Eigen::Matrix<double, 6, 6>& D, int n_integration_points,
+                                double f[3][8]) {
+    switch (n_integration_points) {
+        case 2:
+            return element_force<2>(coords, u, D, f);
+        case 3:
+            return element_force<3>(coords, u, D, f);
+        default:
+            return false;
+    }
+}
+
+bool compute_c3d8_internal_forces(entt::registry& registry, entt::entity element_entity, int n_integration_points) {
+    if (!registry.all_of<Component::Connectivity, Component::ElementType>(element_entity)) {
+        return false;
+    }
+
+    const auto& connectivity = registry.get<Component::Connectivity>(element_entity);
+    if (connectivity.nodes.size() != 8) {
+        return false;
+    }
+
+    const Eigen::Matrix<double, 6, 6>* D = find_material_matrix(registry, element_entity);
+    if (D == nullptr) {
+        return false;
+    }
+
+    // Get current coordinates and displacement (current - initial)
+    double coords_current[3][8];
+    double u_e[3][8];
+    for (size_t i = 0; i < 8; ++i) {
+        const auto* pos = registry.try_get<Component::Position>(connectivity.nodes[i]);
+        if (pos == nullptr) {
+            return false;
+        }
+        coords_current[0][i] = pos->x;
+        coords_current[1][i] = pos->y;
+        coords_current[2][i] = pos->z;
+
+        if (const auto* pos0 = registry.try_get<Component::InitialPosition>(connectivity.nodes[i])) {
+            u_e[0][i] = pos->x - pos0->x0;
+            u_e[1][i] = pos->y - pos0->y0;
+            u_e[2][i] = pos->z - pos0->z0;
+        } else {
+            u_e[0][i] = 0.0;
+            u_e[1][i] = 0.0;
+            u_e[2][i] = 0.0;
+        }
+    }
+
+    double f_element[3][8];
+    if (!compute_c3d8_element_force(coords_current, u_e, *D, n_integration_points, f_element)) {
+        return false;
+    }
+
+    // Scatter to nodes
+    for (size_t i = 0; i < 8; ++i) {
+        auto& internal_force = registry.get_or_emplace<Component::InternalForce>(connectivity.nodes[i], 0.0, 0.0, 0.0);
+        internal_force.fx += f_element[0][i];
+        internal_force.fy += f_element[1][i];
+        internal_force.fz += f_element[2][i];
+    }
+
+    return true;
+}
+
+bool compute_c3d8_internal_forces(const entt::registry& registry, entt::entity element_entity, NodalState& state,
+                                  int n_integration_points) {
+    if (!registry.all_of<Component::Connectivity, Component::ElementType>(element_entity)) {
+        return false;
+    }
+
+    const auto& connectivity = registry.get<Component::Connectivity>(element_entity);
+    if (connectivity.nodes.size() != 8) {
+        return false;
+    }
+
+    const Eigen::Matrix<double, 6, 6>* D = find_material_matrix(registry, element_entity);
+    if (D == nullptr) {
+        return false;
+    }
+
+    // Gather current coordinates and displacement (current - initial) from the state block
+    int node_index[8];
+    double coords_current[3][8];
+    double u_e[3][8];
+    for (int i = 0; i < 8; ++i) {
+        node_index[i] = state.index_of(connectivity.nodes[i]);
+        if (node_index[i] < 0) {
+            return false;
+        }
+        const size_t n = static_cast<size_t>(node_index[i]);
+        for (int d = 0; d < 3; ++d) {
+            coords_current[d][i] = state.x[3*n + d];
+            u_e[d][i] = state.x[3*n + d] - state.x0[3*n + d];
+        }
+    }
+
+    double f_element[3][8];
+    if (!compute_c3d8_element_force(coords_current, u_e, *D, n_integration_points, f_element)) {
+        return false;
+    }
+
+    // Scatter to the state block
+    for (int i = 0; i < 8; ++i) {
+        const size_t n = static_cast<size_t>(node_index[i]);
+        state.f_int[3*n + 0] += f_element[0][i];
+        state.f_int[3*n + 1] += f_element[1][i];
+        state.f_int[3*n + 2] += f_element[2][i];
+    }
+
+    return true;
+}
+
+template <int NGP>
+size_t compute_c3d8_internal_forces_block(const ConnectivityBlock& block, const uint32_t* slots, size_t count,
+                                          const Eigen::Matrix<double, 6, 6>& D, NodalState& state,
+                                          ElementEnergy* energy) {
+    if (block.nodes_per_element != 8) {
+        return 0;
+    }
+
+    size_t computed = 0;
+    for (size_t k = 0; k < count; ++k) {
+        const uint32_t* nodes = block.nodes_of(slots[k]);
+        double coords_current[3][8];
+        double u_e[3][8];
+        for (int i = 0; i < 8; ++i) {
+            const size_t n = nodes[i];
+            for (int d = 0; d < 3; ++d) {
+                coords_current[d][i] = state.x[3*n + d];
+                u_e[d][i] = state.x[3*n + d] - state.x0[3*n + d];
+            }
+        }
+
+        double f_element[3][8];
+        if (!element_force<NGP>(coords_current, u_e, D, f_element)) {
+            continue;
+        }
+        if (energy != nullptr) {
+            double f_dot_u = 0.0;
+            for (int d = 0; d < 3; ++d) {
+                for (int i = 0; i < 8; ++i) {
+                    f_dot_u += f_element[d][i] * u_e[d][i];
+                }
+            }
+            energy->strain += 0.5 * f_dot_u;
+        }
+        for (int i = 0; i < 8; ++i) {
+            const size_t n = nodes[i];
+            state.f_int[3*n + 0] += f_element[0][i];
+            state.f_int[3*n + 1] += f_element[1][i];
+            state.f_int[3*n + 2] += f_element[2][i];
+        }
+        computed++;
+    }
+    return computed;
+}
+
+template size_t compute_c3d8_internal_forces_block<2>(const ConnectivityBlock&, const uint32_t*, size_t,
+                                                      const Eigen::Matrix<double, 6, 6>&, NodalState&,
+                                                      ElementEnergy*);
+template size_t compute_c3d8_internal_forces_block<3>(const ConnectivityBlock&, const uint32_t*, size_t,
+                                                      const Eigen::Matrix<double, 6, 6>&, NodalState&,
+                                                      ElementEnergy*);
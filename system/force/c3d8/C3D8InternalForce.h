@@ -0,0 +1,79 @@
+// C3D8InternalForce.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include "entt/entt.hpp"
+#include <Eigen/Dense>
+#include "../../../data_center/NodalState.h"
+#include "../../../data_center/ConnectivityStore.h"
+#include "../../../data_center/EnergyBalance.h"
+
+/**
+ * @brief Whether a fully integrated C3D8 rule is available
+ * @param n_integration_points Gauss points per direction (SolidProperty::integration_network)
+ * @return true for the 2x2x2 and 3x3x3 rules
+ */
+bool is_c3d8_rule_supported(int n_integration_points);
+
+/**
+ * @brief Fully integrated C3D8 element internal force (small strain, linear elastic)
+ * @param coords Current nodal coordinates [direction][node]
+ * @param u Nodal displacements [direction][node]
+ * @param D Material matrix (Voigt xx, yy, zz, xy, yz, xz)
+ * @param n_integration_points Gauss points per direction (2 or 3)
+ * @param f Output: element internal force [direction][node]
+ * @return false for an unsupported rule or a non-positive Jacobian at any point
+ * @details f_A = sum_q B_A(q)^T D B(q) u detJ(q) w_q. The rule is a template
+ *          parameter of the kernel; the shape function derivatives come from the
+ *          constexpr tables of c3d8_gauss::C3D8GaussRule and the point loop is
+ *          expanded at compile time.
+ */
+bool compute_c3d8_element_force(const double coords[3][8], const double u[3][8],
+                                const Eigen::Matrix<double, 6, 6>& D, int n_integration_points,
+                                double f[3][8]);
+
+/**
+ * @brief Compute and scatter internal forces for a single fully integrated C3D8 element
+ * @param registry EnTT registry containing element and node data
+ * @param element_entity Element entity to process
+ * @param n_integration_points Gauss points per direction (2 or 3)
+ * @return true if computed successfully, false otherwise
+ * @details Component based counterpart of compute_c3d8r_internal_forces: reads
+ *          Position / InitialPosition and accumulates into node InternalForce.
+ */
+bool compute_c3d8_internal_forces(entt::registry& registry, entt::entity element_entity, int n_integration_points);
+
+/**
+ * @brief Compute a single fully integrated C3D8 element and scatter into the nodal state block
+ * @param registry EnTT registry (element connectivity and material only)
+ * @param element_entity Element entity to process
+ * @param state Nodal state providing coordinates and receiving internal forces
+ * @param n_integration_points Gauss points per direction (2 or 3)
+ * @return true if computed successfully, false otherwise
+ */
+bool compute_c3d8_internal_forces(const entt::registry& registry, entt::entity element_entity, NodalState& state,
+                                  int n_integration_points);
+
+/**
+ * @brief Compute fully integrated C3D8 elements of one block and scatter into the nodal state block
+ * @tparam NGP Gauss points per direction (instantiated for 2 and 3)
+ * @param block Connectivity block of hexahedra sharing one property and material
+ * @param slots Block-local indices of the elements to process
+ * @param count Number of elements
+ * @param D Material matrix of the block
+ * @param state Nodal state providing coordinates and receiving internal forces
+ * @param energy Optional energy sink; the strain energy 1/2 f.u is added when not null
+ * @return Number of elements computed successfully
+ * @details The rule is fixed for the whole span, so the element loop calls the
+ *          rule-specialized kernel directly; no registry access.
+ */
+template <int NGP>
+size_t compute_c3d8_internal_forces_block(const ConnectivityBlock& block, const uint32_t* slots, size_t count,
+                                          const Eigen::Matrix<double, 6, 6>& D, NodalState& state,
+                                          ElementEnergy* energy = nullptr);
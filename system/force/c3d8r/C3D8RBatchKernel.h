@@ -0,0 +1,92 @@
+// C3D8RBatchKernel.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include "../../parallel/SimdPack.h"
+#include "../../element/c3d8r/C3D8RGradient.h"
+
+/**
+ * @brief SoA input/output block of W C3D8R elements (one element per lane)
+ * @tparam Real double, or float for the mixed-precision kernel
+ * @details Every array is laid out [component][node][lane] so that one SIMD
+ *          register holds the same quantity of W different elements.
+ */
+template <int W, typename Real = double>
+struct C3D8RElementBatch {
+    alignas(64) Real x[3][8][W];  ///< Current nodal coordinates
+    alignas(64) Real u[3][8][W];  ///< Nodal displacements (current - initial)
+    alignas(64) Real D[36][W];    ///< Material matrix, row-major 6x6
+    alignas(64) Real f[3][8][W];  ///< Output: element nodal internal forces
+    alignas(64) Real vol[W];      ///< Output: B-bar element volume
+};
+
+/**
+ * @brief Lane-parallel C3D8R internal force kernel (one-point B-bar, small strain)
+ * @tparam W Number of elements per batch (kSimdLanes for the native width,
+ *           kSimdLanesFloat for Real = float)
+ * @tparam Real Arithmetic type of the whole kernel
+ * @param batch Input coordinates/displacements/D and output forces/volume
+ * @details Per lane this is the scalar compute_c3d8r_internal_forces kernel:
+ *            BiI    = c3d8r_gradient::calc_b_bar(...)  (unnormalized gradients)
+ *            VOL    = sum_I x_I * BiI_x(I)
+ *            strain = sum_I BiI(I) (x) u_I / VOL       (Voigt xx,yy,zz,xy,yz,xz)
+ *            stress = D * strain
+ *            f_I    = BiI(I) . stress                  (= B^T sigma VOL)
+ *          The dense 6x24 B matrix is never formed. Lanes with a degenerate
+ *          volume produce non-finite forces; callers must check vol.
+ */
+template <int W, typename Real = double>
+inline void compute_c3d8r_internal_force_batch(C3D8RElementBatch<W, Real>& batch) {
+    using P = SimdPack<W, Real>;
+
+    P X[8], Y[8], Z[8];
+    for (int i = 0; i < 8; ++i) {
+        X[i] = P::load(batch.x[0][i]);
+        Y[i] = P::load(batch.x[1][i]);
+        Z[i] = P::load(batch.x[2][i]);
+    }
+
+    // Unnormalized B-bar gradients and element volume
+    P bx[8], by[8], bz[8];
+    const P vol = c3d8r_gradient::calc_b_bar(X, Y, Z, bx, by, bz);
+    vol.store(batch.vol);
+    const P inv_vol = P::broadcast(Real(1)) / vol;
+
+    // Strain (engineering shear), Voigt order xx, yy, zz, xy, yz, xz
+    P ux[8], uy[8], uz[8];
+    for (int i = 0; i < 8; ++i) {
+        ux[i] = P::load(batch.u[0][i]);
+        uy[i] = P::load(batch.u[1][i]);
+        uz[i] = P::load(batch.u[2][i]);
+    }
+    P strain[6];
+    c3d8r_gradient::gradient_strain(bx, by, bz, ux, uy, uz, strain);
+    for (int r = 0; r < 6; ++r) {
+        strain[r] = strain[r] * inv_vol;
+    }
+
+    // Stress = D * strain
+    P stress[6];
+    for (int r = 0; r < 6; ++r) {
+        P s = P::load(batch.D[6*r + 0]) * strain[0];
+        for (int c = 1; c < 6; ++c) {
+            s = s + P::load(batch.D[6*r + c]) * strain[c];
+        }
+        stress[r] = s;
+    }
+
+    // Nodal forces f_I = BiI(I) . sigma (B-bar already carries the volume)
+    P fx[8], fy[8], fz[8];
+    c3d8r_gradient::gradient_forces(bx, by, bz, stress, fx, fy, fz);
+    for (int i = 0; i < 8; ++i) {
+        fx[i].store(batch.f[0][i]);
+        fy[i].store(batch.f[1][i]);
+        fz[i].store(batch.f[2][i]);
+    }
+}
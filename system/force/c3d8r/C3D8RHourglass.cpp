@@ -0,0 +1,249 @@
+// C3D8RHourglass.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "C3D8RHourglass.h"
+#include "../../../data_center/components/mesh_components.h"
+#include "../../../data_center/components/property_components.h"
+#include "../../../data_center/components/material_components.h"
+#include "../../element/c3d8r/C3D8RGradient.h"
+#include "../../element/c3d8r/C3D8RStiffnessMatrix.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace {
+    // Hourglass base vectors h_i (same modes as H_VECTORS of the stiffness matrix)
+    constexpr double kHourglassBase[4][8] = {
+        { 1.0, -1.0,  1.0, -1.0,  1.0, -1.0,  1.0, -1.0},
+        { 1.0, -1.0, -1.0,  1.0, -1.0,  1.0,  1.0, -1.0},
+        { 1.0,  1.0, -1.0, -1.0, -1.0, -1.0,  1.0,  1.0},
+        {-1.0,  1.0, -1.0,  1.0,  1.0, -1.0,  1.0, -1.0}
+    };
+
+    // Flanagan-Belytschko shape vectors gamma[i][A] on the current configuration.
+    // Returns the B-bar volume and sum_B |b_B|^2 of the unnormalized gradients.
+    double fb_shape_vectors(const double x[3][8], double gamma[4][8], double& b_norm2) {
+        double b[3][8];
+        const double VOL = c3d8r_gradient::calc_b_bar(x[0], x[1], x[2], b[0], b[1], b[2]);
+        if (std::abs(VOL) < 1.0e-20) {
+            return VOL;
+        }
+
+        b_norm2 = 0.0;
+        for (int A = 0; A < 8; ++A) {
+            b_norm2 += b[0][A]*b[0][A] + b[1][A]*b[1][A] + b[2][A]*b[2][A];
+        }
+
+        const double inv_vol = 1.0 / VOL;
+        for (int i = 0; i < 4; ++i) {
+            double hx[3] = {0.0, 0.0, 0.0};
+            for (int A = 0; A < 8; ++A) {
+                for (int d = 0; d < 3; ++d) {
+                    hx[d] += kHourglassBase[i][A] * x[d][A];
+                }
+            }
+            for (int A = 0; A < 8; ++A) {
+                const double hb = (hx[0]*b[0][A] + hx[1]*b[1][A] + hx[2]*b[2][A]) * inv_vol;
+                gamma[i][A] = 0.125 * (kHourglassBase[i][A] - hb);
+            }
+        }
+        return VOL;
+    }
+
+    // f_A += coef * sum_i gamma_Ai q_i(w)
+    void add_mode_forces(const double gamma[4][8], const double w[3][8], double coef, double f[3][8]) {
+        for (int i = 0; i < 4; ++i) {
+            double q[3] = {0.0, 0.0, 0.0};
+            for (int A = 0; A < 8; ++A) {
+                for (int d = 0; d < 3; ++d) {
+                    q[d] += gamma[i][A] * w[d][A];
+                }
+            }
+            for (int A = 0; A < 8; ++A) {
+                const double g = coef * gamma[i][A];
+                for (int d = 0; d < 3; ++d) {
+                    f[d][A] += g * q[d];
+                }
+            }
+        }
+    }
+}
+
+HourglassControl parse_hourglass_control(const std::string& name) {
+    std::string key = name;
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (key == "viscous" || key == "fb_viscous") {
+        return HourglassControl::Viscous;
+    }
+    if (key == "stiffness" || key == "fb_stiffness") {
+        return HourglassControl::Stiffness;
+    }
+    if (key == "eas" || key == "puso") {
+        return HourglassControl::EAS;
+    }
+    return HourglassControl::None;
+}
+
+C3D8RHourglassParams get_c3d8r_hourglass_params(const entt::registry& registry, entt::entity element_entity) {
+    const auto* property_ref = registry.try_get<Component::PropertyRef>(element_entity);
+    if (property_ref == nullptr) {
+        return C3D8RHourglassParams{};
+    }
+    const auto* solid_prop = registry.try_get<Component::SolidProperty>(property_ref->property_entity);
+
+    double rho = 0.0;
+    const auto* material_ref = registry.try_get<Component::MaterialRef>(property_ref->property_entity);
+    if (material_ref != nullptr) {
+        const auto* elastic = registry.try_get<Component::LinearElasticParams>(material_ref->material_entity);
+        if (elastic != nullptr) {
+            rho = elastic->rho;
+        }
+    }
+    return get_c3d8r_hourglass_params(solid_prop, rho);
+}
+
+C3D8RHourglassParams get_c3d8r_hourglass_params(const Component::SolidProperty* solid_prop, double rho) {
+    C3D8RHourglassParams params;
+    if (solid_prop == nullptr) {
+        return params;
+    }
+    params.control = parse_hourglass_control(solid_prop->hourglass_control);
+    params.coefficient = solid_prop->hourglass_coefficient;
+    params.rho = rho;
+    return params;
+}
+
+bool add_c3d8r_hourglass_forces(const C3D8RHourglassParams& params, const Eigen::Matrix<double, 6, 6>& D,
+                                const double x0[3][8], const double x[3][8], const double u[3][8],
+                                const double v[3][8], double f[3][8]) {
+    switch (params.control) {
+        case HourglassControl::Viscous: {
+            double gamma[4][8];
+            double b_norm2 = 0.0;
+            const double VOL = fb_shape_vectors(x, gamma, b_norm2);
+            if (std::abs(VOL) < 1.0e-20 || params.rho <= 0.0 || D(0, 0) <= 0.0) {
+                return false;
+            }
+            // rho * c = sqrt(rho * (lambda + 2 mu))
+            const double rho_c = std::sqrt(params.rho * D(0, 0));
+            const double c_v = 16.0 * params.coefficient * rho_c * std::cbrt(VOL * VOL);
+            add_mode_forces(gamma, v, c_v, f);
+            return true;
+        }
+
+        case HourglassControl::Stiffness: {
+            double gamma[4][8];
+            double b_norm2 = 0.0;
+            const double VOL = fb_shape_vectors(x, gamma, b_norm2);
+            if (std::abs(VOL) < 1.0e-20) {
+                return false;
+            }
+            const double kappa = params.coefficient * D(0, 0) * b_norm2 / VOL;
+            add_mode_forces(gamma, u, kappa, f);
+            return true;
+        }
+
+        case HourglassControl::EAS: {
+            C3D8RHourglassOperator op;
+            if (!compute_c3d8r_hourglass_operator(params, D, x0, op)) {
+                return false;
+            }
+            add_c3d8r_eas_hourglass_forces(&op.gamma[0][0], &op.K[0][0][0][0], u, f);
+            return true;
+        }
+
+        case HourglassControl::None:
+        default:
+            return true;
+    }
+}
+
+void add_c3d8r_eas_hourglass_forces(const double* gamma, const double* K, const double u[3][8], double f[3][8]) {
+    // Generalized hourglass displacements q_j = sum_B Gamma(B, j) u_B
+    double q[4][3];
+    for (int j = 0; j < 4; ++j) {
+        q[j][0] = q[j][1] = q[j][2] = 0.0;
+        for (int B = 0; B < 8; ++B) {
+            const double g = gamma[8*j + B];
+            q[j][0] += g * u[0][B];
+            q[j][1] += g * u[1][B];
+            q[j][2] += g * u[2][B];
+        }
+    }
+    // Mode forces Q_i = sum_j K_ij q_j, scattered with Gamma(A, i)
+    for (int i = 0; i < 4; ++i) {
+        double Q[3] = {0.0, 0.0, 0.0};
+        for (int j = 0; j < 4; ++j) {
+            const double* K_ij = K + 36*i + 9*j;
+            for (int a = 0; a < 3; ++a) {
+                Q[a] += K_ij[3*a + 0] * q[j][0] + K_ij[3*a + 1] * q[j][1] + K_ij[3*a + 2] * q[j][2];
+            }
+        }
+        for (int A = 0; A < 8; ++A) {
+            const double g = gamma[8*i + A];
+            f[0][A] += g * Q[0];
+            f[1][A] += g * Q[1];
+            f[2][A] += g * Q[2];
+        }
+    }
+}
+
+bool compute_c3d8r_hourglass_operator(const C3D8RHourglassParams& params, const Eigen::Matrix<double, 6, 6>& D,
+                                      const double x[3][8], C3D8RHourglassOperator& op) {
+    switch (params.control) {
+        case HourglassControl::Viscous:
+        case HourglassControl::Stiffness: {
+            double b_norm2 = 0.0;
+            const double VOL = fb_shape_vectors(x, op.gamma, b_norm2);
+            if (std::abs(VOL) < 1.0e-20) {
+                return false;
+            }
+            if (params.control == HourglassControl::Viscous) {
+                if (params.rho <= 0.0 || D(0, 0) <= 0.0) {
+                    return false;
+                }
+                op.scale = 16.0 * params.coefficient * std::sqrt(params.rho * D(0, 0)) * std::cbrt(VOL * VOL);
+            } else {
+                op.scale = params.coefficient * D(0, 0) * b_norm2 / VOL;
+            }
+            return true;
+        }
+
+        case HourglassControl::EAS: {
+            Eigen::Matrix<double, 8, 3> coords;
+            for (int A = 0; A < 8; ++A) {
+                coords(A, 0) = x[0][A];
+                coords(A, 1) = x[1][A];
+                coords(A, 2) = x[2][A];
+            }
+            Eigen::Matrix<double, 8, 4> gammas;
+            Eigen::Matrix3d K_mode[4][4];
+            if (!compute_c3d8r_hourglass_modes(coords, D, gammas, K_mode)) {
+                return false;
+            }
+            for (int i = 0; i < 4; ++i) {
+                for (int A = 0; A < 8; ++A) {
+                    op.gamma[i][A] = gammas(A, i);
+                }
+                for (int j = 0; j < 4; ++j) {
+                    for (int a = 0; a < 3; ++a) {
+                        for (int b = 0; b < 3; ++b) {
+                            op.K[i][j][a][b] = K_mode[i][j](a, b);
+                        }
+                    }
+                }
+            }
+            return true;
+        }
+
+        case HourglassControl::None:
+        default:
+            return false;
+    }
+}
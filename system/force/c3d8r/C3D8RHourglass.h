@@ -0,0 +1,122 @@
+// C3D8RHourglass.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include "entt/entt.hpp"
+#include <Eigen/Dense>
+#include <string>
+#include "../../../data_center/components/property_components.h"
+
+/**
+ * @brief Hourglass control of the one-point C3D8R element (SolidProperty::hourglass_control)
+ */
+enum class HourglassControl {
+    None,       ///< "null" / "none" / "": no stabilization
+    Viscous,    ///< "viscous": Flanagan-Belytschko viscous form
+    Stiffness,  ///< "stiffness": Flanagan-Belytschko stiffness form
+    EAS         ///< "eas": Puso EAS physical stabilization (reference/vuel_unified.for)
+};
+
+/**
+ * @brief Per-element hourglass parameters resolved from the element's property and material
+ */
+struct C3D8RHourglassParams {
+    HourglassControl control = HourglassControl::None;
+    double coefficient = 0.1;  ///< QH of the Flanagan-Belytschko forms (unused by EAS)
+    double rho = 0.0;          ///< Material density (viscous form)
+    const double* eas_gamma = nullptr;      ///< EAS: precomputed Gamma of the block (32 per element) or nullptr
+    const double* eas_stiffness = nullptr;  ///< EAS: precomputed mode stiffness of the block (144 per element)
+};
+
+/**
+ * @brief Map a hourglass_control string to HourglassControl (case-insensitive)
+ * @details Unknown names map to None.
+ */
+HourglassControl parse_hourglass_control(const std::string& name);
+
+/**
+ * @brief Resolve the hourglass parameters of an element
+ * @param registry EnTT registry
+ * @param element_entity Element entity (PropertyRef -> SolidProperty / MaterialRef -> LinearElasticParams)
+ * @return Parameters; control is None if the element has no SolidProperty
+ */
+C3D8RHourglassParams get_c3d8r_hourglass_params(const entt::registry& registry, entt::entity element_entity);
+
+/**
+ * @brief Hourglass parameters from an already resolved property and density
+ * @param solid_prop SolidProperty of the element block (nullptr gives control None)
+ * @param rho Material density
+ */
+C3D8RHourglassParams get_c3d8r_hourglass_params(const Component::SolidProperty* solid_prop, double rho);
+
+/**
+ * @brief Add the hourglass resisting forces of one C3D8R element
+ * @param params Hourglass parameters of the element
+ * @param D Material matrix (D(0,0) = lambda + 2 mu is the modulus of the FB forms)
+ * @param x0 Initial nodal coordinates [direction][node]
+ * @param x Current nodal coordinates
+ * @param u Nodal displacements
+ * @param v Nodal velocities
+ * @param f Element internal force [direction][node]; the hourglass forces are added
+ * @return false if the element is degenerate (f is left unchanged)
+ * @details With Gamma_Ai = (h_Ai - (h_i . x_B) b_B(A) / V) / 8 the Flanagan-Belytschko
+ *          hourglass shape vectors (orthogonal to the linear velocity field) and
+ *          q_i = sum_A Gamma_Ai w_A the generalized hourglass mode of w:
+ *   - Viscous:   f_A += c_v sum_i Gamma_Ai q_i(v),  c_v = 16 QH rho c V^(2/3)
+ *                (the LS-DYNA type 1 coefficient QH rho c V^(2/3) / 4 on the
+ *                unscaled +-1 vectors)
+ *   - Stiffness: f_A += kappa sum_i Gamma_Ai q_i(u),  kappa = QH (lambda + 2 mu) sum_B |b_B|^2 / V
+ *                with b_B the unnormalized B-bar gradients
+ *   - EAS:       f_A += sum_i Gamma_Ai sum_j K_ij q_j(u), the condensed Puso EAS mode
+ *                stiffness of compute_c3d8r_hourglass_modes on the initial
+ *                configuration, i.e. exactly the hourglass part of the C3D8R
+ *                stiffness matrix times u (total Lagrangian, like the TL branch
+ *                of the VUEL; linear elasticity needs no stored hourglass forces)
+ */
+bool add_c3d8r_hourglass_forces(const C3D8RHourglassParams& params, const Eigen::Matrix<double, 6, 6>& D,
+                                const double x0[3][8], const double x[3][8], const double u[3][8],
+                                const double v[3][8], double f[3][8]);
+
+/**
+ * @brief Add the EAS hourglass forces of one element from its precomputed operator
+ * @param gamma Hourglass shape vectors of the element, gamma[8*i + A]
+ * @param K Mode stiffness of the element, K[36*i + 9*j + 3*a + b]
+ * @param u Nodal displacements
+ * @param f Element internal force; f_A += sum_i Gamma_Ai sum_j K_ij q_j(u)
+ * @details The EAS branch of add_c3d8r_hourglass_forces evaluates the operator on x0
+ *          and then applies it here; block kernels with C3D8RHourglassParams::eas_gamma
+ *          set skip the evaluation.
+ */
+void add_c3d8r_eas_hourglass_forces(const double* gamma, const double* K, const double u[3][8], double f[3][8]);
+
+/**
+ * @brief Hourglass operator of one C3D8R element frozen on a given configuration
+ * @details The resisting force is linear in the generalized modes q_i = sum_A gamma[i][A] w_A:
+ *            Viscous / Stiffness: f_A += scale * sum_i gamma[i][A] q_i   (w = v or u)
+ *            EAS:                 f_A += sum_i gamma[i][A] sum_j K[i][j] q_j(u)
+ */
+struct C3D8RHourglassOperator {
+    double gamma[4][8];
+    double scale = 0.0;      ///< c_v (Viscous) or kappa (Stiffness)
+    double K[4][4][3][3];    ///< EAS mode stiffness K[i][j](a, b)
+};
+
+/**
+ * @brief Evaluate the hourglass operator of add_c3d8r_hourglass_forces on one configuration
+ * @param params Hourglass parameters (control must not be None)
+ * @param D Material matrix
+ * @param x Nodal coordinates the operator is evaluated on [direction][node]
+ * @param op Output operator (gamma always, scale for the FB forms, K for EAS)
+ * @return false for None or a degenerate element
+ * @details Used by the reference-configuration cache (for small strain the operator
+ *          on the initial coordinates is reused every step) and, for EAS, by the
+ *          HourglassOperatorCache of uncached blocks.
+ */
+bool compute_c3d8r_hourglass_operator(const C3D8RHourglassParams& params, const Eigen::Matrix<double, 6, 6>& D,
+                                      const double x[3][8], C3D8RHourglassOperator& op);
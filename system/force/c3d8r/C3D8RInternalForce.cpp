@@ -10,196 +10,363 @@
 #include "../../../data_center/components/mesh_components.h"
 #include "../../../data_center/components/property_components.h"
 #include "../../../data_center/components/material_components.h"
+#include "../../../data_center/NodalState.h"
+#include "../../element/c3d8r/C3D8RGradient.h"
+#include "../../element/ElementBlock.h"
+#include "C3D8RBatchKernel.h"
+#include "C3D8RHourglass.h"
 #include <Eigen/Dense>
 #include "spdlog/spdlog.h"
 #include <cmath>
+#include <type_traits>
 
 namespace {
-    // Helper function: Calculate B-bar component (same as in C3D8RStiffnessMatrix.cpp)
-    void calc_b_bar_component(const double* y, const double* z, double* BiI) {
-        BiI[0] = -(y[1]*(z[2]+z[3]-z[4]-z[5])+y[2]*(-z[1]+z[3])
-                 +y[3]*(-z[1]-z[2]+z[4]+z[7])+y[4]*(z[1]-z[3]+z[5]-z[7])
-                 +y[5]*(z[1]-z[4])+y[7]*(-z[3]+z[4]))/12.0;
-
-        BiI[1] = (y[0]*(z[2]+z[3]-z[4]-z[5])+y[2]*(-z[0]-z[3]+z[5]+z[6])
-                 +y[3]*(-z[0]+z[2])+y[4]*(z[0]-z[5])
-                 +y[5]*(z[0]-z[2]+z[4]-z[6])+y[6]*(-z[2]+z[5]))/12.0;
-
-        BiI[2] = -(y[0]*(z[1]-z[3])+y[1]*(-z[0]-z[3]+z[5]+z[6])
-                 +y[3]*(z[0]+z[1]-z[6]-z[7])+y[5]*(-z[1]+z[6])
-                 +y[6]*(-z[1]+z[3]-z[5]+z[7])+y[7]*(z[3]-z[6]))/12.0;
-
-        BiI[3] = -(y[0]*(z[1]+z[2]-z[4]-z[7])+y[1]*(-z[0]+z[2])
-                 +y[2]*(-z[0]-z[1]+z[6]+z[7])+y[4]*(z[0]-z[7])
-                 +y[6]*(-z[2]+z[7])+y[7]*(z[0]-z[2]+z[4]-z[6]))/12.0;
+    // Element internal force from current coordinates and element displacement.
+    // Arrays are [direction][node]; the dense B matrix is never formed.
+    bool compute_element_force(const double coords[3][8], const double u[3][8],
+                               const Eigen::Matrix<double, 6, 6>& D, double f[3][8]) {
+        // Unnormalized B-bar gradients using current coordinates
+        double bx[8], by[8], bz[8];
+        const double VOL = c3d8r_gradient::calc_b_bar(coords[0], coords[1], coords[2], bx, by, bz);
+        if (std::abs(VOL) < 1.0e-20) {
+            return false;
+        }
 
-        BiI[4] = (y[0]*(z[1]-z[3]+z[5]-z[7])+y[1]*(-z[0]+z[5])
-                 +y[3]*(z[0]-z[7])+y[5]*(-z[0]-z[1]+z[6]+z[7])
-                 +y[6]*(-z[5]+z[7])+y[7]*(z[0]+z[3]-z[5]-z[6]))/12.0;
+        // strain = sum_I B_I u_I / V, stress = D * strain
+        double strain[6];
+        c3d8r_gradient::gradient_strain(bx, by, bz, u[0], u[1], u[2], strain);
+        const double inv_vol = 1.0 / VOL;
+        for (double& e : strain) {
+            e *= inv_vol;
+        }
+        double stress[6];
+        for (int r = 0; r < 6; ++r) {
+            stress[r] = 0.0;
+            for (int c = 0; c < 6; ++c) {
+                stress[r] += D(r, c) * strain[c];
+            }
+        }
 
-        BiI[5] = (y[0]*(z[1]-z[4])+y[1]*(-z[0]+z[2]-z[4]+z[6])
-                 +y[2]*(-z[1]+z[6])+y[4]*(z[0]+z[1]-z[6]-z[7])
-                 +y[6]*(-z[1]-z[2]+z[4]+z[7])+y[7]*(z[4]-z[6]))/12.0;
+        // element internal force: f_I = B_I^T * sigma * V (gradients carry V)
+        c3d8r_gradient::gradient_forces(bx, by, bz, stress, f[0], f[1], f[2]);
+        return true;
+    }
+}
 
-        BiI[6] = (y[1]*(z[2]-z[5])+y[2]*(-z[1]+z[3]-z[5]+z[7])
-                 +y[3]*(-z[2]+z[7])+y[4]*(z[5]-z[7])
-                 +y[5]*(z[1]+z[2]-z[4]-z[7])+y[7]*(-z[2]-z[3]+z[4]+z[5]))/12.0;
+bool compute_c3d8r_internal_forces(entt::registry& registry, entt::entity element_entity) {
+    const Eigen::Matrix<double, 6, 6>* D = find_material_matrix(registry, element_entity);
+    if (D == nullptr) {
+        return false;
+    }
+    return compute_c3d8r_internal_forces(registry, element_entity, *D,
+                                         get_c3d8r_hourglass_params(registry, element_entity));
+}
 
-        BiI[7] = -(y[0]*(z[3]-z[4])+y[2]*(-z[3]+z[6])
-                 +y[3]*(-z[0]+z[2]-z[4]+z[6])+y[4]*(z[0]+z[3]-z[5]-z[6])
-                 +y[5]*(z[4]-z[6])+y[6]*(-z[2]-z[3]+z[4]+z[5]))/12.0;
+bool compute_c3d8r_internal_forces(entt::registry& registry, entt::entity element_entity,
+                                   const Eigen::Matrix<double, 6, 6>& D, const C3D8RHourglassParams& hourglass) {
+    if (!registry.all_of<Component::Connectivity, Component::ElementType>(element_entity)) {
+        return false;
     }
 
-    double calc_vol_bbar(const double* BiI, const double* X) {
-        double V = 0.0;
-        for (int i = 0; i < 8; ++i) {
-            V += X[i] * BiI[i];
-        }
-        return V;
+    const auto& connectivity = registry.get<Component::Connectivity>(element_entity);
+    if (connectivity.nodes.size() != 8) {
+        return false;
     }
 
-    Eigen::Matrix<double, 6, 24> form_b_matrix(const Eigen::Matrix<double, 8, 3>& BiI) {
-        Eigen::Matrix<double, 6, 24> B = Eigen::Matrix<double, 6, 24>::Zero();
+    // Get current/initial coordinates, displacement (current - initial) and velocity
+    double coords_current[3][8];
+    double coords_initial[3][8];
+    double u_e[3][8];
+    double v_e[3][8];
 
-        for (int K = 0; K < 8; ++K) {
-            B(0, 3*K + 0) = BiI(K, 0);  // XX
-            B(1, 3*K + 1) = BiI(K, 1);  // YY
-            B(2, 3*K + 2) = BiI(K, 2);  // ZZ
+    for (size_t i = 0; i < 8; ++i) {
+        entt::entity node_entity = connectivity.nodes[i];
 
-            // XY
-            B(3, 3*K + 0) = BiI(K, 1);
-            B(3, 3*K + 1) = BiI(K, 0);
+        if (!registry.all_of<Component::Position>(node_entity)) {
+            return false;
+        }
 
-            // YZ
-            B(4, 3*K + 1) = BiI(K, 2);
-            B(4, 3*K + 2) = BiI(K, 1);
+        const auto& pos = registry.get<Component::Position>(node_entity);
+        coords_current[0][i] = pos.x;
+        coords_current[1][i] = pos.y;
+        coords_current[2][i] = pos.z;
 
-            // XZ
-            B(5, 3*K + 0) = BiI(K, 2);
-            B(5, 3*K + 2) = BiI(K, 0);
+        if (registry.all_of<Component::InitialPosition>(node_entity)) {
+            const auto& pos0 = registry.get<Component::InitialPosition>(node_entity);
+            coords_initial[0][i] = pos0.x0;
+            coords_initial[1][i] = pos0.y0;
+            coords_initial[2][i] = pos0.z0;
+        } else {
+            coords_initial[0][i] = pos.x;
+            coords_initial[1][i] = pos.y;
+            coords_initial[2][i] = pos.z;
+        }
+        for (int d = 0; d < 3; ++d) {
+            u_e[d][i] = coords_current[d][i] - coords_initial[d][i];
         }
 
-        return B;
+        if (const auto* vel = registry.try_get<Component::Velocity>(node_entity)) {
+            v_e[0][i] = vel->vx;
+            v_e[1][i] = vel->vy;
+            v_e[2][i] = vel->vz;
+        } else {
+            v_e[0][i] = 0.0;
+            v_e[1][i] = 0.0;
+            v_e[2][i] = 0.0;
+        }
     }
-}
 
-bool compute_c3d8r_internal_forces(entt::registry& registry, entt::entity element_entity) {
-    if (!registry.all_of<Component::Connectivity, Component::ElementType>(element_entity)) {
+    double f_element[3][8];
+    if (!compute_element_force(coords_current, u_e, D, f_element)) {
         return false;
     }
+    add_c3d8r_hourglass_forces(hourglass, D, coords_initial, coords_current, u_e, v_e, f_element);
 
-    const auto& connectivity = registry.get<Component::Connectivity>(element_entity);
-    if (connectivity.nodes.size() != 8) {
-        return false;
-    }
+    // Scatter to nodes
+    for (size_t i = 0; i < 8; ++i) {
+        entt::entity node_entity = connectivity.nodes[i];
+        if (!registry.all_of<Component::InternalForce>(node_entity)) {
+            registry.emplace<Component::InternalForce>(node_entity, 0.0, 0.0, 0.0);
+        }
 
-    // Get material D matrix
-    if (!registry.all_of<Component::PropertyRef>(element_entity)) {
-        return false;
+        auto& internal_force = registry.get<Component::InternalForce>(node_entity);
+        internal_force.fx += f_element[0][i];
+        internal_force.fy += f_element[1][i];
+        internal_force.fz += f_element[2][i];
     }
 
-    const auto& property_ref = registry.get<Component::PropertyRef>(element_entity);
-    entt::entity property_entity = property_ref.property_entity;
+    return true;
+}
 
-    if (!registry.all_of<Component::MaterialRef>(property_entity)) {
+bool compute_c3d8r_internal_forces(const entt::registry& registry, entt::entity element_entity, NodalState& state) {
+    if (!registry.all_of<Component::Connectivity, Component::ElementType>(element_entity)) {
         return false;
     }
 
-    const auto& material_ref = registry.get<Component::MaterialRef>(property_entity);
-    entt::entity material_entity = material_ref.material_entity;
-
-    if (!registry.all_of<Component::LinearElasticMatrix>(material_entity)) {
+    const auto& connectivity = registry.get<Component::Connectivity>(element_entity);
+    if (connectivity.nodes.size() != 8) {
         return false;
     }
 
-    const auto& material_matrix = registry.get<Component::LinearElasticMatrix>(material_entity);
-    if (!material_matrix.is_initialized) {
+    const Eigen::Matrix<double, 6, 6>* D = find_material_matrix(registry, element_entity);
+    if (D == nullptr) {
         return false;
     }
 
-    const Eigen::Matrix<double, 6, 6>& D = material_matrix.D;
-
-    // Get current and initial node coordinates
-    Eigen::Matrix<double, 8, 3> coords_current;
-    Eigen::Matrix<double, 8, 3> coords_initial;
-
-    for (size_t i = 0; i < 8; ++i) {
-        entt::entity node_entity = connectivity.nodes[i];
+    const C3D8RHourglassParams hourglass = get_c3d8r_hourglass_params(registry, element_entity);
 
-        if (!registry.all_of<Component::Position>(node_entity)) {
+    // Gather coordinates, displacement (current - initial) and velocity from the state block
+    int node_index[8];
+    double coords_current[3][8];
+    double coords_initial[3][8];
+    double u_e[3][8];
+    double v_e[3][8];
+    for (int i = 0; i < 8; ++i) {
+        node_index[i] = state.index_of(connectivity.nodes[i]);
+        if (node_index[i] < 0) {
             return false;
         }
-
-        const auto& pos = registry.get<Component::Position>(node_entity);
-        coords_current(i, 0) = pos.x;
-        coords_current(i, 1) = pos.y;
-        coords_current(i, 2) = pos.z;
-
-        if (registry.all_of<Component::InitialPosition>(node_entity)) {
-            const auto& pos0 = registry.get<Component::InitialPosition>(node_entity);
-            coords_initial(i, 0) = pos0.x0;
-            coords_initial(i, 1) = pos0.y0;
-            coords_initial(i, 2) = pos0.z0;
-        } else {
-            coords_initial(i, 0) = pos.x;
-            coords_initial(i, 1) = pos.y;
-            coords_initial(i, 2) = pos.z;
+        const size_t n = static_cast<size_t>(node_index[i]);
+        for (int d = 0; d < 3; ++d) {
+            coords_current[d][i] = state.x[3*n + d];
+            coords_initial[d][i] = state.x0[3*n + d];
+            u_e[d][i] = state.x[3*n + d] - state.x0[3*n + d];
+            v_e[d][i] = state.v[3*n + d];
         }
     }
 
-    // Displacement vector (current - initial)
-    Eigen::Matrix<double, 24, 1> u_e;
-    for (int i = 0; i < 8; ++i) {
-        u_e(3*i + 0) = coords_current(i, 0) - coords_initial(i, 0);
-        u_e(3*i + 1) = coords_current(i, 1) - coords_initial(i, 1);
-        u_e(3*i + 2) = coords_current(i, 2) - coords_initial(i, 2);
+    double f_element[3][8];
+    if (!compute_element_force(coords_current, u_e, *D, f_element)) {
+        return false;
     }
+    add_c3d8r_hourglass_forces(hourglass, *D, coords_initial, coords_current, u_e, v_e, f_element);
 
-    // B-bar matrix using current coordinates
-    Eigen::Matrix<double, 8, 3> BiI;
-    double x[8], y[8], z[8];
+    // Scatter to the state block
     for (int i = 0; i < 8; ++i) {
-        x[i] = coords_current(i, 0);
-        y[i] = coords_current(i, 1);
-        z[i] = coords_current(i, 2);
+        const size_t n = static_cast<size_t>(node_index[i]);
+        state.f_int[3*n + 0] += f_element[0][i];
+        state.f_int[3*n + 1] += f_element[1][i];
+        state.f_int[3*n + 2] += f_element[2][i];
     }
 
-    calc_b_bar_component(y, z, BiI.data() + 0*8);  // x component
-    calc_b_bar_component(z, x, BiI.data() + 1*8);  // y component
-    calc_b_bar_component(x, y, BiI.data() + 2*8);  // z component
+    return true;
+}
 
-    // Element volume
-    double VOL = calc_vol_bbar(BiI.data() + 0*8, x);
-    if (std::abs(VOL) < 1.0e-20) {
-        return false;
+namespace {
+    // Hourglass forces of the element in block slot `slot`: the block's precomputed EAS
+    // operator when there is one, otherwise add_c3d8r_hourglass_forces evaluates it
+    void add_block_hourglass_forces(const C3D8RHourglassParams& hourglass, const Eigen::Matrix<double, 6, 6>& D,
+                                    uint32_t slot, const double x0[3][8], const double x[3][8],
+                                    const double u[3][8], const double v[3][8], double f[3][8]) {
+        if (hourglass.control == HourglassControl::EAS && hourglass.eas_gamma != nullptr) {
+            add_c3d8r_eas_hourglass_forces(hourglass.eas_gamma + 32 * static_cast<size_t>(slot),
+                                           hourglass.eas_stiffness + 144 * static_cast<size_t>(slot), u, f);
+            return;
+        }
+        add_c3d8r_hourglass_forces(hourglass, D, x0, x, u, v, f);
     }
 
-    // Normalize B-bar matrix
-    BiI /= VOL;
-
-    // B matrix (6x24)
-    Eigen::Matrix<double, 6, 24> B = form_b_matrix(BiI);
-
-    // strain and stress
-    Eigen::Matrix<double, 6, 1> strain = B * u_e;
-    Eigen::Matrix<double, 6, 1> stress = D * strain;
+    // Shared batch loop on one block: D and the hourglass parameters are resolved once
+    // by the caller and the material columns of the batch are filled once. Real = float
+    // runs the element kernel in single precision on twice the lanes; the hourglass
+    // term, energies and the scatter into f_int stay in double.
+    template <typename Real = double>
+    size_t compute_batched(const ConnectivityBlock& block, const uint32_t* slots, size_t count,
+                           const Eigen::Matrix<double, 6, 6>& D, const C3D8RHourglassParams& hourglass,
+                           NodalState& state, ElementEnergy* energy) {
+        constexpr bool single = std::is_same_v<Real, float>;
+        constexpr int W = single ? kSimdLanesFloat : kSimdLanes;
+        C3D8RElementBatch<W, Real> batch;
+        const uint32_t* node_index[W];
+        uint32_t lane_slot[W];
+        size_t computed = 0;
+
+        if (block.nodes_per_element != 8) {
+            return 0;
+        }
 
-    // element internal force: f_int = B^T * sigma * V
-    Eigen::Matrix<double, 24, 1> f_element = B.transpose() * stress * VOL;
+        for (int l = 0; l < W; ++l) {
+            for (int r = 0; r < 6; ++r) {
+                for (int c = 0; c < 6; ++c) {
+                    batch.D[6*r + c][l] = static_cast<Real>(D(r, c));
+                }
+            }
+        }
 
-    // Scatter to nodes
-    for (size_t i = 0; i < 8; ++i) {
-        entt::entity node_entity = connectivity.nodes[i];
-        if (!registry.all_of<Component::InternalForce>(node_entity)) {
-            registry.emplace<Component::InternalForce>(node_entity, 0.0, 0.0, 0.0);
+        size_t k = 0;
+        while (k < count) {
+            // 1. Gather up to W elements into the lanes
+            int lanes = 0;
+            while (lanes < W && k < count) {
+                const uint32_t slot = slots[k++];
+                lane_slot[lanes] = slot;
+                node_index[lanes] = block.nodes_of(slot);
+                // In single precision the coordinates are taken relative to the first node
+                // (in double): the gradients are translation invariant and the element size,
+                // not the distance to the origin, then sets the rounding error
+                double origin[3] = {0.0, 0.0, 0.0};
+                if constexpr (single) {
+                    const size_t n0 = node_index[lanes][0];
+                    for (int d = 0; d < 3; ++d) {
+                        origin[d] = state.x[3*n0 + d];
+                    }
+                }
+                for (int i = 0; i < 8; ++i) {
+                    const size_t n = node_index[lanes][i];
+                    for (int d = 0; d < 3; ++d) {
+                        batch.x[d][i][lanes] = static_cast<Real>(state.x[3*n + d] - origin[d]);
+                        batch.u[d][i][lanes] = static_cast<Real>(state.x[3*n + d] - state.x0[3*n + d]);
+                    }
+                }
+                lanes++;
+            }
+            if (lanes == 0) {
+                break;
+            }
+
+            // 2. Pad unused lanes with a copy of lane 0 (results are discarded)
+            for (int l = lanes; l < W; ++l) {
+                for (int d = 0; d < 3; ++d) {
+                    for (int i = 0; i < 8; ++i) {
+                        batch.x[d][i][l] = batch.x[d][i][0];
+                        batch.u[d][i][l] = batch.u[d][i][0];
+                    }
+                }
+            }
+
+            // 3. Lane-parallel kernel
+            compute_c3d8r_internal_force_batch<W, Real>(batch);
+
+            // 4. Scatter lanes with a valid volume (hourglass forces are added per lane)
+            for (int l = 0; l < lanes; ++l) {
+                if (std::abs(batch.vol[l]) < 1.0e-20) {
+                    continue;
+                }
+                double f_element[3][8];
+                for (int d = 0; d < 3; ++d) {
+                    for (int i = 0; i < 8; ++i) {
+                        f_element[d][i] = static_cast<double>(batch.f[d][i][l]);
+                    }
+                }
+                // Strain energy 1/2 f.u (the force is linear in u)
+                double f_dot_u = 0.0;
+                if (energy != nullptr) {
+                    for (int i = 0; i < 8; ++i) {
+                        const size_t n = node_index[l][i];
+                        for (int d = 0; d < 3; ++d) {
+                            f_dot_u += f_element[d][i] * (state.x[3*n + d] - state.x0[3*n + d]);
+                        }
+                    }
+                    energy->strain += 0.5 * f_dot_u;
+                }
+                if (hourglass.control != HourglassControl::None) {
+                    double coords_current[3][8], coords_initial[3][8], u_e[3][8], v_e[3][8];
+                    for (int i = 0; i < 8; ++i) {
+                        const size_t n = node_index[l][i];
+                        for (int d = 0; d < 3; ++d) {
+                            coords_current[d][i] = state.x[3*n + d];
+                            coords_initial[d][i] = state.x0[3*n + d];
+                            u_e[d][i] = state.x[3*n + d] - state.x0[3*n + d];
+                            v_e[d][i] = state.v[3*n + d];
+                        }
+                    }
+                    if (energy == nullptr) {
+                        add_block_hourglass_forces(hourglass, D, lane_slot[l], coords_initial, coords_current,
+                                                   u_e, v_e, f_element);
+                    } else {
+                        double f_hg[3][8] = {};
+                        add_block_hourglass_forces(hourglass, D, lane_slot[l], coords_initial, coords_current,
+                                                   u_e, v_e, f_hg);
+                        const bool viscous = (hourglass.control == HourglassControl::Viscous);
+                        double work = 0.0;
+                        for (int d = 0; d < 3; ++d) {
+                            for (int i = 0; i < 8; ++i) {
+                                f_element[d][i] += f_hg[d][i];
+                                work += f_hg[d][i] * (viscous ? v_e[d][i] : u_e[d][i]);
+                            }
+                        }
+                        if (viscous) {
+                            energy->hourglass_power += work;
+                        } else {
+                            energy->hourglass += 0.5 * work;
+                        }
+                    }
+                }
+                for (int i = 0; i < 8; ++i) {
+                    const size_t n = node_index[l][i];
+                    state.f_int[3*n + 0] += f_element[0][i];
+                    state.f_int[3*n + 1] += f_element[1][i];
+                    state.f_int[3*n + 2] += f_element[2][i];
+                }
+                computed++;
+            }
         }
 
-        auto& internal_force = registry.get<Component::InternalForce>(node_entity);
-        internal_force.fx += f_element(3*i + 0);
-        internal_force.fy += f_element(3*i + 1);
-        internal_force.fz += f_element(3*i + 2);
+        return computed;
+    }
+}
+
+size_t compute_c3d8r_internal_forces_batched(const entt::registry& registry, const ConnectivityBlock& block,
+                                             const uint32_t* slots, size_t count, NodalState& state) {
+    // Blocks are homogeneous in property and material: resolve them once for the span
+    const ElementBlockData data = resolve_element_block(registry, block);
+    if (data.D == nullptr) {
+        return 0;
     }
+    return compute_batched(block, slots, count, *data.D, get_c3d8r_hourglass_params(data.solid, data.rho),
+                           state, nullptr);
+}
 
-    return true;
+size_t compute_c3d8r_internal_forces_batched(const ConnectivityBlock& block, const uint32_t* slots, size_t count,
+                                             const Eigen::Matrix<double, 6, 6>& D,
+                                             const C3D8RHourglassParams& hourglass, NodalState& state,
+                                             ElementEnergy* energy) {
+    return compute_batched(block, slots, count, D, hourglass, state, energy);
 }
 
+size_t compute_c3d8r_internal_forces_mixed(const ConnectivityBlock& block, const uint32_t* slots, size_t count,
+                                           const Eigen::Matrix<double, 6, 6>& D,
+                                           const C3D8RHourglassParams& hourglass, NodalState& state,
+                                           ElementEnergy* energy) {
+    return compute_batched<float>(block, slots, count, D, hourglass, state, energy);
+}
@@ -9,6 +9,11 @@
 #pragma once
 
 #include "entt/entt.hpp"
+#include "../../../data_center/NodalState.h"
+#include "../../../data_center/ConnectivityStore.h"
+#include "../../../data_center/EnergyBalance.h"
+#include "C3D8RHourglass.h"
+#include <Eigen/Dense>
 
 /**
  * @brief Compute and scatter internal forces for a single C3D8R element
@@ -20,6 +25,80 @@
  *   - Reads material D matrix from LinearElasticMatrix (via PropertyRef -> MaterialRef)
  *   - Computes B-bar at current configuration (reduced integration)
  *   - Computes element internal force vector and accumulates into node InternalForce
+ *   - Adds the hourglass resisting forces selected by SolidProperty::hourglass_control
+ *     (add_c3d8r_hourglass_forces; the viscous form reads the optional Velocity)
  */
 bool compute_c3d8r_internal_forces(entt::registry& registry, entt::entity element_entity);
 
+/**
+ * @brief Component based C3D8R element with the material and hourglass parameters already resolved
+ * @param D Material matrix of the element's block
+ * @param hourglass Hourglass parameters of the element's block
+ * @details Block loops resolve D and the hourglass parameters once per block
+ *          (resolve_element_block) instead of walking PropertyRef -> MaterialRef
+ *          for every element.
+ */
+bool compute_c3d8r_internal_forces(entt::registry& registry, entt::entity element_entity,
+                                   const Eigen::Matrix<double, 6, 6>& D, const C3D8RHourglassParams& hourglass);
+
+
+/**
+ * @brief Compute a single C3D8R element and scatter into the nodal state block
+ * @param registry EnTT registry (element connectivity and material only)
+ * @param element_entity Element entity to process
+ * @param state Nodal state providing coordinates and receiving internal forces
+ * @return true if computed successfully, false otherwise
+ * @details Same kernel as the component based overload; node data is read from
+ *          NodalState::x / x0 / v and accumulated into NodalState::f_int.
+ */
+bool compute_c3d8r_internal_forces(const entt::registry& registry, entt::entity element_entity, NodalState& state);
+
+/**
+ * @brief Compute C3D8R elements in SIMD batches and scatter into the nodal state block
+ * @param registry EnTT registry (block property and material only)
+ * @param block Connectivity block of C3D8R elements (type 308, 8 nodes per element)
+ * @param slots Block-local indices of the elements to process (reduced integration)
+ * @param count Number of elements
+ * @param state Nodal state providing coordinates and receiving internal forces
+ * @return Number of elements computed successfully
+ * @details Elements are gathered kSimdLanes at a time into a C3D8RElementBatch and
+ *          evaluated by compute_c3d8r_internal_force_batch. Node indices come straight
+ *          from the block (same numbering as the state); D and the hourglass
+ *          parameters are resolved once for the block. Hourglass forces are added
+ *          per lane before scattering. Scattering is serial within the call, so the
+ *          span may contain elements sharing nodes.
+ */
+size_t compute_c3d8r_internal_forces_batched(const entt::registry& registry, const ConnectivityBlock& block,
+                                             const uint32_t* slots, size_t count, NodalState& state);
+
+/**
+ * @brief Block-material variant of compute_c3d8r_internal_forces_batched
+ * @param block Connectivity block of C3D8R elements sharing one property and material
+ * @param slots Block-local indices of the elements to process
+ * @param count Number of elements
+ * @param D Material matrix of the block
+ * @param hourglass Hourglass parameters of the block
+ * @param state Nodal state providing coordinates and receiving internal forces
+ * @param energy Optional energy sink; strain / hourglass energies are added when not null
+ * @return Number of elements computed successfully
+ * @details No registry access: the material columns of the batch are filled once
+ *          and the element loop only gathers coordinates. With hourglass.eas_gamma
+ *          set the EAS forces use the precomputed operator of the block slot.
+ */
+size_t compute_c3d8r_internal_forces_batched(const ConnectivityBlock& block, const uint32_t* slots, size_t count,
+                                             const Eigen::Matrix<double, 6, 6>& D,
+                                             const C3D8RHourglassParams& hourglass, NodalState& state,
+                                             ElementEnergy* energy = nullptr);
+
+/**
+ * @brief Mixed-precision variant of the block-material compute_c3d8r_internal_forces_batched
+ * @details Coordinates (relative to the first node of each element), displacements
+ *          and D are rounded to float and the element kernel runs in float32 on
+ *          kSimdLanesFloat lanes. The hourglass term, the energies and the
+ *          accumulation into NodalState::f_int are evaluated in double, so nodal
+ *          quantities do not drift. See KernelPrecision::Mixed.
+ */
+size_t compute_c3d8r_internal_forces_mixed(const ConnectivityBlock& block, const uint32_t* slots, size_t count,
+                                           const Eigen::Matrix<double, 6, 6>& D,
+                                           const C3D8RHourglassParams& hourglass, NodalState& state,
+                                           ElementEnergy* energy = nullptr);
@@ -0,0 +1,166 @@
+// C3D8RReferenceForce.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "C3D8RReferenceForce.h"
+#include "../../element/c3d8r/C3D8RGradient.h"
+
+namespace {
+    template <typename Real>
+    size_t compute_cached(const ConnectivityBlock& block, const ReferenceElementBlock& cache,
+                          const ReferenceElementFields<Real>& fields, const uint32_t* slots, size_t count,
+                          NodalState& state, ElementEnergy* energy) {
+        const Eigen::Matrix<double, 6, 6>& D = *cache.D;
+        const ReferenceHourglassTerm hourglass = cache.hourglass;
+        size_t computed = 0;
+
+        for (size_t s = 0; s < count; ++s) {
+            const uint32_t k = slots[s];
+            const double inv_vol = cache.inv_volume[k];
+            if (inv_vol == 0.0) {
+                continue;
+            }
+
+            // 1. Gather displacement (and velocity for the viscous hourglass term)
+            const uint32_t* nodes = block.nodes_of(k);
+            double u_e[3][8];
+            for (int i = 0; i < 8; ++i) {
+                const size_t n = nodes[i];
+                for (int d = 0; d < 3; ++d) {
+                    u_e[d][i] = state.x[3*n + d] - state.x0[3*n + d];
+                }
+            }
+
+            // 2. Cached gradients (widened to double), strain, stress and B^T sigma
+            double b[3][8];
+            const Real* g = fields.gradients.data() + 24 * static_cast<size_t>(k);
+            for (int d = 0; d < 3; ++d) {
+                for (int i = 0; i < 8; ++i) {
+                    b[d][i] = static_cast<double>(g[8*d + i]);
+                }
+            }
+            double strain[6];
+            c3d8r_gradient::gradient_strain(b[0], b[1], b[2], u_e[0], u_e[1], u_e[2], strain);
+            double stress[6];
+            for (int r = 0; r < 6; ++r) {
+                double sum = 0.0;
+                for (int c = 0; c < 6; ++c) {
+                    sum += D(r, c) * strain[c];
+                }
+                stress[r] = sum * inv_vol;
+            }
+            double f_element[3][8];
+            c3d8r_gradient::gradient_forces(b[0], b[1], b[2], stress, f_element[0], f_element[1], f_element[2]);
+            if (energy != nullptr) {
+                double f_dot_u = 0.0;
+                for (int d = 0; d < 3; ++d) {
+                    for (int i = 0; i < 8; ++i) {
+                        f_dot_u += f_element[d][i] * u_e[d][i];
+                    }
+                }
+                energy->strain += 0.5 * f_dot_u;
+            }
+
+            // 3. Linear hourglass term on the cached modes
+            if (hourglass != ReferenceHourglassTerm::None) {
+                double w[3][8];
+                if (hourglass == ReferenceHourglassTerm::ScalarOnVel) {
+                    for (int i = 0; i < 8; ++i) {
+                        const size_t n = nodes[i];
+                        for (int d = 0; d < 3; ++d) {
+                            w[d][i] = state.v[3*n + d];
+                        }
+                    }
+                } else {
+                    for (int d = 0; d < 3; ++d) {
+                        for (int i = 0; i < 8; ++i) {
+                            w[d][i] = u_e[d][i];
+                        }
+                    }
+                }
+
+                const Real* gamma = fields.hourglass_gamma.data() + 32 * static_cast<size_t>(k);
+                double q[4][3];
+                for (int m = 0; m < 4; ++m) {
+                    for (int d = 0; d < 3; ++d) {
+                        double sum = 0.0;
+                        for (int i = 0; i < 8; ++i) {
+                            sum += static_cast<double>(gamma[8*m + i]) * w[d][i];
+                        }
+                        q[m][d] = sum;
+                    }
+                }
+
+                double Q[4][3];
+                if (hourglass == ReferenceHourglassTerm::ModeMatrix) {
+                    const Real* K = fields.hourglass_stiffness.data() + 144 * static_cast<size_t>(k);
+                    for (int m = 0; m < 4; ++m) {
+                        for (int a = 0; a < 3; ++a) {
+                            double sum = 0.0;
+                            for (int j = 0; j < 4; ++j) {
+                                for (int c = 0; c < 3; ++c) {
+                                    sum += static_cast<double>(K[36*m + 9*j + 3*a + c]) * q[j][c];
+                                }
+                            }
+                            Q[m][a] = sum;
+                        }
+                    }
+                } else {
+                    const double scale = cache.hourglass_scale[k];
+                    for (int m = 0; m < 4; ++m) {
+                        for (int d = 0; d < 3; ++d) {
+                            Q[m][d] = scale * q[m][d];
+                        }
+                    }
+                }
+
+                // f_hg . w = sum_m Q_m . q_m
+                if (energy != nullptr) {
+                    double work = 0.0;
+                    for (int m = 0; m < 4; ++m) {
+                        work += Q[m][0] * q[m][0] + Q[m][1] * q[m][1] + Q[m][2] * q[m][2];
+                    }
+                    if (hourglass == ReferenceHourglassTerm::ScalarOnVel) {
+                        energy->hourglass_power += work;
+                    } else {
+                        energy->hourglass += 0.5 * work;
+                    }
+                }
+                for (int m = 0; m < 4; ++m) {
+                    for (int i = 0; i < 8; ++i) {
+                        const double gm = static_cast<double>(gamma[8*m + i]);
+                        f_element[0][i] += gm * Q[m][0];
+                        f_element[1][i] += gm * Q[m][1];
+                        f_element[2][i] += gm * Q[m][2];
+                    }
+                }
+            }
+
+            // 4. Scatter
+            for (int i = 0; i < 8; ++i) {
+                const size_t n = nodes[i];
+                state.f_int[3*n + 0] += f_element[0][i];
+                state.f_int[3*n + 1] += f_element[1][i];
+                state.f_int[3*n + 2] += f_element[2][i];
+            }
+            computed++;
+        }
+        return computed;
+    }
+}
+
+size_t compute_c3d8r_internal_forces_cached(const ConnectivityBlock& block, const ReferenceElementBlock& cache,
+                                            const uint32_t* slots, size_t count, NodalState& state,
+                                            ElementEnergy* energy) {
+    if (!cache.cached || cache.D == nullptr || block.nodes_per_element != 8) {
+        return 0;
+    }
+    if (!cache.fp32.gradients.empty()) {
+        return compute_cached(block, cache, cache.fp32, slots, count, state, energy);
+    }
+    return compute_cached(block, cache, cache.fp64, slots, count, state, energy);
+}
@@ -0,0 +1,34 @@
+// C3D8RReferenceForce.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "../../../data_center/NodalState.h"
+#include "../../../data_center/ConnectivityStore.h"
+#include "../../../data_center/ReferenceElementCache.h"
+#include "../../../data_center/EnergyBalance.h"
+
+/**
+ * @brief Compute C3D8R elements from the reference-configuration cache and scatter into the nodal state block
+ * @param block Connectivity block of C3D8R elements
+ * @param cache Cached reference data of the same block (ReferenceElementBlock::cached must be true)
+ * @param slots Block-local indices of the elements to process
+ * @param count Number of elements
+ * @param state Nodal state providing x, x0 (and v for viscous hourglass) and receiving f_int
+ * @param energy Optional energy sink; strain / hourglass energies are added when not null
+ * @return Number of elements computed
+ * @details Per element: gather u = x - x0, strain = sum_I b_I u_I / V0, stress = D strain,
+ *          f_I = b_I^T stress, plus the cached linear hourglass term. No gradient
+ *          evaluation and no registry access. The stored precision of the cache
+ *          (double or float) is selected once per call; arithmetic is double.
+ */
+size_t compute_c3d8r_internal_forces_cached(const ConnectivityBlock& block, const ReferenceElementBlock& cache,
+                                            const uint32_t* slots, size_t count, NodalState& state,
+                                            ElementEnergy* energy = nullptr);
@@ -10,9 +10,10 @@
 #include "../../data_center/components/mesh_components.h"
 #include "../../data_center/components/load_components.h"
 #include "../curve/CurveSystem.h"
+#include "../dof/DofMask.h"
 #include "spdlog/spdlog.h"
 #include <algorithm>
-#include <cctype>
+#include <unordered_map>
 
 void LoadSystem::reset_external_forces(entt::registry& registry) {
     auto node_view = registry.view<Component::ExternalForce>();
@@ -60,35 +61,16 @@ void LoadSystem::apply_nodal_loads(entt::registry& registry, double t) {
             // Calculate scaled load value
             const double scaled_value = nodal_load.value * scale_factor;
 
-            // Convert dof string to lowercase for comparison
-            std::string dof = nodal_load.dof;
-            std::transform(dof.begin(), dof.end(), dof.begin(), ::tolower);
-
             // Apply load based on DOF specification
-            if (dof == "all" || dof == "xyz") {
-                external_force.fx += scaled_value;
-                external_force.fy += scaled_value;
-                external_force.fz += scaled_value;
-            } else if (dof == "x") {
-                external_force.fx += scaled_value;
-            } else if (dof == "y") {
-                external_force.fy += scaled_value;
-            } else if (dof == "z") {
-                external_force.fz += scaled_value;
-            } else if (dof == "xy" || dof == "yx") {
-                external_force.fx += scaled_value;
-                external_force.fy += scaled_value;
-            } else if (dof == "xz" || dof == "zx") {
-                external_force.fx += scaled_value;
-                external_force.fz += scaled_value;
-            } else if (dof == "yz" || dof == "zy") {
-                external_force.fy += scaled_value;
-                external_force.fz += scaled_value;
-            } else {
+            const uint8_t mask = DofMask::from_string(nodal_load.dof);
+            if (mask == 0) {
                 // Current explicit solver applies translational forces only.
                 // Rotational dofs (rx/ry/rz) are ignored here.
                 continue;
             }
+            if (DofMask::has(mask, 0)) external_force.fx += scaled_value;
+            if (DofMask::has(mask, 1)) external_force.fy += scaled_value;
+            if (DofMask::has(mask, 2)) external_force.fz += scaled_value;
 
             load_count++;
         }
@@ -98,3 +80,115 @@ void LoadSystem::apply_nodal_loads(entt::registry& registry, double t) {
         spdlog::debug("Applied {} nodal loads at time {:.6e}.", load_count, t);
     }
 }
+
+LoadProgram& LoadSystem::compile_nodal_loads(entt::registry& registry, const NodalState& state) {
+    LoadProgram* program_ptr = nullptr;
+    if (registry.ctx().contains<LoadProgram>()) {
+        program_ptr = &registry.ctx().get<LoadProgram>();
+        program_ptr->clear();
+    } else {
+        program_ptr = &registry.ctx().emplace<LoadProgram>();
+    }
+    auto& program = *program_ptr;
+
+    // Slot 0: loads without a curve (constant scale 1.0)
+    program.curve_entities.push_back(entt::null);
+    program.curves.emplace_back();
+    std::unordered_map<entt::entity, uint32_t> curve_slot_of;
+
+    size_t ignored_loads = 0;
+    auto node_view = registry.view<Component::AppliedLoadRef>();
+    for (auto node_entity : node_view) {
+        const int i = state.index_of(node_entity);
+        if (i < 0) {
+            continue;
+        }
+
+        const auto& load_ref = registry.get<Component::AppliedLoadRef>(node_entity);
+        for (const auto load_entity : load_ref.load_entities) {
+            if (!registry.valid(load_entity) || !registry.all_of<Component::NodalLoad>(load_entity)) {
+                spdlog::warn("Load entity missing NodalLoad component. Skipping.");
+                continue;
+            }
+
+            const auto& nodal_load = registry.get<Component::NodalLoad>(load_entity);
+            const uint8_t mask = DofMask::from_string(nodal_load.dof);
+            if (mask == 0) {
+                // Current explicit solver applies translational forces only.
+                // Rotational dofs (rx/ry/rz) are ignored here.
+                ignored_loads++;
+                continue;
+            }
+
+            uint32_t slot = 0;
+            if (registry.all_of<Component::CurveRef>(load_entity)) {
+                const entt::entity curve_entity = registry.get<Component::CurveRef>(load_entity).curve_entity;
+                auto it = curve_slot_of.find(curve_entity);
+                if (it != curve_slot_of.end()) {
+                    slot = it->second;
+                } else if (registry.valid(curve_entity) && registry.all_of<Component::Curve>(curve_entity)) {
+                    slot = static_cast<uint32_t>(program.curves.size());
+                    program.curve_entities.push_back(curve_entity);
+                    program.curves.push_back(registry.get<Component::Curve>(curve_entity));
+                    curve_slot_of.emplace(curve_entity, slot);
+                } else {
+                    spdlog::warn("Curve entity missing Curve component. Using scale 1.0.");
+                }
+            }
+
+            program.records.push_back({static_cast<uint32_t>(i), mask, slot, nodal_load.value});
+        }
+    }
+
+    program.slot_values.assign(program.curves.size(), 1.0);
+
+    spdlog::info("LoadSystem: Compiled {} nodal load records using {} curves.",
+                 program.records.size(), program.curves.size() - 1);
+    if (ignored_loads > 0) {
+        spdlog::debug("LoadSystem: Ignored {} non-translational nodal loads.", ignored_loads);
+    }
+
+    return program;
+}
+
+void LoadSystem::apply_nodal_loads(LoadProgram& program, NodalState& state, double t) {
+    // 1. Evaluate every distinct curve once (slot 0 stays 1.0)
+    for (size_t slot = 1; slot < program.curves.size(); ++slot) {
+        program.slot_values[slot] = CurveSystem::evaluate_curve(program.curves[slot], t);
+    }
+
+    // 2. Single scatter pass over the flattened records
+    std::fill(state.f_ext.begin(), state.f_ext.end(), 0.0);
+    double* f_ext = state.f_ext.data();
+    const double* slot_values = program.slot_values.data();
+    for (const auto& record : program.records) {
+        const double value = record.base_value * slot_values[record.curve_slot];
+        double* f = f_ext + 3 * static_cast<size_t>(record.node_index);
+        f[0] += DofMask::has(record.dof_mask, 0) ? value : 0.0;
+        f[1] += DofMask::has(record.dof_mask, 1) ? value : 0.0;
+        f[2] += DofMask::has(record.dof_mask, 2) ? value : 0.0;
+    }
+}
+
+void LoadSystem::update_nodal_loads(LoadProgram& program, NodalState& state, double t) {
+    for (size_t slot = 1; slot < program.curves.size(); ++slot) {
+        program.slot_values[slot] = CurveSystem::evaluate_curve(program.curves[slot], t);
+    }
+
+    // f_ext is zero outside the loaded nodes: reset only those, then scatter
+    double* f_ext = state.f_ext.data();
+    for (const auto& record : program.records) {
+        double* f = f_ext + 3 * static_cast<size_t>(record.node_index);
+        f[0] = 0.0;
+        f[1] = 0.0;
+        f[2] = 0.0;
+    }
+    const double* slot_values = program.slot_values.data();
+    for (const auto& record : program.records) {
+        const double value = record.base_value * slot_values[record.curve_slot];
+        double* f = f_ext + 3 * static_cast<size_t>(record.node_index);
+        f[0] += DofMask::has(record.dof_mask, 0) ? value : 0.0;
+        f[1] += DofMask::has(record.dof_mask, 1) ? value : 0.0;
+        f[2] += DofMask::has(record.dof_mask, 2) ? value : 0.0;
+    }
+}
@@ -9,6 +9,8 @@
 #pragma once
 
 #include "entt/entt.hpp"
+#include "../../data_center/NodalState.h"
+#include "../../data_center/LoadProgram.h"
 
 /**
  * @class LoadSystem
@@ -31,4 +33,35 @@ public:
      *          If load has a curve reference, the load value is scaled by the curve value at time t.
      */
     static void apply_nodal_loads(entt::registry& registry, double t);
+
+    /**
+     * @brief Compile nodal loads into the LoadProgram stored in registry.ctx()
+     * @param registry EnTT registry
+     * @param state Nodal state providing the dense node numbering
+     * @return Reference to the compiled LoadProgram
+     * @details Flattens AppliedLoadRef/NodalLoad/CurveRef into (node index, DOF mask,
+     *          base value, curve slot) records. Each distinct curve gets one slot.
+     */
+    static LoadProgram& compile_nodal_loads(entt::registry& registry, const NodalState& state);
+
+    /**
+     * @brief Apply a compiled load program into the nodal state block
+     * @param program Compiled load program (slot values are refreshed)
+     * @param state Nodal state; f_ext is zeroed and then accumulated
+     * @param t Current time (for curve evaluation)
+     * @details Every distinct curve is evaluated exactly once, followed by a single
+     *          linear scatter over the load records.
+     */
+    static void apply_nodal_loads(LoadProgram& program, NodalState& state, double t);
+
+    /**
+     * @brief Apply a compiled load program, resetting only the loaded nodes
+     * @param program Compiled load program (slot values are refreshed)
+     * @param state Nodal state; f_ext must be zero outside the nodes of the load
+     *        records, which holds once apply_nodal_loads has run on it
+     * @param t Current time (for curve evaluation)
+     * @details Used by the fused explicit step: the full-length zero fill of f_ext
+     *          is replaced by a reset of the few loaded nodes.
+     */
+    static void update_nodal_loads(LoadProgram& program, NodalState& state, double t);
 };
@@ -18,6 +18,7 @@
 #include "mesh/TopologySystems.h"         // 引入拓扑逻辑系统
 #include "AppSession.h"                   // 引入会话状态机
 #include "dof/DofNumberingSystem.h"      // DOF 映射系统
+#include "mesh/ConnectivitySystem.h"     // 扁平连接关系
 #include "mass/MassSystem.h"             // 质量系统
 #include "force/InternalForceSystem.h"   // 内力系统
 #include "load/LoadSystem.h"             // 载荷系统
@@ -35,6 +36,7 @@
 #include <filesystem>
 #include <sstream>
 #include <cstdlib>
+#include <stdexcept>
 
 // Function to print the startup banner
 void print_banner() {
@@ -62,6 +64,8 @@ void print_help() {
     std::cout << "  --output-file, -o <file>   Specify output file (.xfem)" << std::endl;
     std::cout << "  --log-level, -l <level>    Set log level (trace, debug, info, warn, error, critical)" << std::endl;
     std::cout << "  --log-directory, -d <path> Set log file path" << std::endl;
+    std::cout << "  --threads, -t <n>          Number of solver threads (0 = all hardware threads, default 1)" << std::endl;
+    std::cout << "  --restart, -r <file>       Resume the explicit run from a checkpoint (same input file)" << std::endl;
     std::cout << "  --help, -h                 Show this help message" << std::endl;
     std::cout << std::endl;
     std::cout << "Supported Input Formats:" << std::endl;
@@ -72,6 +76,7 @@ void print_help() {
     std::cout << "Examples:" << std::endl;
     std::cout << "  hyperFEM_app --input-file case/model.jsonc --output-file case/output.xfem" << std::endl;
     std::cout << "  hyperFEM_app --input-file case/node.xfem --output-file case/output.xfem" << std::endl;
+    std::cout << "  hyperFEM_app --input-file case/model.jsonc --restart result/checkpoint.hfc" << std::endl;
 }
 
 // --- 引入交互模式的命令处理器 ---
@@ -122,6 +127,8 @@ void process_command(const std::string& command_line, AppSession& session) {
         
         if (parse_success) {
             session.mesh_loaded = true;
+            // 解析完成后构建一次扁平连接关系（供数值系统使用）
+            ConnectivitySystem::build(session.data.registry);
             // Count entities using views
             auto node_count = session.data.registry.view<Component::Position>().size();
             auto element_count = session.data.registry.view<Component::Connectivity>().size();
@@ -165,6 +172,7 @@ void process_command(const std::string& command_line, AppSession& session) {
         try {
             if (SimdroidParser::parse(mesh_path.string(), control_path.string(), session.data)) {
                 session.mesh_loaded = true;
+                ConnectivitySystem::build(session.data.registry);
 
                 // 核心步骤：导入成功后，立即构建 Inspector 索引
                 session.inspector.build(session.data.registry);
@@ -391,6 +399,8 @@ void process_command(const std::string& command_line, AppSession& session) {
                 session.data.registry.ctx().erase<std::unique_ptr<TopologyData>>();
             }
             session.topology_built = false;
+            // 连接关系同样失效，重建
+            ConnectivitySystem::build(session.data.registry);
         }
         spdlog::info("delete_part done. Deleted={}, Failed={}", deleted, failed);
     }
@@ -464,6 +474,9 @@ int main(int argc, char* argv[]) {
     // 输出文件路径
     std::string output_file_path;
     
+    // 显式求解器运行选项
+    ExplicitRunOptions explicit_options;
+    
     // 解析命令行参数
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -535,6 +548,34 @@ int main(int argc, char* argv[]) {
                 std::cerr << "Error: --log-directory requires a path argument" << std::endl;
                 return 1;
             }
+        } else if (arg == "--threads" || arg == "-t") {
+            if (i + 1 < argc) {
+                std::string threads_str = argv[++i];
+                try {
+                    int num_threads = std::stoi(threads_str);
+                    if (num_threads < 0) {
+                        throw std::invalid_argument("negative");
+                    }
+                    explicit_options.num_threads = static_cast<unsigned>(num_threads);
+                } catch (const std::exception&) {
+                    std::cerr << "Error: --threads requires a non-negative integer, got: " << threads_str << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << "Error: --threads requires a number argument" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--restart" || arg == "-r") {
+            if (i + 1 < argc) {
+                explicit_options.restart_file = argv[++i];
+                if (!std::filesystem::exists(explicit_options.restart_file)) {
+                    std::cerr << "Error: Checkpoint file does not exist: " << explicit_options.restart_file << std::endl;
+                    return 1;
+                }
+            } else {
+                std::cerr << "Error: --restart requires a checkpoint file argument" << std::endl;
+                return 1;
+            }
         } else {
             std::cerr << "Unknown argument: " << arg << std::endl;
             std::cerr << "Use --help or -h for usage information" << std::endl;
@@ -589,6 +630,9 @@ int main(int argc, char* argv[]) {
         if (parse_success) {
             spdlog::info("Successfully parsed input file: {}", input_file_path);
             
+            // Flat connectivity store for the numerical systems (built once after parsing)
+            ConnectivitySystem::build(data_context.registry);
+            
             // Count entities using views
             auto node_count = data_context.registry.view<Component::Position>().size();
             auto element_count = data_context.registry.view<Component::Connectivity>().size();
@@ -603,7 +647,7 @@ int main(int argc, char* argv[]) {
                 && data_context.registry.valid(data_context.analysis_entity)
                 && data_context.registry.all_of<Component::AnalysisType>(data_context.analysis_entity)
                 && data_context.registry.get<Component::AnalysisType>(data_context.analysis_entity).value == "explicit") {
-                run_explicit_solver(data_context);
+                run_explicit_solver(data_context, explicit_options);
             }
             
             // --- Step 6: Export the mesh if an output file is specified ---
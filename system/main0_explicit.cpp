@@ -10,43 +10,92 @@
 
 #include "spdlog/spdlog.h"
 #include "DataContext.h"
+#include "StableTimeStep.h"
+#include "MassScaling.h"
 #include "components/mesh_components.h"
 #include "components/analysis_component.h"
 #include "dof/DofNumberingSystem.h"
 #include "mass/MassSystem.h"
+#include "mass/MassScalingSystem.h"
+#include "mesh/ConnectivitySystem.h"
+#include "mesh/NodeGroupSystem.h"
+#include "mesh/PartitionSystem.h"
 #include "force/InternalForceSystem.h"
+#include "force/ReferenceElementCacheSystem.h"
 #include "load/LoadSystem.h"
+#include "main0_explicit.h"
 #include "explicit/ExplicitSolver.h"
+#include "explicit/NodalStateSystem.h"
+#include "explicit/SubcycleSystem.h"
+#include "explicit/EnergyBalanceSystem.h"
+#include "explicit/CheckpointSystem.h"
+#include "boundary/BoundarySystem.h"
+#include "parallel/ThreadPool.h"
+#include "parallel/ElementColoringSystem.h"
 #include "material/mat1/LinearElasticMatrixSystem.h"
 #include "output/VtuExporter.h"
+#include "output/AsyncVtuWriter.h"
+#include "output/PvdWriter.h"
+#include "output/HistoryWriter.h"
+#include "profile/StepProfiler.h"
+#include <cmath>
 #include <filesystem>
 #include <iomanip>
+#include <memory>
 #include <sstream>
 
 /**
  * @brief Run explicit dynamics solver
  * @param data_context The data context containing the mesh and analysis configuration
+ * @param options Run-time options (threads, ...)
  */
-void run_explicit_solver(DataContext& data_context) {
+void run_explicit_solver(DataContext& data_context, const ExplicitRunOptions& options) {
     spdlog::info("Starting explicit dynamics solver...");
     
+    // Restart: the checkpoint is memory-mapped and supplies the nodal state, masses,
+    // element state and loop counters; the model definition still comes from the input
+    CheckpointFile checkpoint;
+    const bool restart = !options.restart_file.empty();
+    if (restart) {
+        if (!checkpoint.open(options.restart_file)) {
+            spdlog::error("Cannot restart from '{}'.", options.restart_file);
+            return;
+        }
+        spdlog::info("Restarting from checkpoint '{}' at t = {:.6e} s (step {}).", options.restart_file,
+                     checkpoint.header().run.time, checkpoint.header().run.step);
+    }
+    
     // 1. Initialize material D matrices
     spdlog::info("Computing material D matrices...");
     LinearElasticMatrixSystem::compute_linear_elastic_matrix(data_context.registry);
     
-    // 2. Build DOF map (needed for boundary conditions)
-    spdlog::info("Building DOF map...");
-    DofNumberingSystem::build_dof_map(data_context.registry);
+    if (!restart) {
+        // 2. Build DOF map (needed for boundary conditions)
+        spdlog::info("Building DOF map...");
+        DofNumberingSystem::build_dof_map(data_context.registry);
+        
+        // 3. Compute lumped mass matrix
+        spdlog::info("Computing lumped mass matrix...");
+        MassSystem::compute_lumped_mass(data_context.registry);
+    } else {
+        // 3. On restart the nodal masses (including added mass) come from the checkpoint
+        spdlog::info("Restoring nodal masses from the checkpoint...");
+        if (!CheckpointSystem::restore_nodal_mass(checkpoint, data_context.registry,
+                                                  ConnectivitySystem::get_or_build(data_context.registry))) {
+            spdlog::error("Checkpoint '{}' does not match the model.", options.restart_file);
+            return;
+        }
+    }
     
-    // 3. Compute lumped mass matrix
-    spdlog::info("Computing lumped mass matrix...");
-    MassSystem::compute_lumped_mass(data_context.registry);
+    // 4. Complete the node components and build the owning node group
+    //    (after the lumped mass, so that every node already carries Mass)
+    spdlog::info("Building node group...");
+    auto node_group = NodeGroupSystem::build(data_context.registry);
     
-    // 4. Initialize initial positions (for displacement calculation)
+    // 5. Initialize initial positions (for displacement calculation)
     spdlog::info("Initializing initial positions...");
-    auto node_view = data_context.registry.view<Component::Position>();
-    for (auto node_entity : node_view) {
-        const auto& pos = data_context.registry.get<Component::Position>(node_entity);
+    for (auto node_entity : node_group) {
+        const auto& pos = node_group.get<Component::Position>(node_entity);
         if (!data_context.registry.all_of<Component::InitialPosition>(node_entity)) {
             data_context.registry.emplace<Component::InitialPosition>(
                 node_entity, pos.x, pos.y, pos.z
@@ -54,30 +103,139 @@ void run_explicit_solver(DataContext& data_context) {
         }
     }
     
-    // 5. Initialize velocity and acceleration to zero
-    spdlog::info("Initializing velocity and acceleration...");
-    for (auto node_entity : node_view) {
-        if (!data_context.registry.all_of<Component::Velocity>(node_entity)) {
-            data_context.registry.emplace<Component::Velocity>(node_entity, 0.0, 0.0, 0.0);
+    // 6. Build the SoA nodal state block; the step loop below runs only on it.
+    //    Node numbering is shared with the flat connectivity store built after parsing.
+    spdlog::info("Building nodal state block...");
+    const ConnectivityStore& connectivity = ConnectivitySystem::get_or_build(data_context.registry);
+    NodalState& state = NodalStateSystem::build(data_context.registry);
+    if (restart && !CheckpointSystem::restore_nodal_state(checkpoint, state)) {
+        spdlog::error("Checkpoint '{}' does not match the model.", options.restart_file);
+        return;
+    }
+    
+    // Optional reference-configuration element cache (AnalysisControl.ElementCache, small strain only)
+    ReferenceCacheMode element_cache_mode = ReferenceCacheMode::Off;
+    if (data_context.analysis_entity != entt::null && data_context.registry.valid(data_context.analysis_entity)) {
+        if (const auto* element_cache = data_context.registry.try_get<Component::ElementCache>(data_context.analysis_entity)) {
+            element_cache_mode = ReferenceElementCacheSystem::parse_mode(element_cache->mode);
         }
-        if (!data_context.registry.all_of<Component::Acceleration>(node_entity)) {
-            data_context.registry.emplace<Component::Acceleration>(node_entity, 0.0, 0.0, 0.0);
+    }
+    ReferenceElementCacheSystem::build(data_context.registry, connectivity, state, element_cache_mode);
+
+    // Element kernel precision (AnalysisControl.ElementPrecision); Mixed is checked
+    // against the fp64 kernel every check_interval steps
+    Component::ElementPrecision element_precision;
+    if (data_context.analysis_entity != entt::null && data_context.registry.valid(data_context.analysis_entity)) {
+        if (const auto* precision = data_context.registry.try_get<Component::ElementPrecision>(data_context.analysis_entity)) {
+            element_precision = *precision;
         }
     }
+    const KernelPrecision kernel_precision = InternalForceSystem::parse_precision(element_precision.mode);
+    InternalForceSystem::set_precision(data_context.registry, kernel_precision);
+    const bool check_precision = (kernel_precision == KernelPrecision::Mixed && element_precision.check_interval > 0);
+    if (kernel_precision == KernelPrecision::Mixed) {
+        spdlog::info("Element kernels: mixed precision (float32 element kernel, fp64 accumulation).");
+    }
+    PrecisionDeviation max_precision_deviation;
+    
+    // 7. Compile SPC definitions into a flat constrained DOF list
+    const SpcTable& spc = BoundarySystem::compile_spc(data_context.registry, state);
     
-    // 6. Time step loop (dt, total_time from analysis entity when present)
+    // 8. Compile nodal loads into flat (node, DOF mask, value, curve slot) records
+    LoadProgram& load_program = LoadSystem::compile_nodal_loads(data_context.registry, state);
+    
+    // 9. Color elements for the conflict-free parallel internal force scatter
+    ThreadPool pool(options.num_threads);
+    spdlog::info("Using {} thread(s) for element loops.", pool.size());
+    const ElementColoring& coloring = ElementColoringSystem::build(data_context.registry, connectivity);
+
+    // Optional domain partition (AnalysisControl.Partition): load-balance statistics
+    // and the PartitionID cell field of the VTU output
+    const MeshPartition* mesh_partition = nullptr;
+    if (data_context.analysis_entity != entt::null && data_context.registry.valid(data_context.analysis_entity)) {
+        const auto* partition = data_context.registry.try_get<Component::DomainPartition>(data_context.analysis_entity);
+        if (partition != nullptr && partition->num_parts > 1) {
+            PartitionMethod method = PartitionMethod::RCB;
+            if (!PartitionSystem::parse_method(partition->method, method)) {
+                spdlog::warn("Unknown partition method '{}'. Using RCB.", partition->method);
+            }
+            mesh_partition = &PartitionSystem::partition(data_context.registry, partition->num_parts, method);
+        }
+    }
+
+    // 10. Time step: CFL estimate scaled by DtScale, unless only a FixedTimeStep is given
     double t = 0.0;
-    double dt = 1e-6;
     double total_time = 1e-3;
+    const Component::TimeStepControl* dt_control = nullptr;
+    const Component::FixedTimeStep* fixed_time_step = nullptr;
     if (data_context.analysis_entity != entt::null && data_context.registry.valid(data_context.analysis_entity)) {
-        if (data_context.registry.all_of<Component::FixedTimeStep>(data_context.analysis_entity)) {
-            dt = data_context.registry.get<Component::FixedTimeStep>(data_context.analysis_entity).value;
-        }
+        dt_control = data_context.registry.try_get<Component::TimeStepControl>(data_context.analysis_entity);
+        fixed_time_step = data_context.registry.try_get<Component::FixedTimeStep>(data_context.analysis_entity);
         if (data_context.registry.all_of<Component::EndTime>(data_context.analysis_entity)) {
             total_time = data_context.registry.get<Component::EndTime>(data_context.analysis_entity).value;
         }
     }
-    spdlog::info("Starting time integration. dt = {:.2e}, total_time = {:.2e}", dt, total_time);
+    const Component::TimeStepControl time_step_control = dt_control ? *dt_control : Component::TimeStepControl{};
+    const bool use_fixed_dt = (fixed_time_step != nullptr && dt_control == nullptr);
+
+    // Wave speeds and element masses of a previous run may carry mass scaling: start from scratch
+    if (data_context.registry.ctx().contains<StableTimeStep>()) {
+        data_context.registry.ctx().erase<StableTimeStep>();
+    }
+    if (data_context.registry.ctx().contains<MassScaling>()) {
+        data_context.registry.ctx().erase<MassScaling>();
+    }
+    if (restart && !CheckpointSystem::restore_element_state(checkpoint, data_context.registry, connectivity)) {
+        spdlog::error("Checkpoint '{}' does not match the model.", options.restart_file);
+        return;
+    }
+    double dt_critical = ExplicitSolver::compute_stable_timestep(data_context.registry, connectivity, state.x, pool);
+    if (!(dt_critical > 0.0)) {
+        spdlog::error("Invalid elements in the initial mesh (see above). Aborting the explicit analysis.");
+        return;
+    }
+
+    // Selective mass scaling: lift elements below Dtmin to the target time step.
+    // The initial pass is limited by InitMassScalRatio (and MaxMassScalRatio), later passes by MaxMassScalRatio.
+    const bool mass_scaling = (!use_fixed_dt && time_step_control.control_type == "MassScaling" &&
+                               time_step_control.dt_min > 0.0);
+    if (mass_scaling && !restart) {
+        double initial_limit = time_step_control.max_mass_scale_ratio;
+        if (time_step_control.init_mass_scale_ratio > 0.0 &&
+            (initial_limit <= 0.0 || time_step_control.init_mass_scale_ratio < initial_limit)) {
+            initial_limit = time_step_control.init_mass_scale_ratio;
+        }
+        dt_critical = MassScalingSystem::apply(data_context.registry, connectivity, state,
+                                               time_step_control.dt_scale, time_step_control.dt_min, initial_limit);
+    }
+
+    double dt = 1e-6;
+    if (use_fixed_dt) {
+        dt = fixed_time_step->value;
+        if (dt > dt_critical) {
+            spdlog::warn("FixedTimeStep {:.3e} exceeds the critical time step {:.3e}; the solution may be unstable.",
+                         dt, dt_critical);
+        }
+    } else if (std::isfinite(dt_critical)) {
+        dt = time_step_control.dt_scale * dt_critical;
+    } else {
+        spdlog::warn("No element contributes to the stable time step. Using dt = {:.2e}.", dt);
+    }
+    if (restart) {
+        dt = checkpoint.header().run.dt;
+        t = checkpoint.header().run.time;
+    }
+    spdlog::info("Starting time integration. dt = {:.2e} (critical {:.2e}), total_time = {:.2e}",
+                 dt, dt_critical, total_time);
+
+    // Subcycling: element levels with power-of-two multiples of the base dt
+    SubcycleSchedule* schedule = nullptr;
+    if (!use_fixed_dt && time_step_control.subcycle_levels > 1) {
+        schedule = &SubcycleSystem::build(data_context.registry, connectivity, time_step_control.subcycle_levels);
+        if (schedule->num_levels == 1) {
+            schedule = nullptr;
+        }
+    }
 
     const bool do_output = (data_context.output_entity != entt::null &&
                             data_context.registry.valid(data_context.output_entity));
@@ -85,47 +243,306 @@ void run_explicit_solver(DataContext& data_context) {
     if (do_output && data_context.registry.all_of<Component::OutputIntervalTime>(data_context.output_entity)) {
         output_interval = data_context.registry.get<Component::OutputIntervalTime>(data_context.output_entity).interval_time;
     }
+    // Frames are snapshotted from the nodal state block and written by a background
+    // thread; with both buffers still in flight the next output waits (back-pressure)
+    const std::vector<std::string>* node_output_fields = nullptr;
+    if (do_output) {
+        if (const auto* node_output = data_context.registry.try_get<Component::NodeOutput>(data_context.output_entity)) {
+            node_output_fields = &node_output->node_output;
+        }
+    }
+    // With Output.Pieces > 1 each frame is split into pieces written concurrently
+    // behind a .pvtu file; result/res.pvd indexes the frames by physical time.
+    // A frame enters res.pvd only once the writer thread has it on disk.
+    std::shared_ptr<const VtuTopology> vtu_topology;
+    std::unique_ptr<AsyncVtuWriter> vtu_writer;
+    PvdWriter pvd("result/res.pvd");
+    bool partitioned_output = false;
+    auto write_output_frame = [&](int index, double time) {
+        std::ostringstream oss;
+        oss << "res_" << std::setfill('0') << std::setw(4) << index << (partitioned_output ? ".pvtu" : ".vtu");
+        VtuFrame& frame = vtu_writer->acquire();
+        VtuExporter::capture_frame(state, vtu_topology, node_output_fields, time, frame, mesh_partition);
+        vtu_writer->submit(frame, "result/" + oss.str(), [&pvd, time, name = oss.str()](bool ok) {
+            if (ok) {
+                pvd.add(time, name);
+            }
+        });
+    };
     int output_index = 0;
     double next_output_time = 0.0;
     if (do_output) {
         std::filesystem::create_directories("result");
-        std::ostringstream oss;
-        oss << "result/res_" << std::setfill('0') << std::setw(4) << 0 << ".vtu";
-        VtuExporter::save(oss.str(), data_context, data_context.output_entity);
-        output_index = 0;
-        next_output_time = output_interval;
+        vtu_topology = VtuExporter::build_topology(connectivity);
+        VtuEncoding vtu_encoding = VtuEncoding::Ascii;
+        std::shared_ptr<const VtuPartition> vtu_partition;
+        if (const auto* format = data_context.registry.try_get<Component::OutputFormat>(data_context.output_entity)) {
+            vtu_encoding = VtuExporter::parse_encoding(format->value);
+            if (format->pieces > 1) {
+                vtu_partition = VtuExporter::partition_topology(*vtu_topology, static_cast<size_t>(format->pieces));
+                partitioned_output = true;
+                spdlog::info("Partitioned VTU output: {} pieces per frame.", vtu_partition->pieces.size());
+            }
+        }
+        // Piece threads only use the cores the solver pool leaves idle
+        const unsigned hardware_threads = ThreadPool::hardware_threads();
+        const unsigned piece_threads = hardware_threads > pool.size() ? hardware_threads - pool.size() : 1;
+        vtu_writer = std::make_unique<AsyncVtuWriter>(2, vtu_encoding, vtu_partition, piece_threads);
+        if (restart) {
+            output_index = static_cast<int>(checkpoint.header().run.output_index);
+            next_output_time = checkpoint.header().run.next_output_time;
+            pvd.resume(static_cast<size_t>(output_index) + 1);
+        } else {
+            write_output_frame(0, t);
+            output_index = 0;
+            next_output_time = output_interval;
+        }
     }
     
+    // Global history (energies): collected in the element and node passes only when
+    // History.GlobalFields is requested or StopEnergyErr is active
+    const Component::HistoryOutput* history_output = nullptr;
+    if (data_context.analysis_entity != entt::null && data_context.registry.valid(data_context.analysis_entity)) {
+        history_output = data_context.registry.try_get<Component::HistoryOutput>(data_context.analysis_entity);
+    }
+    HistoryWriter history;
+    if (history_output != nullptr) {
+        std::filesystem::create_directories("result");
+        if (history_output->format != "ASCII") {
+            spdlog::warn("History Format '{}' is not supported. Writing ASCII.", history_output->format);
+        }
+        history.open("result/history.dat", history_output->global_fields,
+                     restart ? checkpoint.header().run.history_bytes : 0);
+    }
+    const bool track_energy = history.is_open() || time_step_control.stop_energy_error > 0.0;
+    ElementEnergy element_energy;
+    NodalEnergy nodal_energy;
+    EnergyBalance energy_balance;
+    std::vector<ElementEnergy> level_energy;
+    double next_history_time = 0.0;
+    if (restart) {
+        energy_balance = checkpoint.header().run.energy;
+        next_history_time = checkpoint.header().run.next_history_time;
+    }
+
+    // Checkpoints: periodic (Checkpoint.TimeInterval) and on SIGTERM
+    Component::CheckpointControl checkpoint_control;
+    if (data_context.analysis_entity != entt::null && data_context.registry.valid(data_context.analysis_entity)) {
+        if (const auto* control = data_context.registry.try_get<Component::CheckpointControl>(data_context.analysis_entity)) {
+            checkpoint_control = *control;
+        }
+    }
+    double next_checkpoint_time = restart ? checkpoint.header().run.next_checkpoint_time
+                                          : checkpoint_control.interval_time;
+
+    // Per-phase timers; HYPERFEM_PROFILE_SCOPE compiles to nothing unless HYPERFEM_PROFILE is defined
+    StepProfiler profiler;
+
+    // Fused step: NodalState starts with zero forces, the element loop accumulates into
+    // f_int, loads reset only their own nodes and the single node pass consumes and
+    // re-zeroes f_int. Exported InternalForce components are therefore zero.
     int step_count = 0;
+    size_t cycle_step = 0;
+    int last_dt_update = 0;
+    int last_mass_rescale = 0;
+    if (restart) {
+        step_count = static_cast<int>(checkpoint.header().run.step);
+        last_dt_update = static_cast<int>(checkpoint.header().run.last_dt_update);
+        last_mass_rescale = static_cast<int>(checkpoint.header().run.last_mass_rescale);
+    }
+    auto write_checkpoint = [&]() {
+        CheckpointRunState run;
+        run.time = t;
+        run.dt = dt;
+        run.step = static_cast<uint64_t>(step_count);
+        run.last_dt_update = static_cast<uint64_t>(last_dt_update);
+        run.last_mass_rescale = static_cast<uint64_t>(last_mass_rescale);
+        run.output_index = output_index;
+        run.next_output_time = next_output_time;
+        run.next_history_time = next_history_time;
+        run.next_checkpoint_time = next_checkpoint_time;
+        run.history_bytes = history.size();
+        run.energy = energy_balance;
+        const auto& ctx = data_context.registry.ctx();
+        std::filesystem::path dir = std::filesystem::path(checkpoint_control.file).parent_path();
+        if (!dir.empty()) {
+            std::filesystem::create_directories(dir);
+        }
+        return CheckpointSystem::write(checkpoint_control.file, run, state,
+                                ctx.contains<StableTimeStep>() ? &ctx.get<StableTimeStep>() : nullptr,
+                                ctx.contains<MassScaling>() ? &ctx.get<MassScaling>() : nullptr);
+    };
+    CheckpointSystem::install_termination_handler();
+    // The checkpoint is only needed during setup; release the mapping
+    checkpoint.close();
     while (t < total_time) {
-        // Reset and compute internal forces (based on current coordinates)
-        InternalForceSystem::reset_internal_forces(data_context.registry);
-        InternalForceSystem::compute_internal_forces(data_context.registry);
+        HYPERFEM_PROFILE_SCOPE(profiler, ProfilePhase::Step);
+
+        // Mixed precision: compare with the fp64 kernel on the same state
+        if (check_precision && step_count % element_precision.check_interval == 0) {
+            const PrecisionDeviation deviation =
+                InternalForceSystem::compare_precision(data_context.registry, connectivity, state, coloring, pool);
+            max_precision_deviation.take_max(deviation);
+            spdlog::info("Mixed precision at t = {:.6e} s: internal energy {:.6e} (fp64 {:.6e}), "
+                         "deviation {:.3e}, max force deviation {:.3e}, energy balance error {:.3e}",
+                         t, deviation.energy_mixed, deviation.energy_double, deviation.energy_error(),
+                         deviation.force_error, energy_balance.error);
+        }
+
+        // Internal forces (based on current coordinates)
+        {
+            HYPERFEM_PROFILE_SCOPE(profiler, ProfilePhase::InternalForce,
+                                   schedule != nullptr ? schedule->num_active_elements(cycle_step)
+                                                       : connectivity.num_elements());
+            if (schedule != nullptr) {
+                SubcycleSystem::compute_internal_forces(data_context.registry, connectivity, state, *schedule,
+                                                        cycle_step, pool, track_energy ? &level_energy : nullptr);
+                if (track_energy) {
+                    element_energy.clear();
+                    for (const ElementEnergy& e : level_energy) {
+                        element_energy += e;
+                    }
+                }
+            } else {
+                // f_int was zeroed by the fused node pass of the previous step (or by NodalStateSystem::build)
+                InternalForceSystem::accumulate_internal_forces(data_context.registry, connectivity, state, coloring,
+                                                                pool, track_energy ? &element_energy : nullptr);
+            }
+        }
         
-        // Reset and apply external loads
-        LoadSystem::reset_external_forces(data_context.registry);
-        LoadSystem::apply_nodal_loads(data_context.registry, t);
+        // External loads
+        {
+            HYPERFEM_PROFILE_SCOPE(profiler, ProfilePhase::ExternalLoad);
+            LoadSystem::update_nodal_loads(load_program, state, t);
+        }
         
-        // Time integration
-        ExplicitSolver::integrate(data_context.registry, dt);
+        // Time integration: one pass over the nodes for acceleration, SPC, update and
+        // the f_int reset (energies refer to t, where the forces were evaluated)
+        {
+            HYPERFEM_PROFILE_SCOPE(profiler, ProfilePhase::Integrate, state.num_nodes());
+            ExplicitSolver::integrate_fused(state, spc, dt, track_energy ? &nodal_energy : nullptr);
+        }
+        if (track_energy) {
+            HYPERFEM_PROFILE_SCOPE(profiler, ProfilePhase::History);
+            EnergyBalanceSystem::update(energy_balance, element_energy, nodal_energy, dt);
+            if (history.is_open() && t >= next_history_time) {
+                history.write(t, static_cast<size_t>(step_count), dt, energy_balance);
+                next_history_time = (history_output->interval_time > 0.0)
+                                        ? next_history_time + history_output->interval_time : t;
+            }
+        }
         
         t += dt;
         step_count++;
+        cycle_step++;
+        
+        // Re-evaluate the stable time step as the mesh deforms (and optionally rescale the mass).
+        // With subcycling dt may only change when all levels are synchronized.
+        const bool synchronized = (schedule == nullptr || cycle_step % schedule->cycle_length() == 0);
+        const bool rescale_mass = (synchronized && mass_scaling && time_step_control.mass_scale_interval > 0 &&
+                                   step_count - last_mass_rescale >= time_step_control.mass_scale_interval);
+        const bool update_dt = (synchronized && step_count - last_dt_update >= time_step_control.update_interval);
+        if (!use_fixed_dt && (rescale_mass || update_dt)) {
+            HYPERFEM_PROFILE_SCOPE(profiler, ProfilePhase::TimeStep);
+            dt_critical = ExplicitSolver::compute_stable_timestep(data_context.registry, connectivity, state.x, pool);
+            last_dt_update = step_count;
+            if (!(dt_critical > 0.0)) {
+                spdlog::error("Invalid elements at t = {:.6e} s (step {}). Stopping.", t, step_count);
+                break;
+            }
+            if (rescale_mass) {
+                dt_critical = MassScalingSystem::apply(data_context.registry, connectivity, state,
+                                                       time_step_control.dt_scale, time_step_control.dt_min,
+                                                       time_step_control.max_mass_scale_ratio);
+                last_mass_rescale = step_count;
+            }
+            if (std::isfinite(dt_critical)) {
+                dt = time_step_control.dt_scale * dt_critical;
+            }
+            if (schedule != nullptr && !SubcycleSystem::is_stable(data_context.registry, *schedule)) {
+                schedule = &SubcycleSystem::build(data_context.registry, connectivity,
+                                                  time_step_control.subcycle_levels);
+                cycle_step = 0;
+            }
+        }
         
         if (do_output && t >= next_output_time) {
+            HYPERFEM_PROFILE_SCOPE(profiler, ProfilePhase::Output);
             output_index++;
-            std::filesystem::create_directories("result");
-            std::ostringstream oss;
-            oss << "result/res_" << std::setfill('0') << std::setw(4) << output_index << ".vtu";
-            VtuExporter::save(oss.str(), data_context, data_context.output_entity);
+            write_output_frame(output_index, t);
             next_output_time += output_interval;
         }
         
+        // Checkpoints are taken where all subcycle levels are synchronized, so a restart
+        // begins a new cycle; on SIGTERM the run stops after writing one
+        const bool terminate = CheckpointSystem::termination_requested();
+        if (synchronized && (terminate || (checkpoint_control.interval_time > 0.0 && t >= next_checkpoint_time))) {
+            HYPERFEM_PROFILE_SCOPE(profiler, ProfilePhase::Checkpoint);
+            while (checkpoint_control.interval_time > 0.0 && t >= next_checkpoint_time) {
+                next_checkpoint_time += checkpoint_control.interval_time;
+            }
+            const bool saved = write_checkpoint();
+            if (!saved) {
+                spdlog::error("Checkpoint '{}' could not be written at t = {:.6e} s (step {}); no checkpoint was saved.",
+                              checkpoint_control.file, t, step_count);
+            }
+            if (terminate) {
+                if (saved) {
+                    spdlog::warn("SIGTERM received at t = {:.6e} s (step {}). Stopping after the checkpoint.", t,
+                                 step_count);
+                } else {
+                    spdlog::error("SIGTERM received at t = {:.6e} s (step {}). Stopping without a checkpoint.", t,
+                                  step_count);
+                }
+                break;
+            }
+        }
+        
         // Output progress every 100 steps
         if (step_count % 100 == 0) {
-            spdlog::info("Time: {:.6e} s, Step: {}", t, step_count);
+            spdlog::info("Time: {:.6e} s, Step: {}, dt: {:.3e}", t, step_count, dt);
         }
+
+        // StopEnergyErr: a diverging run is stopped right away
+        if (EnergyBalanceSystem::should_stop(energy_balance, time_step_control.stop_energy_error)) {
+            spdlog::error("Energy error {:.3e} exceeds StopEnergyErr {:.3e} at t = {:.6e} s (step {}). Stopping.",
+                          energy_balance.error, time_step_control.stop_energy_error, t, step_count);
+            break;
+        }
+    }
+
+    CheckpointSystem::remove_termination_handler();
+
+    if (check_precision) {
+        spdlog::info("Mixed precision: max internal energy deviation {:.3e}, max force deviation {:.3e} against fp64"
+                     "{}.", max_precision_deviation.energy_error(), max_precision_deviation.force_error,
+                     track_energy ? fmt::format(", final energy balance error {:.3e}", energy_balance.error) : "");
     }
+
+    if (vtu_writer) {
+        if (!vtu_writer->flush()) {
+            spdlog::error("{} VTU frame(s) could not be written.", vtu_writer->frames_failed());
+        }
+        if (vtu_writer->stall_seconds() > 0.0) {
+            spdlog::info("VTU output: the solver waited {:.3f} s for the background writer.",
+                         vtu_writer->stall_seconds());
+        }
+    }
+
+    if constexpr (kStepProfilerEnabled) {
+        profiler.print_summary(connectivity.num_elements(), state.num_nodes());
+        std::filesystem::create_directories("result");
+        profiler.write_json("result/profile.json", connectivity.num_elements(), state.num_nodes(), pool.size());
+    }
+    
+    // Leave the final state in the node components for later exports
+    NodalStateSystem::sync_to_registry(data_context.registry, node_group);
     
+    if (mass_scaling && data_context.registry.ctx().contains<MassScaling>()) {
+        const MassScaling& scaling = data_context.registry.ctx().get<MassScaling>();
+        spdlog::info("Mass scaling: added mass {:.4e} ({:.4f}% of the physical mass).",
+                     scaling.added_mass, 100.0 * scaling.added_mass_ratio());
+    }
+
     spdlog::info("Explicit solver completed. Final time: {:.6e} s, Total steps: {}", t, step_count);
 }
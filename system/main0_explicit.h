@@ -10,11 +10,24 @@
 
 #pragma once
 
+#include <string>
+
 // Forward declaration
 struct DataContext;
 
+/**
+ * @brief Run-time options of the explicit solver (set from the command line)
+ */
+struct ExplicitRunOptions {
+    /// Number of threads for the element loops (0 = hardware concurrency)
+    unsigned num_threads = 1;
+    /// Checkpoint file to resume from (empty = start at t = 0)
+    std::string restart_file;
+};
+
 /**
  * @brief Run explicit dynamics solver
  * @param data_context The data context containing the mesh and analysis configuration
+ * @param options Run-time options (threads, ...)
  */
-void run_explicit_solver(DataContext& data_context);
+void run_explicit_solver(DataContext& data_context, const ExplicitRunOptions& options = {});
@@ -0,0 +1,213 @@
+// MassScalingSystem.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "MassScalingSystem.h"
+#include "../../data_center/components/mesh_components.h"
+#include "../../data_center/components/property_components.h"
+#include "../../data_center/components/material_components.h"
+#include "../../data_center/StableTimeStep.h"
+#include "../../data_center/MassScaling.h"
+#include "../element/c3d8r/C3D8RGradient.h"
+#include "spdlog/spdlog.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+    // Material density of an element (0 if unavailable)
+    double element_density(const entt::registry& registry, entt::entity element_entity) {
+        const auto* property_ref = registry.try_get<Component::PropertyRef>(element_entity);
+        if (property_ref == nullptr) {
+            return 0.0;
+        }
+        const auto* material_ref = registry.try_get<Component::MaterialRef>(property_ref->property_entity);
+        if (material_ref == nullptr) {
+            return 0.0;
+        }
+        const auto* params = registry.try_get<Component::LinearElasticParams>(material_ref->material_entity);
+        return (params != nullptr) ? params->rho : 0.0;
+    }
+
+    // Physical mass rho * V of a hexahedron in the initial configuration (0 if degenerate)
+    double hex_element_mass(const uint32_t* nodes, const std::vector<double>& x0, double rho) {
+        double cx[8], cy[8], cz[8];
+        for (int i = 0; i < 8; ++i) {
+            cx[i] = x0[3*nodes[i] + 0];
+            cy[i] = x0[3*nodes[i] + 1];
+            cz[i] = x0[3*nodes[i] + 2];
+        }
+        double bx[8], by[8], bz[8];
+        const double volume = c3d8r_gradient::calc_b_bar(cx, cy, cz, bx, by, bz);
+        return (volume > 0.0) ? rho * volume : 0.0;
+    }
+
+    // Element masses on the store layout; built on first use (or after the store changed)
+    MassScaling& get_or_init_mass_scaling(entt::registry& registry, const ConnectivityStore& store,
+                                          const NodalState& state) {
+        MassScaling* scaling_ptr = nullptr;
+        if (registry.ctx().contains<MassScaling>()) {
+            scaling_ptr = &registry.ctx().get<MassScaling>();
+        } else {
+            scaling_ptr = &registry.ctx().emplace<MassScaling>();
+        }
+        auto& scaling = *scaling_ptr;
+
+        bool layout_matches = scaling.element_mass.size() == store.blocks.size();
+        for (size_t b = 0; layout_matches && b < store.blocks.size(); ++b) {
+            layout_matches = scaling.element_mass[b].size() == store.blocks[b].num_elements();
+        }
+        if (layout_matches) {
+            return scaling;
+        }
+
+        scaling.clear();
+        scaling.element_mass.resize(store.blocks.size());
+        for (size_t b = 0; b < store.blocks.size(); ++b) {
+            const ConnectivityBlock& block = store.blocks[b];
+            scaling.element_mass[b].assign(block.num_elements(), 0.0);
+            if (block.type_id != 308 || block.nodes_per_element != 8) {
+                continue;
+            }
+            for (size_t k = 0; k < block.num_elements(); ++k) {
+                const double rho = element_density(registry, block.elements[k]);
+                if (rho <= 0.0) {
+                    continue;
+                }
+                const double mass = hex_element_mass(block.nodes_of(k), state.x0, rho);
+                scaling.element_mass[b][k] = mass;
+                scaling.physical_mass += mass;
+            }
+        }
+        return scaling;
+    }
+}
+
+double MassScalingSystem::apply(entt::registry& registry, const ConnectivityStore& store, NodalState& state,
+                                double dt_scale, double dt_target, double max_added_mass_ratio) {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+
+    if (!registry.ctx().contains<StableTimeStep>()) {
+        spdlog::warn("MassScalingSystem: No stable time step available. Skipping mass scaling.");
+        return inf;
+    }
+    auto& stable = registry.ctx().get<StableTimeStep>();
+    if (stable.element_dt.size() != store.blocks.size() || dt_target <= 0.0 || dt_scale <= 0.0) {
+        return stable.dt_critical;
+    }
+
+    MassScaling& scaling = get_or_init_mass_scaling(registry, store, state);
+
+    // Target on the unscaled critical time step
+    double dt_crit_target = dt_target / dt_scale;
+    if (stable.dt_critical >= dt_crit_target) {
+        scaling.scaled_elements = 0;
+        return stable.dt_critical;
+    }
+
+    // Mass that would be added to reach a given critical time step
+    auto added_mass_for = [&](double dt_crit) {
+        double added = 0.0;
+        for (size_t b = 0; b < store.blocks.size(); ++b) {
+            const std::vector<double>& element_dt = stable.element_dt[b];
+            const std::vector<double>& element_mass = scaling.element_mass[b];
+            for (size_t k = 0; k < element_dt.size(); ++k) {
+                if (element_dt[k] < dt_crit && element_mass[k] > 0.0) {
+                    const double ratio = dt_crit / element_dt[k];
+                    added += element_mass[k] * (ratio * ratio - 1.0);
+                }
+            }
+        }
+        return added;
+    };
+
+    // Respect the added-mass limit: lower the target until the added mass fits
+    if (max_added_mass_ratio > 0.0) {
+        const double allowed = max_added_mass_ratio * scaling.physical_mass - scaling.added_mass;
+        if (allowed <= 0.0) {
+            spdlog::warn("MassScalingSystem: Added-mass limit {:.3g} reached. No further mass is added.",
+                         max_added_mass_ratio);
+            scaling.scaled_elements = 0;
+            return stable.dt_critical;
+        }
+        if (added_mass_for(dt_crit_target) > allowed) {
+            double low = stable.dt_critical;
+            double high = dt_crit_target;
+            for (int iteration = 0; iteration < 60; ++iteration) {
+                const double mid = 0.5 * (low + high);
+                if (added_mass_for(mid) > allowed) {
+                    high = mid;
+                } else {
+                    low = mid;
+                }
+            }
+            spdlog::warn("MassScalingSystem: Added-mass limit {:.3g} lowers the target time step from {:.3e} to {:.3e}.",
+                         max_added_mass_ratio, dt_target, dt_scale * low);
+            dt_crit_target = low;
+        }
+    }
+
+    // Scale the selected elements and distribute their added mass to the nodes
+    std::vector<char> touched(state.num_nodes(), 0);
+    double added_total = 0.0;
+    size_t scaled_count = 0;
+    for (size_t b = 0; b < store.blocks.size(); ++b) {
+        const ConnectivityBlock& block = store.blocks[b];
+        std::vector<double>& element_dt = stable.element_dt[b];
+        std::vector<double>& wave_speed = stable.wave_speed[b];
+        std::vector<double>& element_mass = scaling.element_mass[b];
+        for (size_t k = 0; k < element_dt.size(); ++k) {
+            if (!(element_dt[k] < dt_crit_target) || element_mass[k] <= 0.0) {
+                continue;
+            }
+            const double ratio = dt_crit_target / element_dt[k];
+            const double factor = ratio * ratio;
+            const double added = element_mass[k] * (factor - 1.0);
+
+            const uint32_t* nodes = block.nodes_of(k);
+            const double nodal_added = added / block.nodes_per_element;
+            for (int i = 0; i < block.nodes_per_element; ++i) {
+                state.mass[nodes[i]] += nodal_added;
+                touched[nodes[i]] = 1;
+            }
+
+            element_mass[k] *= factor;
+            wave_speed[k] /= ratio;
+            element_dt[k] = dt_crit_target;
+            added_total += added;
+            scaled_count++;
+        }
+    }
+
+    for (size_t n = 0; n < state.num_nodes(); ++n) {
+        if (touched[n] && std::abs(state.mass[n]) >= 1.0e-20) {
+            state.inv_mass[n] = 1.0 / state.mass[n];
+        }
+    }
+
+    // New critical time step (serial scan, first minimum wins)
+    stable.dt_critical = inf;
+    for (size_t b = 0; b < stable.element_dt.size(); ++b) {
+        for (size_t k = 0; k < stable.element_dt[b].size(); ++k) {
+            if (stable.element_dt[b][k] < stable.dt_critical) {
+                stable.dt_critical = stable.element_dt[b][k];
+                stable.critical_block = static_cast<uint32_t>(b);
+                stable.critical_element = static_cast<uint32_t>(k);
+            }
+        }
+    }
+
+    scaling.added_mass += added_total;
+    scaling.dt_target = dt_scale * dt_crit_target;
+    scaling.scaled_elements = scaled_count;
+
+    spdlog::info("MassScalingSystem: {} elements scaled to dt = {:.3e}; added mass {:.4e} ({:.4f}% of {:.4e}).",
+                 scaled_count, scaling.dt_target, scaling.added_mass,
+                 100.0 * scaling.added_mass_ratio(), scaling.physical_mass);
+
+    return stable.dt_critical;
+}
@@ -0,0 +1,46 @@
+// MassScalingSystem.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include "entt/entt.hpp"
+#include "../../data_center/ConnectivityStore.h"
+#include "../../data_center/NodalState.h"
+
+/**
+ * @class MassScalingSystem
+ * @brief Selective mass scaling for explicit dynamics (DtControlType "MassScaling")
+ * @details Runs after MassSystem::compute_lumped_mass and the nodal state build, on
+ *          top of the element time steps of ExplicitSolver::compute_stable_timestep.
+ *          Only elements whose scaled time step is below the target receive mass,
+ *          so a few small elements no longer dictate the global time step.
+ */
+class MassScalingSystem {
+public:
+    /**
+     * @brief Add mass to the elements that are below the target time step
+     * @param registry EnTT registry (materials; owns the StableTimeStep and MassScaling in ctx)
+     * @param store Connectivity blocks (same numbering as state)
+     * @param state Nodal state; mass and inv_mass are updated in place
+     * @param dt_scale DtScale safety factor applied to the critical time step
+     * @param dt_target Target time step (Dtmin); the scaled time step will not fall below it
+     * @param max_added_mass_ratio Limit on the cumulative added-mass ratio (0 = no limit)
+     * @return Critical time step after scaling (not scaled by DtScale)
+     * @details
+     *   - Requires a current StableTimeStep (call compute_stable_timestep first)
+     *   - Element k needs the mass factor f = (dt_target / (dt_scale * dt_e))^2 >= 1;
+     *     its added mass m_e * (f - 1) is split evenly over its nodes and its cached
+     *     wave speed is divided by sqrt(f)
+     *   - If the limit would be exceeded, the target is lowered by bisection to the
+     *     largest value that keeps the added-mass ratio within the limit
+     *   - Repeated calls (periodic rescaling) add mass on top of the current element
+     *     masses; added mass is never removed
+     */
+    static double apply(entt::registry& registry, const ConnectivityStore& store, NodalState& state,
+                        double dt_scale, double dt_target, double max_added_mass_ratio);
+};
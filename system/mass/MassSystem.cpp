@@ -8,68 +8,87 @@
  */
 #include "MassSystem.h"
 #include "../../data_center/components/mesh_components.h"
-#include "../../data_center/components/property_components.h"
 #include "c3d8/C3D8Mass.h"
+#include "../element/ElementBlock.h"
+#include "../element/ElementTraits.h"
+#include "../mesh/ConnectivitySystem.h"
 #include "spdlog/spdlog.h"
+#include <vector>
+
+namespace {
+    // Lumped mass of one homogeneous block, specialized on the element traits
+    template <typename Traits>
+    size_t lumped_mass_block(const ConnectivityBlock& block, double rho, const std::vector<double>& xyz,
+                             std::vector<double>& nodal_mass) {
+        constexpr int N = Traits::num_nodes;
+        size_t computed = 0;
+        for (size_t k = 0; k < block.num_elements(); ++k) {
+            const uint32_t* nodes = block.nodes_of(k);
+            double coords[3][N];
+            for (int i = 0; i < N; ++i) {
+                for (int d = 0; d < 3; ++d) {
+                    coords[d][i] = xyz[3*nodes[i] + d];
+                }
+            }
+
+            double element_nodal_mass = 0.0;
+            if (compute_c3d8_nodal_mass(coords, rho, Traits::integration_points, element_nodal_mass)) {
+                for (int i = 0; i < N; ++i) {
+                    nodal_mass[nodes[i]] += element_nodal_mass;
+                }
+                computed++;
+            }
+        }
+        return computed;
+    }
+}
 
 void MassSystem::compute_lumped_mass(entt::registry& registry) {
     spdlog::info("Computing lumped mass matrix...");
 
-    // Initialize mass to zero for all nodes
-    auto node_view = registry.view<Component::Position>();
-    for (auto node_entity : node_view) {
-        if (!registry.all_of<Component::Mass>(node_entity)) {
-            registry.emplace<Component::Mass>(node_entity, 0.0);
-        } else {
-            registry.get<Component::Mass>(node_entity).value = 0.0;
-        }
+    const ConnectivityStore& store = ConnectivitySystem::get_or_build(registry);
+    const size_t num_nodes = store.num_nodes();
+
+    // Gather node coordinates once into a dense array (store numbering)
+    std::vector<double> xyz(3 * num_nodes);
+    for (size_t n = 0; n < num_nodes; ++n) {
+        const auto& pos = registry.get<Component::Position>(store.node_entities[n]);
+        xyz[3*n + 0] = pos.x;
+        xyz[3*n + 1] = pos.y;
+        xyz[3*n + 2] = pos.z;
     }
 
-    // Traverse all elements
-    auto element_view = registry.view<Component::Connectivity, Component::ElementType>();
+    // Accumulate nodal mass on the dense numbering
+    std::vector<double> nodal_mass(num_nodes, 0.0);
     size_t element_count = 0;
-    
-    for (auto element_entity : element_view) {
-        const auto& element_type = registry.get<Component::ElementType>(element_entity);
-        
-        // Switch-case dispatch based on element type
-        switch (element_type.type_id) {
-            case 308: {  // C3D8 (8-node hexahedron)
-                // Get integration points from SolidProperty
-                int n_integration_points = 1;  // Default to reduced integration
-                
-                if (registry.all_of<Component::PropertyRef>(element_entity)) {
-                    const auto& property_ref = registry.get<Component::PropertyRef>(element_entity);
-                    entt::entity property_entity = property_ref.property_entity;
-                    
-                    if (registry.all_of<Component::SolidProperty>(property_entity)) {
-                        const auto& solid_prop = registry.get<Component::SolidProperty>(property_entity);
-                        n_integration_points = solid_prop.integration_network;
-                    } else {
-                        spdlog::warn("Property missing SolidProperty component. Using default integration points = 1.");
-                    }
-                } else {
-                    spdlog::warn("Element missing PropertyRef component. Using default integration points = 1.");
-                }
-                
-                if (compute_c3d8_mass(registry, element_entity, n_integration_points)) {
-                    element_count++;
-                }
-                break;
-            }
-            
-            // Future element types can be added here:
-            // case 304: {  // Tetra4
-            //     if (compute_tet4_mass(registry, element_entity)) {
-            //         element_count++;
-            //     }
-            //     break;
-            // }
-            
-            default:
-                // Skip unsupported element types
-                break;
+
+    for (const auto& block : store.blocks) {
+        // Property and material are shared by the whole block: resolve and validate once
+        const ElementBlockData data = resolve_element_block(registry, block);
+        if (!data.has_density) {
+            spdlog::warn("Element block of type {} ({} elements) has no material density. Skipping mass calculation.",
+                         block.type_id, block.num_elements());
+            continue;
         }
+        if (data.solid == nullptr) {
+            spdlog::warn("Element block of type {} has no SolidProperty. Using default integration points = 1.",
+                         block.type_id);
+        }
+
+        const bool supported = dispatch_element_traits(block, data.integration_points,
+            [&]<typename Traits>() {
+                element_count += lumped_mass_block<Traits>(block, data.rho, xyz, nodal_mass);
+            });
+        if (!supported) {
+            spdlog::warn("No mass kernel for element block (type {}, property {}, integration_network {}). "
+                         "Skipping {} element(s).",
+                         block.type_id, data.property_id, data.integration_points, block.num_elements());
+        }
+    }
+
+    // Write the mass of every node (zero for nodes without elements)
+    for (size_t n = 0; n < num_nodes; ++n) {
+        registry.emplace_or_replace<Component::Mass>(store.node_entities[n], nodal_mass[n]);
     }
 
     spdlog::info("Lumped mass computed for {} elements.", element_count);
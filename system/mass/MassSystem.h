@@ -21,11 +21,12 @@ public:
      * @brief Compute lumped mass matrix for all nodes
      * @param registry EnTT registry containing elements and nodes
      * @details 
-     *   - Traverses all elements
-     *   - Gets material density from LinearElasticParams
+     *   - Traverses the ConnectivityStore blocks (built if missing)
+     *   - Gets material density from LinearElasticParams once per block
+     *   - Dispatches each block to the kernel specialized on its ElementTraits
      *   - Computes element volume
      *   - Distributes element mass (rho * V) uniformly to 8 nodes
-     *   - Accumulates mass in Component::Mass
+     *   - Accumulates mass on the dense node numbering and writes Component::Mass
      */
     static void compute_lumped_mass(entt::registry& registry);
 };
@@ -11,59 +11,12 @@
 #include "../../../data_center/components/property_components.h"
 #include "../../../data_center/components/material_components.h"
 #include "../gauss/GaussIntegration.h"
+#include "../../element/c3d8r/C3D8RGradient.h"
 #include <Eigen/Dense>
 #include "spdlog/spdlog.h"
 #include <cmath>
 
 namespace {
-    // Helper function: Calculate B-bar component (same as in C3D8RStiffnessMatrix.cpp)
-    void calc_b_bar_component(
-        const double* y,  // 8 node y coordinates
-        const double* z,  // 8 node z coordinates
-        double* BiI       // Output: 8 B-bar values
-    ) {
-        BiI[0] = -(y[1]*(z[2]+z[3]-z[4]-z[5])+y[2]*(-z[1]+z[3])
-                 +y[3]*(-z[1]-z[2]+z[4]+z[7])+y[4]*(z[1]-z[3]+z[5]-z[7])
-                 +y[5]*(z[1]-z[4])+y[7]*(-z[3]+z[4]))/12.0;
-        
-        BiI[1] = (y[0]*(z[2]+z[3]-z[4]-z[5])+y[2]*(-z[0]-z[3]+z[5]+z[6])
-                 +y[3]*(-z[0]+z[2])+y[4]*(z[0]-z[5])
-                 +y[5]*(z[0]-z[2]+z[4]-z[6])+y[6]*(-z[2]+z[5]))/12.0;
-        
-        BiI[2] = -(y[0]*(z[1]-z[3])+y[1]*(-z[0]-z[3]+z[5]+z[6])
-                 +y[3]*(z[0]+z[1]-z[6]-z[7])+y[5]*(-z[1]+z[6])
-                 +y[6]*(-z[1]+z[3]-z[5]+z[7])+y[7]*(z[3]-z[6]))/12.0;
-        
-        BiI[3] = -(y[0]*(z[1]+z[2]-z[4]-z[7])+y[1]*(-z[0]+z[2])
-                 +y[2]*(-z[0]-z[1]+z[6]+z[7])+y[4]*(z[0]-z[7])
-                 +y[6]*(-z[2]+z[7])+y[7]*(z[0]-z[2]+z[4]-z[6]))/12.0;
-        
-        BiI[4] = (y[0]*(z[1]-z[3]+z[5]-z[7])+y[1]*(-z[0]+z[5])
-                 +y[3]*(z[0]-z[7])+y[5]*(-z[0]-z[1]+z[6]+z[7])
-                 +y[6]*(-z[5]+z[7])+y[7]*(z[0]+z[3]-z[5]-z[6]))/12.0;
-        
-        BiI[5] = (y[0]*(z[1]-z[4])+y[1]*(-z[0]+z[2]-z[4]+z[6])
-                 +y[2]*(-z[1]+z[6])+y[4]*(z[0]+z[1]-z[6]-z[7])
-                 +y[6]*(-z[1]-z[2]+z[4]+z[7])+y[7]*(z[4]-z[6]))/12.0;
-        
-        BiI[6] = (y[1]*(z[2]-z[5])+y[2]*(-z[1]+z[3]-z[5]+z[7])
-                 +y[3]*(-z[2]+z[7])+y[4]*(z[5]-z[7])
-                 +y[5]*(z[1]+z[2]-z[4]-z[7])+y[7]*(-z[2]-z[3]+z[4]+z[5]))/12.0;
-        
-        BiI[7] = -(y[0]*(z[3]-z[4])+y[2]*(-z[3]+z[6])
-                 +y[3]*(-z[0]+z[2]-z[4]+z[6])+y[4]*(z[0]+z[3]-z[5]-z[6])
-                 +y[5]*(z[4]-z[6])+y[6]*(-z[2]-z[3]+z[4]+z[5]))/12.0;
-    }
-
-    // Helper function: Calculate element volume using B-bar method
-    double calc_vol_bbar(const double* BiI, const double* X) {
-        double V = 0.0;
-        for (int i = 0; i < 8; ++i) {
-            V += X[i] * BiI[i];
-        }
-        return V;
-    }
-
     // Helper function: Shape function for 8-node hexahedron at natural coordinates (xi, eta, zeta)
     void shape_function_8node(double xi, double eta, double zeta, double N[8]) {
         N[0] = 0.125 * (1.0 - xi) * (1.0 - eta) * (1.0 - zeta);
@@ -123,6 +76,25 @@ namespace {
     }
 }
 
+bool compute_c3d8_nodal_mass(const double coords[3][8], double rho, int n_integration_points, double& nodal_mass) {
+    // The B-bar volume is the exact volume of the trilinear hexahedron, so it equals
+    // the Gauss-integrated volume of every rule (1, 2 or 3 points per direction)
+    (void)n_integration_points;
+
+    // B-bar method (reduced integration): element volume from the B-bar gradients
+    double bx[8], by[8], bz[8];
+    const double VOL = c3d8r_gradient::calc_b_bar(coords[0], coords[1], coords[2], bx, by, bz);
+
+    if (std::abs(VOL) < 1.0e-20) {
+        spdlog::warn("Element volume is zero or too small. Skipping.");
+        return false;
+    }
+
+    // Element mass distributed uniformly to 8 nodes
+    nodal_mass = rho * VOL / 8.0;
+    return true;
+}
+
 bool compute_c3d8_mass(entt::registry& registry, entt::entity element_entity, int n_integration_points) {
     const auto& connectivity = registry.get<Component::Connectivity>(element_entity);
     
@@ -157,75 +129,23 @@ bool compute_c3d8_mass(entt::registry& registry, entt::entity element_entity, in
     double rho = material_params.rho;
 
     // Get node coordinates
-    Eigen::Matrix<double, 8, 3> coords;
+    double coords[3][8];
     for (size_t i = 0; i < 8; ++i) {
         if (!registry.all_of<Component::Position>(connectivity.nodes[i])) {
             spdlog::warn("Node missing Position component. Skipping element.");
             return false;
         }
         const auto& pos = registry.get<Component::Position>(connectivity.nodes[i]);
-        coords(i, 0) = pos.x;
-        coords(i, 1) = pos.y;
-        coords(i, 2) = pos.z;
+        coords[0][i] = pos.x;
+        coords[1][i] = pos.y;
+        coords[2][i] = pos.z;
     }
 
-    double VOL = 0.0;
-
-    if (n_integration_points == 1) {
-        // Use B-bar method (reduced integration)
-        Eigen::Matrix<double, 8, 3> BiI;
-        
-        // Extract coordinate components
-        double x[8], y[8], z[8];
-        for (int i = 0; i < 8; ++i) {
-            x[i] = coords(i, 0);
-            y[i] = coords(i, 1);
-            z[i] = coords(i, 2);
-        }
-
-        // Calculate three B-bar components
-        calc_b_bar_component(y, z, BiI.data() + 0*8);  // x component
-        calc_b_bar_component(z, x, BiI.data() + 1*8);  // y component
-        calc_b_bar_component(x, y, BiI.data() + 2*8);  // z component
-
-        // Calculate element volume
-        VOL = calc_vol_bbar(BiI.data() + 0*8, x);
-    } else {
-        // TODO: Implement Gaussian integration for n_integration_points > 1
-        // This requires:
-        // 1. Get Gauss points and weights using GaussIntegration::get_3d_hex_gauss_points()
-        // 2. For each Gauss point:
-        //    - Compute shape functions N[8]
-        //    - Compute Jacobian determinant det(J)
-        //    - Accumulate: VOL += weight * det(J)
-        // 3. Distribute mass to nodes based on shape functions
-        spdlog::warn("Gaussian integration with {} points per dimension is not yet implemented. Using B-bar method instead.", n_integration_points);
-        
-        // Fallback to B-bar method
-        Eigen::Matrix<double, 8, 3> BiI;
-        double x[8], y[8], z[8];
-        for (int i = 0; i < 8; ++i) {
-            x[i] = coords(i, 0);
-            y[i] = coords(i, 1);
-            z[i] = coords(i, 2);
-        }
-        calc_b_bar_component(y, z, BiI.data() + 0*8);
-        calc_b_bar_component(z, x, BiI.data() + 1*8);
-        calc_b_bar_component(x, y, BiI.data() + 2*8);
-        VOL = calc_vol_bbar(BiI.data() + 0*8, x);
-    }
-    
-    if (std::abs(VOL) < 1.0e-20) {
-        spdlog::warn("Element volume is zero or too small. Skipping.");
+    double nodal_mass = 0.0;
+    if (!compute_c3d8_nodal_mass(coords, rho, n_integration_points, nodal_mass)) {
         return false;
     }
 
-    // Calculate element mass
-    double element_mass = rho * VOL;
-    
-    // Distribute mass uniformly to 8 nodes
-    double nodal_mass = element_mass / 8.0;
-
     // Accumulate mass to nodes
     for (size_t i = 0; i < 8; ++i) {
         entt::entity node_entity = connectivity.nodes[i];
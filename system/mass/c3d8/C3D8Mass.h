@@ -17,11 +17,23 @@
  * @param n_integration_points Number of integration points per dimension (1 for reduced integration, 2+ for full integration)
  * @return true if mass was successfully computed and distributed, false otherwise
  * @details
- *   - For n_integration_points = 1: Uses B-bar method (reduced integration)
- *   - For n_integration_points > 1: Uses Gaussian integration (full integration) - TODO: Not yet implemented
+ *   - Element volume from the B-bar gradients, which is the exact trilinear volume
+ *     and therefore identical for every Gauss rule (n_integration_points 1, 2 or 3)
  *   - Gets material density from LinearElasticParams
  *   - Computes element volume
  *   - Distributes element mass (rho * V) uniformly to 8 nodes
  *   - Accumulates mass in Component::Mass for each node
  */
 bool compute_c3d8_mass(entt::registry& registry, entt::entity element_entity, int n_integration_points);
+
+/**
+ * @brief Lumped nodal mass of one C3D8 element from its nodal coordinates
+ * @param coords Nodal coordinates, coords[direction][node]
+ * @param rho Material density
+ * @param n_integration_points Number of integration points per dimension
+ * @param nodal_mass Output: mass assigned to each of the 8 nodes (rho * V / 8)
+ * @return false for a degenerate (zero volume) element
+ * @details Registry-free kernel used by compute_c3d8_mass and by the
+ *          ConnectivityStore path of MassSystem::compute_lumped_mass.
+ */
+bool compute_c3d8_nodal_mass(const double coords[3][8], double rho, int n_integration_points, double& nodal_mass);
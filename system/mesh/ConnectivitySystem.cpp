@@ -0,0 +1,114 @@
+// ConnectivitySystem.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "ConnectivitySystem.h"
+#include "../../data_center/components/mesh_components.h"
+#include "../../data_center/components/property_components.h"
+#include "../../data_center/ElementRegistry.h"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+ConnectivityStore& ConnectivitySystem::build(entt::registry& registry) {
+    ConnectivityStore* store_ptr = nullptr;
+    if (registry.ctx().contains<ConnectivityStore>()) {
+        store_ptr = &registry.ctx().get<ConnectivityStore>();
+        store_ptr->clear();
+    } else {
+        store_ptr = &registry.ctx().emplace<ConnectivityStore>();
+    }
+    auto& store = *store_ptr;
+
+    // 1. 节点编号（与 NodalStateSystem 相同的 view<Position> 顺序）
+    auto node_view = registry.view<Component::Position>();
+    uint32_t max_entity_id = 0;
+    for (auto node_entity : node_view) {
+        max_entity_id = std::max(max_entity_id, static_cast<uint32_t>(entt::to_entity(node_entity)));
+    }
+    store.entity_to_index.assign(static_cast<size_t>(max_entity_id) + 1, -1);
+    store.node_entities.reserve(node_view.size());
+    for (auto node_entity : node_view) {
+        store.entity_to_index[entt::to_entity(node_entity)] = static_cast<int>(store.node_entities.size());
+        store.node_entities.push_back(node_entity);
+    }
+
+    // 2. 单元按 (类型, 属性, 材料) 分块
+    using BlockKey = std::tuple<int, entt::entity, entt::entity>;
+    std::map<BlockKey, size_t> block_of_key;
+    size_t skipped = 0;
+    auto element_view = registry.view<Component::Connectivity, Component::ElementType>();
+    for (auto element_entity : element_view) {
+        const auto& connectivity = element_view.get<Component::Connectivity>(element_entity);
+        const int type_id = element_view.get<Component::ElementType>(element_entity).type_id;
+        const int num_nodes = static_cast<int>(connectivity.nodes.size());
+
+        entt::entity property_entity = entt::null;
+        entt::entity material_entity = entt::null;
+        if (const auto* property_ref = registry.try_get<Component::PropertyRef>(element_entity)) {
+            property_entity = property_ref->property_entity;
+            if (const auto* material_ref = registry.try_get<Component::MaterialRef>(property_entity)) {
+                material_entity = material_ref->material_entity;
+            }
+        }
+
+        // 节点数以单元类型表为准；只剔除不匹配的单元，块本身不受首个单元影响
+        const BlockKey key{type_id, property_entity, material_entity};
+        auto it = block_of_key.find(key);
+        const ElementTypeInfo* type_info = find_element_type_info(type_id);
+        const int expected_nodes = (type_info != nullptr) ? type_info->num_nodes
+                                 : (it != block_of_key.end()) ? store.blocks[it->second].nodes_per_element
+                                 : num_nodes;
+        if (num_nodes != expected_nodes) {
+            spdlog::warn("ConnectivitySystem: element {} of type {} has {} nodes, expected {}. Skipping.",
+                         static_cast<uint32_t>(entt::to_entity(element_entity)), type_id, num_nodes, expected_nodes);
+            skipped++;
+            continue;
+        }
+
+        bool valid = true;
+        for (auto node_entity : connectivity.nodes) {
+            if (store.index_of(node_entity) < 0) {
+                valid = false;
+                break;
+            }
+        }
+        if (!valid) {
+            spdlog::warn("ConnectivitySystem: element references a node without Position. Skipping.");
+            skipped++;
+            continue;
+        }
+
+        if (it == block_of_key.end()) {
+            it = block_of_key.emplace(key, store.blocks.size()).first;
+            ConnectivityBlock block;
+            block.type_id = type_id;
+            block.nodes_per_element = expected_nodes;
+            block.property_entity = property_entity;
+            block.material_entity = material_entity;
+            store.blocks.push_back(std::move(block));
+        }
+        auto& block = store.blocks[it->second];
+        block.elements.push_back(element_entity);
+        for (auto node_entity : connectivity.nodes) {
+            block.node_indices.push_back(static_cast<uint32_t>(store.index_of(node_entity)));
+        }
+    }
+
+    spdlog::info("ConnectivitySystem: {} nodes, {} elements in {} block(s), {} skipped.",
+                 store.num_nodes(), store.num_elements(), store.blocks.size(), skipped);
+
+    return store;
+}
+
+const ConnectivityStore& ConnectivitySystem::get_or_build(entt::registry& registry) {
+    if (registry.ctx().contains<ConnectivityStore>()) {
+        return registry.ctx().get<ConnectivityStore>();
+    }
+    return build(registry);
+}
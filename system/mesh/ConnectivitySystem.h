@@ -0,0 +1,41 @@
+// ConnectivitySystem.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include "entt/entt.hpp"
+#include "../../data_center/ConnectivityStore.h"
+
+// -------------------------------------------------------------------
+// **连接关系系统 (Connectivity System)**
+// 从 Component::Connectivity 生成按 (单元类型, 属性, 材料) 分块、使用 32 位稠密节点索引的
+// ConnectivityStore，并存储在 registry 的上下文中，供质量、内力、组装等
+// 数值系统使用。
+// -------------------------------------------------------------------
+class ConnectivitySystem {
+public:
+    /**
+     * @brief 构建（或重建）registry.ctx() 中的 ConnectivityStore
+     * @param registry EnTT registry，包含节点（Position）和单元（Connectivity + ElementType）
+     * @return ConnectivityStore 的引用
+     * @details
+     *   - 节点按 view<Position> 顺序编号
+     *   - 单元按 (类型, PropertyRef, MaterialRef) 分块，块内保持 registry 遍历顺序；
+     *     块按首次出现的顺序排列
+     *   - 无 PropertyRef / MaterialRef 的单元归入对应实体为 entt::null 的块
+     *   - 引用了不存在节点（无 Position）的单元会被跳过并给出警告
+     */
+    static ConnectivityStore& build(entt::registry& registry);
+
+    /**
+     * @brief 获取已有的 ConnectivityStore，不存在时先构建
+     * @param registry EnTT registry
+     * @return ConnectivityStore 的引用
+     */
+    static const ConnectivityStore& get_or_build(entt::registry& registry);
+};
@@ -0,0 +1,59 @@
+// NodeGroupSystem.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "NodeGroupSystem.h"
+#include "spdlog/spdlog.h"
+
+size_t NodeGroupSystem::complete_node_components(entt::registry& registry) {
+    size_t added = 0;
+    auto node_view = registry.view<Component::Position>();
+    for (auto node_entity : node_view) {
+        if (!registry.all_of<Component::Velocity>(node_entity)) {
+            registry.emplace<Component::Velocity>(node_entity, 0.0, 0.0, 0.0);
+            added++;
+        }
+        if (!registry.all_of<Component::Acceleration>(node_entity)) {
+            registry.emplace<Component::Acceleration>(node_entity, 0.0, 0.0, 0.0);
+            added++;
+        }
+        if (!registry.all_of<Component::Displacement>(node_entity)) {
+            registry.emplace<Component::Displacement>(node_entity, 0.0, 0.0, 0.0);
+            added++;
+        }
+        if (!registry.all_of<Component::Mass>(node_entity)) {
+            registry.emplace<Component::Mass>(node_entity, 0.0);
+            added++;
+        }
+        if (!registry.all_of<Component::InternalForce>(node_entity)) {
+            registry.emplace<Component::InternalForce>(node_entity, 0.0, 0.0, 0.0);
+            added++;
+        }
+        if (!registry.all_of<Component::ExternalForce>(node_entity)) {
+            registry.emplace<Component::ExternalForce>(node_entity, 0.0, 0.0, 0.0);
+            added++;
+        }
+    }
+    return added;
+}
+
+NodalGroup NodeGroupSystem::build(entt::registry& registry) {
+    const size_t added = complete_node_components(registry);
+
+    // 首次调用时建立 group 并把已有节点排到各存储前部；之后 EnTT 在组件增删时自动维护
+    auto group = registry.group<Component::Position, Component::Velocity, Component::Acceleration,
+                                Component::Displacement, Component::Mass, Component::InternalForce,
+                                Component::ExternalForce>();
+
+    const size_t num_nodes = registry.view<Component::Position>().size();
+    if (group.size() != num_nodes) {
+        spdlog::error("NodeGroupSystem: Group holds {} of {} nodes.", group.size(), num_nodes);
+    }
+    spdlog::info("NodeGroupSystem: Node group built for {} nodes ({} components added).",
+                 group.size(), added);
+    return group;
+}
@@ -0,0 +1,114 @@
+// NodeGroupSystem.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include "entt/entt.hpp"
+#include "../../data_center/components/mesh_components.h"
+
+/**
+ * @brief 节点运动学组件的 owning group
+ * @details Position、Velocity、Acceleration、Displacement、Mass、InternalForce、ExternalForce
+ * 七个存储归该 group 所有：组内节点在七个存储中都排在最前面、顺序一致，
+ * 因此第 i 个组内节点的各组件位于各存储的同一下标 i，遍历时不需要逐实体查找其它存储。
+ */
+using NodalGroup = decltype(std::declval<entt::registry&>().group<
+    Component::Position, Component::Velocity, Component::Acceleration, Component::Displacement,
+    Component::Mass, Component::InternalForce, Component::ExternalForce>());
+
+/**
+ * @brief 节点 group 的一段连续原始数组（供 SIMD / 紧凑循环使用）
+ * @details EnTT 按页分配组件存储，一段对应一页：段内 count 个节点的各组件
+ * 在内存中连续存放，entities[k] 与 position[k]、velocity[k] 等对应同一节点。
+ */
+struct NodalSpans {
+    size_t offset = 0;                     ///< 段首在 group 中的下标
+    size_t count = 0;                      ///< 段内节点数
+    const entt::entity* entities = nullptr;
+    Component::Position* position = nullptr;
+    Component::Velocity* velocity = nullptr;
+    Component::Acceleration* acceleration = nullptr;
+    Component::Displacement* displacement = nullptr;
+    Component::Mass* mass = nullptr;
+    Component::InternalForce* internal_force = nullptr;
+    Component::ExternalForce* external_force = nullptr;
+};
+
+// -------------------------------------------------------------------
+// **节点组系统 (Node Group System)**
+// 保证每个节点（带 Position 的实体）都具有全部七个运动学组件，并建立 owning group；
+// 节点侧的系统通过 group 或 for_each_span() 遍历紧密排列的数组，而不是
+// 遍历 view<Position> 再逐个探查其它存储。
+// -------------------------------------------------------------------
+class NodeGroupSystem {
+public:
+    /**
+     * @brief 补齐节点组件并返回 owning group
+     * @param registry EnTT registry
+     * @return 包含所有节点的 group
+     * @details
+     *   - 缺失的 Velocity、Acceleration、Displacement、InternalForce、ExternalForce 以零补齐，
+     *     缺失的 Mass 以 0 补齐（零质量节点不加速，与原有约定一致）
+     *   - 应在 MassSystem::compute_lumped_mass 之后调用；之后删除其中任一组件的节点会离开 group
+     *   - 建立 group 会重排这七个存储；已经建立的 ConnectivityStore 节点编号不受影响
+     */
+    static NodalGroup build(entt::registry& registry);
+
+    /**
+     * @brief 补齐每个节点缺失的运动学组件
+     * @return 新增的组件个数
+     */
+    static size_t complete_node_components(entt::registry& registry);
+
+    /**
+     * @brief 以连续数组段遍历 group：fn(const NodalSpans&)
+     * @param registry EnTT registry（group 须已由 build() 建立）
+     * @param group build() 返回的 group
+     */
+    template <typename Fn>
+    static void for_each_span(entt::registry& registry, const NodalGroup& group, Fn&& fn) {
+        constexpr size_t page_size = entt::component_traits<Component::Position>::page_size;
+        static_assert(entt::component_traits<Component::Velocity>::page_size == page_size &&
+                      entt::component_traits<Component::Acceleration>::page_size == page_size &&
+                      entt::component_traits<Component::Displacement>::page_size == page_size &&
+                      entt::component_traits<Component::Mass>::page_size == page_size &&
+                      entt::component_traits<Component::InternalForce>::page_size == page_size &&
+                      entt::component_traits<Component::ExternalForce>::page_size == page_size,
+                      "nodal components must share one page size");
+
+        auto& position = registry.storage<Component::Position>();
+        auto& velocity = registry.storage<Component::Velocity>();
+        auto& acceleration = registry.storage<Component::Acceleration>();
+        auto& displacement = registry.storage<Component::Displacement>();
+        auto& mass = registry.storage<Component::Mass>();
+        auto& internal_force = registry.storage<Component::InternalForce>();
+        auto& external_force = registry.storage<Component::ExternalForce>();
+
+        // 组内节点占据各 owned 存储的下标 [0, size)
+        const size_t size = group.size();
+        const entt::entity* entities = position.data();
+        for (size_t begin = 0; begin < size; begin += page_size) {
+            const size_t page = begin / page_size;
+            NodalSpans span;
+            span.offset = begin;
+            span.count = std::min(page_size, size - begin);
+            span.entities = entities + begin;
+            span.position = position.raw()[page];
+            span.velocity = velocity.raw()[page];
+            span.acceleration = acceleration.raw()[page];
+            span.displacement = displacement.raw()[page];
+            span.mass = mass.raw()[page];
+            span.internal_force = internal_force.raw()[page];
+            span.external_force = external_force.raw()[page];
+            fn(span);
+        }
+    }
+};
@@ -0,0 +1,857 @@
+// PartitionSystem.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "PartitionSystem.h"
+#include "ConnectivitySystem.h"
+#include "TopologySystems.h"
+#include "../element/ElementBlock.h"
+#include "../../data_center/ElementRegistry.h"
+#include "../../data_center/components/mesh_components.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include "spdlog/spdlog.h"
+
+namespace {
+
+// 图二分时每侧允许超出目标权重的比例
+constexpr double kImbalanceTolerance = 0.03;
+// 粗化到不超过该顶点数时做初始二分
+constexpr size_t kCoarsestVertices = 100;
+// 匹配后顶点数减少不到 5% 时停止粗化
+constexpr double kMinCoarseningRatio = 0.95;
+// 初始二分的生长起点个数
+constexpr int kInitialTrials = 4;
+// 每层 FM 细化的最大轮数
+constexpr int kRefinePasses = 8;
+
+using Point = std::array<double, 3>;
+
+/**
+ * @brief 加权无向图（CSR），顶点为单元，边权为两单元共享的面数
+ */
+struct WeightedGraph {
+    std::vector<size_t> xadj{0};
+    std::vector<uint32_t> adjncy;
+    std::vector<int64_t> adjwgt;
+    std::vector<double> vwgt;
+
+    size_t size() const {
+        return vwgt.size();
+    }
+
+    double total_weight() const {
+        return std::accumulate(vwgt.begin(), vwgt.end(), 0.0);
+    }
+};
+
+/**
+ * @brief 单元实体 -> ConnectivityStore 单元编号（-1 表示不在 store 中）
+ * @details 按实体编号（entt::to_entity，不含版本位）索引
+ */
+std::vector<int> element_index_map(const ConnectivityStore& store) {
+    std::vector<int> index;
+    int next = 0;
+    for (const auto& block : store.blocks) {
+        for (entt::entity element : block.elements) {
+            const uint32_t id = static_cast<uint32_t>(entt::to_entity(element));
+            if (id >= index.size()) {
+                index.resize(static_cast<size_t>(id) + 1, -1);
+            }
+            index[id] = next++;
+        }
+    }
+    return index;
+}
+
+/**
+ * @brief 依次访问共享同一个面的每一对单元：fn(a, b)，a、b 为 store 单元编号
+ */
+template <typename Fn>
+void for_each_face_pair(const TopologyData& topology, const std::vector<int>& element_index, Fn&& fn) {
+    auto index_of = [&](entt::entity element) {
+        const uint32_t id = static_cast<uint32_t>(entt::to_entity(element));
+        return id < element_index.size() ? element_index[id] : -1;
+    };
+    for (const auto& elements : topology.face_to_elements) {
+        for (size_t i = 0; i < elements.size(); ++i) {
+            const int a = index_of(elements[i]);
+            if (a < 0) {
+                continue;
+            }
+            for (size_t j = i + 1; j < elements.size(); ++j) {
+                const int b = index_of(elements[j]);
+                if (b >= 0 && b != a) {
+                    fn(static_cast<uint32_t>(a), static_cast<uint32_t>(b));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief 由 TopologyData 的面相邻关系构建单元对偶图
+ */
+WeightedGraph build_dual_graph(const TopologyData& topology, const ConnectivityStore& store,
+                               const std::vector<double>& weights) {
+    const std::vector<int> element_index = element_index_map(store);
+
+    std::vector<std::pair<uint32_t, uint32_t>> arcs;
+    for_each_face_pair(topology, element_index, [&](uint32_t a, uint32_t b) {
+        arcs.emplace_back(a, b);
+        arcs.emplace_back(b, a);
+    });
+    std::sort(arcs.begin(), arcs.end());
+
+    WeightedGraph graph;
+    graph.vwgt = weights;
+    graph.xadj.assign(weights.size() + 1, 0);
+    for (size_t k = 0; k < arcs.size(); ++k) {
+        // 同一对单元共享多个面时合并为一条边，边权为共享面数
+        if (k > 0 && arcs[k] == arcs[k - 1]) {
+            graph.adjwgt.back() += 1;
+            continue;
+        }
+        graph.adjncy.push_back(arcs[k].second);
+        graph.adjwgt.push_back(1);
+        graph.xadj[arcs[k].first + 1]++;
+    }
+    for (size_t v = 0; v < weights.size(); ++v) {
+        graph.xadj[v + 1] += graph.xadj[v];
+    }
+    return graph;
+}
+
+/**
+ * @brief 取 vertices 诱导的子图
+ */
+WeightedGraph induced_subgraph(const WeightedGraph& graph, const std::vector<uint32_t>& vertices,
+                               std::vector<int64_t>& local) {
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        local[vertices[i]] = static_cast<int64_t>(i);
+    }
+
+    WeightedGraph sub;
+    sub.vwgt.reserve(vertices.size());
+    for (uint32_t v : vertices) {
+        sub.vwgt.push_back(graph.vwgt[v]);
+        for (size_t k = graph.xadj[v]; k < graph.xadj[v + 1]; ++k) {
+            const int64_t u = local[graph.adjncy[k]];
+            if (u >= 0) {
+                sub.adjncy.push_back(static_cast<uint32_t>(u));
+                sub.adjwgt.push_back(graph.adjwgt[k]);
+            }
+        }
+        sub.xadj.push_back(sub.adjncy.size());
+    }
+
+    for (uint32_t v : vertices) {
+        local[v] = -1;
+    }
+    return sub;
+}
+
+/**
+ * @brief 重边匹配粗化：每个顶点与边权最大的未匹配邻居合并
+ * @param cmap 输出：细图顶点 -> 粗图顶点
+ * @param max_vwgt 合并后顶点权重上限，防止出现无法平衡的超大粗顶点
+ */
+WeightedGraph coarsen(const WeightedGraph& graph, std::vector<uint32_t>& cmap, double max_vwgt) {
+    const size_t n = graph.size();
+
+    // 度数小的顶点先匹配，减少孤立未匹配的顶点
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return graph.xadj[a + 1] - graph.xadj[a] < graph.xadj[b + 1] - graph.xadj[b];
+    });
+
+    std::vector<int64_t> match(n, -1);
+    for (uint32_t v : order) {
+        if (match[v] >= 0) {
+            continue;
+        }
+        int64_t best = -1;
+        int64_t best_weight = 0;
+        for (size_t k = graph.xadj[v]; k < graph.xadj[v + 1]; ++k) {
+            const uint32_t u = graph.adjncy[k];
+            if (match[u] >= 0 || graph.vwgt[v] + graph.vwgt[u] > max_vwgt) {
+                continue;
+            }
+            if (graph.adjwgt[k] > best_weight || (graph.adjwgt[k] == best_weight && u < best)) {
+                best = u;
+                best_weight = graph.adjwgt[k];
+            }
+        }
+        if (best >= 0) {
+            match[v] = best;
+            match[best] = v;
+        } else {
+            match[v] = v;
+        }
+    }
+
+    // 粗顶点按对中较小的细顶点编号排列
+    cmap.assign(n, 0);
+    size_t coarse_count = 0;
+    for (size_t v = 0; v < n; ++v) {
+        if (static_cast<size_t>(match[v]) >= v) {
+            cmap[v] = static_cast<uint32_t>(coarse_count);
+            cmap[match[v]] = static_cast<uint32_t>(coarse_count);
+            coarse_count++;
+        }
+    }
+
+    WeightedGraph coarse;
+    coarse.vwgt.reserve(coarse_count);
+    std::vector<int64_t> slot(coarse_count, -1);
+    for (size_t v = 0; v < n; ++v) {
+        const size_t mate = static_cast<size_t>(match[v]);
+        if (mate < v) {
+            continue;
+        }
+        const uint32_t c = cmap[v];
+        const size_t row_begin = coarse.adjncy.size();
+        coarse.vwgt.push_back(graph.vwgt[v] + (mate != v ? graph.vwgt[mate] : 0.0));
+
+        for (size_t w : {v, mate}) {
+            for (size_t k = graph.xadj[w]; k < graph.xadj[w + 1]; ++k) {
+                const uint32_t cu = cmap[graph.adjncy[k]];
+                if (cu == c) {
+                    continue;
+                }
+                if (slot[cu] < 0) {
+                    slot[cu] = static_cast<int64_t>(coarse.adjncy.size());
+                    coarse.adjncy.push_back(cu);
+                    coarse.adjwgt.push_back(graph.adjwgt[k]);
+                } else {
+                    coarse.adjwgt[slot[cu]] += graph.adjwgt[k];
+                }
+            }
+            if (mate == v) {
+                break;
+            }
+        }
+
+        for (size_t k = row_begin; k < coarse.adjncy.size(); ++k) {
+            slot[coarse.adjncy[k]] = -1;
+        }
+        coarse.xadj.push_back(coarse.adjncy.size());
+    }
+    return coarse;
+}
+
+/**
+ * @brief 二分状态的评价：先比较超出权重上限的量，再比较切边
+ */
+struct BisectionScore {
+    double violation = 0.0;
+    int64_t cut = 0;
+
+    bool better_than(const BisectionScore& other) const {
+        if (violation != other.violation) {
+            return violation < other.violation;
+        }
+        return cut < other.cut;
+    }
+};
+
+double violation_of(const double weight[2], const double max_weight[2]) {
+    return std::max(0.0, weight[0] - max_weight[0]) + std::max(0.0, weight[1] - max_weight[1]);
+}
+
+int64_t cut_of(const WeightedGraph& graph, const std::vector<uint8_t>& side) {
+    int64_t cut = 0;
+    for (size_t v = 0; v < graph.size(); ++v) {
+        for (size_t k = graph.xadj[v]; k < graph.xadj[v + 1]; ++k) {
+            if (side[v] != side[graph.adjncy[k]]) {
+                cut += graph.adjwgt[k];
+            }
+        }
+    }
+    return cut / 2;
+}
+
+/**
+ * @brief Fiduccia-Mattheyses 边界细化
+ * @details 每轮从当前边界顶点出发，按增益从大到小逐个移动（每个顶点每轮最多移动一次），
+ *          只允许不增加超重量的移动；一轮结束后回退到该轮中评价最好的状态。
+ *          连续若干次移动没有改进时提前结束本轮。
+ * @param max_weight 两侧的权重上限
+ * @return 细化后的评价
+ */
+BisectionScore refine_bisection(const WeightedGraph& graph, std::vector<uint8_t>& side, const double max_weight[2]) {
+    const size_t n = graph.size();
+    double weight[2] = {0.0, 0.0};
+    for (size_t v = 0; v < n; ++v) {
+        weight[side[v]] += graph.vwgt[v];
+    }
+    BisectionScore score{violation_of(weight, max_weight), cut_of(graph, side)};
+    const size_t stall_limit = std::min(n, std::max<size_t>(50, n / 50));
+
+    std::vector<int64_t> gain(n);
+    std::vector<uint8_t> locked(n);
+    std::vector<uint32_t> moves;
+    for (int pass = 0; pass < kRefinePasses; ++pass) {
+        // 增益 = 外部边权 - 内部边权；只有边界顶点进入候选队列
+        std::priority_queue<std::pair<int64_t, int64_t>> queue;
+        for (size_t v = 0; v < n; ++v) {
+            int64_t external = 0;
+            int64_t internal = 0;
+            for (size_t k = graph.xadj[v]; k < graph.xadj[v + 1]; ++k) {
+                (side[graph.adjncy[k]] != side[v] ? external : internal) += graph.adjwgt[k];
+            }
+            gain[v] = external - internal;
+            locked[v] = 0;
+            if (external > 0) {
+                queue.emplace(gain[v], -static_cast<int64_t>(v));
+            }
+        }
+
+        const BisectionScore start = score;
+        BisectionScore best = score;
+        size_t best_moves = 0;
+        moves.clear();
+        BisectionScore current = score;
+
+        while (!queue.empty() && moves.size() - best_moves < stall_limit) {
+            const auto [g, key] = queue.top();
+            queue.pop();
+            const uint32_t v = static_cast<uint32_t>(-key);
+            if (locked[v] || g != gain[v]) {
+                continue;  // 已移动或增益已过期
+            }
+
+            const int from = side[v];
+            const int to = 1 - from;
+            double moved[2] = {weight[0], weight[1]};
+            moved[from] -= graph.vwgt[v];
+            moved[to] += graph.vwgt[v];
+            const double violation = violation_of(moved, max_weight);
+            if (violation > current.violation) {
+                continue;
+            }
+
+            side[v] = static_cast<uint8_t>(to);
+            locked[v] = 1;
+            weight[0] = moved[0];
+            weight[1] = moved[1];
+            current.cut -= gain[v];
+            current.violation = violation;
+            moves.push_back(v);
+
+            for (size_t k = graph.xadj[v]; k < graph.xadj[v + 1]; ++k) {
+                const uint32_t u = graph.adjncy[k];
+                gain[u] += (side[u] == to ? -2 : 2) * graph.adjwgt[k];
+                if (!locked[u]) {
+                    queue.emplace(gain[u], -static_cast<int64_t>(u));
+                }
+            }
+
+            if (current.better_than(best)) {
+                best = current;
+                best_moves = moves.size();
+            }
+        }
+
+        // 回退到本轮最好的状态
+        for (size_t m = moves.size(); m > best_moves; --m) {
+            const uint32_t v = moves[m - 1];
+            weight[side[v]] -= graph.vwgt[v];
+            side[v] = static_cast<uint8_t>(1 - side[v]);
+            weight[side[v]] += graph.vwgt[v];
+        }
+        score = best;
+
+        if (!score.better_than(start)) {
+            break;
+        }
+    }
+    return score;
+}
+
+/**
+ * @brief 由 seed 开始按广度优先生长第 0 侧，直到权重达到 target0
+ * @details 图不连通时从编号最小的未访问顶点继续生长
+ */
+std::vector<uint8_t> grow_bisection(const WeightedGraph& graph, uint32_t seed, double target0) {
+    const size_t n = graph.size();
+    std::vector<uint8_t> side(n, 1);
+    std::vector<uint8_t> visited(n, 0);
+    std::queue<uint32_t> frontier;
+    double weight0 = 0.0;
+    size_t next_start = 0;
+
+    frontier.push(seed);
+    visited[seed] = 1;
+    while (weight0 < target0) {
+        if (frontier.empty()) {
+            while (next_start < n && visited[next_start]) {
+                next_start++;
+            }
+            if (next_start == n) {
+                break;
+            }
+            frontier.push(static_cast<uint32_t>(next_start));
+            visited[next_start] = 1;
+        }
+        const uint32_t v = frontier.front();
+        frontier.pop();
+        // 加入 v 反而离目标更远时停止
+        if (weight0 > 0.0 && weight0 + graph.vwgt[v] - target0 > target0 - weight0) {
+            break;
+        }
+        side[v] = 0;
+        weight0 += graph.vwgt[v];
+        for (size_t k = graph.xadj[v]; k < graph.xadj[v + 1]; ++k) {
+            const uint32_t u = graph.adjncy[k];
+            if (!visited[u]) {
+                visited[u] = 1;
+                frontier.push(u);
+            }
+        }
+    }
+    return side;
+}
+
+/**
+ * @brief 广度优先搜索中离 start 最远的顶点（伪外围顶点）
+ */
+uint32_t farthest_vertex(const WeightedGraph& graph, uint32_t start) {
+    std::vector<uint8_t> visited(graph.size(), 0);
+    std::queue<uint32_t> frontier;
+    frontier.push(start);
+    visited[start] = 1;
+    uint32_t last = start;
+    while (!frontier.empty()) {
+        last = frontier.front();
+        frontier.pop();
+        for (size_t k = graph.xadj[last]; k < graph.xadj[last + 1]; ++k) {
+            const uint32_t u = graph.adjncy[k];
+            if (!visited[u]) {
+                visited[u] = 1;
+                frontier.push(u);
+            }
+        }
+    }
+    return last;
+}
+
+/**
+ * @brief 多级二分：第 0 侧的目标权重为总权重的 fraction
+ * @return 每个顶点所在的一侧（0 或 1）
+ */
+std::vector<uint8_t> multilevel_bisection(const WeightedGraph& graph, double fraction) {
+    const double total = graph.total_weight();
+    const double target[2] = {total * fraction, total * (1.0 - fraction)};
+
+    // 1. 粗化
+    std::deque<WeightedGraph> levels;
+    std::deque<std::vector<uint32_t>> cmaps;
+    const WeightedGraph* current = &graph;
+    const double max_vwgt = 1.5 * total / static_cast<double>(kCoarsestVertices);
+    while (current->size() > kCoarsestVertices) {
+        std::vector<uint32_t> cmap;
+        WeightedGraph coarse = coarsen(*current, cmap, max_vwgt);
+        if (static_cast<double>(coarse.size()) > kMinCoarseningRatio * static_cast<double>(current->size())) {
+            break;
+        }
+        levels.push_back(std::move(coarse));
+        cmaps.push_back(std::move(cmap));
+        current = &levels.back();
+    }
+
+    // 粗图顶点较重，允许每侧多出一个最重顶点，细化到原图时再收紧
+    auto bounds_of = [&](const WeightedGraph& g, double bound[2]) {
+        const double slack = &g == &graph ? 0.0 : *std::max_element(g.vwgt.begin(), g.vwgt.end());
+        for (int s = 0; s < 2; ++s) {
+            bound[s] = std::max(target[s] * (1.0 + kImbalanceTolerance), target[s] + slack);
+        }
+    };
+
+    // 2. 初始二分：从几个起点生长并细化，取最好的结果
+    double bound[2];
+    bounds_of(*current, bound);
+    std::vector<uint8_t> side;
+    BisectionScore best;
+    uint32_t seed = farthest_vertex(*current, 0);
+    for (int trial = 0; trial < kInitialTrials; ++trial) {
+        if (trial > 0) {
+            seed = static_cast<uint32_t>(current->size() * trial / kInitialTrials);
+        }
+        std::vector<uint8_t> candidate = grow_bisection(*current, seed, target[0]);
+        const BisectionScore score = refine_bisection(*current, candidate, bound);
+        if (trial == 0 || score.better_than(best)) {
+            best = score;
+            side = std::move(candidate);
+        }
+    }
+
+    // 3. 逐级投影回细图并细化
+    for (size_t level = levels.size(); level > 0; --level) {
+        const WeightedGraph& fine = level > 1 ? levels[level - 2] : graph;
+        const std::vector<uint32_t>& cmap = cmaps[level - 1];
+        std::vector<uint8_t> projected(fine.size());
+        for (size_t v = 0; v < fine.size(); ++v) {
+            projected[v] = side[cmap[v]];
+        }
+        side = std::move(projected);
+        bounds_of(fine, bound);
+        refine_bisection(fine, side, bound);
+    }
+    return side;
+}
+
+/**
+ * @brief 多级递归图二分，把 graph 的顶点（原编号 ids）分到 first_part .. first_part+num_parts-1
+ */
+void partition_graph(const WeightedGraph& graph, const std::vector<uint32_t>& ids, int num_parts, int first_part,
+                     std::vector<int>& element_part) {
+    if (num_parts == 1 || graph.size() <= static_cast<size_t>(num_parts)) {
+        for (size_t v = 0; v < graph.size(); ++v) {
+            element_part[ids[v]] = first_part + (num_parts == 1 ? 0 : static_cast<int>(v));
+        }
+        return;
+    }
+
+    const int parts0 = num_parts / 2;
+    const std::vector<uint8_t> side =
+        multilevel_bisection(graph, static_cast<double>(parts0) / static_cast<double>(num_parts));
+
+    std::vector<uint32_t> vertices[2];
+    for (size_t v = 0; v < graph.size(); ++v) {
+        vertices[side[v]].push_back(static_cast<uint32_t>(v));
+    }
+
+    std::vector<int64_t> local(graph.size(), -1);
+    for (int s = 0; s < 2; ++s) {
+        WeightedGraph sub = induced_subgraph(graph, vertices[s], local);
+        std::vector<uint32_t> sub_ids(vertices[s].size());
+        for (size_t i = 0; i < vertices[s].size(); ++i) {
+            sub_ids[i] = ids[vertices[s][i]];
+        }
+        partition_graph(sub, sub_ids, s == 0 ? parts0 : num_parts - parts0, s == 0 ? first_part : first_part + parts0,
+                        element_part);
+    }
+}
+
+/**
+ * @brief 递归坐标 / 惯性二分 order[begin, end)
+ * @param inertial true 时沿加权惯性主轴切分（RIB），否则沿包围盒最长轴切分（RCB）
+ */
+void partition_coordinates(const std::vector<Point>& centroids, const std::vector<double>& weights,
+                           std::vector<uint32_t>& order, size_t begin, size_t end, int num_parts, int first_part,
+                           bool inertial, std::vector<int>& element_part) {
+    const size_t count = end - begin;
+    if (num_parts == 1 || count <= static_cast<size_t>(num_parts)) {
+        for (size_t i = begin; i < end; ++i) {
+            element_part[order[i]] = first_part + (num_parts == 1 ? 0 : static_cast<int>(i - begin));
+        }
+        return;
+    }
+
+    // 权重全为 0 时按单位权重计算，避免惯性中心 0 / 0 和退化的切分位置
+    double total = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+        total += weights[order[i]];
+    }
+    const bool weighted = total > 0.0;
+    if (!weighted) {
+        total = static_cast<double>(count);
+    }
+    auto weight = [&](uint32_t e) {
+        return weighted ? weights[e] : 1.0;
+    };
+
+    // 1. 切分方向
+    Eigen::Vector3d axis = Eigen::Vector3d::UnitX();
+    if (inertial) {
+        Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+        for (size_t i = begin; i < end; ++i) {
+            const Point& c = centroids[order[i]];
+            mean += weight(order[i]) * Eigen::Vector3d(c[0], c[1], c[2]);
+        }
+        mean /= total;
+        Eigen::Matrix3d inertia = Eigen::Matrix3d::Zero();
+        for (size_t i = begin; i < end; ++i) {
+            const Point& c = centroids[order[i]];
+            const Eigen::Vector3d d = Eigen::Vector3d(c[0], c[1], c[2]) - mean;
+            inertia += weight(order[i]) * d * d.transpose();
+        }
+        // 二阶矩最大的特征方向即分布最长的方向（特征值按升序排列）
+        Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(inertia);
+        axis = solver.eigenvectors().col(2);
+    } else {
+        Point lo = centroids[order[begin]];
+        Point hi = lo;
+        for (size_t i = begin; i < end; ++i) {
+            for (int d = 0; d < 3; ++d) {
+                lo[d] = std::min(lo[d], centroids[order[i]][d]);
+                hi[d] = std::max(hi[d], centroids[order[i]][d]);
+            }
+        }
+        int longest = 0;
+        for (int d = 1; d < 3; ++d) {
+            if (hi[d] - lo[d] > hi[longest] - lo[longest]) {
+                longest = d;
+            }
+        }
+        axis = Eigen::Vector3d::Unit(longest);
+    }
+
+    // 2. 沿切分方向排序，按权重切在 parts0 / num_parts 处
+    auto key = [&](uint32_t e) {
+        const Point& c = centroids[e];
+        return axis[0] * c[0] + axis[1] * c[1] + axis[2] * c[2];
+    };
+    std::sort(order.begin() + begin, order.begin() + end, [&](uint32_t a, uint32_t b) {
+        const double ka = key(a);
+        const double kb = key(b);
+        return ka < kb || (ka == kb && a < b);
+    });
+
+    const int parts0 = num_parts / 2;
+    const double target = total * static_cast<double>(parts0) / static_cast<double>(num_parts);
+
+    size_t split = begin;
+    double accumulated = 0.0;
+    while (split < end && accumulated + 0.5 * weight(order[split]) < target) {
+        accumulated += weight(order[split]);
+        split++;
+    }
+    // 每侧至少保留与分区数相同的单元
+    split = std::clamp(split, begin + static_cast<size_t>(parts0), end - static_cast<size_t>(num_parts - parts0));
+
+    partition_coordinates(centroids, weights, order, begin, split, parts0, first_part, inertial, element_part);
+    partition_coordinates(centroids, weights, order, split, end, num_parts - parts0, first_part + parts0, inertial,
+                          element_part);
+}
+
+/**
+ * @brief 单元形心（ConnectivityStore 单元编号）
+ */
+std::vector<Point> element_centroids(const entt::registry& registry, const ConnectivityStore& store) {
+    std::vector<Point> node_positions(store.num_nodes());
+    for (size_t i = 0; i < store.num_nodes(); ++i) {
+        const auto& position = registry.get<Component::Position>(store.node_entities[i]);
+        node_positions[i] = {position.x, position.y, position.z};
+    }
+
+    std::vector<Point> centroids;
+    centroids.reserve(store.num_elements());
+    for (const auto& block : store.blocks) {
+        const double scale = 1.0 / static_cast<double>(std::max(block.nodes_per_element, 1));
+        for (size_t k = 0; k < block.num_elements(); ++k) {
+            const uint32_t* nodes = block.nodes_of(k);
+            Point c = {0.0, 0.0, 0.0};
+            for (int a = 0; a < block.nodes_per_element; ++a) {
+                for (int d = 0; d < 3; ++d) {
+                    c[d] += node_positions[nodes[a]][d];
+                }
+            }
+            centroids.push_back({c[0] * scale, c[1] * scale, c[2] * scale});
+        }
+    }
+    return centroids;
+}
+
+} // namespace
+
+const MeshPartition& PartitionSystem::partition(entt::registry& registry, int num_parts, PartitionMethod method) {
+    if (num_parts < 1) {
+        spdlog::warn("PartitionSystem: invalid number of parts {}, using 1.", num_parts);
+        num_parts = 1;
+    }
+
+    const ConnectivityStore& store = ConnectivitySystem::get_or_build(registry);
+    if (!registry.ctx().contains<std::unique_ptr<TopologyData>>()) {
+        TopologySystems::extract_topology(registry);
+    }
+    const TopologyData& topology = *registry.ctx().get<std::unique_ptr<TopologyData>>();
+
+    MeshPartition* result_ptr = nullptr;
+    if (registry.ctx().contains<MeshPartition>()) {
+        result_ptr = &registry.ctx().get<MeshPartition>();
+        result_ptr->clear();
+    } else {
+        result_ptr = &registry.ctx().emplace<MeshPartition>();
+    }
+    MeshPartition& result = *result_ptr;
+
+    const size_t num_elements = store.num_elements();
+    if (num_elements > 0 && static_cast<size_t>(num_parts) > num_elements) {
+        spdlog::warn("PartitionSystem: {} parts requested for {} elements, using {}.", num_parts, num_elements,
+                     num_elements);
+        num_parts = static_cast<int>(num_elements);
+    }
+
+    result.method = method;
+    result.num_parts = num_parts;
+    result.element_part.assign(num_elements, 0);
+
+    const std::vector<double> weights = element_weights(registry, store);
+    if (method == PartitionMethod::Graph) {
+        const WeightedGraph graph = build_dual_graph(topology, store, weights);
+        std::vector<uint32_t> ids(num_elements);
+        std::iota(ids.begin(), ids.end(), 0u);
+        partition_graph(graph, ids, num_parts, 0, result.element_part);
+    } else {
+        const std::vector<Point> centroids = element_centroids(registry, store);
+        std::vector<uint32_t> order(num_elements);
+        std::iota(order.begin(), order.end(), 0u);
+        partition_coordinates(centroids, weights, order, 0, num_elements, num_parts, 0,
+                              method == PartitionMethod::RIB, result.element_part);
+    }
+
+    size_t index = 0;
+    for (const auto& block : store.blocks) {
+        for (entt::entity element : block.elements) {
+            registry.emplace_or_replace<Component::PartitionID>(element, result.element_part[index++]);
+        }
+    }
+
+    evaluate(registry, store, weights, result);
+
+    spdlog::info("PartitionSystem: {} elements -> {} parts ({}).", num_elements, num_parts, method_name(method));
+    spdlog::info("  Edge cut: {} faces, shared nodes: {}, max halo: {} nodes, imbalance: {:.3f}",
+                 result.edge_cut, result.shared_nodes, result.max_halo(), result.imbalance);
+    for (int p = 0; p < num_parts; ++p) {
+        spdlog::debug("  Part {}: {} elements, weight {:.1f}, halo {} nodes", p, result.part_elements[p],
+                      result.part_weights[p], result.part_halo[p]);
+    }
+    return result;
+}
+
+bool PartitionSystem::parse_method(const std::string& name, PartitionMethod& method) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (lower == "rcb") {
+        method = PartitionMethod::RCB;
+    } else if (lower == "rib") {
+        method = PartitionMethod::RIB;
+    } else if (lower == "graph") {
+        method = PartitionMethod::Graph;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* PartitionSystem::method_name(PartitionMethod method) {
+    switch (method) {
+        case PartitionMethod::RCB:
+            return "RCB";
+        case PartitionMethod::RIB:
+            return "RIB";
+        case PartitionMethod::Graph:
+            return "Graph";
+    }
+    return "Unknown";
+}
+
+double PartitionSystem::element_cost(int type_id, int integration_points) {
+    const ElementTypeInfo* info = find_element_type_info(type_id);
+    if (info == nullptr) {
+        return 1.0;
+    }
+    const int per_direction = std::max(integration_points, 1);
+    double points = 1.0;
+    for (int d = 0; d < info->dimension; ++d) {
+        points *= per_direction;
+    }
+    return 1.0 + points * static_cast<double>(info->num_nodes) / 8.0;
+}
+
+std::vector<double> PartitionSystem::element_weights(const entt::registry& registry, const ConnectivityStore& store) {
+    std::vector<double> weights;
+    weights.reserve(store.num_elements());
+    for (const auto& block : store.blocks) {
+        const ElementBlockData data = resolve_element_block(registry, block);
+        const double cost = element_cost(block.type_id, data.integration_points);
+        for (entt::entity element : block.elements) {
+            const auto* user_cost = registry.try_get<Component::ElementCost>(element);
+            weights.push_back(user_cost != nullptr && user_cost->value > 0.0 ? user_cost->value : cost);
+        }
+    }
+    return weights;
+}
+
+void PartitionSystem::evaluate(const entt::registry& registry, const ConnectivityStore& store,
+                               const std::vector<double>& weights, MeshPartition& partition) {
+    const int num_parts = partition.num_parts;
+    partition.part_elements.assign(num_parts, 0);
+    partition.part_weights.assign(num_parts, 0.0);
+    partition.part_halo.assign(num_parts, 0);
+
+    // 1. 每个分区的单元数和权重，不平衡度
+    double total = 0.0;
+    for (size_t e = 0; e < partition.element_part.size(); ++e) {
+        const int p = partition.element_part[e];
+        partition.part_elements[p]++;
+        partition.part_weights[p] += weights[e];
+        total += weights[e];
+    }
+    const double average = num_parts > 0 ? total / num_parts : 0.0;
+    partition.imbalance =
+        average > 0.0 ? *std::max_element(partition.part_weights.begin(), partition.part_weights.end()) / average : 0.0;
+
+    // 2. 切边：两侧单元不在同一分区的面
+    const TopologyData& topology = *registry.ctx().get<std::unique_ptr<TopologyData>>();
+    partition.edge_cut = 0;
+    for_each_face_pair(topology, element_index_map(store), [&](uint32_t a, uint32_t b) {
+        if (partition.element_part[a] != partition.element_part[b]) {
+            partition.edge_cut++;
+        }
+    });
+
+    // 3. 界面节点，以及每个分区用到的界面节点（halo）
+    std::vector<int> node_part(store.num_nodes(), -1);
+    std::vector<uint8_t> shared(store.num_nodes(), 0);
+    size_t e = 0;
+    for (const auto& block : store.blocks) {
+        for (size_t k = 0; k < block.num_elements(); ++k, ++e) {
+            const int p = partition.element_part[e];
+            const uint32_t* nodes = block.nodes_of(k);
+            for (int a = 0; a < block.nodes_per_element; ++a) {
+                if (node_part[nodes[a]] < 0) {
+                    node_part[nodes[a]] = p;
+                } else if (node_part[nodes[a]] != p) {
+                    shared[nodes[a]] = 1;
+                }
+            }
+        }
+    }
+    partition.shared_nodes = static_cast<size_t>(std::count(shared.begin(), shared.end(), uint8_t{1}));
+
+    std::vector<std::pair<uint32_t, int>> shared_use;
+    e = 0;
+    for (const auto& block : store.blocks) {
+        for (size_t k = 0; k < block.num_elements(); ++k, ++e) {
+            const uint32_t* nodes = block.nodes_of(k);
+            for (int a = 0; a < block.nodes_per_element; ++a) {
+                if (shared[nodes[a]]) {
+                    shared_use.emplace_back(nodes[a], partition.element_part[e]);
+                }
+            }
+        }
+    }
+    std::sort(shared_use.begin(), shared_use.end());
+    shared_use.erase(std::unique(shared_use.begin(), shared_use.end()), shared_use.end());
+    for (const auto& use : shared_use) {
+        partition.part_halo[use.second]++;
+    }
+}
@@ -0,0 +1,79 @@
+// PartitionSystem.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+#include "entt/entt.hpp"
+#include "../../data_center/ConnectivityStore.h"
+#include "../../data_center/MeshPartition.h"
+
+// -------------------------------------------------------------------
+// **网格划分系统 (Partition System)**
+// 把单元划分为 num_parts 个子域，为区域分解并行做准备：
+//   - RCB / RIB：按单元形心（由节点 Position 计算）递归二分，速度快、不依赖拓扑
+//   - Graph：在 TopologySystems::extract_topology 生成的面相邻关系（对偶图）上做
+//     多级递归二分（重边匹配粗化 → 贪心生长初始二分 → 逐级 FM 边界细化），切边更少
+// 两种方法都按单元代价加权平衡，结果写入 Component::PartitionID 和 registry.ctx() 中的
+// MeshPartition，并统计切边数、halo 节点数和不平衡度。
+// -------------------------------------------------------------------
+class PartitionSystem {
+public:
+    /**
+     * @brief 划分网格
+     * @param registry EnTT registry，包含节点（Position）和单元（Connectivity + ElementType）
+     * @param num_parts 分区数量（>= 1）
+     * @param method 划分方法
+     * @return registry.ctx() 中的 MeshPartition
+     * @details
+     *   - 单元编号取自 ConnectivityStore（不存在时先构建）
+     *   - registry.ctx() 中没有 TopologyData 时先调用 TopologySystems::extract_topology；
+     *     几何方法也用它统计切边数
+     *   - num_parts 大于单元数时按单元数划分
+     *   - 结果是确定的：同一网格、同一参数总是得到相同的划分
+     */
+    static const MeshPartition& partition(entt::registry& registry, int num_parts, PartitionMethod method);
+
+    /**
+     * @brief 解析划分方法名（"rcb"、"rib"、"graph"，不区分大小写）
+     * @return 名称无法识别时返回 false
+     */
+    static bool parse_method(const std::string& name, PartitionMethod& method);
+
+    /**
+     * @brief 划分方法名
+     */
+    static const char* method_name(PartitionMethod method);
+
+    /**
+     * @brief 估计一个单元的计算代价
+     * @param type_id 单元类型 ID
+     * @param integration_points 每个方向的积分点数（SolidProperty::integration_network）
+     * @return 相对代价：每单元固定开销（收集、散射、稳定时间步）记 1，
+     *         每个积分点的开销按节点数比例计（8 节点单元每个积分点记 1）。
+     *         例如 C3D8R（1 点）为 2，C3D8（2x2x2）为 9
+     */
+    static double element_cost(int type_id, int integration_points);
+
+    /**
+     * @brief 每个单元的代价权重（ConnectivityStore 单元编号）
+     * @details 单元带有 Component::ElementCost 时使用该值，否则按所在块的单元类型和积分规则估计
+     */
+    static std::vector<double> element_weights(const entt::registry& registry, const ConnectivityStore& store);
+
+    /**
+     * @brief 统计划分质量：每个分区的单元数、权重和 halo 节点数，切边数、界面节点数和不平衡度
+     * @param registry EnTT registry，其上下文中必须包含 TopologyData
+     * @param store 连接关系
+     * @param weights element_weights() 的结果
+     * @param partition element_part 与 num_parts 已经填好的划分结果
+     */
+    static void evaluate(const entt::registry& registry, const ConnectivityStore& store,
+                         const std::vector<double>& weights, MeshPartition& partition);
+};
@@ -0,0 +1,119 @@
+// system/output/AsyncVtuWriter.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "output/AsyncVtuWriter.h"
+#include "output/VtuExporter.h"
+#include "parallel/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+
+AsyncVtuWriter::AsyncVtuWriter(size_t num_buffers, VtuEncoding encoding,
+                               std::shared_ptr<const VtuPartition> partition, unsigned piece_threads)
+    : encoding_(encoding), partition_(std::move(partition)) {
+    if (partition_ && partition_->pieces.size() > 1) {
+        const size_t threads = std::min<size_t>(partition_->pieces.size(), piece_threads);
+        if (threads > 1) {
+            piece_pool_ = std::make_unique<ThreadPool>(static_cast<unsigned>(threads));
+        }
+    }
+    if (num_buffers < 1) num_buffers = 1;
+    for (size_t i = 0; i < num_buffers; ++i) {
+        buffers_.push_back(std::make_unique<VtuFrame>());
+        free_.push_back(buffers_.back().get());
+    }
+    worker_ = std::thread(&AsyncVtuWriter::run, this);
+}
+
+AsyncVtuWriter::~AsyncVtuWriter() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    job_ready_.notify_all();
+    worker_.join();
+}
+
+VtuFrame& AsyncVtuWriter::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (free_.empty()) {
+        // 背压：写线程落后，等待一帧写完
+        const auto start = std::chrono::steady_clock::now();
+        buffer_free_.wait(lock, [this] { return !free_.empty(); });
+        stall_seconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    VtuFrame* frame = free_.back();
+    free_.pop_back();
+    return *frame;
+}
+
+void AsyncVtuWriter::submit(VtuFrame& frame, const std::string& filepath, std::function<void(bool)> on_written) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(Job{&frame, filepath, std::move(on_written)});
+        in_flight_++;
+    }
+    job_ready_.notify_one();
+}
+
+bool AsyncVtuWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    buffer_free_.wait(lock, [this] { return in_flight_ == 0; });
+    return failed_ == 0;
+}
+
+size_t AsyncVtuWriter::frames_written() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+}
+
+size_t AsyncVtuWriter::frames_failed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
+
+double AsyncVtuWriter::stall_seconds() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stall_seconds_;
+}
+
+void AsyncVtuWriter::run() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            job_ready_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;  // stop_ 且无剩余任务
+            }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        // 序列化与写文件不持锁，求解器可同时填充另一帧
+        const bool ok = partition_
+                            ? VtuExporter::write_partitioned(job.filepath, *job.frame, *partition_, encoding_,
+                                                             piece_pool_.get())
+                            : VtuExporter::write_frame(job.filepath, *job.frame, encoding_);
+        if (job.on_written) {
+            job.on_written(ok);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(job.frame);
+            in_flight_--;
+            if (ok) {
+                written_++;
+            } else {
+                failed_++;
+            }
+        }
+        buffer_free_.notify_all();
+    }
+}
@@ -0,0 +1,108 @@
+// system/output/AsyncVtuWriter.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "output/VtuFrame.h"
+
+class ThreadPool;
+
+/**
+ * @brief 异步 VTU 输出服务（多缓冲 + 后台写线程）
+ * @details
+ *   - 求解器在输出时刻 acquire() 一个空闲帧，把字段拷贝进去（VtuExporter::capture_frame），
+ *     再 submit() 交给后台线程，随即继续时间步循环；序列化与磁盘写入都在后台线程完成
+ *   - 帧缓冲数量固定（默认 2，即双缓冲）：所有缓冲都在排队或写出时，acquire() 阻塞等待，
+ *     形成背压，内存占用不会随输出频率增长
+ *   - 帧对象循环使用，容器容量保留，稳态下输出不再分配内存
+ *   - 分区输出时，写线程把一帧拆成 N 块，由内部线程池并发提取与写出；线程数由调用方限定，
+ *     不与求解器线程池争抢核心
+ *   - submit() 可附带回调，在该帧写完后于写线程中调用（如追加 .pvd 索引），
+ *     因此索引中只出现已经落盘的帧
+ *   - flush() 等待所有已提交的帧写完；析构时自动 flush 并结束写线程
+ */
+class AsyncVtuWriter {
+public:
+    /**
+     * @brief 启动写线程
+     * @param num_buffers 帧缓冲数量（至少 1；1 时求解与写出不重叠）
+     * @param encoding 写出所有帧使用的数组编码
+     * @param partition 非空时每帧按划分写成 .pvtu + 各块 .vtu，由写线程与块线程池并发写出；
+     *                  此时 submit() 的路径应为 .pvtu
+     * @param piece_threads 写出各块的线程数上限（含写线程本身），不超过块数；
+     *                      1 时各块在写线程中依次写出
+     */
+    explicit AsyncVtuWriter(size_t num_buffers = 2, VtuEncoding encoding = VtuEncoding::Ascii,
+                            std::shared_ptr<const VtuPartition> partition = nullptr, unsigned piece_threads = 1);
+    ~AsyncVtuWriter();
+
+    AsyncVtuWriter(const AsyncVtuWriter&) = delete;
+    AsyncVtuWriter& operator=(const AsyncVtuWriter&) = delete;
+
+    /**
+     * @brief 取得一个空闲帧；全部缓冲都在使用中时阻塞（背压）
+     * @return 空闲帧，调用方填充后必须 submit()
+     */
+    VtuFrame& acquire();
+
+    /**
+     * @brief 提交 acquire() 得到的帧，由写线程写出到 filepath
+     * @param on_written 可选；该帧写完（成功或失败）后在写线程中以结果调用，
+     *                   各帧按提交顺序回调，flush() 返回前回调均已完成
+     */
+    void submit(VtuFrame& frame, const std::string& filepath, std::function<void(bool)> on_written = nullptr);
+
+    /**
+     * @brief 等待所有已提交的帧写完
+     * @return 到目前为止所有帧都写出成功时返回 true
+     */
+    bool flush();
+
+    size_t frames_written() const;
+    size_t frames_failed() const;
+
+    /**
+     * @brief acquire() 因写线程落后而等待的累计时间（秒）
+     */
+    double stall_seconds() const;
+
+private:
+    struct Job {
+        VtuFrame* frame;
+        std::string filepath;
+        std::function<void(bool)> on_written;
+    };
+
+    void run();
+
+    const VtuEncoding encoding_;
+    std::shared_ptr<const VtuPartition> partition_;
+    std::unique_ptr<ThreadPool> piece_pool_;   ///< 只在写线程中使用
+    std::vector<std::unique_ptr<VtuFrame>> buffers_;
+    std::vector<VtuFrame*> free_;
+    std::deque<Job> queue_;
+    size_t in_flight_ = 0;   ///< 已提交但尚未写完的帧
+    size_t written_ = 0;
+    size_t failed_ = 0;
+    double stall_seconds_ = 0.0;
+    bool stop_ = false;
+
+    mutable std::mutex mutex_;
+    std::condition_variable job_ready_;
+    std::condition_variable buffer_free_;
+    std::thread worker_;
+};
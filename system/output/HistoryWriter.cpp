@@ -0,0 +1,114 @@
+// system/output/HistoryWriter.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "output/HistoryWriter.h"
+#include <spdlog/spdlog.h>
+#include <filesystem>
+#include <iomanip>
+
+bool HistoryWriter::open(const std::string& filepath, const std::vector<std::string>& fields, uint64_t resume_bytes) {
+    static const std::pair<const char*, Field> kFieldNames[] = {
+        {"Time", Field::Time},
+        {"Cycle", Field::Cycle},
+        {"Time-Step", Field::TimeStep},
+        {"K-Energy-TOT", Field::Kinetic},
+        {"I-Energy", Field::Internal},
+        {"HG-Energy", Field::Hourglass},
+        {"Ext-Work", Field::ExternalWork},
+        {"TOT-Energy", Field::Total},
+        {"Error", Field::Error},
+        {"Total-Mass", Field::Mass},
+    };
+
+    columns_.clear();
+    std::vector<std::string> names;
+    for (const auto& name : fields) {
+        bool known = false;
+        for (const auto& [key, field] : kFieldNames) {
+            if (name == key) {
+                columns_.push_back(field);
+                names.push_back(name);
+                known = true;
+                break;
+            }
+        }
+        if (!known) {
+            spdlog::warn("HistoryWriter: global field '{}' is not supported, skipped.", name);
+        }
+    }
+    if (columns_.empty()) {
+        return false;
+    }
+
+    // Restart: drop the rows written after the checkpoint, as PvdWriter::resume does for frames
+    bool resume = false;
+    if (resume_bytes > 0) {
+        std::error_code ec;
+        const uintmax_t existing = std::filesystem::file_size(filepath, ec);
+        if (!ec && existing >= resume_bytes) {
+            std::filesystem::resize_file(filepath, resume_bytes, ec);
+            resume = !ec;
+        }
+        if (!resume) {
+            spdlog::warn("HistoryWriter: '{}' does not hold the {} bytes of the checkpoint. Starting a new file.",
+                         filepath, resume_bytes);
+        }
+    }
+    filepath_ = filepath;
+    file_.open(filepath, std::ios::out | (resume ? std::ios::app : std::ios::trunc));
+    if (!file_.is_open()) {
+        spdlog::error("HistoryWriter: cannot open '{}'.", filepath);
+        return false;
+    }
+
+    if (!resume) {
+        file_ << "#";
+        for (const auto& name : names) {
+            file_ << " " << name;
+        }
+        file_ << "\n";
+    }
+    file_ << std::scientific << std::setprecision(9);
+    file_.flush();
+    return true;
+}
+
+void HistoryWriter::write(double time, size_t cycle, double dt, const EnergyBalance& balance) {
+    if (!file_.is_open()) {
+        return;
+    }
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        if (i > 0) {
+            file_ << " ";
+        }
+        switch (columns_[i]) {
+            case Field::Time:         file_ << time; break;
+            case Field::Cycle:        file_ << cycle; break;
+            case Field::TimeStep:     file_ << dt; break;
+            case Field::Kinetic:      file_ << balance.kinetic; break;
+            case Field::Internal:     file_ << balance.internal; break;
+            case Field::Hourglass:    file_ << balance.hourglass; break;
+            case Field::ExternalWork: file_ << balance.external_work; break;
+            case Field::Total:        file_ << balance.total; break;
+            case Field::Error:        file_ << balance.error; break;
+            case Field::Mass:         file_ << balance.mass; break;
+        }
+    }
+    file_ << "\n";
+    file_.flush();
+}
+
+uint64_t HistoryWriter::size() const {
+    if (!file_.is_open()) {
+        return 0;
+    }
+    // Every row is flushed, so the file length is the written length
+    std::error_code ec;
+    const uintmax_t bytes = std::filesystem::file_size(filepath_, ec);
+    return ec ? 0 : static_cast<uint64_t>(bytes);
+}
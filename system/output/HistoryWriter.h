@@ -0,0 +1,59 @@
+// system/output/HistoryWriter.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "EnergyBalance.h"
+
+/**
+ * @brief 全局历史输出 (Simdroid History.GlobalFields)
+ * @details 每次输出写一行空格分隔的数值，首行为以 '#' 开头的列名，便于 gnuplot / numpy.loadtxt 读取。
+ * 支持的字段：Time、Cycle、Time-Step、K-Energy-TOT、I-Energy、HG-Energy、Ext-Work、
+ * TOT-Energy、Error、Total-Mass；其余字段在 open() 时给出警告并忽略。
+ * 每行写完即 flush，中途终止的计算也保留已写出的历史。
+ */
+class HistoryWriter {
+public:
+    /**
+     * @brief 打开历史文件并写出列名
+     * @param filepath 输出路径（如 result/history.dat）
+     * @param fields 请求的字段名，按此顺序输出
+     * @param resume_bytes 从检查点重启时为检查点记录的文件长度（size()）：文件截断到该长度后
+     *        续写，检查点之后写出的行被丢弃、不会重复；0 表示新建文件
+     * @return 成功返回 true；没有可输出的字段或文件无法打开时返回 false
+     */
+    bool open(const std::string& filepath, const std::vector<std::string>& fields, uint64_t resume_bytes = 0);
+
+    /**
+     * @brief 写出一行
+     * @param time 当前时间
+     * @param cycle 当前步数
+     * @param dt 当前时间步长
+     * @param balance 当前能量平衡
+     */
+    void write(double time, size_t cycle, double dt, const EnergyBalance& balance);
+
+    bool is_open() const { return file_.is_open(); }
+
+    /**
+     * @brief 已写出的文件长度（字节），随检查点保存；未打开时为 0
+     */
+    uint64_t size() const;
+
+private:
+    enum class Field { Time, Cycle, TimeStep, Kinetic, Internal, Hourglass, ExternalWork, Total, Error, Mass };
+
+    std::string filepath_;
+    std::ofstream file_;
+    std::vector<Field> columns_;
+};
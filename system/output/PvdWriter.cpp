@@ -0,0 +1,89 @@
+// system/output/PvdWriter.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "output/PvdWriter.h"
+#include <spdlog/spdlog.h>
+#include <charconv>
+
+namespace {
+    constexpr const char* kPvdHeader =
+        "<?xml version=\"1.0\"?>\n"
+        "<VTKFile type=\"Collection\" version=\"0.1\">\n"
+        "  <Collection>\n";
+    constexpr const char* kPvdTail =
+        "  </Collection>\n"
+        "</VTKFile>\n";
+
+    void write_entry(std::ostream& file, double time, const std::string& dataset) {
+        // 最短可回读表示，保证时间值与求解器一致
+        char buffer[32];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), time);
+        file << "    <DataSet timestep=\"" << std::string(buffer, result.ptr)
+             << "\" group=\"\" part=\"0\" file=\"" << dataset << "\"/>\n";
+    }
+}
+
+PvdWriter::PvdWriter(std::string filepath) : filepath_(std::move(filepath)) {}
+
+bool PvdWriter::rewrite(const std::vector<std::pair<double, std::string>>& entries) {
+    if (file_.is_open()) {
+        file_.close();
+    }
+    file_.open(filepath_, std::ios::out | std::ios::trunc);
+    if (!file_.is_open()) {
+        spdlog::error("PvdWriter: cannot open '{}'.", filepath_);
+        return false;
+    }
+    file_ << kPvdHeader;
+    for (const auto& [time, dataset] : entries) {
+        write_entry(file_, time, dataset);
+    }
+    tail_offset_ = file_.tellp();
+    file_ << kPvdTail;
+    file_.flush();
+    num_frames_ = entries.size();
+    return static_cast<bool>(file_);
+}
+
+size_t PvdWriter::resume(size_t num_frames) {
+    std::vector<std::pair<double, std::string>> entries;
+    {
+        std::ifstream file(filepath_);
+        std::string line;
+        while (entries.size() < num_frames && std::getline(file, line)) {
+            const size_t time_pos = line.find("timestep=\"");
+            const size_t file_pos = line.find("file=\"");
+            if (time_pos == std::string::npos || file_pos == std::string::npos) {
+                continue;
+            }
+            const size_t time_begin = time_pos + 10;
+            const size_t file_begin = file_pos + 6;
+            double time = 0.0;
+            std::from_chars(line.data() + time_begin, line.data() + line.size(), time);
+            entries.emplace_back(time, line.substr(file_begin, line.find('"', file_begin) - file_begin));
+        }
+    }
+    rewrite(entries);
+    return entries.size();
+}
+
+bool PvdWriter::add(double time, const std::string& dataset_file) {
+    if (!file_.is_open()) {
+        if (!rewrite({})) {
+            return false;
+        }
+    }
+    // 新条目加文件尾总比原文件尾长，覆盖后不会残留旧内容
+    file_.seekp(tail_offset_);
+    write_entry(file_, time, dataset_file);
+    tail_offset_ = file_.tellp();
+    file_ << kPvdTail;
+    file_.flush();
+    ++num_frames_;
+    return static_cast<bool>(file_);
+}
@@ -0,0 +1,58 @@
+// system/output/PvdWriter.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief ParaView 时间序列索引（.pvd）
+ * @details 记录每个输出帧的物理时间与数据文件（.vtu 或 .pvtu），ParaView 打开 .pvd
+ * 即可按真实时间加载整个序列。文件在首次写入后保持打开，add() 只覆盖文件尾
+ * （"</Collection></VTKFile>"）为新条目加文件尾，每帧开销与已有帧数无关，计算过程中文件始终完整。
+ * 数据文件路径相对 .pvd 所在目录。
+ */
+class PvdWriter {
+public:
+    /**
+     * @param filepath 输出 .pvd 路径
+     */
+    explicit PvdWriter(std::string filepath);
+
+    /**
+     * @brief 追加一帧；应在该帧数据文件写完后调用
+     * @param time 物理时间
+     * @param dataset_file 数据文件（相对 .pvd 所在目录）
+     * @return 写出成功返回 true
+     */
+    bool add(double time, const std::string& dataset_file);
+
+    /**
+     * @brief 从检查点重启时读回已有索引中的前 num_frames 帧，并以这些帧重写索引（丢弃之后的帧）
+     * @return 实际读回的帧数
+     */
+    size_t resume(size_t num_frames);
+
+    size_t num_frames() const {
+        return num_frames_;
+    }
+
+private:
+    /**
+     * @brief 以给定条目重写整个索引，并打开文件供后续追加
+     */
+    bool rewrite(const std::vector<std::pair<double, std::string>>& entries);
+
+    std::string filepath_;
+    std::ofstream file_;
+    std::streamoff tail_offset_ = 0;  // 文件尾在文件中的起始位置
+    size_t num_frames_ = 0;
+};
@@ -8,14 +8,22 @@
  */
 #include "output/VtuExporter.h"
 #include "DataContext.h"
+#include "NodalState.h"
+#include "ConnectivityStore.h"
+#include "MeshPartition.h"
 #include "components/mesh_components.h"
 #include "components/analysis_component.h"
-#include <tinyxml2.h>
+#include "parallel/ThreadPool.h"
 #include <spdlog/spdlog.h>
-#include <sstream>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
 #include <unordered_map>
 #include <vector>
 #include <algorithm>
+#include <array>
 
 namespace {
 
@@ -36,10 +44,513 @@ inline bool wantField(const std::vector<std::string>* list, const char* name) {
     return std::find(list->begin(), list->end(), std::string(name)) != list->end();
 }
 
+/** 取第 index 个点场（不存在时追加），保留已有数组的容量 */
+VtuField& pointField(VtuFrame& frame, size_t index, const char* name, int components) {
+    if (frame.point_fields.size() <= index) {
+        frame.point_fields.resize(index + 1);
+    }
+    VtuField& field = frame.point_fields[index];
+    field.name = name;
+    field.components = components;
+    return field;
+}
+
+/** 取第 index 个单元场（不存在时追加），保留已有数组的容量 */
+VtuField& cellField(VtuFrame& frame, size_t index, const char* name, int components) {
+    if (frame.cell_fields.size() <= index) {
+        frame.cell_fields.resize(index + 1);
+    }
+    VtuField& field = frame.cell_fields[index];
+    field.name = name;
+    field.components = components;
+    return field;
+}
+
+/** DataArray 标量类型 */
+enum class VtuScalar { Float64, Int32, UInt8 };
+
+const char* scalarName(VtuScalar type) {
+    switch (type) {
+        case VtuScalar::Float64: return "Float64";
+        case VtuScalar::Int32:   return "Int32";
+        default:                 return "UInt8";
+    }
+}
+
+/** 待写出的连续数组（只引用帧中的数据，不拷贝） */
+struct ArrayRef {
+    VtuScalar type;
+    std::string name;
+    int components;
+    const void* data;
+    size_t count;       ///< 标量个数
+    size_t elem_size;   ///< 每个标量的字节数
+
+    size_t bytes() const { return count * elem_size; }
+};
+
+template <typename T>
+ArrayRef arrayRef(VtuScalar type, std::string name, int components, const std::vector<T>& values) {
+    return ArrayRef{type, std::move(name), components, values.data(), values.size(), sizeof(T)};
+}
+
+/**
+ * 带缓冲的文件写出：数值用 std::to_chars 直接格式化进缓冲区（最短可回读表示），
+ * 二进制数组直接按字节写出或流式 base64 编码，不经过 ostream / XML 文本节点
+ */
+class VtuFileWriter {
+public:
+    explicit VtuFileWriter(const std::string& filepath) : file_(std::fopen(filepath.c_str(), "wb")) {
+        buffer_.reserve(kBufferSize + 64);
+    }
+    ~VtuFileWriter() {
+        close();
+    }
+
+    bool is_open() const { return file_ != nullptr; }
+
+    void text(const char* s) {
+        buffer_.append(s);
+        flush_if_full();
+    }
+    void text(const std::string& s) {
+        buffer_.append(s);
+        flush_if_full();
+    }
+
+    template <typename T>
+    void number(T value) {
+        char tmp[32];
+        const auto result = std::to_chars(tmp, tmp + sizeof(tmp), value);
+        buffer_.append(tmp, result.ptr);
+        buffer_.push_back(' ');
+        flush_if_full();
+    }
+
+    /** ASCII：逐个标量格式化 */
+    void ascii(const ArrayRef& array) {
+        for (size_t i = 0; i < array.count; ++i) {
+            switch (array.type) {
+                case VtuScalar::Float64: number(static_cast<const double*>(array.data)[i]); break;
+                case VtuScalar::Int32:   number(static_cast<const int32_t*>(array.data)[i]); break;
+                case VtuScalar::UInt8:   number(static_cast<int>(static_cast<const uint8_t*>(array.data)[i])); break;
+            }
+        }
+    }
+
+    /** 原始字节：大块数据绕过缓冲区直接写出 */
+    void bytes(const void* data, size_t size) {
+        if (size >= kBufferSize) {
+            flush();
+            std::fwrite(data, 1, size, file_);
+            return;
+        }
+        buffer_.append(static_cast<const char*>(data), size);
+        flush_if_full();
+    }
+
+    /** 流式 base64 编码：多次 base64() 调用的字节拼成一个连续的编码流，base64_end() 补齐填充 */
+    void base64(const void* data, size_t size) {
+        const auto* p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            carry_[carry_size_++] = p[i];
+            if (carry_size_ == 3) {
+                encode_group(3);
+                carry_size_ = 0;
+            }
+        }
+        flush_if_full();
+    }
+    void base64_end() {
+        if (carry_size_ > 0) {
+            for (int i = carry_size_; i < 3; ++i) carry_[i] = 0;
+            encode_group(carry_size_);
+            carry_size_ = 0;
+        }
+    }
+
+    bool close() {
+        if (file_ == nullptr) return false;
+        flush();
+        const bool ok = (std::ferror(file_) == 0);
+        std::fclose(file_);
+        file_ = nullptr;
+        return ok;
+    }
+
+private:
+    static constexpr size_t kBufferSize = size_t(1) << 20;
+
+    void encode_group(int n) {
+        static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        const uint32_t v = (uint32_t(carry_[0]) << 16) | (uint32_t(carry_[1]) << 8) | uint32_t(carry_[2]);
+        char out[4] = {kAlphabet[(v >> 18) & 63], kAlphabet[(v >> 12) & 63],
+                       n > 1 ? kAlphabet[(v >> 6) & 63] : '=', n > 2 ? kAlphabet[v & 63] : '='};
+        buffer_.append(out, 4);
+    }
+
+    void flush_if_full() {
+        if (buffer_.size() >= kBufferSize) flush();
+    }
+    void flush() {
+        if (!buffer_.empty()) {
+            std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+            buffer_.clear();
+        }
+    }
+
+    std::FILE* file_;
+    std::string buffer_;
+    uint8_t carry_[3] = {0, 0, 0};
+    int carry_size_ = 0;
+};
+
+/**
+ * 写出一个 DataArray
+ *   - Ascii：文本数值
+ *   - Base64：format="binary"，UInt64 字节数头与数据连续 base64 编码
+ *   - Appended：format="appended" 加 offset，数据稍后在 AppendedData 中按原始字节写出
+ */
+void writeDataArray(VtuFileWriter& out, const ArrayRef& array, VtuEncoding encoding, uint64_t appended_offset) {
+    out.text("        <DataArray type=\"");
+    out.text(scalarName(array.type));
+    out.text("\"");
+    if (!array.name.empty()) {
+        out.text(" Name=\"" + array.name + "\"");
+    }
+    if (array.components > 1) {
+        out.text(" NumberOfComponents=\"" + std::to_string(array.components) + "\"");
+    }
+    switch (encoding) {
+        case VtuEncoding::Ascii:
+            out.text(" format=\"ascii\">\n");
+            out.ascii(array);
+            out.text("\n        </DataArray>\n");
+            break;
+        case VtuEncoding::Base64: {
+            out.text(" format=\"binary\">\n");
+            const uint64_t header = array.bytes();
+            out.base64(&header, sizeof(header));
+            out.base64(array.data, array.bytes());
+            out.base64_end();
+            out.text("\n        </DataArray>\n");
+            break;
+        }
+        case VtuEncoding::Appended:
+            out.text(" format=\"appended\" offset=\"" + std::to_string(appended_offset) + "\"/>\n");
+            break;
+    }
+}
+
+/** 分块文件路径：<dir>/<stem>_<piece>.vtu */
+std::filesystem::path piecePath(const std::filesystem::path& master, size_t piece) {
+    return master.parent_path() / (master.stem().string() + "_" + std::to_string(piece) + ".vtu");
+}
+
+/** 从全局帧中提取一块：按 piece.nodes 收集点与点数据，按单元区间截取单元数据 */
+void gatherPiece(const VtuFrame& frame, const VtuPiece& piece, VtuFrame& out) {
+    out.time = frame.time;
+    out.topology = piece.topology;
+
+    const size_t num_nodes = piece.nodes.size();
+    out.points.resize(3 * num_nodes);
+    for (size_t i = 0; i < num_nodes; ++i) {
+        const size_t g = piece.nodes[i];
+        out.points[3 * i + 0] = frame.points[3 * g + 0];
+        out.points[3 * i + 1] = frame.points[3 * g + 1];
+        out.points[3 * i + 2] = frame.points[3 * g + 2];
+    }
+
+    out.point_fields.resize(frame.point_fields.size());
+    for (size_t f = 0; f < frame.point_fields.size(); ++f) {
+        const VtuField& src = frame.point_fields[f];
+        VtuField& dst = out.point_fields[f];
+        const size_t nc = static_cast<size_t>(src.components);
+        dst.name = src.name;
+        dst.components = src.components;
+        dst.values.resize(nc * num_nodes);
+        for (size_t i = 0; i < num_nodes; ++i) {
+            const size_t g = piece.nodes[i];
+            for (size_t c = 0; c < nc; ++c) {
+                dst.values[nc * i + c] = src.values[nc * g + c];
+            }
+        }
+    }
+
+    out.cell_fields.resize(frame.cell_fields.size());
+    for (size_t f = 0; f < frame.cell_fields.size(); ++f) {
+        const VtuField& src = frame.cell_fields[f];
+        VtuField& dst = out.cell_fields[f];
+        const size_t nc = static_cast<size_t>(src.components);
+        dst.name = src.name;
+        dst.components = src.components;
+        dst.values.assign(src.values.begin() + nc * piece.cell_begin, src.values.begin() + nc * piece.cell_end);
+    }
+}
+
+/** .pvtu 中声明一个数组（只有类型与名字，数据在各块文件中） */
+void writePDataArray(VtuFileWriter& out, const char* type, const std::string& name, int components) {
+    out.text(std::string("      <PDataArray type=\"") + type + "\"");
+    if (!name.empty()) {
+        out.text(" Name=\"" + name + "\"");
+    }
+    if (components > 1) {
+        out.text(" NumberOfComponents=\"" + std::to_string(components) + "\"");
+    }
+    out.text("/>\n");
+}
+
 } // namespace
 
+std::shared_ptr<VtuTopology> VtuExporter::build_topology(const ConnectivityStore& store) {
+    auto topology = std::make_shared<VtuTopology>();
+    topology->num_points = store.num_nodes();
+    const size_t num_cells = store.num_elements();
+    topology->offsets.reserve(num_cells);
+    topology->types.reserve(num_cells);
+
+    int32_t offset = 0;
+    for (const auto& block : store.blocks) {
+        const uint8_t vtk_type = static_cast<uint8_t>(toVtkCellType(block.type_id));
+        topology->connectivity.insert(topology->connectivity.end(), block.node_indices.begin(),
+                                      block.node_indices.end());
+        for (size_t k = 0; k < block.num_elements(); ++k) {
+            offset += block.nodes_per_element;
+            topology->offsets.push_back(offset);
+            topology->types.push_back(vtk_type);
+        }
+    }
+    return topology;
+}
+
+void VtuExporter::capture_frame(const NodalState& state, std::shared_ptr<const VtuTopology> topology,
+                                const std::vector<std::string>* node_fields, double time, VtuFrame& frame,
+                                const MeshPartition* partition) {
+    frame.time = time;
+    frame.topology = std::move(topology);
+    frame.points.assign(state.x.begin(), state.x.end());
+
+    size_t count = 0;
+    if (wantField(node_fields, "Displacement")) {
+        pointField(frame, count++, "Displacement", 3).values.assign(state.u.begin(), state.u.end());
+    }
+    if (wantField(node_fields, "Velocity")) {
+        pointField(frame, count++, "Velocity", 3).values.assign(state.v.begin(), state.v.end());
+    }
+    if (wantField(node_fields, "Acceleration")) {
+        pointField(frame, count++, "Acceleration", 3).values.assign(state.a.begin(), state.a.end());
+    }
+    frame.point_fields.resize(count);
+
+    // MeshPartition 与拓扑同为 ConnectivityStore 单元顺序
+    size_t cells = 0;
+    if (partition != nullptr && frame.topology && partition->element_part.size() == frame.topology->num_cells()) {
+        cellField(frame, cells++, "PartitionID", 1).values.assign(partition->element_part.begin(),
+                                                                  partition->element_part.end());
+    }
+    frame.cell_fields.resize(cells);
+}
+
+VtuEncoding VtuExporter::parse_encoding(const std::string& format) {
+    std::string key = format;
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (key.empty() || key == "ascii") return VtuEncoding::Ascii;
+    if (key == "binary" || key == "appended" || key == "raw") return VtuEncoding::Appended;
+    if (key == "base64") return VtuEncoding::Base64;
+    spdlog::warn("VtuExporter: unknown output format '{}', using ASCII.", format);
+    return VtuEncoding::Ascii;
+}
+
+bool VtuExporter::write_frame(const std::string& filepath, const VtuFrame& frame, VtuEncoding encoding) {
+    if (!frame.topology) {
+        spdlog::error("VtuExporter: frame without topology, skip {}", filepath);
+        return false;
+    }
+    const VtuTopology& topology = *frame.topology;
+
+    // 按文件中的出现顺序列出所有数组；Appended 模式的 offset 依此顺序累加
+    std::vector<ArrayRef> arrays;
+    arrays.push_back(arrayRef(VtuScalar::Float64, "", 3, frame.points));
+    arrays.push_back(arrayRef(VtuScalar::Int32, "connectivity", 1, topology.connectivity));
+    arrays.push_back(arrayRef(VtuScalar::Int32, "offsets", 1, topology.offsets));
+    arrays.push_back(arrayRef(VtuScalar::UInt8, "types", 1, topology.types));
+    for (const auto& field : frame.point_fields) {
+        arrays.push_back(arrayRef(VtuScalar::Float64, field.name, field.components, field.values));
+    }
+    for (const auto& field : frame.cell_fields) {
+        arrays.push_back(arrayRef(VtuScalar::Float64, field.name, field.components, field.values));
+    }
+    std::vector<uint64_t> offsets(arrays.size(), 0);
+    for (size_t a = 1; a < arrays.size(); ++a) {
+        offsets[a] = offsets[a - 1] + sizeof(uint64_t) + arrays[a - 1].bytes();
+    }
+
+    VtuFileWriter out(filepath);
+    if (!out.is_open()) {
+        spdlog::error("VtuExporter could not write file: {}", filepath);
+        return false;
+    }
+
+    const char* byte_order = (std::endian::native == std::endian::little) ? "LittleEndian" : "BigEndian";
+    out.text("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    out.text(std::string("<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"") + byte_order +
+             "\" header_type=\"UInt64\">\n");
+    out.text("  <UnstructuredGrid>\n");
+    out.text("    <Piece NumberOfPoints=\"" + std::to_string(topology.num_points) +
+             "\" NumberOfCells=\"" + std::to_string(topology.num_cells()) + "\">\n");
+
+    size_t a = 0;
+    auto write_next = [&]() {
+        writeDataArray(out, arrays[a], encoding, offsets[a]);
+        a++;
+    };
+
+    // --- Points (Float64, 3 components) ---
+    out.text("      <Points>\n");
+    write_next();
+    out.text("      </Points>\n");
+
+    // --- Cells: connectivity, offsets, types ---
+    out.text("      <Cells>\n");
+    write_next();
+    write_next();
+    write_next();
+    out.text("      </Cells>\n");
+
+    // --- PointData / CellData ---
+    out.text("      <PointData>\n");
+    for (size_t f = 0; f < frame.point_fields.size(); ++f) {
+        write_next();
+    }
+    out.text("      </PointData>\n");
+    out.text("      <CellData>\n");
+    for (size_t f = 0; f < frame.cell_fields.size(); ++f) {
+        write_next();
+    }
+    out.text("      </CellData>\n");
+
+    out.text("    </Piece>\n");
+    out.text("  </UnstructuredGrid>\n");
+
+    // --- AppendedData：每个数组为 UInt64 字节数 + 原始字节，直接从帧的连续缓冲写出 ---
+    if (encoding == VtuEncoding::Appended) {
+        out.text("  <AppendedData encoding=\"raw\">\n   _");
+        for (const auto& array : arrays) {
+            const uint64_t header = array.bytes();
+            out.bytes(&header, sizeof(header));
+            out.bytes(array.data, array.bytes());
+        }
+        out.text("\n  </AppendedData>\n");
+    }
+    out.text("</VTKFile>\n");
+
+    if (!out.close()) {
+        spdlog::error("VtuExporter could not write file: {}", filepath);
+        return false;
+    }
+    spdlog::info("VtuExporter wrote: {}", filepath);
+    return true;
+}
+
+std::shared_ptr<VtuPartition> VtuExporter::partition_topology(const VtuTopology& topology, size_t num_pieces) {
+    auto partition = std::make_shared<VtuPartition>();
+    const size_t num_cells = topology.num_cells();
+    num_pieces = std::max<size_t>(1, std::min(num_pieces, num_cells));
+    partition->pieces.resize(num_pieces);
+
+    // 全局点 -> 块内局部点；每块结束后只复位用到的条目
+    std::vector<int32_t> local_index(topology.num_points, -1);
+    for (size_t p = 0; p < num_pieces; ++p) {
+        VtuPiece& piece = partition->pieces[p];
+        piece.cell_begin = num_cells * p / num_pieces;
+        piece.cell_end = num_cells * (p + 1) / num_pieces;
+
+        auto local = std::make_shared<VtuTopology>();
+        int32_t first = (piece.cell_begin > 0) ? topology.offsets[piece.cell_begin - 1] : 0;
+        const int32_t last = (piece.cell_end > 0) ? topology.offsets[piece.cell_end - 1] : 0;
+        local->connectivity.reserve(static_cast<size_t>(last - first));
+        for (int32_t k = first; k < last; ++k) {
+            const int32_t g = topology.connectivity[k];
+            if (local_index[g] < 0) {
+                local_index[g] = static_cast<int32_t>(piece.nodes.size());
+                piece.nodes.push_back(static_cast<uint32_t>(g));
+            }
+            local->connectivity.push_back(local_index[g]);
+        }
+        local->offsets.reserve(piece.cell_end - piece.cell_begin);
+        for (size_t c = piece.cell_begin; c < piece.cell_end; ++c) {
+            local->offsets.push_back(topology.offsets[c] - first);
+        }
+        local->types.assign(topology.types.begin() + piece.cell_begin, topology.types.begin() + piece.cell_end);
+        local->num_points = piece.nodes.size();
+        for (uint32_t g : piece.nodes) {
+            local_index[g] = -1;
+        }
+        piece.topology = std::move(local);
+    }
+    return partition;
+}
+
+bool VtuExporter::write_partitioned(const std::string& filepath, const VtuFrame& frame, const VtuPartition& partition,
+                                    VtuEncoding encoding, ThreadPool* pool) {
+    const std::filesystem::path master(filepath);
+    const size_t num_pieces = partition.pieces.size();
+
+    // 各块互不依赖：提取与序列化都在块内完成，线程之间只共享只读的全局帧
+    std::vector<char> piece_ok(num_pieces, 0);
+    auto write_pieces = [&](size_t begin, size_t end, unsigned) {
+        VtuFrame piece_frame;
+        for (size_t p = begin; p < end; ++p) {
+            gatherPiece(frame, partition.pieces[p], piece_frame);
+            piece_ok[p] = write_frame(piecePath(master, p).string(), piece_frame, encoding) ? 1 : 0;
+        }
+    };
+    if (pool != nullptr) {
+        pool->parallel_for(0, num_pieces, write_pieces);
+    } else {
+        write_pieces(0, num_pieces, 0u);
+    }
+    bool ok = std::all_of(piece_ok.begin(), piece_ok.end(), [](char v) { return v != 0; });
+
+    VtuFileWriter out(filepath);
+    if (!out.is_open()) {
+        spdlog::error("VtuExporter could not write file: {}", filepath);
+        return false;
+    }
+    const char* byte_order = (std::endian::native == std::endian::little) ? "LittleEndian" : "BigEndian";
+    out.text("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    out.text(std::string("<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"") + byte_order +
+             "\" header_type=\"UInt64\">\n");
+    out.text("  <PUnstructuredGrid GhostLevel=\"0\">\n");
+    out.text("    <PPoints>\n");
+    writePDataArray(out, "Float64", "", 3);
+    out.text("    </PPoints>\n");
+    out.text("    <PPointData>\n");
+    for (const auto& field : frame.point_fields) {
+        writePDataArray(out, "Float64", field.name, field.components);
+    }
+    out.text("    </PPointData>\n");
+    out.text("    <PCellData>\n");
+    for (const auto& field : frame.cell_fields) {
+        writePDataArray(out, "Float64", field.name, field.components);
+    }
+    out.text("    </PCellData>\n");
+    for (size_t p = 0; p < num_pieces; ++p) {
+        out.text("    <Piece Source=\"" + piecePath(master, p).filename().string() + "\"/>\n");
+    }
+    out.text("  </PUnstructuredGrid>\n");
+    out.text("</VTKFile>\n");
+    if (!out.close()) {
+        spdlog::error("VtuExporter could not write file: {}", filepath);
+        return false;
+    }
+    if (!ok) {
+        spdlog::error("VtuExporter: some pieces of {} could not be written.", filepath);
+    }
+    return ok;
+}
+
 bool VtuExporter::save(const std::string& filepath, const DataContext& data_context, entt::entity output_entity) {
-    using namespace tinyxml2;
     const auto& registry = data_context.registry;
 
     auto pos_view = registry.view<Component::Position>();
@@ -63,80 +574,32 @@ bool VtuExporter::save(const std::string& filepath, const DataContext& data_cont
     for (size_t i = 0; i < node_entities.size(); ++i)
         entity_to_index[node_entities[i]] = i;
 
-    XMLDocument doc;
-    doc.InsertEndChild(doc.NewDeclaration());
-    XMLElement* vtkFile = doc.NewElement("VTKFile");
-    vtkFile->SetAttribute("type", "UnstructuredGrid");
-    vtkFile->SetAttribute("version", "1.0");
-    vtkFile->SetAttribute("byte_order", "LittleEndian");
-    doc.InsertEndChild(vtkFile);
-
-    XMLElement* grid = doc.NewElement("UnstructuredGrid");
-    vtkFile->InsertEndChild(grid);
-
-    XMLElement* piece = doc.NewElement("Piece");
-    piece->SetAttribute("NumberOfPoints", static_cast<unsigned int>(num_points));
-    piece->SetAttribute("NumberOfCells",  static_cast<unsigned int>(num_cells));
-    grid->InsertEndChild(piece);
+    VtuFrame frame;
 
-    // --- Points (Float64, 3 components) ---
-    {
-        std::ostringstream os;
-        for (entt::entity e : node_entities) {
-            const auto& p = registry.get<Component::Position>(e);
-            os << p.x << ' ' << p.y << ' ' << p.z << ' ';
-        }
-        XMLElement* points = doc.NewElement("Points");
-        piece->InsertEndChild(points);
-        XMLElement* da = doc.NewElement("DataArray");
-        da->SetAttribute("type", "Float64");
-        da->SetAttribute("NumberOfComponents", 3);
-        da->SetAttribute("format", "ascii");
-        da->SetText(os.str().c_str());
-        points->InsertEndChild(da);
+    // --- Points ---
+    frame.points.reserve(3 * num_points);
+    for (entt::entity e : node_entities) {
+        const auto& p = registry.get<Component::Position>(e);
+        frame.points.insert(frame.points.end(), {p.x, p.y, p.z});
     }
 
     // --- Cells: connectivity, offsets, types ---
-    {
-        std::ostringstream conn_os, off_os, type_os;
-        int offset = 0;
-        for (auto cell_entity : cell_view) {
-            const auto& conn = cell_view.get<Component::Connectivity>(cell_entity);
-            const auto& etype = cell_view.get<Component::ElementType>(cell_entity);
-            for (entt::entity node_entity : conn.nodes) {
-                auto it = entity_to_index.find(node_entity);
-                if (it != entity_to_index.end())
-                    conn_os << it->second << ' ';
-            }
-            offset += static_cast<int>(conn.nodes.size());
-            off_os << offset << ' ';
-            type_os << toVtkCellType(etype.type_id) << ' ';
+    auto topology = std::make_shared<VtuTopology>();
+    topology->num_points = num_points;
+    int32_t offset = 0;
+    for (auto cell_entity : cell_view) {
+        const auto& conn = cell_view.get<Component::Connectivity>(cell_entity);
+        const auto& etype = cell_view.get<Component::ElementType>(cell_entity);
+        for (entt::entity node_entity : conn.nodes) {
+            auto it = entity_to_index.find(node_entity);
+            if (it != entity_to_index.end())
+                topology->connectivity.push_back(static_cast<int32_t>(it->second));
         }
-
-        XMLElement* cells = doc.NewElement("Cells");
-        piece->InsertEndChild(cells);
-
-        XMLElement* conn_da = doc.NewElement("DataArray");
-        conn_da->SetAttribute("type", "Int32");
-        conn_da->SetAttribute("Name", "connectivity");
-        conn_da->SetAttribute("format", "ascii");
-        conn_da->SetText(conn_os.str().c_str());
-        cells->InsertEndChild(conn_da);
-
-        XMLElement* off_da = doc.NewElement("DataArray");
-        off_da->SetAttribute("type", "Int32");
-        off_da->SetAttribute("Name", "offsets");
-        off_da->SetAttribute("format", "ascii");
-        off_da->SetText(off_os.str().c_str());
-        cells->InsertEndChild(off_da);
-
-        XMLElement* type_da = doc.NewElement("DataArray");
-        type_da->SetAttribute("type", "UInt8");
-        type_da->SetAttribute("Name", "types");
-        type_da->SetAttribute("format", "ascii");
-        type_da->SetText(type_os.str().c_str());
-        cells->InsertEndChild(type_da);
+        offset += static_cast<int32_t>(conn.nodes.size());
+        topology->offsets.push_back(offset);
+        topology->types.push_back(static_cast<uint8_t>(toVtkCellType(etype.type_id)));
     }
+    frame.topology = std::move(topology);
 
     const std::vector<std::string>* node_fields = nullptr;
     const std::vector<std::string>* elem_fields = nullptr;
@@ -148,84 +611,50 @@ bool VtuExporter::save(const std::string& filepath, const DataContext& data_cont
     }
 
     // --- PointData: 仅写出 output 指定的节点场（无指定时默认写 Displacement）---
-    {
-        XMLElement* pointData = doc.NewElement("PointData");
-        piece->InsertEndChild(pointData);
-        if (wantField(node_fields, "Displacement")) {
-            std::ostringstream os;
-            for (entt::entity e : node_entities) {
-                if (registry.all_of<Component::Displacement>(e)) {
-                    const auto& d = registry.get<Component::Displacement>(e);
-                    os << d.dx << ' ' << d.dy << ' ' << d.dz << ' ';
-                } else {
-                    os << "0 0 0 ";
-                }
-            }
-            XMLElement* da = doc.NewElement("DataArray");
-            da->SetAttribute("type", "Float64");
-            da->SetAttribute("Name", "Displacement");
-            da->SetAttribute("NumberOfComponents", 3);
-            da->SetAttribute("format", "ascii");
-            da->SetText(os.str().c_str());
-            pointData->InsertEndChild(da);
-        }
-        if (wantField(node_fields, "Velocity")) {
-            std::ostringstream os;
-            for (entt::entity e : node_entities) {
-                if (registry.all_of<Component::Velocity>(e)) {
-                    const auto& v = registry.get<Component::Velocity>(e);
-                    os << v.vx << ' ' << v.vy << ' ' << v.vz << ' ';
-                } else {
-                    os << "0 0 0 ";
-                }
-            }
-            XMLElement* da = doc.NewElement("DataArray");
-            da->SetAttribute("type", "Float64");
-            da->SetAttribute("Name", "Velocity");
-            da->SetAttribute("NumberOfComponents", 3);
-            da->SetAttribute("format", "ascii");
-            da->SetText(os.str().c_str());
-            pointData->InsertEndChild(da);
-        }
-        if (wantField(node_fields, "Acceleration")) {
-            std::ostringstream os;
-            for (entt::entity e : node_entities) {
-                if (registry.all_of<Component::Acceleration>(e)) {
-                    const auto& a = registry.get<Component::Acceleration>(e);
-                    os << a.ax << ' ' << a.ay << ' ' << a.az << ' ';
-                } else {
-                    os << "0 0 0 ";
-                }
-            }
-            XMLElement* da = doc.NewElement("DataArray");
-            da->SetAttribute("type", "Float64");
-            da->SetAttribute("Name", "Acceleration");
-            da->SetAttribute("NumberOfComponents", 3);
-            da->SetAttribute("format", "ascii");
-            da->SetText(os.str().c_str());
-            pointData->InsertEndChild(da);
+    auto gather = [&](const char* name, auto get) {
+        VtuField field{name, 3, {}};
+        field.values.reserve(3 * num_points);
+        for (entt::entity e : node_entities) {
+            const std::array<double, 3> value = get(e);
+            field.values.insert(field.values.end(), value.begin(), value.end());
         }
-        // TODO: Reaction Force (PointData) — 需在 data_center 提供对应组件后再写入
+        frame.point_fields.push_back(std::move(field));
+    };
+    if (wantField(node_fields, "Displacement")) {
+        gather("Displacement", [&](entt::entity e) {
+            const auto* d = registry.try_get<Component::Displacement>(e);
+            return d ? std::array<double, 3>{d->dx, d->dy, d->dz} : std::array<double, 3>{};
+        });
+    }
+    if (wantField(node_fields, "Velocity")) {
+        gather("Velocity", [&](entt::entity e) {
+            const auto* v = registry.try_get<Component::Velocity>(e);
+            return v ? std::array<double, 3>{v->vx, v->vy, v->vz} : std::array<double, 3>{};
+        });
     }
+    if (wantField(node_fields, "Acceleration")) {
+        gather("Acceleration", [&](entt::entity e) {
+            const auto* a = registry.try_get<Component::Acceleration>(e);
+            return a ? std::array<double, 3>{a->ax, a->ay, a->az} : std::array<double, 3>{};
+        });
+    }
+    // TODO: Reaction Force (PointData) — 需在 data_center 提供对应组件后再写入
 
     // --- CellData: 仅写出 output 指定的单元场；Stress/Strain/Mises 等尚待组件支持 ---
-    {
-        XMLElement* cellData = doc.NewElement("CellData");
-        piece->InsertEndChild(cellData);
-        if (elem_fields) {
-            for (const std::string& name : *elem_fields) {
-                if (name == "Stress" || name == "Strain" || name == "Mises" || name == "Equivalent") {
-                    // TODO: 需在 data_center 提供对应单元分量后再写入
-                    (void)name;
-                }
+    if (elem_fields) {
+        for (const std::string& name : *elem_fields) {
+            if (name == "Stress" || name == "Strain" || name == "Mises" || name == "Equivalent") {
+                // TODO: 需在 data_center 提供对应单元分量后再写入
+                (void)name;
             }
         }
     }
 
-    if (doc.SaveFile(filepath.c_str()) != XML_SUCCESS) {
-        spdlog::error("VtuExporter could not write file: {}", filepath);
-        return false;
+    VtuEncoding encoding = VtuEncoding::Ascii;
+    if (output_entity != entt::null && registry.valid(output_entity)) {
+        if (const auto* format = registry.try_get<Component::OutputFormat>(output_entity)) {
+            encoding = parse_encoding(format->value);
+        }
     }
-    spdlog::info("VtuExporter wrote: {}", filepath);
-    return true;
+    return write_frame(filepath, frame, encoding);
 }
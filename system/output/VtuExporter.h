@@ -1,6 +1,6 @@
 // system/output/VtuExporter.h
 /**
- * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. 
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
  * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
  *
  * Copyright (c) 2025 hyperFEM. All rights reserved.
@@ -8,16 +8,25 @@
  */
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 #include "entt/entt.hpp"
+#include "output/VtuFrame.h"
 
 struct DataContext;
+struct NodalState;
+struct ConnectivityStore;
+struct MeshPartition;
+class ThreadPool;
 
 /**
  * @brief VTU (VTK UnstructuredGrid) 输出辅助类
  * @details 按 docs/vtu_format.md 规格写出 .vtu 文件，供 HyperView 等后处理使用。
  * 几何与拓扑来自 mesh_components（Position、Connectivity、ElementType），
  * 节点/单元数据按 output_entity 上的 NodeOutput、ElementOutput 指定字段输出。
+ * 所有写出都经过 VtuFrame：先把数据整理为连续数组，再由 write_frame() 直接从数组序列化，
+ * 不为大数组构建 XML 文本节点。output_entity 上的 OutputFormat 选择 ASCII / 二进制编码。
  */
 class VtuExporter {
 public:
@@ -29,4 +38,60 @@ public:
      * @return 成功返回 true，否则 false
      */
     static bool save(const std::string& filepath, const DataContext& data_context, entt::entity output_entity = entt::null);
+
+    /**
+     * @brief 由扁平连接关系构建 VTU 拓扑（点编号即 NodalState 的稠密节点索引）
+     * @param store 连接块
+     * @return 可在多帧间共享的拓扑
+     */
+    static std::shared_ptr<VtuTopology> build_topology(const ConnectivityStore& store);
+
+    /**
+     * @brief 把节点状态块中的输出字段拷贝进帧（时间步循环中调用，只做连续数组拷贝）
+     * @param state 节点状态块（x、u、v、a）
+     * @param topology build_topology() 构建的拓扑
+     * @param node_fields 请求的节点字段；为空指针或空列表时按 save() 的默认规则
+     * @param time 物理时间
+     * @param frame 输出帧；已有容器的容量被复用
+     * @param partition 非空且单元编号与拓扑一致时，写出单元字段 PartitionID
+     */
+    static void capture_frame(const NodalState& state, std::shared_ptr<const VtuTopology> topology,
+                              const std::vector<std::string>* node_fields, double time, VtuFrame& frame,
+                              const MeshPartition* partition = nullptr);
+
+    /**
+     * @brief 把一帧写出为 VTU 文件
+     * @param filepath 输出 .vtu 路径
+     * @param frame 帧数据
+     * @param encoding 数组编码；Appended 时所有数组以原始字节写在文件末尾的 AppendedData 中
+     * @return 成功返回 true，否则 false
+     */
+    static bool write_frame(const std::string& filepath, const VtuFrame& frame,
+                            VtuEncoding encoding = VtuEncoding::Ascii);
+
+    /**
+     * @brief 把拓扑按单元连续区间划分为 num_pieces 块（各块单元数相差不超过 1）
+     * @param topology 全局拓扑
+     * @param num_pieces 块数（至少 1，不超过单元数）
+     * @return 可在多帧间共享的划分
+     */
+    static std::shared_ptr<VtuPartition> partition_topology(const VtuTopology& topology, size_t num_pieces);
+
+    /**
+     * @brief 分块写出一帧：每块一个 .vtu，外加引用各块的 .pvtu 主文件
+     * @param filepath 输出 .pvtu 路径；块文件写在同一目录，命名为 <stem>_<块号>.vtu
+     * @param frame 帧数据（全局拓扑与字段）
+     * @param partition partition_topology() 构建的划分
+     * @param encoding 块文件的数组编码
+     * @param pool 非空时各块由线程池并发提取与写出；为空时依次写出
+     * @return 所有块与主文件都写出成功时返回 true
+     */
+    static bool write_partitioned(const std::string& filepath, const VtuFrame& frame, const VtuPartition& partition,
+                                  VtuEncoding encoding = VtuEncoding::Ascii, ThreadPool* pool = nullptr);
+
+    /**
+     * @brief Output.Format 字符串 -> 编码："ASCII"、"Binary"（原始字节 appended）、"Base64"（内联）
+     * @details 不区分大小写；未知取值给出警告并使用 ASCII
+     */
+    static VtuEncoding parse_encoding(const std::string& format);
 };
@@ -0,0 +1,83 @@
+// system/output/VtuFrame.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief VTU DataArray 的编码方式
+ */
+enum class VtuEncoding {
+    Ascii,     ///< format="ascii"，文本数值
+    Base64,    ///< format="binary"，每个数组内联 base64（UInt64 字节数头 + 数据）
+    Appended   ///< format="appended"，所有数组以原始字节写在文件末尾的 AppendedData 中（最小、最快）
+};
+
+/**
+ * @brief VTU 网格拓扑（连续数组），各帧共享
+ * @details 数组含义见 docs/vtu_format.md：connectivity 为从 0 开始的点索引，
+ * offsets 为每个单元在 connectivity 中的结束位置，types 为 VTK 单元类型。
+ */
+struct VtuTopology {
+    size_t num_points = 0;
+    std::vector<int32_t> connectivity;
+    std::vector<int32_t> offsets;
+    std::vector<uint8_t> types;
+
+    size_t num_cells() const {
+        return types.size();
+    }
+};
+
+/**
+ * @brief VTU 场数据数组（Float64，按点/单元连续存放，分量交错）
+ */
+struct VtuField {
+    std::string name;
+    int components = 1;
+    std::vector<double> values;
+};
+
+/**
+ * @brief 一帧 VTU 输出的完整快照
+ * @details 求解器在输出时刻把所需字段拷贝进帧（只有连续数组拷贝，不做格式化），
+ * 序列化与写文件可以在后台线程完成（见 AsyncVtuWriter）。
+ * 帧对象可以反复使用：容器容量保留，后续帧不再分配内存。
+ */
+struct VtuFrame {
+    double time = 0.0;                              ///< 物理时间
+    std::shared_ptr<const VtuTopology> topology;    ///< 网格拓扑（多帧共享，只读）
+    std::vector<double> points;                     ///< 点坐标 xyz 交错，长度 3 * num_points
+    std::vector<VtuField> point_fields;             ///< PointData
+    std::vector<VtuField> cell_fields;              ///< CellData
+};
+
+/**
+ * @brief 分区输出中的一块（.pvtu 的一个 Piece）
+ * @details 单元为全局单元的连续区间 [cell_begin, cell_end)，点为这些单元引用到的节点；
+ * topology 使用块内局部点编号，nodes[i] 为局部点 i 对应的全局点编号。
+ * 块之间共享的节点在每块中各写一份。
+ */
+struct VtuPiece {
+    size_t cell_begin = 0;
+    size_t cell_end = 0;
+    std::vector<uint32_t> nodes;
+    std::shared_ptr<const VtuTopology> topology;
+};
+
+/**
+ * @brief 网格到 N 块的划分，由 VtuExporter::partition_topology() 构建一次，各帧共享
+ */
+struct VtuPartition {
+    std::vector<VtuPiece> pieces;
+};
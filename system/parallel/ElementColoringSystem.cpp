@@ -0,0 +1,101 @@
+// ElementColoringSystem.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "ElementColoringSystem.h"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+ElementColoring& ElementColoringSystem::build(entt::registry& registry, const ConnectivityStore& store) {
+    ElementColoring* coloring_ptr = nullptr;
+    if (registry.ctx().contains<ElementColoring>()) {
+        coloring_ptr = &registry.ctx().get<ElementColoring>();
+        coloring_ptr->clear();
+    } else {
+        coloring_ptr = &registry.ctx().emplace<ElementColoring>();
+    }
+    auto& coloring = *coloring_ptr;
+
+    const size_t num_elements = store.num_elements();
+    coloring.elements.reserve(num_elements);
+
+    // Blocks are processed one after another, so each block is colored on its own
+    std::vector<uint32_t> slots;
+    for (size_t b = 0; b < store.blocks.size(); ++b) {
+        slots.resize(store.blocks[b].num_elements());
+        for (size_t k = 0; k < slots.size(); ++k) {
+            slots[k] = static_cast<uint32_t>(k);
+        }
+        append_colors(store, b, slots, coloring);
+    }
+    if (coloring.color_offsets.empty()) {
+        coloring.color_offsets.push_back(0);
+    }
+
+    spdlog::info("ElementColoringSystem: {} elements colored with {} colors.",
+                 num_elements, coloring.num_colors());
+
+    return coloring;
+}
+
+void ElementColoringSystem::append_colors(const ConnectivityStore& store, size_t block_index,
+                                          const std::vector<uint32_t>& slots, ElementColoring& coloring) {
+    if (coloring.color_offsets.empty()) {
+        coloring.color_offsets.push_back(coloring.elements.size());
+    }
+
+    const ConnectivityBlock& block = store.blocks[block_index];
+    const int npe = block.nodes_per_element;
+
+    std::vector<uint64_t> node_colors(store.num_nodes(), 0);
+    std::vector<uint32_t> remaining(slots);
+    std::vector<uint32_t> deferred;
+    std::vector<std::vector<uint32_t>> colors;
+
+    // Each round hands out up to 64 new colors
+    while (!remaining.empty()) {
+        std::fill(node_colors.begin(), node_colors.end(), 0);
+        deferred.clear();
+        colors.clear();
+
+        for (uint32_t k : remaining) {
+            const uint32_t* nodes = block.nodes_of(k);
+
+            uint64_t used = 0;
+            for (int i = 0; i < npe; ++i) {
+                used |= node_colors[nodes[i]];
+            }
+
+            if (used == ~uint64_t(0)) {
+                deferred.push_back(k);
+                continue;
+            }
+
+            const int color = std::countr_one(used);
+            const uint64_t bit = uint64_t(1) << color;
+            for (int i = 0; i < npe; ++i) {
+                node_colors[nodes[i]] |= bit;
+            }
+
+            if (static_cast<size_t>(color) >= colors.size()) {
+                colors.resize(color + 1);
+            }
+            colors[color].push_back(k);
+        }
+
+        // Flatten this round into the CSR layout
+        for (const auto& color : colors) {
+            coloring.elements.insert(coloring.elements.end(), color.begin(), color.end());
+            coloring.color_offsets.push_back(coloring.elements.size());
+            coloring.color_block.push_back(static_cast<uint32_t>(block_index));
+        }
+
+        remaining.swap(deferred);
+    }
+}
@@ -0,0 +1,46 @@
+// ElementColoringSystem.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include "entt/entt.hpp"
+#include "../../data_center/ConnectivityStore.h"
+#include "../../data_center/ElementColoring.h"
+#include <vector>
+
+/**
+ * @class ElementColoringSystem
+ * @brief Greedy element coloring so that elements of one color share no node
+ * @details Each ConnectivityStore block is colored separately. Elements are visited
+ *          in block order and get the lowest color not yet used by any of their
+ *          nodes. Node color sets are 64-bit masks; elements that find all 64
+ *          colors taken are colored in a further round with a fresh set of 64
+ *          colors, so any mesh can be colored.
+ */
+class ElementColoringSystem {
+public:
+    /**
+     * @brief Build the ElementColoring stored in registry.ctx()
+     * @param registry EnTT registry (owns the ctx storage)
+     * @param store Connectivity blocks with dense node indices
+     * @return Reference to the ElementColoring
+     */
+    static ElementColoring& build(entt::registry& registry, const ConnectivityStore& store);
+
+    /**
+     * @brief Append the colors of a subset of one block to a coloring
+     * @param store Connectivity blocks with dense node indices
+     * @param block_index Block the slots belong to
+     * @param slots Element slots (indices into ConnectivityBlock::elements) to color
+     * @param coloring Coloring the new colors are appended to
+     * @details Used by build() for whole blocks and by SubcycleSystem for the
+     *          elements of one time step level.
+     */
+    static void append_colors(const ConnectivityStore& store, size_t block_index,
+                              const std::vector<uint32_t>& slots, ElementColoring& coloring);
+};
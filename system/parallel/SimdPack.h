@@ -0,0 +1,147 @@
+// SimdPack.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Fixed-width pack of doubles (or floats) for lane-parallel element kernels
+ * @details The generic template works on plain arrays (and is left to the
+ *          auto-vectorizer); when the translation unit is built with AVX2 or
+ *          AVX-512 enabled (see HYPERFEM_SIMD in CMakeLists.txt) the 4- and
+ *          8-wide double packs map directly onto __m256d / __m512d registers,
+ *          the 8- and 16-wide float packs onto __m256 / __m512.
+ *
+ *          Packs only provide what the element kernels need: element-wise
+ *          arithmetic, broadcast, and unaligned load/store of W consecutive values.
+ */
+template <int W, typename Real = double>
+struct SimdPack {
+    Real v[W];
+
+    static SimdPack broadcast(Real s) {
+        SimdPack r;
+        for (int l = 0; l < W; ++l) r.v[l] = s;
+        return r;
+    }
+    static SimdPack load(const Real* p) {
+        SimdPack r;
+        for (int l = 0; l < W; ++l) r.v[l] = p[l];
+        return r;
+    }
+    void store(Real* p) const {
+        for (int l = 0; l < W; ++l) p[l] = v[l];
+    }
+
+    friend SimdPack operator+(const SimdPack& a, const SimdPack& b) {
+        SimdPack r;
+        for (int l = 0; l < W; ++l) r.v[l] = a.v[l] + b.v[l];
+        return r;
+    }
+    friend SimdPack operator-(const SimdPack& a, const SimdPack& b) {
+        SimdPack r;
+        for (int l = 0; l < W; ++l) r.v[l] = a.v[l] - b.v[l];
+        return r;
+    }
+    friend SimdPack operator*(const SimdPack& a, const SimdPack& b) {
+        SimdPack r;
+        for (int l = 0; l < W; ++l) r.v[l] = a.v[l] * b.v[l];
+        return r;
+    }
+    friend SimdPack operator/(const SimdPack& a, const SimdPack& b) {
+        SimdPack r;
+        for (int l = 0; l < W; ++l) r.v[l] = a.v[l] / b.v[l];
+        return r;
+    }
+    friend SimdPack operator-(const SimdPack& a) {
+        SimdPack r;
+        for (int l = 0; l < W; ++l) r.v[l] = -a.v[l];
+        return r;
+    }
+};
+
+#if defined(__AVX2__)
+template <>
+struct SimdPack<4> {
+    __m256d v;
+
+    static SimdPack broadcast(double s) { return {_mm256_set1_pd(s)}; }
+    static SimdPack load(const double* p) { return {_mm256_loadu_pd(p)}; }
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+
+    friend SimdPack operator+(const SimdPack& a, const SimdPack& b) { return {_mm256_add_pd(a.v, b.v)}; }
+    friend SimdPack operator-(const SimdPack& a, const SimdPack& b) { return {_mm256_sub_pd(a.v, b.v)}; }
+    friend SimdPack operator*(const SimdPack& a, const SimdPack& b) { return {_mm256_mul_pd(a.v, b.v)}; }
+    friend SimdPack operator/(const SimdPack& a, const SimdPack& b) { return {_mm256_div_pd(a.v, b.v)}; }
+    friend SimdPack operator-(const SimdPack& a) { return {_mm256_sub_pd(_mm256_setzero_pd(), a.v)}; }
+};
+
+template <>
+struct SimdPack<8, float> {
+    __m256 v;
+
+    static SimdPack broadcast(float s) { return {_mm256_set1_ps(s)}; }
+    static SimdPack load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+
+    friend SimdPack operator+(const SimdPack& a, const SimdPack& b) { return {_mm256_add_ps(a.v, b.v)}; }
+    friend SimdPack operator-(const SimdPack& a, const SimdPack& b) { return {_mm256_sub_ps(a.v, b.v)}; }
+    friend SimdPack operator*(const SimdPack& a, const SimdPack& b) { return {_mm256_mul_ps(a.v, b.v)}; }
+    friend SimdPack operator/(const SimdPack& a, const SimdPack& b) { return {_mm256_div_ps(a.v, b.v)}; }
+    friend SimdPack operator-(const SimdPack& a) { return {_mm256_sub_ps(_mm256_setzero_ps(), a.v)}; }
+};
+#endif
+
+#if defined(__AVX512F__)
+template <>
+struct SimdPack<8> {
+    __m512d v;
+
+    static SimdPack broadcast(double s) { return {_mm512_set1_pd(s)}; }
+    static SimdPack load(const double* p) { return {_mm512_loadu_pd(p)}; }
+    void store(double* p) const { _mm512_storeu_pd(p, v); }
+
+    friend SimdPack operator+(const SimdPack& a, const SimdPack& b) { return {_mm512_add_pd(a.v, b.v)}; }
+    friend SimdPack operator-(const SimdPack& a, const SimdPack& b) { return {_mm512_sub_pd(a.v, b.v)}; }
+    friend SimdPack operator*(const SimdPack& a, const SimdPack& b) { return {_mm512_mul_pd(a.v, b.v)}; }
+    friend SimdPack operator/(const SimdPack& a, const SimdPack& b) { return {_mm512_div_pd(a.v, b.v)}; }
+    friend SimdPack operator-(const SimdPack& a) { return {_mm512_sub_pd(_mm512_setzero_pd(), a.v)}; }
+};
+
+template <>
+struct SimdPack<16, float> {
+    __m512 v;
+
+    static SimdPack broadcast(float s) { return {_mm512_set1_ps(s)}; }
+    static SimdPack load(const float* p) { return {_mm512_loadu_ps(p)}; }
+    void store(float* p) const { _mm512_storeu_ps(p, v); }
+
+    friend SimdPack operator+(const SimdPack& a, const SimdPack& b) { return {_mm512_add_ps(a.v, b.v)}; }
+    friend SimdPack operator-(const SimdPack& a, const SimdPack& b) { return {_mm512_sub_ps(a.v, b.v)}; }
+    friend SimdPack operator*(const SimdPack& a, const SimdPack& b) { return {_mm512_mul_ps(a.v, b.v)}; }
+    friend SimdPack operator/(const SimdPack& a, const SimdPack& b) { return {_mm512_div_ps(a.v, b.v)}; }
+    friend SimdPack operator-(const SimdPack& a) { return {_mm512_sub_ps(_mm512_setzero_ps(), a.v)}; }
+};
+#endif
+
+/**
+ * @brief Native lane count of the element batch kernels for this build
+ */
+#if defined(__AVX512F__)
+inline constexpr int kSimdLanes = 8;
+#else
+inline constexpr int kSimdLanes = 4;
+#endif
+
+/**
+ * @brief Native lane count of the single-precision batch kernels (twice the double width)
+ */
+inline constexpr int kSimdLanesFloat = 2 * kSimdLanes;
@@ -0,0 +1,78 @@
+// ThreadPool.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned num_threads) {
+    if (num_threads == 0) {
+        num_threads = hardware_threads();
+    }
+    workers_.reserve(num_threads - 1);
+    for (unsigned i = 1; i < num_threads; ++i) {
+        workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+unsigned ThreadPool::hardware_threads() {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+void ThreadPool::run(const std::function<void(unsigned)>& task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        pending_ = static_cast<unsigned>(workers_.size());
+        generation_++;
+    }
+    start_cv_.notify_all();
+
+    // The calling thread works as thread 0
+    task(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return pending_ == 0; });
+    task_ = nullptr;
+}
+
+void ThreadPool::worker_loop(unsigned thread_index) {
+    uint64_t seen_generation = 0;
+    while (true) {
+        const std::function<void(unsigned)>* task = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stop_ || generation_ != seen_generation; });
+            if (stop_) {
+                return;
+            }
+            seen_generation = generation_;
+            task = task_;
+        }
+
+        (*task)(thread_index);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_--;
+            if (pending_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+}
@@ -0,0 +1,94 @@
+// ThreadPool.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed-size pool of persistent worker threads for data-parallel loops
+ * @details The calling thread takes part in every loop as thread 0, so a pool of
+ *          size 1 runs everything inline without any synchronization. Ranges are
+ *          split into one contiguous chunk per thread; the split only depends on
+ *          the range and the pool size.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Create a pool
+     * @param num_threads Total number of threads including the caller (0 = hardware concurrency)
+     */
+    explicit ThreadPool(unsigned num_threads = 1);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Number of threads taking part in a loop (including the caller)
+     */
+    unsigned size() const {
+        return static_cast<unsigned>(workers_.size()) + 1;
+    }
+
+    /**
+     * @brief Run fn(chunk_begin, chunk_end, thread_index) over [begin, end) and wait
+     * @details Each thread receives at most one contiguous chunk. fn must not throw.
+     */
+    template <typename Fn>
+    void parallel_for(size_t begin, size_t end, Fn&& fn) {
+        if (end <= begin) {
+            return;
+        }
+        const size_t count = end - begin;
+        const unsigned num_threads = size();
+        if (num_threads == 1 || count == 1) {
+            fn(begin, end, 0u);
+            return;
+        }
+
+        const size_t chunk = (count + num_threads - 1) / num_threads;
+        run([&](unsigned thread_index) {
+            const size_t chunk_begin = begin + static_cast<size_t>(thread_index) * chunk;
+            if (chunk_begin >= end) {
+                return;
+            }
+            const size_t chunk_end = (chunk_begin + chunk < end) ? chunk_begin + chunk : end;
+            fn(chunk_begin, chunk_end, thread_index);
+        });
+    }
+
+    /**
+     * @brief Number of hardware threads (at least 1)
+     */
+    static unsigned hardware_threads();
+
+private:
+    /**
+     * @brief Execute task(thread_index) once on every thread and wait for completion
+     */
+    void run(const std::function<void(unsigned)>& task);
+
+    void worker_loop(unsigned thread_index);
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(unsigned)>* task_ = nullptr;
+    uint64_t generation_ = 0;
+    unsigned pending_ = 0;
+    bool stop_ = false;
+};
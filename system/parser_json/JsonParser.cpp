@@ -14,6 +14,7 @@
 #include "components/analysis_component.h"
 #include "nlohmann/json.hpp"
 #include "spdlog/spdlog.h"
+#include <algorithm>
 #include <fstream>
 #include <stdexcept>
 #include "JsonParser.h"
@@ -249,6 +250,7 @@ void JsonParser::parse_properties(
                 solid_prop.type_id = type_id;
                 solid_prop.integration_network = prop["integration_network"];
                 solid_prop.hourglass_control = prop["hourglass_control"];
+                solid_prop.hourglass_coefficient = prop.value("hourglass_coefficient", 0.1);
                 registry.emplace<Component::SolidProperty>(e, solid_prop);
                 spdlog::debug("  Created SolidProperty {}: integration={}, hourglass={}", 
                               pid, solid_prop.integration_network, solid_prop.hourglass_control);
@@ -760,6 +762,63 @@ void JsonParser::parse_analysis(const nlohmann::json& j, entt::registry& registr
         if (a.contains("fixed_time_step") && a["fixed_time_step"].is_number()) {
             registry.emplace<Component::FixedTimeStep>(e, a["fixed_time_step"].get<double>());
         }
+        if (a.contains("time_step_control") && a["time_step_control"].is_object()) {
+            const auto& tsc = a["time_step_control"];
+            Component::TimeStepControl control;
+            control.dt_scale = tsc.value("dt_scale", control.dt_scale);
+            control.dt_min = tsc.value("dt_min", control.dt_min);
+            control.control_type = tsc.value("control_type", control.control_type);
+            control.init_mass_scale_ratio = tsc.value("init_mass_scale_ratio", control.init_mass_scale_ratio);
+            control.max_mass_scale_ratio = tsc.value("max_mass_scale_ratio", control.max_mass_scale_ratio);
+            control.mass_scale_interval = std::max(0, tsc.value("mass_scale_interval", control.mass_scale_interval));
+            control.subcycle_levels = std::max(1, tsc.value("subcycle_levels", control.subcycle_levels));
+            control.stop_energy_error = tsc.value("stop_energy_error", control.stop_energy_error);
+            control.update_interval = std::max(1, tsc.value("update_interval", control.update_interval));
+            if (control.dt_scale <= 0.0 || control.dt_scale > 1.0) {
+                spdlog::warn("time_step_control: dt_scale = {} is outside (0, 1]. Using 0.9.", control.dt_scale);
+                control.dt_scale = 0.9;
+            }
+            registry.emplace<Component::TimeStepControl>(e, control);
+        }
+        if (a.contains("element_cache") && a["element_cache"].is_string()) {
+            registry.emplace<Component::ElementCache>(e, a["element_cache"].get<std::string>());
+        }
+        if (a.contains("element_precision") && a["element_precision"].is_string()) {
+            Component::ElementPrecision precision;
+            precision.mode = a["element_precision"].get<std::string>();
+            precision.check_interval = std::max(0, a.value("precision_check_interval", precision.check_interval));
+            registry.emplace<Component::ElementPrecision>(e, precision);
+        }
+        if (a.contains("partition") && a["partition"].is_object()) {
+            const auto& part = a["partition"];
+            Component::DomainPartition partition;
+            partition.num_parts = std::max(1, part.value("parts", partition.num_parts));
+            partition.method = part.value("method", partition.method);
+            registry.emplace<Component::DomainPartition>(e, partition);
+        }
+        if (a.contains("history") && a["history"].is_object()) {
+            const auto& hist = a["history"];
+            Component::HistoryOutput history;
+            if (hist.contains("global_fields") && hist["global_fields"].is_array()) {
+                for (const auto& field : hist["global_fields"]) {
+                    if (field.is_string()) {
+                        history.global_fields.push_back(field.get<std::string>());
+                    }
+                }
+            }
+            history.interval_time = std::max(0.0, hist.value("interval_time", history.interval_time));
+            history.format = hist.value("format", history.format);
+            if (!history.global_fields.empty()) {
+                registry.emplace<Component::HistoryOutput>(e, std::move(history));
+            }
+        }
+        if (a.contains("checkpoint") && a["checkpoint"].is_object()) {
+            const auto& ckpt = a["checkpoint"];
+            Component::CheckpointControl control;
+            control.interval_time = std::max(0.0, ckpt.value("interval_time", control.interval_time));
+            control.file = ckpt.value("file", control.file);
+            registry.emplace<Component::CheckpointControl>(e, std::move(control));
+        }
 
         analysis_id_map[aid] = e;
         spdlog::debug("  Created Analysis {}: type={}", aid, analysis_type_str);
@@ -794,6 +853,12 @@ void JsonParser::parse_output(const nlohmann::json &j, entt::registry &registry,
     if (o.contains("interval_time") && o["interval_time"].is_number()) {
         registry.emplace<Component::OutputIntervalTime>(e, o["interval_time"].get<double>());
     }
+    if (o.contains("format") || o.contains("pieces")) {
+        Component::OutputFormat format;
+        format.value = o.value("format", format.value);
+        format.pieces = std::max(1, o.value("pieces", format.pieces));
+        registry.emplace<Component::OutputFormat>(e, format);
+    }
 
     output_id_map[0] = e;
     spdlog::debug("  Created Output (single global)");
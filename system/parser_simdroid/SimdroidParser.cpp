@@ -387,11 +387,35 @@ void SimdroidParser::parse_control_json(const std::string& path, DataContext& ct
         parse_initial_conditions(j["InitialCondition"], registry);
     }
 
+    // Time step control (AnalysisControl.TimeStepControl); Step settings below take precedence
+    if (j.contains("AnalysisControl") && j["AnalysisControl"].is_object()) {
+        spdlog::info("Parsing Analysis Control...");
+        parse_analysis_control(j["AnalysisControl"], registry, ctx);
+    }
+
     // [新增] Analysis Settings (Step)
     if (j.contains("Step") && j["Step"].is_object()) {
         spdlog::info("Parsing Analysis Settings...");
         parse_analysis_settings(j["Step"], registry, ctx);
     }
+
+    // Field output (format, fields, animation interval); after Step so its interval takes precedence
+    if (j.contains("Output") && j["Output"].is_object()) {
+        spdlog::info("Parsing Field Output...");
+        parse_field_output(j["Output"], registry, ctx);
+    }
+
+    // Restart checkpoints
+    if (j.contains("Checkpoint") && j["Checkpoint"].is_object()) {
+        spdlog::info("Parsing Checkpoint Control...");
+        parse_checkpoint_control(j["Checkpoint"], registry, ctx);
+    }
+
+    // Global history output (energies, time step, ...)
+    if (j.contains("History") && j["History"].is_object()) {
+        spdlog::info("Parsing History Output...");
+        parse_history_output(j["History"], registry, ctx);
+    }
 }
 
 entt::entity SimdroidParser::find_set_by_name(entt::registry& registry, const std::string& name) {
@@ -742,6 +766,196 @@ void SimdroidParser::parse_analysis_settings(const json& j_step, entt::registry&
     spdlog::info("  -> Analysis Configured: Type={}, EndTime={}, OutputInterval={}", type, end_time, interval);
 }
 
+// =========================================================
+// 实现：时间步控制 (AnalysisControl.TimeStepControl)
+// =========================================================
+void SimdroidParser::parse_analysis_control(const json& j_control, entt::registry& registry, DataContext& ctx) {
+    const bool has_time_step_control = j_control.contains("TimeStepControl") && j_control["TimeStepControl"].is_object();
+    const bool has_element_cache = j_control.contains("ElementCache") && j_control["ElementCache"].is_string();
+    const bool has_element_precision = j_control.contains("ElementPrecision") && j_control["ElementPrecision"].is_string();
+    const bool has_partition = j_control.contains("Partition") && j_control["Partition"].is_object();
+    if (!has_time_step_control && !has_element_cache && !has_element_precision && !has_partition) return;
+
+    // Analysis entity (singleton)
+    entt::entity analysis_entity = ctx.analysis_entity;
+    if (analysis_entity == entt::null || !registry.valid(analysis_entity)) {
+        analysis_entity = registry.create();
+        ctx.analysis_entity = analysis_entity;
+    }
+    if (!registry.all_of<Component::AnalysisType>(analysis_entity)) {
+        registry.emplace<Component::AnalysisType>(analysis_entity, "Explicit");
+    }
+
+    // Reference-configuration element cache (small-strain linear runs)
+    if (has_element_cache) {
+        const std::string mode = j_control["ElementCache"].get<std::string>();
+        registry.emplace_or_replace<Component::ElementCache>(analysis_entity, mode);
+        spdlog::info("  -> Element Cache: {}", mode);
+    }
+
+    // Element kernel precision (mixed float32 kernel with fp64 accumulation)
+    if (has_element_precision) {
+        Component::ElementPrecision precision;
+        precision.mode = j_control["ElementPrecision"].get<std::string>();
+        if (j_control.contains("PrecisionCheckInterval") && j_control["PrecisionCheckInterval"].is_number_integer()) {
+            precision.check_interval = std::max(0, j_control["PrecisionCheckInterval"].get<int>());
+        }
+        registry.emplace_or_replace<Component::ElementPrecision>(analysis_entity, precision);
+        spdlog::info("  -> Element Precision: {} (check every {} steps)", precision.mode, precision.check_interval);
+    }
+
+    // Domain partition of the elements (statistics and PartitionID output)
+    if (has_partition) {
+        const auto& j_partition = j_control["Partition"];
+        Component::DomainPartition partition;
+        partition.num_parts = std::max(1, j_partition.value("Parts", partition.num_parts));
+        partition.method = j_partition.value("Method", partition.method);
+        registry.emplace_or_replace<Component::DomainPartition>(analysis_entity, partition);
+        spdlog::info("  -> Partition: {} parts ({})", partition.num_parts, partition.method);
+    }
+
+    if (!has_time_step_control) return;
+    const auto& j_ts = j_control["TimeStepControl"];
+
+    if (j_ts.contains("EndTime") && j_ts["EndTime"].is_number()) {
+        registry.emplace_or_replace<Component::EndTime>(analysis_entity, j_ts["EndTime"].get<double>());
+    }
+
+    Component::TimeStepControl control;
+    control.dt_scale = j_ts.value("DtScale", control.dt_scale);
+    control.dt_min = j_ts.value("Dtmin", control.dt_min);
+    control.control_type = j_ts.value("DtControlType", control.control_type);
+    control.init_mass_scale_ratio = j_ts.value("InitMassScalRatio", control.init_mass_scale_ratio);
+    control.max_mass_scale_ratio = j_ts.value("MaxMassScalRatio", control.max_mass_scale_ratio);
+    control.mass_scale_interval = j_ts.value("MassScalInterval", control.mass_scale_interval);
+    control.subcycle_levels = j_ts.value("SubcycleLevels", control.subcycle_levels);
+    control.stop_energy_error = j_ts.value("StopEnergyErr", control.stop_energy_error);
+    control.update_interval = j_ts.value("DtUpdateInterval", control.update_interval);
+
+    if (control.dt_scale <= 0.0 || control.dt_scale > 1.0) {
+        spdlog::warn("TimeStepControl: DtScale = {} is outside (0, 1]. Using 0.9.", control.dt_scale);
+        control.dt_scale = 0.9;
+    }
+    if (control.update_interval < 1) {
+        control.update_interval = 1;
+    }
+    if (control.mass_scale_interval < 0) {
+        control.mass_scale_interval = 0;
+    }
+    if (control.subcycle_levels < 1) {
+        control.subcycle_levels = 1;
+    }
+
+    registry.emplace_or_replace<Component::TimeStepControl>(analysis_entity, control);
+
+    spdlog::info("  -> Time Step Control: DtScale={}, Dtmin={}, DtControlType='{}'",
+                 control.dt_scale, control.dt_min, control.control_type);
+}
+
+// =========================================================
+// 实现：场输出 (Output)
+// =========================================================
+void SimdroidParser::parse_field_output(const json& j_output, entt::registry& registry, DataContext& ctx) {
+    // Output entity (singleton) - used by explicit solver
+    entt::entity output_entity = ctx.output_entity;
+    if (output_entity == entt::null || !registry.valid(output_entity)) {
+        output_entity = registry.create();
+        ctx.output_entity = output_entity;
+    }
+
+    Component::OutputFormat format;
+    format.value = j_output.value("Format", format.value);
+    format.pieces = j_output.value("Pieces", format.pieces);
+    if (format.pieces < 1) {
+        format.pieces = 1;
+    }
+    registry.emplace_or_replace<Component::OutputFormat>(output_entity, format);
+
+    // OutFields: nodal fields go to NodeOutput, everything else is element output
+    if (j_output.contains("OutFields") && j_output["OutFields"].is_array()) {
+        std::vector<std::string> node_fields;
+        std::vector<std::string> element_fields;
+        for (const auto& field : j_output["OutFields"]) {
+            if (!field.is_string()) continue;
+            const std::string name = field.get<std::string>();
+            if (name == "Displacement" || name == "Velocity" || name == "Acceleration") {
+                node_fields.push_back(name);
+            } else {
+                element_fields.push_back(name);
+            }
+        }
+        if (!node_fields.empty()) {
+            registry.emplace_or_replace<Component::NodeOutput>(output_entity, std::move(node_fields));
+        }
+        if (!element_fields.empty()) {
+            registry.emplace_or_replace<Component::ElementOutput>(output_entity, std::move(element_fields));
+        }
+    }
+
+    if (j_output.contains("AnimOutTimeInterval") && j_output["AnimOutTimeInterval"].is_number()) {
+        const double interval = j_output["AnimOutTimeInterval"].get<double>();
+        if (interval > 0.0) {
+            registry.emplace_or_replace<Component::OutputControl>(output_entity, interval);
+            registry.emplace_or_replace<Component::OutputIntervalTime>(output_entity, interval);
+        }
+    }
+
+    spdlog::info("  -> Field Output: Format={}, Pieces={}", format.value, format.pieces);
+}
+
+// =========================================================
+// 实现：全局历史输出 (History)
+// =========================================================
+void SimdroidParser::parse_history_output(const json& j_history, entt::registry& registry, DataContext& ctx) {
+    if (!j_history.contains("GlobalFields") || !j_history["GlobalFields"].is_array()) return;
+
+    Component::HistoryOutput history;
+    for (const auto& field : j_history["GlobalFields"]) {
+        if (field.is_string()) {
+            history.global_fields.push_back(field.get<std::string>());
+        }
+    }
+    if (history.global_fields.empty()) return;
+    history.interval_time = j_history.value("HistoryOutTimeInterval", history.interval_time);
+    history.format = j_history.value("Format", history.format);
+    if (history.interval_time < 0.0) {
+        history.interval_time = 0.0;
+    }
+
+    // Analysis entity (singleton)
+    entt::entity analysis_entity = ctx.analysis_entity;
+    if (analysis_entity == entt::null || !registry.valid(analysis_entity)) {
+        analysis_entity = registry.create();
+        ctx.analysis_entity = analysis_entity;
+    }
+
+    spdlog::info("  -> History Output: {} field(s), interval {}", history.global_fields.size(),
+                 history.interval_time);
+    registry.emplace_or_replace<Component::HistoryOutput>(analysis_entity, std::move(history));
+}
+
+// =========================================================
+// 实现：重启检查点 (Checkpoint)
+// =========================================================
+void SimdroidParser::parse_checkpoint_control(const json& j_checkpoint, entt::registry& registry, DataContext& ctx) {
+    Component::CheckpointControl control;
+    control.interval_time = j_checkpoint.value("TimeInterval", control.interval_time);
+    control.file = j_checkpoint.value("File", control.file);
+    if (control.interval_time < 0.0) {
+        control.interval_time = 0.0;
+    }
+
+    // Analysis entity (singleton)
+    entt::entity analysis_entity = ctx.analysis_entity;
+    if (analysis_entity == entt::null || !registry.valid(analysis_entity)) {
+        analysis_entity = registry.create();
+        ctx.analysis_entity = analysis_entity;
+    }
+
+    spdlog::info("  -> Checkpoint: '{}', interval {}", control.file, control.interval_time);
+    registry.emplace_or_replace<Component::CheckpointControl>(analysis_entity, std::move(control));
+}
+
 void SimdroidParser::parse_mesh_dat(const std::string& path, DataContext& ctx) {
     MeshSetDefs defs;
     collect_set_definitions_from_file(path, defs);
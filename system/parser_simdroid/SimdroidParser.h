@@ -29,6 +29,10 @@ class SimdroidParser {
         static void parse_initial_conditions(const nlohmann::json& j, entt::registry& registry);
         static void parse_rigid_walls(const nlohmann::json& j, entt::registry& registry);
         static void parse_analysis_settings(const nlohmann::json& j, entt::registry& registry, DataContext& ctx);
+        static void parse_analysis_control(const nlohmann::json& j, entt::registry& registry, DataContext& ctx);
+        static void parse_field_output(const nlohmann::json& j, entt::registry& registry, DataContext& ctx);
+        static void parse_checkpoint_control(const nlohmann::json& j, entt::registry& registry, DataContext& ctx);
+        static void parse_history_output(const nlohmann::json& j, entt::registry& registry, DataContext& ctx);
         
         // Helper to find a set entity by name
         static entt::entity find_set_by_name(entt::registry& registry, const std::string& name);
@@ -0,0 +1,134 @@
+// StepProfiler.cpp
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#include "StepProfiler.h"
+#include "nlohmann/json.hpp"
+#include "spdlog/spdlog.h"
+#include <fstream>
+
+namespace {
+    double to_seconds(uint64_t ns) {
+        return static_cast<double>(ns) * 1.0e-9;
+    }
+
+    double per_second(uint64_t count, uint64_t ns) {
+        return (ns > 0) ? static_cast<double>(count) / to_seconds(ns) : 0.0;
+    }
+}
+
+uint64_t PhaseStats::quantile_ns(double q) const {
+    if (calls == 0) {
+        return 0;
+    }
+    const uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(calls - 1)) + 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+        seen += histogram[i];
+        if (seen >= rank) {
+            const uint64_t upper = (i + 1 < 64) ? (uint64_t(1) << (i + 1)) : UINT64_MAX;
+            return (upper < max_ns) ? upper : max_ns;
+        }
+    }
+    return max_ns;
+}
+
+const char* StepProfiler::phase_name(ProfilePhase phase) {
+    switch (phase) {
+        case ProfilePhase::InternalForce: return "InternalForce";
+        case ProfilePhase::ExternalLoad:  return "ExternalLoad";
+        case ProfilePhase::Integrate:     return "Integrate";
+        case ProfilePhase::TimeStep:      return "TimeStep";
+        case ProfilePhase::Output:        return "Output";
+        case ProfilePhase::History:       return "History";
+        case ProfilePhase::Checkpoint:    return "Checkpoint";
+        case ProfilePhase::Step:          return "Step";
+        default:                          return "Unknown";
+    }
+}
+
+void StepProfiler::print_summary(size_t num_elements, size_t num_nodes) const {
+    const PhaseStats& step = stats(ProfilePhase::Step);
+    spdlog::info("Step profile ({} steps, {:.3f} s in the loop):", step.calls, to_seconds(step.total_ns));
+    spdlog::info("  {:<14} {:>10} {:>11} {:>7} {:>11} {:>11} {:>11} {:>11}",
+                 "phase", "calls", "total [s]", "share", "mean [us]", "p50 [us]", "p95 [us]", "max [us]");
+    for (int p = 0; p < static_cast<int>(ProfilePhase::Count); ++p) {
+        const PhaseStats& s = stats_[p];
+        if (s.calls == 0) {
+            continue;
+        }
+        const double share = (step.total_ns > 0)
+                                 ? 100.0 * static_cast<double>(s.total_ns) / static_cast<double>(step.total_ns) : 0.0;
+        spdlog::info("  {:<14} {:>10} {:>11.4f} {:>6.1f}% {:>11.2f} {:>11.2f} {:>11.2f} {:>11.2f}",
+                     phase_name(static_cast<ProfilePhase>(p)), s.calls, to_seconds(s.total_ns), share,
+                     1.0e-3 * static_cast<double>(s.total_ns) / static_cast<double>(s.calls),
+                     1.0e-3 * static_cast<double>(s.quantile_ns(0.5)),
+                     1.0e-3 * static_cast<double>(s.quantile_ns(0.95)),
+                     1.0e-3 * static_cast<double>(s.max_ns));
+    }
+
+    const PhaseStats& force = stats(ProfilePhase::InternalForce);
+    const PhaseStats& integrate = stats(ProfilePhase::Integrate);
+    spdlog::info("  Throughput: {:.3e} elements/s (internal force), {:.3e} nodes/s (integrate), "
+                 "{:.3e} elements/s and {:.3e} nodes/s per step",
+                 per_second(force.items, force.total_ns), per_second(integrate.items, integrate.total_ns),
+                 per_second(num_elements * step.calls, step.total_ns),
+                 per_second(num_nodes * step.calls, step.total_ns));
+}
+
+bool StepProfiler::write_json(const std::string& filepath, size_t num_elements, size_t num_nodes,
+                              unsigned num_threads) const {
+    using nlohmann::json;
+
+    const PhaseStats& step = stats(ProfilePhase::Step);
+    const PhaseStats& force = stats(ProfilePhase::InternalForce);
+    const PhaseStats& integrate = stats(ProfilePhase::Integrate);
+
+    json report;
+    report["model"] = {{"elements", num_elements}, {"nodes", num_nodes}, {"threads", num_threads}};
+    report["steps"] = step.calls;
+    report["loop_seconds"] = to_seconds(step.total_ns);
+    report["throughput"] = {
+        {"internal_force_elements_per_second", per_second(force.items, force.total_ns)},
+        {"integrate_nodes_per_second", per_second(integrate.items, integrate.total_ns)},
+        {"step_elements_per_second", per_second(num_elements * step.calls, step.total_ns)},
+        {"step_nodes_per_second", per_second(num_nodes * step.calls, step.total_ns)},
+    };
+
+    json phases = json::object();
+    for (int p = 0; p < static_cast<int>(ProfilePhase::Count); ++p) {
+        const PhaseStats& s = stats_[p];
+        // Trailing empty buckets are dropped; bucket i covers [2^i, 2^(i+1)) ns
+        int last = PhaseStats::kNumBuckets - 1;
+        while (last >= 0 && s.histogram[last] == 0) {
+            last--;
+        }
+        json histogram = json::array();
+        for (int i = 0; i <= last; ++i) {
+            histogram.push_back(s.histogram[i]);
+        }
+        phases[phase_name(static_cast<ProfilePhase>(p))] = {
+            {"calls", s.calls},
+            {"total_seconds", to_seconds(s.total_ns)},
+            {"min_ns", s.calls > 0 ? s.min_ns : 0},
+            {"max_ns", s.max_ns},
+            {"p50_ns", s.quantile_ns(0.5)},
+            {"p95_ns", s.quantile_ns(0.95)},
+            {"items", s.items},
+            {"histogram_log2_ns", histogram},
+        };
+    }
+    report["phases"] = phases;
+
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        spdlog::error("StepProfiler: cannot open '{}'.", filepath);
+        return false;
+    }
+    file << report.dump(2) << "\n";
+    return true;
+}
@@ -0,0 +1,148 @@
+// StepProfiler.h
+/**
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * Copyright (c) 2025 hyperFEM. All rights reserved.
+ * Author: Xiaotong Wang (or hyperFEM Team)
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Phases of the explicit step loop timed by the StepProfiler
+ */
+enum class ProfilePhase : int {
+    InternalForce,  ///< Element loop (f_int reset and accumulation)
+    ExternalLoad,   ///< f_ext reset and nodal loads
+    Integrate,      ///< Central difference update (and nodal energies)
+    TimeStep,       ///< Stable time step, mass scaling and subcycle rebuilds
+    Output,         ///< State write-back and VTU export
+    History,        ///< Energy balance and history file
+    Checkpoint,     ///< Checkpoint file writes
+    Step,           ///< Whole loop iteration
+    Count
+};
+
+/**
+ * @brief Accumulated timings of one phase
+ * @details The histogram has log2 buckets of the duration in nanoseconds:
+ *          bucket i counts samples in [2^i, 2^(i+1)) ns (bucket 0 also holds 0 ns).
+ */
+struct PhaseStats {
+    static constexpr int kNumBuckets = 40;
+
+    uint64_t calls = 0;
+    uint64_t total_ns = 0;
+    uint64_t min_ns = UINT64_MAX;
+    uint64_t max_ns = 0;
+    uint64_t items = 0;  ///< Work items processed (elements or nodes), for throughput
+    std::array<uint64_t, kNumBuckets> histogram{};
+
+    void add(uint64_t ns, uint64_t work_items) {
+        calls++;
+        total_ns += ns;
+        min_ns = (ns < min_ns) ? ns : min_ns;
+        max_ns = (ns > max_ns) ? ns : max_ns;
+        items += work_items;
+        int bucket = 0;
+        while (bucket + 1 < kNumBuckets && (ns >> (bucket + 1)) != 0) {
+            bucket++;
+        }
+        histogram[bucket]++;
+    }
+
+    /**
+     * @brief Approximate quantile (upper edge of the bucket holding it), in ns
+     */
+    uint64_t quantile_ns(double q) const;
+};
+
+/**
+ * @class StepProfiler
+ * @brief Per-phase accumulators of the explicit step loop
+ * @details Timers are placed with HYPERFEM_PROFILE_SCOPE, which expands to
+ *          nothing unless the build defines HYPERFEM_PROFILE (CMake option
+ *          HYPERFEM_PROFILE=ON), so the default build carries no clock calls
+ *          in the hot loop. Single-threaded use: phases are timed around the
+ *          parallel regions, not inside them.
+ */
+class StepProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void record(ProfilePhase phase, uint64_t ns, uint64_t items = 0) {
+        stats_[static_cast<int>(phase)].add(ns, items);
+    }
+
+    const PhaseStats& stats(ProfilePhase phase) const {
+        return stats_[static_cast<int>(phase)];
+    }
+
+    /**
+     * @brief Print the summary table (calls, total, share of the step, mean / p50 / p95 / max)
+     * @param num_elements Elements of the model, for the elements/s line
+     * @param num_nodes Nodes of the model, for the nodes/s line
+     */
+    void print_summary(size_t num_elements, size_t num_nodes) const;
+
+    /**
+     * @brief Write the machine-readable JSON report
+     * @param filepath Output path (e.g. result/profile.json)
+     * @param num_elements Elements of the model
+     * @param num_nodes Nodes of the model
+     * @param num_threads Threads of the element loops
+     * @return true on success
+     * @details Contains every phase with its accumulators and histogram, and the
+     *          throughput: element updates per second of the internal force phase,
+     *          node updates per second of the integrate phase, and both per second
+     *          of the whole step.
+     */
+    bool write_json(const std::string& filepath, size_t num_elements, size_t num_nodes, unsigned num_threads) const;
+
+    static const char* phase_name(ProfilePhase phase);
+
+private:
+    std::array<PhaseStats, static_cast<int>(ProfilePhase::Count)> stats_{};
+};
+
+/**
+ * @brief RAII timer recording the lifetime of the scope into a StepProfiler phase
+ */
+class ScopedPhaseTimer {
+public:
+    ScopedPhaseTimer(StepProfiler& profiler, ProfilePhase phase, uint64_t items = 0)
+        : profiler_(profiler), phase_(phase), items_(items), start_(StepProfiler::Clock::now()) {}
+
+    ~ScopedPhaseTimer() {
+        const auto elapsed = StepProfiler::Clock::now() - start_;
+        profiler_.record(phase_, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()), items_);
+    }
+
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+private:
+    StepProfiler& profiler_;
+    ProfilePhase phase_;
+    uint64_t items_;
+    StepProfiler::Clock::time_point start_;
+};
+
+#if defined(HYPERFEM_PROFILE)
+inline constexpr bool kStepProfilerEnabled = true;
+#define HYPERFEM_PROFILE_CONCAT_IMPL(a, b) a##b
+#define HYPERFEM_PROFILE_CONCAT(a, b) HYPERFEM_PROFILE_CONCAT_IMPL(a, b)
+/// Time the rest of the enclosing scope as `phase`; extra arguments are the work item count
+#define HYPERFEM_PROFILE_SCOPE(profiler, ...) \
+    ScopedPhaseTimer HYPERFEM_PROFILE_CONCAT(hyperfem_phase_timer_, __LINE__)((profiler), __VA_ARGS__)
+#else
+inline constexpr bool kStepProfilerEnabled = false;
+#define HYPERFEM_PROFILE_SCOPE(profiler, ...) ((void)0)
+#endif
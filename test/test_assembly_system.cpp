@@ -5,6 +5,7 @@
 #include <entt/entt.hpp>
 #include <Eigen/Dense>
 #include <Eigen/Sparse>
+#include <algorithm>
 #include <cmath>
 
 // Include the modules to test
@@ -227,6 +228,65 @@ TEST_F(AssemblySystemTest, C3D8RStiffnessMatrixTest) {
     EXPECT_GT(Ke.norm(), 1e-10);
 }
 
+// Center Jacobian of a sheared parallelepiped x = c + A xi is A itself: the volumetric
+// stiffness scale detJ * 8 must equal the B-bar volume, so Ke * u of a linear field
+// u = G x is exactly V B^T D eps(G) (linear fields carry no hourglass content)
+TEST_F(AssemblySystemTest, C3D8RStiffnessMatrixJacobianOfParallelepiped) {
+    LinearElasticMatrixSystem::compute_linear_elastic_matrix(registry);
+    const auto& D = registry.get<Component::LinearElasticMatrix>(material_entity).D;
+
+    const double xi[8][3] = {{-1, -1, -1}, {1, -1, -1}, {1, 1, -1}, {-1, 1, -1},
+                             {-1, -1, 1}, {1, -1, 1}, {1, 1, 1}, {-1, 1, 1}};
+    // Non-symmetric, so a transposed or mis-filled XiI table changes detJ
+    const double A[3][3] = {{0.6, 0.25, 0.05}, {0.0, 0.5, 0.3}, {0.2, 0.0, 0.7}};
+    Eigen::Matrix<double, 8, 3> coords;
+    for (int i = 0; i < 8; ++i) {
+        for (int r = 0; r < 3; ++r) {
+            coords(i, r) = 1.0 + A[r][0] * xi[i][0] + A[r][1] * xi[i][1] + A[r][2] * xi[i][2];
+        }
+    }
+
+    Eigen::MatrixXd Ke;
+    ASSERT_NO_THROW(compute_c3d8r_stiffness_matrix(coords, D, Ke));
+
+    const double G[3][3] = {{1.0e-3, 2.0e-4, -3.0e-4}, {5.0e-4, -1.0e-3, 4.0e-4}, {-2.0e-4, 1.0e-4, 7.0e-4}};
+    Eigen::VectorXd u(24);
+    for (int i = 0; i < 8; ++i) {
+        for (int a = 0; a < 3; ++a) {
+            u(3*i + a) = G[a][0] * coords(i, 0) + G[a][1] * coords(i, 1) + G[a][2] * coords(i, 2);
+        }
+    }
+    const Eigen::VectorXd f = Ke * u;
+
+    // Reference: sigma = D eps, f_I = V B_I^T sigma with B_I the gradients of N_I
+    Eigen::Matrix<double, 6, 1> eps;
+    eps << G[0][0], G[1][1], G[2][2], G[0][1] + G[1][0], G[1][2] + G[2][1], G[0][2] + G[2][0];
+    const Eigen::Matrix<double, 6, 1> sigma = D * eps;
+    Eigen::Matrix3d J;
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            J(r, c) = A[r][c];
+        }
+    }
+    const double volume = 8.0 * J.determinant();
+    const Eigen::Matrix3d J_inv = J.inverse();
+    double max_force = 0.0;
+    Eigen::VectorXd f_ref(24);
+    for (int i = 0; i < 8; ++i) {
+        // dN_I/dx = J^-T dN_I/dxi at the center, dN_I/dxi = xi_I / 8
+        const Eigen::Vector3d dN_dxi(xi[i][0] / 8.0, xi[i][1] / 8.0, xi[i][2] / 8.0);
+        const Eigen::Vector3d g = J_inv.transpose() * dN_dxi;
+        f_ref(3*i + 0) = volume * (g(0) * sigma(0) + g(1) * sigma(3) + g(2) * sigma(5));
+        f_ref(3*i + 1) = volume * (g(1) * sigma(1) + g(0) * sigma(3) + g(2) * sigma(4));
+        f_ref(3*i + 2) = volume * (g(2) * sigma(2) + g(1) * sigma(4) + g(0) * sigma(5));
+        max_force = std::max({max_force, std::abs(f_ref(3*i)), std::abs(f_ref(3*i + 1)), std::abs(f_ref(3*i + 2))});
+    }
+    ASSERT_GT(max_force, 0.0);
+    for (int k = 0; k < 24; ++k) {
+        EXPECT_NEAR(f(k), f_ref(k), 1e-9 * max_force) << "dof " << k;
+    }
+}
+
 // Test AssemblySystem dispatcher
 TEST_F(AssemblySystemTest, AssemblySystemDispatcherTest) {
     // First compute material matrix
@@ -0,0 +1,645 @@
+// test_c3d8r_internal_force.cpp
+// Unit tests for the explicit C3D8R / C3D8 internal force kernels and element loops
+
+#include <gtest/gtest.h>
+#include <entt/entt.hpp>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Include the modules to test
+// Note: Using paths relative to include directories set in CMakeLists.txt
+// (data_center/ and system/ are in include directories)
+#include "NodalState.h"
+#include "ConnectivityStore.h"
+#include "explicit/NodalStateSystem.h"
+#include "explicit/EnergyBalanceSystem.h"
+#include "mesh/ConnectivitySystem.h"
+#include "force/InternalForceSystem.h"
+#include "parallel/ElementColoringSystem.h"
+#include "parallel/ThreadPool.h"
+#include "material/mat1/LinearElasticMatrixSystem.h"
+#include "force/c3d8r/C3D8RInternalForce.h"
+#include "force/c3d8r/C3D8RBatchKernel.h"
+#include "force/c3d8r/C3D8RHourglass.h"
+#include "force/c3d8/C3D8InternalForce.h"
+#include "force/ReferenceElementCacheSystem.h"
+#include "element/c3d8/C3D8GaussTable.h"
+#include "element/ElementTraits.h"
+#include "element/c3d8r/C3D8RStiffnessMatrix.h"
+#include "element/c3d8r/C3D8RGradient.h"
+#include "components/mesh_components.h"
+#include "components/material_components.h"
+#include "components/property_components.h"
+#include "test_mesh_builder.h"
+
+// Test fixture: a row of distorted, displaced hexahedra sharing faces
+class C3D8RInternalForceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Linear elastic material (E=210000, nu=0.3), reduced integration
+        material_entity = test_mesh::add_linear_elastic_material(registry, 1, 7850.0);
+        property_entity = test_mesh::add_solid_property(registry, 1, material_entity);
+        LinearElasticMatrixSystem::compute_linear_elastic_matrix(registry);
+
+        element_entities = test_mesh::build_distorted_bar(registry, property_entity, num_elements).elements;
+    }
+
+    void TearDown() override {
+        registry.clear();
+        element_entities.clear();
+    }
+
+    static std::vector<uint32_t> all_slots(const ConnectivityBlock& block) {
+        std::vector<uint32_t> slots(block.num_elements());
+        for (size_t k = 0; k < slots.size(); ++k) {
+            slots[k] = static_cast<uint32_t>(k);
+        }
+        return slots;
+    }
+
+    // Number of elements is not a multiple of the lane count to exercise padding
+    static constexpr int num_elements = 2 * kSimdLanes + 3;
+
+    entt::registry registry;
+    std::vector<entt::entity> element_entities;
+    entt::entity material_entity;
+    entt::entity property_entity;
+};
+
+// Dense reference for the matrix-free gradient operators
+namespace {
+    // 6x24 B matrix (Voigt xx, yy, zz, xy, yz, xz; dofs node-major) from the unnormalized gradients
+    Eigen::Matrix<double, 6, 24> form_b_matrix(const double* bx, const double* by, const double* bz) {
+        Eigen::Matrix<double, 6, 24> B = Eigen::Matrix<double, 6, 24>::Zero();
+        for (int i = 0; i < 8; ++i) {
+            B(0, 3*i + 0) = bx[i];
+            B(1, 3*i + 1) = by[i];
+            B(2, 3*i + 2) = bz[i];
+            B(3, 3*i + 0) = by[i];
+            B(3, 3*i + 1) = bx[i];
+            B(4, 3*i + 1) = bz[i];
+            B(4, 3*i + 2) = by[i];
+            B(5, 3*i + 0) = bz[i];
+            B(5, 3*i + 2) = bx[i];
+        }
+        return B;
+    }
+
+    // Current and initial coordinates of an element, [direction][node]
+    void element_coordinates(const entt::registry& registry, entt::entity element,
+                             double x[3][8], double x0[3][8]) {
+        const auto& nodes = registry.get<Component::Connectivity>(element).nodes;
+        for (int i = 0; i < 8; ++i) {
+            const auto& pos = registry.get<Component::Position>(nodes[i]);
+            const auto& pos0 = registry.get<Component::InitialPosition>(nodes[i]);
+            x[0][i] = pos.x;
+            x[1][i] = pos.y;
+            x[2][i] = pos.z;
+            x0[0][i] = pos0.x0;
+            x0[1][i] = pos0.y0;
+            x0[2][i] = pos0.z0;
+        }
+    }
+}
+
+// Stiffness blocks from the gradient table equal the blocks of the dense B^T D B
+TEST_F(C3D8RInternalForceTest, GradientStiffnessBlockMatchesDenseProduct) {
+    const auto& D = registry.get<Component::LinearElasticMatrix>(material_entity).D;
+    for (auto element : element_entities) {
+        double x[3][8], x0[3][8];
+        element_coordinates(registry, element, x, x0);
+        double bx[8], by[8], bz[8];
+        const double volume = c3d8r_gradient::calc_b_bar(x[0], x[1], x[2], bx, by, bz);
+        ASSERT_GT(volume, 0.0);
+
+        const Eigen::Matrix<double, 6, 24> B = form_b_matrix(bx, by, bz);
+        const Eigen::Matrix<double, 24, 24> K_dense = B.transpose() * D * B;
+        const double scale = K_dense.cwiseAbs().maxCoeff();
+        for (int I = 0; I < 8; ++I) {
+            for (int J = 0; J < 8; ++J) {
+                const double gi[3] = {bx[I], by[I], bz[I]};
+                const double gj[3] = {bx[J], by[J], bz[J]};
+                double K[3][3];
+                c3d8r_gradient::gradient_stiffness_block(gi, gj, D, K);
+                for (int a = 0; a < 3; ++a) {
+                    for (int b = 0; b < 3; ++b) {
+                        EXPECT_NEAR(K[a][b], K_dense(3*I + a, 3*J + b), 1e-13 * scale);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Batched SIMD kernel must reproduce the scalar reference kernel, and both the
+// dense one-point force f = B^T D B u / V (B from the current coordinates)
+TEST_F(C3D8RInternalForceTest, BatchedKernelMatchesScalarReference) {
+    // Scalar reference: component based path
+    for (auto element : element_entities) {
+        ASSERT_TRUE(compute_c3d8r_internal_forces(registry, element));
+    }
+
+    // Batched path on the nodal state block
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    ASSERT_EQ(store.blocks.size(), 1u);
+    const std::vector<uint32_t> slots = all_slots(store.blocks[0]);
+    std::fill(state.f_int.begin(), state.f_int.end(), 0.0);
+    size_t computed = compute_c3d8r_internal_forces_batched(
+        registry, store.blocks[0], slots.data(), slots.size(), state);
+    EXPECT_EQ(computed, element_entities.size());
+
+    double max_force = 0.0;
+    for (size_t i = 0; i < state.num_nodes(); ++i) {
+        const auto& f_ref = registry.get<Component::InternalForce>(state.node_entity(i));
+        max_force = std::max({max_force, std::abs(f_ref.fx), std::abs(f_ref.fy), std::abs(f_ref.fz)});
+    }
+    ASSERT_GT(max_force, 0.0);
+
+    for (size_t i = 0; i < state.num_nodes(); ++i) {
+        const auto& f_ref = registry.get<Component::InternalForce>(state.node_entity(i));
+        EXPECT_NEAR(state.f_int[3*i + 0], f_ref.fx, 1e-12 * max_force);
+        EXPECT_NEAR(state.f_int[3*i + 1], f_ref.fy, 1e-12 * max_force);
+        EXPECT_NEAR(state.f_int[3*i + 2], f_ref.fz, 1e-12 * max_force);
+    }
+
+    // Dense reference assembled element by element
+    const auto& D = registry.get<Component::LinearElasticMatrix>(material_entity).D;
+    std::vector<double> f_dense(state.f_int.size(), 0.0);
+    for (auto element : element_entities) {
+        double x[3][8], x0[3][8];
+        element_coordinates(registry, element, x, x0);
+        double bx[8], by[8], bz[8];
+        const double volume = c3d8r_gradient::calc_b_bar(x[0], x[1], x[2], bx, by, bz);
+        const Eigen::Matrix<double, 6, 24> B = form_b_matrix(bx, by, bz);
+        Eigen::Matrix<double, 24, 1> u;
+        for (int i = 0; i < 8; ++i) {
+            for (int d = 0; d < 3; ++d) {
+                u(3*i + d) = x[d][i] - x0[d][i];
+            }
+        }
+        const Eigen::Matrix<double, 24, 1> f_e = B.transpose() * (D * (B * u)) / volume;
+        const auto& nodes = registry.get<Component::Connectivity>(element).nodes;
+        for (int i = 0; i < 8; ++i) {
+            const size_t n = static_cast<size_t>(state.index_of(nodes[i]));
+            for (int d = 0; d < 3; ++d) {
+                f_dense[3*n + d] += f_e(3*i + d);
+            }
+        }
+    }
+    for (size_t k = 0; k < f_dense.size(); ++k) {
+        EXPECT_NEAR(state.f_int[k], f_dense[k], 1e-12 * max_force);
+    }
+}
+
+// Rigid body translation must not produce internal forces
+TEST_F(C3D8RInternalForceTest, RigidTranslationIsForceFree) {
+    for (auto [node, pos, pos0] : registry.view<Component::Position, Component::InitialPosition>().each()) {
+        pos.x = pos0.x0 + 0.3;
+        pos.y = pos0.y0 - 0.2;
+        pos.z = pos0.z0 + 0.1;
+    }
+
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    const std::vector<uint32_t> slots = all_slots(store.blocks[0]);
+    std::fill(state.f_int.begin(), state.f_int.end(), 0.0);
+    compute_c3d8r_internal_forces_batched(registry, store.blocks[0], slots.data(), slots.size(), state);
+
+    for (double f : state.f_int) {
+        EXPECT_NEAR(f, 0.0, 1e-9);
+    }
+}
+
+// Colored multi-threaded element loop must match the serial loop
+TEST_F(C3D8RInternalForceTest, ColoredParallelLoopMatchesSerial) {
+    NodalState& state = NodalStateSystem::build(registry);
+    InternalForceSystem::compute_internal_forces(registry, state);
+    const std::vector<double> f_serial = state.f_int;
+
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    const ElementColoring& coloring = ElementColoringSystem::build(registry, store);
+    ThreadPool pool(3);
+    InternalForceSystem::compute_internal_forces(registry, store, state, coloring, pool);
+
+    for (size_t k = 0; k < f_serial.size(); ++k) {
+        EXPECT_NEAR(state.f_int[k], f_serial[k], 1e-9);
+    }
+}
+
+// Hourglass forces: batched path must match the component path for every control
+TEST_F(C3D8RInternalForceTest, HourglassBatchedMatchesScalarReference) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> velocity(-1.0, 1.0);
+    for (auto node : registry.view<Component::Position>()) {
+        registry.emplace_or_replace<Component::Velocity>(node, velocity(rng), velocity(rng), velocity(rng));
+    }
+
+    for (const char* control : {"viscous", "stiffness", "eas"}) {
+        registry.get<Component::SolidProperty>(property_entity).hourglass_control = control;
+
+        InternalForceSystem::reset_internal_forces(registry);
+        for (auto element : element_entities) {
+            ASSERT_TRUE(compute_c3d8r_internal_forces(registry, element));
+        }
+
+        NodalState& state = NodalStateSystem::build(registry);
+        const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+        const std::vector<uint32_t> slots = all_slots(store.blocks[0]);
+        std::fill(state.f_int.begin(), state.f_int.end(), 0.0);
+        compute_c3d8r_internal_forces_batched(registry, store.blocks[0], slots.data(), slots.size(), state);
+
+        double max_force = 0.0;
+        for (double f : state.f_int) {
+            max_force = std::max(max_force, std::abs(f));
+        }
+        ASSERT_GT(max_force, 0.0);
+        for (size_t i = 0; i < state.num_nodes(); ++i) {
+            const auto& f_ref = registry.get<Component::InternalForce>(state.node_entity(i));
+            EXPECT_NEAR(state.f_int[3*i + 0], f_ref.fx, 1e-12 * max_force) << control;
+            EXPECT_NEAR(state.f_int[3*i + 1], f_ref.fy, 1e-12 * max_force) << control;
+            EXPECT_NEAR(state.f_int[3*i + 2], f_ref.fz, 1e-12 * max_force) << control;
+        }
+    }
+}
+
+// EAS operators precomputed on x0 at setup reproduce the per-step evaluation
+TEST_F(C3D8RInternalForceTest, PrecomputedEASOperatorMatchesPerStepEvaluation) {
+    registry.get<Component::SolidProperty>(property_entity).hourglass_control = "eas";
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    const std::vector<uint32_t> slots = all_slots(store.blocks[0]);
+    const auto& D = registry.get<Component::LinearElasticMatrix>(material_entity).D;
+    C3D8RHourglassParams hourglass = get_c3d8r_hourglass_params(
+        &registry.get<Component::SolidProperty>(property_entity), 7850.0);
+    ASSERT_EQ(hourglass.control, HourglassControl::EAS);
+
+    std::fill(state.f_int.begin(), state.f_int.end(), 0.0);
+    ElementEnergy energy_ref;
+    compute_c3d8r_internal_forces_batched(store.blocks[0], slots.data(), slots.size(), D, hourglass, state,
+                                          &energy_ref);
+    const std::vector<double> f_ref = state.f_int;
+
+    // Cache Off still builds the operators of the (uncached) EAS block
+    ReferenceElementCacheSystem::build(registry, store, state, ReferenceCacheMode::Off);
+    const HourglassOperatorCache* operators = ReferenceElementCacheSystem::find_hourglass_operators(registry, store);
+    ASSERT_NE(operators, nullptr);
+    ASSERT_EQ(operators->blocks[0].num_elements(), store.blocks[0].num_elements());
+    hourglass.eas_gamma = operators->blocks[0].gamma.data();
+    hourglass.eas_stiffness = operators->blocks[0].stiffness.data();
+
+    std::fill(state.f_int.begin(), state.f_int.end(), 0.0);
+    ElementEnergy energy;
+    compute_c3d8r_internal_forces_batched(store.blocks[0], slots.data(), slots.size(), D, hourglass, state, &energy);
+    const double max_force = std::abs(*std::max_element(f_ref.begin(), f_ref.end(),
+        [](double a, double b) { return std::abs(a) < std::abs(b); }));
+    ASSERT_GT(max_force, 0.0);
+    for (size_t i = 0; i < f_ref.size(); ++i) {
+        EXPECT_NEAR(state.f_int[i], f_ref[i], 1e-12 * max_force);
+    }
+    ASSERT_GT(energy_ref.hourglass, 0.0);
+    EXPECT_NEAR(energy.hourglass, energy_ref.hourglass, 1e-12 * energy_ref.hourglass);
+
+    // The block loop picks the operators up from the registry context
+    InternalForceSystem::compute_internal_forces(registry, state);
+    for (size_t i = 0; i < f_ref.size(); ++i) {
+        EXPECT_NEAR(state.f_int[i], f_ref[i], 1e-12 * max_force);
+    }
+}
+
+// EAS hourglass force is the hourglass stiffness of the implicit element times u
+TEST_F(C3D8RInternalForceTest, EASForceMatchesStiffnessMatrix) {
+    registry.get<Component::SolidProperty>(property_entity).hourglass_control = "eas";
+    const entt::entity element = element_entities[0];
+    const auto& nodes = registry.get<Component::Connectivity>(element).nodes;
+
+    // Sheared parallelepiped: the center Jacobian volume of the stiffness matrix
+    // equals the B-bar volume of the force kernel, so only the O(u) geometric
+    // update of the one-point part separates the two
+    const double xi[8][3] = {{-1, -1, -1}, {1, -1, -1}, {1, 1, -1}, {-1, 1, -1},
+                             {-1, -1, 1}, {1, -1, 1}, {1, 1, 1}, {-1, 1, 1}};
+    const double A[3][3] = {{0.6, 0.1, 0.05}, {0.0, 0.5, 0.1}, {0.08, 0.0, 0.7}};
+    for (int i = 0; i < 8; ++i) {
+        double p[3];
+        for (int r = 0; r < 3; ++r) {
+            p[r] = 1.0 + A[r][0] * xi[i][0] + A[r][1] * xi[i][1] + A[r][2] * xi[i][2];
+        }
+        registry.replace<Component::InitialPosition>(nodes[i], p[0], p[1], p[2]);
+    }
+
+    // Small displacement with a strong hourglass content
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> perturb(-1.0, 1.0);
+    const double h1[8] = {1.0, -1.0, 1.0, -1.0, 1.0, -1.0, 1.0, -1.0};
+    const double scale = 1.0e-7;
+    Eigen::Matrix<double, 8, 3> coords;
+    Eigen::Matrix<double, 24, 1> u;
+    for (int i = 0; i < 8; ++i) {
+        const auto& pos0 = registry.get<Component::InitialPosition>(nodes[i]);
+        coords.row(i) << pos0.x0, pos0.y0, pos0.z0;
+        for (int d = 0; d < 3; ++d) {
+            u(3*i + d) = scale * (h1[i] + 0.3 * perturb(rng));
+        }
+        registry.replace<Component::Position>(nodes[i], pos0.x0 + u(3*i + 0), pos0.y0 + u(3*i + 1),
+                                              pos0.z0 + u(3*i + 2));
+    }
+
+    const auto& D = registry.get<Component::LinearElasticMatrix>(material_entity).D;
+    Eigen::MatrixXd Ke;
+    compute_c3d8r_stiffness_matrix(coords, D, Ke);
+    const Eigen::VectorXd f_ref = Ke * u;
+
+    NodalState& state = NodalStateSystem::build(registry);
+    std::fill(state.f_int.begin(), state.f_int.end(), 0.0);
+    ASSERT_TRUE(compute_c3d8r_internal_forces(registry, element, state));
+
+    const double max_force = f_ref.cwiseAbs().maxCoeff();
+    ASSERT_GT(max_force, 0.0);
+    for (int i = 0; i < 8; ++i) {
+        const size_t n = static_cast<size_t>(state.index_of(nodes[i]));
+        for (int d = 0; d < 3; ++d) {
+            EXPECT_NEAR(state.f_int[3*n + d], f_ref(3*i + d), 1e-5 * max_force);
+        }
+    }
+}
+
+// Every control resists the hourglass mode and leaves linear fields untouched
+TEST_F(C3D8RInternalForceTest, HourglassControlResistsOnlyHourglassModes) {
+    const entt::entity element = element_entities[0];
+    const auto& nodes = registry.get<Component::Connectivity>(element).nodes;
+    const double h1[8] = {1.0, -1.0, 1.0, -1.0, 1.0, -1.0, 1.0, -1.0};
+
+    // Work of the element forces on a nodal field w, with displacement and velocity set to w
+    auto element_work = [&](const char* control, auto field) {
+        registry.get<Component::SolidProperty>(property_entity).hourglass_control = control;
+        for (int i = 0; i < 8; ++i) {
+            const auto& pos0 = registry.get<Component::InitialPosition>(nodes[i]);
+            const std::array<double, 3> w = field(i, pos0);
+            registry.replace<Component::Position>(nodes[i], pos0.x0 + w[0], pos0.y0 + w[1], pos0.z0 + w[2]);
+            registry.emplace_or_replace<Component::Velocity>(nodes[i], w[0], w[1], w[2]);
+        }
+        NodalState& state = NodalStateSystem::build(registry);
+        std::fill(state.f_int.begin(), state.f_int.end(), 0.0);
+        EXPECT_TRUE(compute_c3d8r_internal_forces(registry, element, state));
+        double work = 0.0;
+        for (int i = 0; i < 8; ++i) {
+            const size_t n = static_cast<size_t>(state.index_of(nodes[i]));
+            for (int d = 0; d < 3; ++d) {
+                work += state.f_int[3*n + d] * (state.x[3*n + d] - state.x0[3*n + d]);
+            }
+        }
+        return work;
+    };
+
+    // Hourglass mode in x
+    auto hourglass = [&](int i, const Component::InitialPosition&) {
+        return std::array<double, 3>{1.0e-4 * h1[i], 0.0, 0.0};
+    };
+    auto linear = [&](int, const Component::InitialPosition& p) {
+        return std::array<double, 3>{1.0e-4 * (p.x0 + 2.0 * p.y0), -1.0e-4 * p.z0, 1.0e-4 * p.x0};
+    };
+
+    const double free_work = element_work("null", hourglass);
+    for (const char* control : {"viscous", "stiffness", "eas"}) {
+        EXPECT_GT(element_work(control, hourglass), free_work + 1e-12) << control;
+    }
+
+    // Linear displacement/velocity fields are reproduced exactly by the one-point element
+    const double linear_work = element_work("null", linear);
+    for (const char* control : {"viscous", "stiffness", "eas"}) {
+        EXPECT_NEAR(element_work(control, linear), linear_work, 1e-9 * std::abs(linear_work)) << control;
+    }
+}
+
+// Gauss tables are built at compile time: weights sum to the reference volume,
+// derivatives of the partition of unity vanish
+namespace {
+    template <int NGP>
+    constexpr bool gauss_table_consistent() {
+        constexpr const auto& table = c3d8_gauss::C3D8GaussRule<NGP>::table;
+        double weight_sum = 0.0;
+        for (int q = 0; q < c3d8_gauss::C3D8GaussRule<NGP>::num_points; ++q) {
+            weight_sum += table.weight[q];
+            for (int d = 0; d < 3; ++d) {
+                double dN_sum = 0.0;
+                for (int A = 0; A < 8; ++A) {
+                    dN_sum += table.dN[q][d][A];
+                }
+                if (dN_sum > 1e-15 || dN_sum < -1e-15) {
+                    return false;
+                }
+            }
+        }
+        return weight_sum > 8.0 - 1e-12 && weight_sum < 8.0 + 1e-12;
+    }
+    static_assert(gauss_table_consistent<2>());
+    static_assert(gauss_table_consistent<3>());
+}
+
+// Linear displacement fields: every rule integrates the constant-strain force exactly
+TEST_F(C3D8RInternalForceTest, FullIntegrationMatchesOnePointForLinearField) {
+    for (auto [node, pos, pos0] : registry.view<Component::Position, Component::InitialPosition>().each()) {
+        pos.x = pos0.x0 + 1.0e-3 * (pos0.x0 + 0.5 * pos0.y0 - 0.2 * pos0.z0);
+        pos.y = pos0.y0 + 1.0e-3 * (0.3 * pos0.x0 - pos0.y0 + 0.4 * pos0.z0);
+        pos.z = pos0.z0 + 1.0e-3 * (-0.1 * pos0.x0 + 0.2 * pos0.y0 + 0.7 * pos0.z0);
+    }
+    NodalState& state = NodalStateSystem::build(registry);
+    const size_t n = state.f_int.size();
+
+    std::fill(state.f_int.begin(), state.f_int.end(), 0.0);
+    for (auto element : element_entities) {
+        ASSERT_TRUE(compute_c3d8r_internal_forces(registry, element, state));
+    }
+    const std::vector<double> f_ref = state.f_int;
+    const double max_force = *std::max_element(f_ref.begin(), f_ref.end(),
+        [](double a, double b) { return std::abs(a) < std::abs(b); });
+    ASSERT_GT(std::abs(max_force), 0.0);
+
+    for (int rule : {2, 3}) {
+        std::fill(state.f_int.begin(), state.f_int.end(), 0.0);
+        for (auto element : element_entities) {
+            ASSERT_TRUE(compute_c3d8_internal_forces(registry, element, state, rule));
+        }
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_NEAR(state.f_int[i], f_ref[i], 1e-10 * std::abs(max_force)) << "rule " << rule;
+        }
+    }
+}
+
+// Full integration resists the hourglass mode without any stabilization and
+// the element loop no longer skips integration_network > 1
+TEST_F(C3D8RInternalForceTest, FullIntegrationResistsHourglassMode) {
+    const double h1[8] = {1.0, -1.0, 1.0, -1.0, 1.0, -1.0, 1.0, -1.0};
+    const auto& nodes = registry.get<Component::Connectivity>(element_entities[0]).nodes;
+    for (auto [node, pos, pos0] : registry.view<Component::Position, Component::InitialPosition>().each()) {
+        pos.x = pos0.x0;
+        pos.y = pos0.y0;
+        pos.z = pos0.z0;
+    }
+    for (int i = 0; i < 8; ++i) {
+        registry.get<Component::Position>(nodes[i]).x += 1.0e-4 * h1[i];
+    }
+
+    for (int rule : {2, 3}) {
+        registry.get<Component::SolidProperty>(property_entity).integration_network = rule;
+        NodalState& state = NodalStateSystem::build(registry);
+        InternalForceSystem::compute_internal_forces(registry, state);
+
+        double work = 0.0;
+        for (size_t i = 0; i < state.num_nodes(); ++i) {
+            for (int d = 0; d < 3; ++d) {
+                work += state.f_int[3*i + d] * (state.x[3*i + d] - state.x0[3*i + d]);
+            }
+        }
+        EXPECT_GT(work, 0.0) << "rule " << rule;
+
+        // The element force is self-equilibrated
+        for (int d = 0; d < 3; ++d) {
+            double sum = 0.0;
+            for (size_t i = 0; i < state.num_nodes(); ++i) {
+                sum += state.f_int[3*i + d];
+            }
+            EXPECT_NEAR(sum, 0.0, 1e-9 * std::sqrt(work)) << "rule " << rule;
+        }
+    }
+}
+
+// Small strain: the reference-configuration cache reproduces the current-configuration
+// kernels (bulk and every hourglass form) in both storage precisions
+TEST_F(C3D8RInternalForceTest, ReferenceCacheMatchesCurrentConfiguration) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (auto [node, pos, pos0] : registry.view<Component::Position, Component::InitialPosition>().each()) {
+        pos.x = pos0.x0 + 1.0e-7 * dist(rng);
+        pos.y = pos0.y0 + 1.0e-7 * dist(rng);
+        pos.z = pos0.z0 + 1.0e-7 * dist(rng);
+    }
+
+    for (const char* control : {"null", "stiffness", "viscous", "eas"}) {
+        registry.get<Component::SolidProperty>(property_entity).hourglass_control = control;
+        NodalState& state = NodalStateSystem::build(registry);
+        for (double& v : state.v) {
+            v = 1.0e-3 * dist(rng);
+        }
+        const ConnectivityStore& store = ConnectivitySystem::get_or_build(registry);
+
+        ReferenceElementCacheSystem::build(registry, store, state, ReferenceCacheMode::Off);
+        ASSERT_EQ(ReferenceElementCacheSystem::find(registry, store), nullptr);
+        InternalForceSystem::compute_internal_forces(registry, state);
+        const std::vector<double> f_ref = state.f_int;
+        const double max_force = std::abs(*std::max_element(f_ref.begin(), f_ref.end(),
+            [](double a, double b) { return std::abs(a) < std::abs(b); }));
+        ASSERT_GT(max_force, 0.0);
+
+        for (ReferenceCacheMode mode : {ReferenceCacheMode::Double, ReferenceCacheMode::Float}) {
+            const ReferenceElementCache& cache = ReferenceElementCacheSystem::build(registry, store, state, mode);
+            ASSERT_EQ(ReferenceElementCacheSystem::find(registry, store), &cache);
+            ASSERT_TRUE(cache.blocks[0].cached);
+            InternalForceSystem::compute_internal_forces(registry, state);
+            for (size_t i = 0; i < f_ref.size(); ++i) {
+                EXPECT_NEAR(state.f_int[i], f_ref[i], 1.0e-4 * max_force) << control;
+            }
+        }
+        ReferenceElementCacheSystem::build(registry, store, state, ReferenceCacheMode::Off);
+    }
+}
+
+// Element traits come from the constexpr type table shared with ElementRegistry
+static_assert(ElementTraits<308, 2>::num_nodes == 8 && ElementTraits<308, 2>::num_faces == 6 &&
+              ElementTraits<308, 2>::dimension == 3 && !ElementTraits<308, 2>::reduced_integration);
+static_assert(ElementTraits<304, 1>::num_nodes == 4 && ElementTraits<304, 1>::num_faces == 4);
+
+// Elements with different properties land in separate homogeneous blocks and
+// the block-dispatched loop matches the per-element kernels
+TEST_F(C3D8RInternalForceTest, BlocksSplitByPropertyMatchPerElementKernels) {
+    auto full_property = registry.create();
+    registry.emplace<Component::PropertyID>(full_property, 2);
+    registry.emplace<Component::SolidProperty>(full_property, 308, 2, "null");
+    registry.emplace<Component::MaterialRef>(full_property, material_entity);
+    registry.get<Component::SolidProperty>(property_entity).hourglass_control = "stiffness";
+    for (size_t e = 0; e < element_entities.size(); e += 2) {
+        registry.get<Component::PropertyRef>(element_entities[e]).property_entity = full_property;
+    }
+
+    const ConnectivityStore& store = ConnectivitySystem::build(registry);
+    ASSERT_EQ(store.blocks.size(), 2u);
+    EXPECT_EQ(store.num_elements(), element_entities.size());
+    for (const auto& block : store.blocks) {
+        EXPECT_EQ(block.material_entity, material_entity);
+        for (auto element : block.elements) {
+            EXPECT_EQ(registry.get<Component::PropertyRef>(element).property_entity, block.property_entity);
+        }
+    }
+
+    NodalState& state = NodalStateSystem::build(registry);
+    std::fill(state.f_int.begin(), state.f_int.end(), 0.0);
+    for (size_t e = 0; e < element_entities.size(); ++e) {
+        if (e % 2 == 0) {
+            ASSERT_TRUE(compute_c3d8_internal_forces(registry, element_entities[e], state, 2));
+        } else {
+            ASSERT_TRUE(compute_c3d8r_internal_forces(registry, element_entities[e], state));
+        }
+    }
+    const std::vector<double> f_ref = state.f_int;
+
+    InternalForceSystem::compute_internal_forces(registry, state);
+    for (size_t i = 0; i < f_ref.size(); ++i) {
+        EXPECT_NEAR(state.f_int[i], f_ref[i], 1e-9 * (1.0 + std::abs(f_ref[i])));
+    }
+
+    const ElementColoring& coloring = ElementColoringSystem::build(registry, store);
+    ThreadPool pool(3);
+    InternalForceSystem::compute_internal_forces(registry, store, state, coloring, pool);
+    for (size_t i = 0; i < f_ref.size(); ++i) {
+        EXPECT_NEAR(state.f_int[i], f_ref[i], 1e-9 * (1.0 + std::abs(f_ref[i])));
+    }
+}
+
+// Mixed precision: float32 element kernel within single-precision tolerance of fp64,
+// also far from the origin; compare_precision reports it and leaves f_int untouched
+TEST_F(C3D8RInternalForceTest, MixedPrecisionKernelTracksDouble) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    const ElementColoring& coloring = ElementColoringSystem::build(registry, store);
+    ThreadPool pool(2);
+    EXPECT_EQ(InternalForceSystem::precision(registry), KernelPrecision::Double);
+    EXPECT_EQ(InternalForceSystem::parse_precision("Float32"), KernelPrecision::Mixed);
+    EXPECT_EQ(InternalForceSystem::parse_precision("double"), KernelPrecision::Double);
+
+    for (double offset : {0.0, 1.0e5}) {
+        for (size_t k = 0; k < state.x.size(); ++k) {
+            state.x[k] += offset;
+            state.x0[k] += offset;
+        }
+
+        ElementEnergy energy_double, energy_mixed;
+        InternalForceSystem::set_precision(registry, KernelPrecision::Double);
+        InternalForceSystem::compute_internal_forces(registry, store, state, coloring, pool, &energy_double);
+        const std::vector<double> f_double = state.f_int;
+        InternalForceSystem::set_precision(registry, KernelPrecision::Mixed);
+        InternalForceSystem::compute_internal_forces(registry, store, state, coloring, pool, &energy_mixed);
+
+        double max_force = 0.0, max_diff = 0.0;
+        for (size_t k = 0; k < f_double.size(); ++k) {
+            max_force = std::max(max_force, std::abs(f_double[k]));
+            max_diff = std::max(max_diff, std::abs(state.f_int[k] - f_double[k]));
+        }
+        ASSERT_GT(max_force, 0.0);
+        EXPECT_GT(max_diff, 0.0);  // the float kernel really ran
+        EXPECT_LT(max_diff, 1.0e-5 * max_force);
+        EXPECT_NEAR(energy_mixed.strain, energy_double.strain, 1.0e-5 * energy_double.strain);
+
+        const std::vector<double> f_before = state.f_int;
+        const PrecisionDeviation deviation =
+            InternalForceSystem::compare_precision(registry, store, state, coloring, pool);
+        EXPECT_EQ(state.f_int, f_before);
+        EXPECT_EQ(deviation.energy_double, energy_double.strain + energy_double.hourglass);
+        EXPECT_EQ(deviation.energy_mixed, energy_mixed.strain + energy_mixed.hourglass);
+        EXPECT_NEAR(deviation.force_error, max_diff / max_force, 1.0e-12);
+        EXPECT_LT(deviation.energy_error(), 1.0e-5);
+    }
+}
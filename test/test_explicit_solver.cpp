@@ -0,0 +1,705 @@
+// test_explicit_solver.cpp
+// Unit tests for the explicit time integration: stable time step, mass scaling,
+// subcycling, energy balance, the fused step and checkpoint / restart
+
+#include <gtest/gtest.h>
+#include <entt/entt.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Include the modules to test
+// Note: Using paths relative to include directories set in CMakeLists.txt
+// (data_center/ and system/ are in include directories)
+#include "NodalState.h"
+#include "ConnectivityStore.h"
+#include "StableTimeStep.h"
+#include "MassScaling.h"
+#include "explicit/NodalStateSystem.h"
+#include "explicit/ExplicitSolver.h"
+#include "explicit/SubcycleSystem.h"
+#include "explicit/EnergyBalanceSystem.h"
+#include "explicit/CheckpointSystem.h"
+#include "load/LoadSystem.h"
+#include "boundary/BoundarySystem.h"
+#include "dof/DofMask.h"
+#include "mass/MassSystem.h"
+#include "mass/MassScalingSystem.h"
+#include "force/InternalForceSystem.h"
+#include "force/c3d8r/C3D8RBatchKernel.h"
+#include "parallel/ElementColoringSystem.h"
+#include "parallel/ThreadPool.h"
+#include "material/mat1/LinearElasticMatrixSystem.h"
+#include "components/mesh_components.h"
+#include "components/material_components.h"
+#include "components/property_components.h"
+#include "components/load_components.h"
+#include "test_mesh_builder.h"
+
+// Row of distorted hexahedra with a spread of element time steps
+class TimeStepTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto material = test_mesh::add_linear_elastic_material(registry, 1, 7850.0);
+        auto property = test_mesh::add_solid_property(registry, 1, material);
+        LinearElasticMatrixSystem::compute_linear_elastic_matrix(registry);
+        // Not a multiple of the lane count, as in the kernel tests
+        test_mesh::build_distorted_bar(registry, property, 2 * kSimdLanes + 3);
+    }
+
+    entt::registry registry;
+};
+
+// Bar of unit hexahedra with one thin element, vibrating from an initial stretch
+class ThinElementBarTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto material = test_mesh::add_linear_elastic_material(registry, 1, 7.85e-9);
+        auto property = test_mesh::add_solid_property(registry, 1, material);
+        LinearElasticMatrixSystem::compute_linear_elastic_matrix(registry);
+        test_mesh::build_thin_element_bar(registry, property);
+        MassSystem::compute_lumped_mass(registry);
+    }
+
+    entt::registry registry;
+};
+
+class SubcycleTest : public ThinElementBarTest {};
+class EnergyBalanceTest : public ThinElementBarTest {};
+class FusedStepTest : public ThinElementBarTest {};
+class SpcCompileTest : public ThinElementBarTest {};
+class LoadCompileTest : public ThinElementBarTest {};
+class CheckpointTest : public ThinElementBarTest {};
+
+// Critical time step of a unit cube is L_c / c with L_c = V / A_max = 1
+TEST(StableTimeStepTest, UnitCubeMatchesWaveSpeed) {
+    entt::registry registry;
+    const double rho = 7.85e-9, E = 210000.0, nu = 0.3;
+
+    auto material = registry.create();
+    registry.emplace<Component::MaterialID>(material, 1);
+    registry.emplace<Component::LinearElasticParams>(material, rho, E, nu);
+    auto property = registry.create();
+    registry.emplace<Component::PropertyID>(property, 1);
+    registry.emplace<Component::SolidProperty>(property, 308, 1, "null");
+    registry.emplace<Component::MaterialRef>(property, material);
+
+    const double corners[8][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+                                  {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}};
+    Component::Connectivity conn;
+    for (const auto& c : corners) {
+        auto node = registry.create();
+        registry.emplace<Component::Position>(node, c[0], c[1], c[2]);
+        conn.nodes.push_back(node);
+    }
+    auto element = registry.create();
+    registry.emplace<Component::ElementType>(element, 308);
+    registry.emplace<Component::PropertyRef>(element, property);
+    registry.emplace<Component::Connectivity>(element, std::move(conn));
+
+    const double c = std::sqrt(E * (1.0 - nu) / ((1.0 + nu) * (1.0 - 2.0 * nu) * rho));
+    EXPECT_NEAR(ExplicitSolver::compute_stable_timestep(registry), 1.0 / c, 1e-12 / c);
+}
+
+// Parallel min-reduction gives the same critical time step and element for any thread count
+TEST_F(TimeStepTest, StableTimeStepIndependentOfThreadCount) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+
+    ThreadPool serial_pool(1);
+    const double dt_serial = ExplicitSolver::compute_stable_timestep(registry, store, state.x, serial_pool);
+    const uint32_t critical_serial = registry.ctx().get<StableTimeStep>().critical_element;
+    ASSERT_TRUE(std::isfinite(dt_serial));
+
+    ThreadPool parallel_pool(4);
+    const double dt_parallel = ExplicitSolver::compute_stable_timestep(registry, store, state.x, parallel_pool);
+    EXPECT_EQ(dt_parallel, dt_serial);
+    EXPECT_EQ(registry.ctx().get<StableTimeStep>().critical_element, critical_serial);
+}
+
+// An inverted element gives no stable time step: dt_critical is 0 and points at the element
+TEST_F(TimeStepTest, InvertedElementHasNoStableTimeStep) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    const ConnectivityBlock& block = store.blocks[0];
+
+    // Reflect the free nodes of an end element through the centre of its shared face
+    std::vector<int> uses(store.num_nodes(), 0);
+    for (uint32_t node : block.node_indices) {
+        ++uses[node];
+    }
+    auto shared_nodes = [&](size_t k) {
+        const uint32_t* nodes = block.nodes_of(k);
+        return std::count_if(nodes, nodes + 8, [&](uint32_t node) { return uses[node] > 1; });
+    };
+    size_t end_element = 0;
+    while (end_element < block.num_elements() && shared_nodes(end_element) != 4) {
+        ++end_element;
+    }
+    ASSERT_LT(end_element, block.num_elements());
+    const uint32_t* nodes = block.nodes_of(end_element);
+    double centre[3] = {0.0, 0.0, 0.0};
+    for (int i = 0; i < 8; ++i) {
+        if (uses[nodes[i]] > 1) {
+            for (int d = 0; d < 3; ++d) {
+                centre[d] += state.x[3*nodes[i] + d];
+            }
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        if (uses[nodes[i]] == 1) {
+            for (int d = 0; d < 3; ++d) {
+                state.x[3*nodes[i] + d] = 0.5 * centre[d] - state.x[3*nodes[i] + d];
+            }
+        }
+    }
+
+    ThreadPool pool(4);
+    EXPECT_EQ(ExplicitSolver::compute_stable_timestep(registry, store, state.x, pool), 0.0);
+    const StableTimeStep& stable = registry.ctx().get<StableTimeStep>();
+    EXPECT_EQ(stable.num_invalid_elements, 1u);
+    EXPECT_EQ(stable.critical_block, 0u);
+    EXPECT_EQ(stable.critical_element, end_element);
+}
+
+// Mass scaling lifts only the elements below the target and conserves the added mass
+TEST_F(TimeStepTest, MassScalingLiftsSmallElementsToTarget) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    ThreadPool pool(1);
+    const double dt_crit = ExplicitSolver::compute_stable_timestep(registry, store, state.x, pool);
+    const std::vector<double> element_dt = registry.ctx().get<StableTimeStep>().element_dt[0];
+    const double dt_max = *std::max_element(element_dt.begin(), element_dt.end());
+    ASSERT_LT(dt_crit, dt_max);
+
+    // Target between the smallest and largest element time step
+    const double dt_scale = 0.9;
+    const double dt_target = dt_scale * 0.5 * (dt_crit + dt_max);
+    const double mass_before = std::accumulate(state.mass.begin(), state.mass.end(), 0.0);
+    const double dt_scaled = MassScalingSystem::apply(registry, store, state, dt_scale, dt_target, 0.0);
+    EXPECT_NEAR(dt_scaled, dt_target / dt_scale, 1e-12 * dt_target);
+
+    const MassScaling& scaling = registry.ctx().get<MassScaling>();
+    size_t expected_scaled = 0;
+    for (double dt : element_dt) {
+        expected_scaled += (dt < dt_target / dt_scale) ? 1 : 0;
+    }
+    EXPECT_EQ(scaling.scaled_elements, expected_scaled);
+    EXPECT_GT(scaling.added_mass, 0.0);
+    const double mass_after = std::accumulate(state.mass.begin(), state.mass.end(), 0.0);
+    EXPECT_NEAR(mass_after - mass_before, scaling.added_mass, 1e-12 * scaling.physical_mass);
+
+    // Scaled wave speeds are cached: a fresh evaluation reproduces the target
+    const double dt_again = ExplicitSolver::compute_stable_timestep(registry, store, state.x, pool);
+    EXPECT_NEAR(dt_again, dt_target / dt_scale, 1e-9 * dt_target);
+}
+
+// The added-mass limit lowers the target instead of exceeding the ratio
+TEST_F(TimeStepTest, MassScalingRespectsAddedMassLimit) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    ThreadPool pool(1);
+    const double dt_crit = ExplicitSolver::compute_stable_timestep(registry, store, state.x, pool);
+
+    const double limit = 0.01;
+    const double dt_scaled = MassScalingSystem::apply(registry, store, state, 1.0, 10.0 * dt_crit, limit);
+    const MassScaling& scaling = registry.ctx().get<MassScaling>();
+    EXPECT_LE(scaling.added_mass_ratio(), limit * (1.0 + 1e-9));
+    EXPECT_GT(scaling.added_mass_ratio(), 0.99 * limit);
+    EXPECT_GT(dt_scaled, dt_crit);
+    EXPECT_LT(dt_scaled, 10.0 * dt_crit);
+}
+
+TEST_F(SubcycleTest, LevelsFollowElementTimeStep) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    ThreadPool pool(1);
+    ExplicitSolver::compute_stable_timestep(registry, store, state.x, pool);
+
+    const SubcycleSchedule& schedule = SubcycleSystem::build(registry, store, 8);
+    ASSERT_EQ(schedule.num_levels, 4);  // dt ratio 10 between the unit and the thin elements
+    EXPECT_EQ(schedule.element_level[0][0], 0);
+    // The unit element sharing nodes with the thin one is evaluated on the small step
+    EXPECT_EQ(schedule.element_level[0][1], 0);
+    for (size_t k = 2; k < store.blocks[0].num_elements(); ++k) {
+        EXPECT_EQ(schedule.element_level[0][k], 3);
+    }
+    EXPECT_TRUE(SubcycleSystem::is_stable(registry, schedule));
+}
+
+// Subcycled run: close to the uniform step on two levels, stable and momentum
+// conserving on all levels
+TEST_F(SubcycleTest, SubcycledMotionMatchesUniformStep) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    const ElementColoring& coloring = ElementColoringSystem::build(registry, store);
+    ThreadPool pool(2);
+    SpcTable spc;
+    const double dt = 0.9 * ExplicitSolver::compute_stable_timestep(registry, store, state.x, pool);
+    const NodalState initial = state;
+    const size_t num_steps = 2048;
+
+    // Reference: every element on every base step
+    std::vector<std::vector<double>> u_uniform;
+    double max_u = 0.0;
+    for (size_t step = 0; step < num_steps; ++step) {
+        InternalForceSystem::compute_internal_forces(registry, store, state, coloring, pool);
+        ExplicitSolver::integrate(state, spc, dt);
+        u_uniform.push_back(state.u);
+        for (double u : state.u) {
+            max_u = std::max(max_u, std::abs(u));
+        }
+    }
+    ASSERT_GT(max_u, 0.0);
+
+    for (int max_levels : {2, 8}) {
+        state = initial;
+        const SubcycleSchedule& schedule = SubcycleSystem::build(registry, store, max_levels);
+        ASSERT_EQ(schedule.num_levels, max_levels == 2 ? 2 : 4);
+
+        double max_diff = 0.0, max_u_subcycled = 0.0;
+        for (size_t step = 0; step < num_steps; ++step) {
+            SubcycleSystem::compute_internal_forces(registry, store, state, schedule, step, pool);
+            ExplicitSolver::integrate(state, spc, dt);
+            for (size_t k = 0; k < state.u.size(); ++k) {
+                ASSERT_TRUE(std::isfinite(state.u[k]));
+                max_u_subcycled = std::max(max_u_subcycled, std::abs(state.u[k]));
+                if (step < 256) {
+                    max_diff = std::max(max_diff, std::abs(state.u[k] - u_uniform[step][k]));
+                }
+            }
+        }
+        // Deeper levels hold the slow forces for longer: looser, but still bounded
+        EXPECT_LT(max_diff, (max_levels == 2 ? 0.05 : 0.15) * max_u) << max_levels << " levels";
+        EXPECT_LT(max_u_subcycled, 1.5 * max_u);
+
+        // Element forces act on all their nodes at once: no net momentum is created
+        double momentum = 0.0, momentum_scale = 0.0;
+        for (size_t n = 0; n < state.num_nodes(); ++n) {
+            momentum += state.mass[n] * state.v[3*n + 2];
+            momentum_scale += state.mass[n] * std::abs(state.v[3*n + 2]);
+        }
+        EXPECT_LT(std::abs(momentum), 1e-10 * momentum_scale);
+    }
+}
+
+// Free vibration: the fused energy channel must balance and the strain energy
+// must equal 1/2 f.u of the assembled forces
+TEST_F(EnergyBalanceTest, ConservedInFreeVibration) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    const ElementColoring& coloring = ElementColoringSystem::build(registry, store);
+    ThreadPool pool(3);
+    SpcTable spc;
+    const double dt = 0.9 * ExplicitSolver::compute_stable_timestep(registry, store, state.x, pool);
+
+    ElementEnergy element_energy;
+    NodalEnergy nodal_energy;
+    EnergyBalance balance;
+    double max_kinetic = 0.0;
+    for (size_t step = 0; step < 1024; ++step) {
+        InternalForceSystem::compute_internal_forces(registry, store, state, coloring, pool, &element_energy);
+        if (step == 0) {
+            // Kernels take the displacement as x - x0 (the stretch is applied through Position)
+            double f_dot_u = 0.0;
+            for (size_t k = 0; k < state.f_int.size(); ++k) {
+                f_dot_u += state.f_int[k] * (state.x[k] - state.x0[k]);
+            }
+            EXPECT_NEAR(element_energy.strain, 0.5 * f_dot_u, 1e-12 * std::abs(f_dot_u));
+            EXPECT_GT(element_energy.strain, 0.0);
+        }
+        ExplicitSolver::integrate(state, spc, dt, nodal_energy);
+        EnergyBalanceSystem::update(balance, element_energy, nodal_energy, dt);
+        max_kinetic = std::max(max_kinetic, balance.kinetic);
+        EXPECT_FALSE(EnergyBalanceSystem::should_stop(balance, 0.01));
+    }
+
+    // Energy moves between strain and kinetic energy while the total is kept
+    EXPECT_GT(max_kinetic, 0.1 * balance.initial_total);
+    EXPECT_EQ(balance.external_work, 0.0);
+    EXPECT_LT(balance.error, 0.01);
+    EXPECT_NEAR(balance.mass, std::accumulate(state.mass.begin(), state.mass.end(), 0.0), 1e-12 * balance.mass);
+}
+
+// An unstable time step makes the energy error grow; StopEnergyErr catches it early
+TEST_F(EnergyBalanceTest, StopEnergyErrDetectsInstability) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    const ElementColoring& coloring = ElementColoringSystem::build(registry, store);
+    ThreadPool pool(1);
+    SpcTable spc;
+    const double dt = 1.5 * ExplicitSolver::compute_stable_timestep(registry, store, state.x, pool);
+
+    ElementEnergy element_energy;
+    NodalEnergy nodal_energy;
+    EnergyBalance balance;
+    size_t stop_step = 0;
+    for (size_t step = 1; step <= 1000 && stop_step == 0; ++step) {
+        InternalForceSystem::compute_internal_forces(registry, store, state, coloring, pool, &element_energy);
+        ExplicitSolver::integrate(state, spc, dt, nodal_energy);
+        EnergyBalanceSystem::update(balance, element_energy, nodal_energy, dt);
+        if (EnergyBalanceSystem::should_stop(balance, 0.1)) {
+            stop_step = step;
+        }
+    }
+    ASSERT_GT(stop_step, 0u);
+    EXPECT_TRUE(std::isfinite(balance.total));
+    EXPECT_LT(balance.total, 1.0e3 * balance.initial_total);
+}
+
+// SPC compilation: dof strings become per-node masks (OR over all SPCs of a node),
+// rotational DOFs are dropped and the constrained DOF list is sorted
+TEST_F(SpcCompileTest, MasksAndConstrainedDofs) {
+    NodalState& state = NodalStateSystem::build(registry);
+    ASSERT_GE(state.num_nodes(), 5u);
+
+    auto add_spc = [&](const std::string& dof) {
+        const entt::entity e = registry.create();
+        registry.emplace<Component::BoundarySPC>(e, Component::BoundarySPC{1, dof, 0.0});
+        return e;
+    };
+    const entt::entity all = add_spc("all");
+    const entt::entity xz = add_spc("XZ");
+    const entt::entity rx = add_spc("rx");
+    const entt::entity x = add_spc("x");
+    auto apply = [&](size_t n, entt::entity boundary) {
+        registry.get_or_emplace<Component::AppliedBoundaryRef>(state.node_entity(n)).boundary_entities.push_back(boundary);
+    };
+    // Attached out of node order; node 2 only carries a rotational SPC
+    apply(4, x);
+    apply(4, xz);
+    apply(3, rx);
+    apply(3, x);
+    apply(2, rx);
+    apply(1, xz);
+    apply(0, all);
+
+    for (int pass = 0; pass < 2; ++pass) {
+        const SpcTable& spc = BoundarySystem::compile_spc(registry, state);
+        ASSERT_EQ(spc.node_mask.size(), state.num_nodes());
+        EXPECT_EQ(spc.node_mask[0], DofMask::XYZ);
+        EXPECT_EQ(spc.node_mask[1], DofMask::X | DofMask::Z);
+        EXPECT_EQ(spc.node_mask[2], 0);
+        EXPECT_EQ(spc.node_mask[3], DofMask::X);
+        EXPECT_EQ(spc.node_mask[4], DofMask::X | DofMask::Z);
+        for (size_t n = 5; n < state.num_nodes(); ++n) {
+            EXPECT_EQ(spc.node_mask[n], 0);
+        }
+        EXPECT_EQ(spc.num_constrained_nodes, 4u);
+        EXPECT_EQ(spc.constrained_dofs, (std::vector<uint32_t>{0, 1, 2, 3, 5, 9, 12, 14}));
+    }
+}
+
+// Load compilation: one slot per distinct curve (slot 0 = no curve), dof strings as
+// masks, rotational loads dropped; the scatter matches the hand-computed forces
+TEST_F(LoadCompileTest, SharedCurvesGetOneSlot) {
+    NodalState& state = NodalStateSystem::build(registry);
+    ASSERT_GE(state.num_nodes(), 3u);
+
+    auto add_curve = [&](double y0, double y1) {
+        const entt::entity e = registry.create();
+        registry.emplace<Component::Curve>(e, Component::Curve{"linear", {0.0, 1.0}, {y0, y1}});
+        return e;
+    };
+    const entt::entity ramp = add_curve(0.0, 2.0);
+    const entt::entity constant = add_curve(3.0, 3.0);
+    auto add_load = [&](const std::string& dof, double value, entt::entity curve) {
+        const entt::entity e = registry.create();
+        registry.emplace<Component::NodalLoad>(e, Component::NodalLoad{1, dof, value});
+        if (curve != entt::null) {
+            registry.emplace<Component::CurveRef>(e, Component::CurveRef{curve});
+        }
+        return e;
+    };
+    const entt::entity pressure_z = add_load("z", 100.0, ramp);
+    const entt::entity shear_xy = add_load("xy", 10.0, ramp);
+    const entt::entity body = add_load("all", 5.0, constant);
+    const entt::entity fixed_x = add_load("x", 7.0, entt::null);
+    const entt::entity moment = add_load("rz", 1.0, ramp);
+    auto apply = [&](size_t n, entt::entity load) {
+        registry.get_or_emplace<Component::AppliedLoadRef>(state.node_entity(n)).load_entities.push_back(load);
+    };
+    apply(0, pressure_z);
+    apply(0, fixed_x);
+    apply(1, pressure_z);
+    apply(1, shear_xy);
+    apply(2, body);
+    apply(2, moment);
+
+    LoadProgram& program = LoadSystem::compile_nodal_loads(registry, state);
+    ASSERT_EQ(program.curves.size(), 3u);
+    ASSERT_EQ(program.curve_entities.size(), 3u);
+    EXPECT_TRUE(program.curve_entities[0] == entt::null);
+    EXPECT_NE(program.curve_entities[1], program.curve_entities[2]);
+    EXPECT_TRUE(program.curve_entities[1] == ramp || program.curve_entities[1] == constant);
+    EXPECT_TRUE(program.curve_entities[2] == ramp || program.curve_entities[2] == constant);
+    const uint32_t ramp_slot = (program.curve_entities[1] == ramp) ? 1u : 2u;
+    EXPECT_EQ(program.slot_values.size(), 3u);
+
+    // The rotational load is dropped; every record of the ramp loads shares its slot
+    ASSERT_EQ(program.records.size(), 5u);
+    for (const LoadProgram::Record& record : program.records) {
+        if (record.base_value == 100.0) {
+            EXPECT_EQ(record.dof_mask, DofMask::Z);
+            EXPECT_EQ(record.curve_slot, ramp_slot);
+        } else if (record.base_value == 10.0) {
+            EXPECT_EQ(record.node_index, 1u);
+            EXPECT_EQ(record.dof_mask, DofMask::X | DofMask::Y);
+            EXPECT_EQ(record.curve_slot, ramp_slot);
+        } else if (record.base_value == 5.0) {
+            EXPECT_EQ(record.node_index, 2u);
+            EXPECT_EQ(record.dof_mask, DofMask::XYZ);
+            EXPECT_EQ(record.curve_slot, 3u - ramp_slot);
+        } else {
+            EXPECT_EQ(record.base_value, 7.0);
+            EXPECT_EQ(record.node_index, 0u);
+            EXPECT_EQ(record.dof_mask, DofMask::X);
+            EXPECT_EQ(record.curve_slot, 0u);
+        }
+    }
+
+    // ramp(0.5) = 1, ramp(1) = 2, constant = 3
+    for (const auto& [t, scale] : {std::pair{0.5, 1.0}, std::pair{1.0, 2.0}}) {
+        LoadSystem::update_nodal_loads(program, state, t);
+        std::vector<double> expected(3 * state.num_nodes(), 0.0);
+        expected[0] = 7.0;
+        expected[2] = 100.0 * scale;
+        expected[3] = 10.0 * scale;
+        expected[4] = 10.0 * scale;
+        expected[5] = 100.0 * scale;
+        expected[6] = expected[7] = expected[8] = 15.0;
+        EXPECT_EQ(state.f_ext, expected) << "t = " << t;
+    }
+}
+
+// Fused step (accumulate, sparse load reset, single node pass) must reproduce the
+// classic zero-fill / integrate sequence bit for bit, with loads and SPCs
+TEST_F(FusedStepTest, MatchesSeparatePasses) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    const ElementColoring& coloring = ElementColoringSystem::build(registry, store);
+    ThreadPool pool(2);
+    const double dt = 0.9 * ExplicitSolver::compute_stable_timestep(registry, store, state.x, pool);
+
+    // Bottom face clamped in z (x and y on one node), ramped load on the top face
+    SpcTable spc;
+    spc.node_mask.assign(state.num_nodes(), 0);
+    LoadProgram program;
+    program.curves.resize(2);
+    program.curves[1].type = "linear";
+    program.curves[1].x = {0.0, 1.0};
+    program.curves[1].y = {0.0, 1.0e4};
+    program.slot_values.assign(2, 1.0);
+    double z_top = 0.0;
+    for (size_t n = 0; n < state.num_nodes(); ++n) {
+        z_top = std::max(z_top, state.x0[3*n + 2]);
+    }
+    bool first = true;
+    for (size_t n = 0; n < state.num_nodes(); ++n) {
+        if (state.x0[3*n + 2] == 0.0) {
+            spc.node_mask[n] = first ? 0b111 : 0b100;
+            first = false;
+        } else if (state.x0[3*n + 2] == z_top) {
+            program.records.push_back({static_cast<uint32_t>(n), 0b100, 1, 1.0});
+            program.records.push_back({static_cast<uint32_t>(n), 0b001, 0, 0.5});
+        }
+    }
+    for (size_t n = 0; n < state.num_nodes(); ++n) {
+        for (int d = 0; d < 3; ++d) {
+            if (spc.node_mask[n] & (1u << d)) {
+                spc.constrained_dofs.push_back(static_cast<uint32_t>(3*n + d));
+            }
+        }
+    }
+
+    const NodalState initial = state;
+    NodalState reference = state;
+    NodalEnergy energy_reference, energy_fused;
+    double t = 0.0;
+    for (size_t step = 0; step < 200; ++step) {
+        InternalForceSystem::compute_internal_forces(registry, store, reference, coloring, pool);
+        LoadSystem::apply_nodal_loads(program, reference, t);
+        ExplicitSolver::integrate(reference, spc, dt, energy_reference);
+
+        InternalForceSystem::accumulate_internal_forces(registry, store, state, coloring, pool);
+        LoadSystem::update_nodal_loads(program, state, t);
+        ExplicitSolver::integrate_fused(state, spc, dt, &energy_fused);
+        t += dt;
+
+        ASSERT_EQ(state.x, reference.x);
+        ASSERT_EQ(state.v, reference.v);
+        ASSERT_EQ(state.f_ext, reference.f_ext);
+        ASSERT_EQ(energy_fused.kinetic, energy_reference.kinetic);
+        ASSERT_EQ(energy_fused.power_after, energy_reference.power_after);
+        for (double f : state.f_int) {
+            ASSERT_EQ(f, 0.0);
+        }
+    }
+    EXPECT_NE(state.u, initial.u);
+    for (uint32_t dof : spc.constrained_dofs) {
+        EXPECT_EQ(state.u[dof], initial.u[dof]);
+    }
+}
+
+// Checkpoint / restart: a run resumed from a checkpoint continues bitwise
+// identically, and damaged or foreign files are rejected
+TEST_F(CheckpointTest, RestartContinuesBitwise) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    const ElementColoring& coloring = ElementColoringSystem::build(registry, store);
+    ThreadPool pool(2);
+    ExplicitSolver::compute_stable_timestep(registry, store, state.x, pool);
+    // Lift the thin bottom element so the checkpoint carries mass-scaled element state
+    const double dt_critical = MassScalingSystem::apply(registry, store, state, 0.9, 1.0e-7, 0.0);
+    ASSERT_TRUE(registry.ctx().contains<MassScaling>());
+    double dt = 0.9 * dt_critical;
+
+    SpcTable spc;
+    spc.node_mask.assign(state.num_nodes(), 0);
+    auto advance = [&](NodalState& s, int steps) {
+        for (int k = 0; k < steps; ++k) {
+            InternalForceSystem::accumulate_internal_forces(registry, store, s, coloring, pool);
+            ExplicitSolver::integrate_fused(s, spc, dt);
+        }
+    };
+    advance(state, 50);
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "hyperfem_checkpoint_test";
+    std::filesystem::create_directories(dir);
+    const std::string path = (dir / "run.hfc").string();
+    CheckpointRunState run;
+    run.time = 50 * dt;
+    run.dt = dt;
+    run.step = 50;
+    run.output_index = 3;
+    run.history_bytes = 4096;
+    run.energy.external_work = 1.25;
+    const StableTimeStep stable = registry.ctx().get<StableTimeStep>();
+    const MassScaling scaling = registry.ctx().get<MassScaling>();
+    ASSERT_TRUE(CheckpointSystem::write(path, run, state, &stable, &scaling));
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    // A changed dt after the checkpoint needs the restored previous dt for the velocity step
+    dt *= 0.8;
+    advance(state, 100);
+    const NodalState reference = state;
+
+    // Restart: wipe the state and the element context, then restore from the mapping
+    registry.ctx().erase<StableTimeStep>();
+    registry.ctx().erase<MassScaling>();
+    std::fill(state.x.begin(), state.x.end(), 0.0);
+    std::fill(state.v.begin(), state.v.end(), 0.0);
+    std::fill(state.mass.begin(), state.mass.end(), 0.0);
+    state.dt_previous = 0.0;
+    {
+        CheckpointFile file;
+        ASSERT_TRUE(file.open(path));
+        EXPECT_EQ(file.header().run.step, 50u);
+        EXPECT_EQ(file.header().run.dt, run.dt);
+        EXPECT_EQ(file.header().run.output_index, 3);
+        EXPECT_EQ(file.header().run.energy.external_work, 1.25);
+        ASSERT_TRUE(CheckpointSystem::restore_nodal_state(file, state));
+        ASSERT_TRUE(CheckpointSystem::restore_element_state(file, registry, store));
+        EXPECT_EQ(state.dt_previous, run.dt);
+        EXPECT_EQ(file.header().run.history_bytes, 4096u);
+        // The restored (mass-scaled) masses are written back to the node components
+        ASSERT_TRUE(CheckpointSystem::restore_nodal_mass(file, registry, store));
+        for (size_t n = 0; n < store.num_nodes(); ++n) {
+            EXPECT_EQ(registry.get<Component::Mass>(store.node_entities[n]).value, state.mass[n]);
+        }
+    }
+    EXPECT_EQ(registry.ctx().get<StableTimeStep>().wave_speed, stable.wave_speed);
+    EXPECT_EQ(registry.ctx().get<MassScaling>().element_mass, scaling.element_mass);
+    EXPECT_EQ(registry.ctx().get<MassScaling>().added_mass, scaling.added_mass);
+    advance(state, 100);
+    EXPECT_EQ(state.x, reference.x);
+    EXPECT_EQ(state.v, reference.v);
+    EXPECT_EQ(state.u, reference.u);
+
+    // Truncated file and wrong version are rejected
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream((dir / "truncated.hfc").string(), std::ios::binary).write(bytes.data(), bytes.size() / 2);
+        CheckpointHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        header.version = kCheckpointVersion + 1;
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        std::ofstream((dir / "version.hfc").string(), std::ios::binary).write(bytes.data(), bytes.size());
+    }
+    CheckpointFile file;
+    EXPECT_FALSE(file.open((dir / "truncated.hfc").string()));
+    EXPECT_FALSE(file.open((dir / "version.hfc").string()));
+    EXPECT_FALSE(file.open((dir / "missing.hfc").string()));
+    std::filesystem::remove_all(dir);
+}
+
+// Colored element loop on a grid large enough for several energy chunks per color:
+// forces, kinematics and the energy balance must be bitwise identical for any pool size
+TEST(DeterministicReductionTest, ExplicitStepsIndependentOfThreadCount) {
+    entt::registry registry;
+    auto material = test_mesh::add_linear_elastic_material(registry, 1, 7.85e-9);
+    auto property = test_mesh::add_solid_property(registry, 1, material, 1, "viscous");
+    LinearElasticMatrixSystem::compute_linear_elastic_matrix(registry);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> perturb(-1.0e-3, 1.0e-3);
+    test_mesh::build_hex_grid(registry, 20, 20, 6,
+        [&](entt::entity node, int i, int j, int k) {
+            registry.emplace<Component::InitialPosition>(node, double(i), double(j), double(k));
+            registry.emplace<Component::Position>(node, i + perturb(rng), j + perturb(rng), k + perturb(rng));
+        },
+        [&](int, int, int) { return property; });
+    MassSystem::compute_lumped_mass(registry);
+
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    const ElementColoring& coloring = ElementColoringSystem::build(registry, store);
+    size_t largest_color = 0;
+    for (size_t c = 0; c < coloring.num_colors(); ++c) {
+        largest_color = std::max(largest_color, coloring.color_offsets[c + 1] - coloring.color_offsets[c]);
+    }
+    ASSERT_GT(largest_color, 256u);  // more than one energy chunk
+
+    const NodalState initial = state;
+    SpcTable spc;
+    double dt = 0.0;
+    {
+        ThreadPool pool(1);
+        dt = 0.5 * ExplicitSolver::compute_stable_timestep(registry, store, state.x, pool);
+    }
+
+    auto run = [&](unsigned threads) {
+        ThreadPool pool(threads);
+        state = initial;
+        ElementEnergy element_energy;
+        NodalEnergy nodal_energy;
+        EnergyBalance balance;
+        for (int step = 0; step < 40; ++step) {
+            InternalForceSystem::accumulate_internal_forces(registry, store, state, coloring, pool, &element_energy);
+            ExplicitSolver::integrate_fused(state, spc, dt, &nodal_energy);
+            EnergyBalanceSystem::update(balance, element_energy, nodal_energy, dt);
+        }
+        return std::make_pair(state, balance);
+    };
+
+    const auto [reference, reference_balance] = run(1);
+    ASSERT_GT(reference_balance.internal, 0.0);
+    for (unsigned threads : {2u, 3u, 4u, 7u}) {
+        const auto [result, balance] = run(threads);
+        EXPECT_EQ(result.x, reference.x) << threads << " threads";
+        EXPECT_EQ(result.v, reference.v) << threads << " threads";
+        EXPECT_EQ(balance.internal, reference_balance.internal) << threads << " threads";
+        EXPECT_EQ(balance.kinetic, reference_balance.kinetic) << threads << " threads";
+        EXPECT_EQ(balance.hourglass, reference_balance.hourglass) << threads << " threads";
+        EXPECT_EQ(balance.error, reference_balance.error) << threads << " threads";
+    }
+}
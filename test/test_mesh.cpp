@@ -0,0 +1,339 @@
+// test_mesh.cpp
+// Unit tests for the mesh systems: connectivity store, owning node group and partitioner
+
+#include <gtest/gtest.h>
+#include <entt/entt.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <vector>
+
+// Include the modules to test
+// Note: Using paths relative to include directories set in CMakeLists.txt
+// (data_center/ and system/ are in include directories)
+#include "NodalState.h"
+#include "ConnectivityStore.h"
+#include "explicit/NodalStateSystem.h"
+#include "explicit/ExplicitSolver.h"
+#include "mass/MassSystem.h"
+#include "mesh/ConnectivitySystem.h"
+#include "mesh/NodeGroupSystem.h"
+#include "mesh/PartitionSystem.h"
+#include "material/mat1/LinearElasticMatrixSystem.h"
+#include "components/mesh_components.h"
+#include "components/material_components.h"
+#include "components/property_components.h"
+#include "test_mesh_builder.h"
+
+// Row of distorted hexahedra sharing faces
+class ConnectivityTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto material = test_mesh::add_linear_elastic_material(registry, 1, 7850.0);
+        auto property = test_mesh::add_solid_property(registry, 1, material);
+        element_entities = test_mesh::build_distorted_bar(registry, property, 5).elements;
+    }
+
+    entt::registry registry;
+    std::vector<entt::entity> element_entities;
+};
+
+// Bar of hexahedra with lumped masses on every node
+class NodeGroupTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto material = test_mesh::add_linear_elastic_material(registry, 1, 7.85e-9);
+        auto property = test_mesh::add_solid_property(registry, 1, material);
+        LinearElasticMatrixSystem::compute_linear_elastic_matrix(registry);
+        test_mesh::build_thin_element_bar(registry, property);
+        MassSystem::compute_lumped_mass(registry);
+    }
+
+    entt::registry registry;
+};
+
+// Connectivity store blocks reference the same nodes as the Connectivity components
+TEST_F(ConnectivityTest, StoreMatchesComponents) {
+    const ConnectivityStore& store = ConnectivitySystem::build(registry);
+    ASSERT_EQ(store.blocks.size(), 1u);
+    const ConnectivityBlock& block = store.blocks[0];
+    EXPECT_EQ(block.type_id, 308);
+    EXPECT_EQ(block.nodes_per_element, 8);
+    ASSERT_EQ(block.num_elements(), element_entities.size());
+
+    for (size_t k = 0; k < block.num_elements(); ++k) {
+        const auto& connectivity = registry.get<Component::Connectivity>(block.elements[k]);
+        for (int i = 0; i < 8; ++i) {
+            EXPECT_EQ(store.node_entities[block.nodes_of(k)[i]], connectivity.nodes[i]);
+        }
+    }
+}
+
+// A malformed hexahedron is rejected on its own, whichever element the view visits first;
+// the block keeps the node count of the element type and all well-formed elements
+TEST_F(ConnectivityTest, MalformedElementKeepsBlock) {
+    const std::vector<entt::entity> hex_nodes = registry.get<Component::Connectivity>(element_entities[0]).nodes;
+    const auto property = registry.get<Component::PropertyRef>(element_entities[0]);
+    for (int malformed_nodes : {4, 9}) {
+        auto malformed = registry.create();
+        registry.emplace<Component::ElementType>(malformed, 308);
+        registry.emplace<Component::PropertyRef>(malformed, property);
+        Component::Connectivity connectivity;
+        for (int i = 0; i < malformed_nodes; ++i) {
+            connectivity.nodes.push_back(hex_nodes[i % 8]);
+        }
+        registry.emplace<Component::Connectivity>(malformed, std::move(connectivity));
+    }
+
+    const ConnectivityStore& store = ConnectivitySystem::build(registry);
+    ASSERT_EQ(store.blocks.size(), 1u);
+    EXPECT_EQ(store.blocks[0].nodes_per_element, 8);
+    EXPECT_EQ(store.blocks[0].num_elements(), element_entities.size());
+}
+
+// Owning node group: every node is packed into the group, the span chunks cover it
+// exactly, and the component path integrates bit for bit like the SoA state block
+TEST_F(NodeGroupTest, SpansMatchNodalState) {
+    NodalState& state = NodalStateSystem::build(registry);
+    auto nodes = NodeGroupSystem::build(registry);
+    ASSERT_EQ(nodes.size(), state.num_nodes());
+
+    // Axial pull on the top layer, same load in both paths
+    for (size_t i = 0; i < state.num_nodes(); ++i) {
+        if (state.x0[3*i + 2] > 8.0) {
+            state.f_ext[3*i + 2] = 1.0e-3;
+            registry.get<Component::ExternalForce>(state.node_entity(i)).fz = 1.0e-3;
+        }
+    }
+
+    size_t covered = 0;
+    NodeGroupSystem::for_each_span(registry, nodes, [&](const NodalSpans& span) {
+        EXPECT_EQ(span.offset, covered);
+        for (size_t k = 0; k < span.count; ++k) {
+            const entt::entity node = span.entities[k];
+            EXPECT_EQ(&span.position[k], &registry.get<Component::Position>(node));
+            EXPECT_EQ(&span.mass[k], &registry.get<Component::Mass>(node));
+            EXPECT_EQ(&span.external_force[k], &registry.get<Component::ExternalForce>(node));
+        }
+        covered += span.count;
+    });
+    EXPECT_EQ(covered, nodes.size());
+
+    SpcTable spc;
+    const double dt = 1.0e-7;
+    for (int step = 0; step < 10; ++step) {
+        ExplicitSolver::integrate(registry, nodes, dt);
+        ExplicitSolver::integrate(state, spc, dt);
+    }
+    for (size_t i = 0; i < state.num_nodes(); ++i) {
+        const auto& pos = registry.get<Component::Position>(state.node_entity(i));
+        const auto& vel = registry.get<Component::Velocity>(state.node_entity(i));
+        EXPECT_EQ(pos.z, state.x[3*i + 2]);
+        EXPECT_EQ(vel.vz, state.v[3*i + 2]);
+    }
+
+    // Writing back goes through the same spans
+    state.v[2] = 42.0;
+    NodalStateSystem::sync_to_registry(registry, nodes);
+    EXPECT_EQ(registry.get<Component::Velocity>(state.node_entity(0)).vz, 42.0);
+}
+
+// View + per-entity lookups against the owning group and its raw spans.
+// Run with --gtest_also_run_disabled_tests; HYPERFEM_BENCH_NODES sets the model
+// size (default 5M nodes).
+TEST(NodeGroupBenchmark, DISABLED_ViewVersusGroupIteration) {
+    size_t num_nodes = 5000000;
+    if (const char* env = std::getenv("HYPERFEM_BENCH_NODES")) {
+        num_nodes = static_cast<size_t>(std::strtoull(env, nullptr, 10));
+    }
+
+    // Components are added in reverse node order, as when they are filled by
+    // separate systems, so the pools do not share a common order before grouping
+    entt::registry registry;
+    std::vector<entt::entity> entities(num_nodes);
+    for (size_t i = 0; i < num_nodes; ++i) {
+        entities[i] = registry.create();
+        registry.emplace<Component::Position>(entities[i], static_cast<double>(i), 0.0, 0.0);
+    }
+    for (size_t i = num_nodes; i-- > 0;) {
+        registry.emplace<Component::Mass>(entities[i], 1.0 + 1.0e-6 * static_cast<double>(i % 97));
+        registry.emplace<Component::ExternalForce>(entities[i], 1.0, 2.0, 3.0);
+    }
+    NodeGroupSystem::complete_node_components(registry);
+
+    const double dt = 1.0e-6;
+    auto update = [dt](Component::Position& x, Component::Velocity& v, Component::Acceleration& a,
+                       const Component::Mass& m, const Component::InternalForce& fi,
+                       const Component::ExternalForce& fe) {
+        const double inv_mass = 1.0 / m.value;
+        a.ax = (fe.fx - fi.fx) * inv_mass;
+        a.ay = (fe.fy - fi.fy) * inv_mass;
+        a.az = (fe.fz - fi.fz) * inv_mass;
+        v.vx += a.ax * dt;
+        v.vy += a.ay * dt;
+        v.vz += a.az * dt;
+        x.x += v.vx * dt;
+        x.y += v.vy * dt;
+        x.z += v.vz * dt;
+    };
+    auto best_of = [](int repeats, auto&& fn) {
+        double best = 1.0e30;
+        for (int r = 0; r < repeats; ++r) {
+            const auto t0 = std::chrono::steady_clock::now();
+            fn();
+            const auto t1 = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+        }
+        return best;
+    };
+    constexpr int repeats = 5;
+
+    const double t_view = best_of(repeats, [&] {
+        for (auto node : registry.view<Component::Position>()) {
+            update(registry.get<Component::Position>(node), registry.get<Component::Velocity>(node),
+                   registry.get<Component::Acceleration>(node), registry.get<Component::Mass>(node),
+                   registry.get<Component::InternalForce>(node), registry.get<Component::ExternalForce>(node));
+        }
+    });
+
+    auto nodes = NodeGroupSystem::build(registry);
+    ASSERT_EQ(nodes.size(), num_nodes);
+
+    const double t_group = best_of(repeats, [&] {
+        for (auto node : nodes) {
+            update(nodes.get<Component::Position>(node), nodes.get<Component::Velocity>(node),
+                   nodes.get<Component::Acceleration>(node), nodes.get<Component::Mass>(node),
+                   nodes.get<Component::InternalForce>(node), nodes.get<Component::ExternalForce>(node));
+        }
+    });
+
+    const double t_spans = best_of(repeats, [&] {
+        NodeGroupSystem::for_each_span(registry, nodes, [&](const NodalSpans& span) {
+            for (size_t k = 0; k < span.count; ++k) {
+                update(span.position[k], span.velocity[k], span.acceleration[k], span.mass[k],
+                       span.internal_force[k], span.external_force[k]);
+            }
+        });
+    });
+
+    const double per_node = 1.0e9 / static_cast<double>(num_nodes);
+    std::printf("[ bench    ] %zu nodes: view+get %.2f ns/node, group %.2f ns/node, spans %.2f ns/node\n",
+                num_nodes, t_view * per_node, t_group * per_node, t_spans * per_node);
+    EXPECT_TRUE(std::isfinite(registry.get<Component::Position>(entities.back()).x));
+}
+
+// Structured hexahedral grid for the partitioner; elements with i >= full_from use 2x2x2 integration
+class PartitionTest : public ::testing::Test {
+protected:
+    void build_grid(int nx, int ny, int nz, int full_from) {
+        auto material = test_mesh::add_linear_elastic_material(registry, 1, 7.85e-9);
+        auto reduced = test_mesh::add_solid_property(registry, 1, material, 1);
+        auto full = test_mesh::add_solid_property(registry, 2, material, 2);
+
+        int next_id = 1;
+        grid = test_mesh::build_hex_grid(registry, nx, ny, nz,
+            [&](entt::entity node, int i, int j, int k) {
+                registry.emplace<Component::OriginalID>(node, next_id++);
+                registry.emplace<Component::Position>(node, double(i), double(j), double(k));
+            },
+            [&](int i, int, int) { return i >= full_from ? full : reduced; });
+    }
+
+    // Faces between grid neighbours in different parts, counted from the PartitionID components
+    size_t count_cut_faces() const {
+        auto part = [&](int i, int j, int k) {
+            return registry.get<Component::PartitionID>(grid.element(i, j, k)).value;
+        };
+        size_t cut = 0;
+        for (int k = 0; k < grid.nz; ++k) {
+            for (int j = 0; j < grid.ny; ++j) {
+                for (int i = 0; i < grid.nx; ++i) {
+                    cut += (i + 1 < grid.nx && part(i, j, k) != part(i + 1, j, k));
+                    cut += (j + 1 < grid.ny && part(i, j, k) != part(i, j + 1, k));
+                    cut += (k + 1 < grid.nz && part(i, j, k) != part(i, j, k + 1));
+                }
+            }
+        }
+        return cut;
+    }
+
+    entt::registry registry;
+    test_mesh::HexGrid grid;
+};
+
+TEST_F(PartitionTest, AllMethodsCoverGridBalanced) {
+    build_grid(16, 8, 4, 16);
+    for (PartitionMethod method : {PartitionMethod::RCB, PartitionMethod::RIB, PartitionMethod::Graph}) {
+        SCOPED_TRACE(PartitionSystem::method_name(method));
+        const MeshPartition& result = PartitionSystem::partition(registry, 4, method);
+        ASSERT_EQ(result.num_parts, 4);
+        ASSERT_EQ(result.element_part.size(), grid.elements.size());
+        for (size_t count : result.part_elements) {
+            EXPECT_GT(count, 0u);
+        }
+        EXPECT_EQ(std::accumulate(result.part_elements.begin(), result.part_elements.end(), size_t{0}), grid.elements.size());
+        EXPECT_LE(result.imbalance, 1.03 + 1.0e-12);
+        EXPECT_EQ(result.edge_cut, count_cut_faces());
+        EXPECT_GT(result.shared_nodes, 0u);
+        EXPECT_GE(result.max_halo(), result.shared_nodes / 4);
+
+        // The optimum for four equal parts of a 16 x 8 x 4 grid is 96 faces (three 8 x 4 slabs)
+        EXPECT_LE(result.edge_cut, method == PartitionMethod::Graph ? 120u : 96u);
+        if (method == PartitionMethod::RCB) {
+            EXPECT_EQ(result.edge_cut, 96u);
+            EXPECT_EQ(result.shared_nodes, 3u * 9u * 5u);
+            EXPECT_EQ(result.max_halo(), 2u * 9u * 5u);
+        }
+
+        // Deterministic
+        const std::vector<int> first = result.element_part;
+        EXPECT_EQ(PartitionSystem::partition(registry, 4, method).element_part, first);
+    }
+}
+
+// All-zero element costs: RIB falls back to unit weights instead of a 0 / 0 centroid
+TEST_F(PartitionTest, ZeroCostsStillSplitWithRib) {
+    build_grid(8, 4, 2, 8);
+    for (entt::entity element : grid.elements) {
+        registry.emplace<Component::ElementCost>(element, 0.0);
+    }
+    const MeshPartition& result = PartitionSystem::partition(registry, 4, PartitionMethod::RIB);
+    ASSERT_EQ(result.element_part.size(), grid.elements.size());
+    for (size_t count : result.part_elements) {
+        EXPECT_EQ(count, grid.elements.size() / 4);
+    }
+}
+
+TEST_F(PartitionTest, CostWeightsBalanceFullAndReducedIntegration) {
+    EXPECT_DOUBLE_EQ(PartitionSystem::element_cost(308, 1), 2.0);
+    EXPECT_DOUBLE_EQ(PartitionSystem::element_cost(308, 2), 9.0);
+
+    // Left half C3D8R (cost 2), right half C3D8 (cost 9)
+    build_grid(20, 6, 3, 10);
+    for (PartitionMethod method : {PartitionMethod::RCB, PartitionMethod::Graph}) {
+        SCOPED_TRACE(PartitionSystem::method_name(method));
+        const MeshPartition& result = PartitionSystem::partition(registry, 2, method);
+        EXPECT_LE(result.imbalance, 1.03 + 1.0e-12);
+        // Equal work means far fewer of the expensive elements per part
+        const size_t reduced_part_elements = std::max(result.part_elements[0], result.part_elements[1]);
+        EXPECT_GT(reduced_part_elements, grid.elements.size() * 3 / 5);
+        EXPECT_EQ(result.edge_cut, count_cut_faces());
+    }
+
+    // A user-defined cost overrides the estimate
+    registry.emplace<Component::ElementCost>(grid.elements[0], 50.0);
+    const ConnectivityStore& store = ConnectivitySystem::get_or_build(registry);
+    const std::vector<double> weights = PartitionSystem::element_weights(registry, store);
+    size_t overridden = 0;
+    for (const auto& block : store.blocks) {
+        for (size_t k = 0; k < block.num_elements(); ++k, ++overridden) {
+            if (block.elements[k] == grid.elements[0]) {
+                EXPECT_EQ(weights[overridden], 50.0);
+            }
+        }
+    }
+    EXPECT_EQ(std::accumulate(weights.begin(), weights.end(), 0.0), 9.0 * 180 + 2.0 * 179 + 50.0);
+}
@@ -0,0 +1,120 @@
+// test_mesh_builder.h
+// Shared mesh builders for the unit tests: materials, properties and structured hexahedral grids
+#pragma once
+
+#include <entt/entt.hpp>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "components/mesh_components.h"
+#include "components/material_components.h"
+#include "components/property_components.h"
+
+namespace test_mesh {
+
+    // Linear elastic material entity (the D matrix is left to LinearElasticMatrixSystem)
+    inline entt::entity add_linear_elastic_material(entt::registry& registry, int material_id, double rho,
+                                                    double E = 210000.0, double nu = 0.3) {
+        auto material = registry.create();
+        registry.emplace<Component::MaterialID>(material, material_id);
+        registry.emplace<Component::LinearElasticParams>(material, rho, E, nu);
+        return material;
+    }
+
+    // Solid property of 8-node hexahedra referencing a material
+    inline entt::entity add_solid_property(entt::registry& registry, int property_id, entt::entity material,
+                                           int integration_network = 1, const std::string& hourglass = "null") {
+        auto property = registry.create();
+        registry.emplace<Component::PropertyID>(property, property_id);
+        registry.emplace<Component::SolidProperty>(property, 308, integration_network, hourglass);
+        registry.emplace<Component::MaterialRef>(property, material);
+        return property;
+    }
+
+    // Structured grid of nx x ny x nz hexahedra; nodes and elements are numbered with i fastest
+    struct HexGrid {
+        int nx = 0, ny = 0, nz = 0;
+        std::vector<entt::entity> nodes;
+        std::vector<entt::entity> elements;
+
+        entt::entity node(int i, int j, int k) const {
+            return nodes[(static_cast<size_t>(k) * (ny + 1) + j) * (nx + 1) + i];
+        }
+        entt::entity element(int i, int j, int k) const {
+            return elements[(static_cast<size_t>(k) * ny + j) * nx + i];
+        }
+    };
+
+    // place_node(node, i, j, k) emplaces the node components (Position, InitialPosition, ...),
+    // property_of(i, j, k) returns the property entity of the element at (i, j, k)
+    template <typename PlaceNode, typename PropertyOf>
+    HexGrid build_hex_grid(entt::registry& registry, int nx, int ny, int nz,
+                           PlaceNode&& place_node, PropertyOf&& property_of) {
+        HexGrid grid;
+        grid.nx = nx;
+        grid.ny = ny;
+        grid.nz = nz;
+        grid.nodes.reserve(static_cast<size_t>(nx + 1) * (ny + 1) * (nz + 1));
+        for (int k = 0; k <= nz; ++k) {
+            for (int j = 0; j <= ny; ++j) {
+                for (int i = 0; i <= nx; ++i) {
+                    auto node = registry.create();
+                    place_node(node, i, j, k);
+                    grid.nodes.push_back(node);
+                }
+            }
+        }
+        grid.elements.reserve(static_cast<size_t>(nx) * ny * nz);
+        for (int k = 0; k < nz; ++k) {
+            for (int j = 0; j < ny; ++j) {
+                for (int i = 0; i < nx; ++i) {
+                    auto element = registry.create();
+                    registry.emplace<Component::ElementType>(element, 308);
+                    registry.emplace<Component::PropertyRef>(element, property_of(i, j, k));
+                    Component::Connectivity conn;
+                    conn.nodes = {grid.node(i, j, k), grid.node(i + 1, j, k), grid.node(i + 1, j + 1, k),
+                                  grid.node(i, j + 1, k), grid.node(i, j, k + 1), grid.node(i + 1, j, k + 1),
+                                  grid.node(i + 1, j + 1, k + 1), grid.node(i, j + 1, k + 1)};
+                    registry.emplace<Component::Connectivity>(element, std::move(conn));
+                    grid.elements.push_back(element);
+                }
+            }
+        }
+        return grid;
+    }
+
+    // Row of num_elements distorted unit hexahedra along z; current = initial + small displacement
+    inline HexGrid build_distorted_bar(entt::registry& registry, entt::entity property, int num_elements,
+                                       unsigned seed = 42) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> perturb(-0.1, 0.1);
+        return build_hex_grid(registry, 1, 1, num_elements,
+            [&](entt::entity node, int i, int j, int k) {
+                const double x0 = i + perturb(rng);
+                const double y0 = j + perturb(rng);
+                const double z0 = k + perturb(rng);
+                registry.emplace<Component::InitialPosition>(node, x0, y0, z0);
+                registry.emplace<Component::Position>(node,
+                    x0 + 0.01 * perturb(rng), y0 + 0.01 * perturb(rng), z0 + 0.01 * perturb(rng));
+            },
+            [&](int, int, int) { return property; });
+    }
+
+    // Bar of unit hexahedra along z with one thin (0.1) element at the bottom and an
+    // initial stretch growing along the bar, which drives a free vibration
+    inline HexGrid build_thin_element_bar(entt::registry& registry, entt::entity property) {
+        std::vector<double> z = {0.0, 0.1};
+        for (int k = 0; k < 8; ++k) {
+            z.push_back(z.back() + 1.0);
+        }
+        return build_hex_grid(registry, 1, 1, static_cast<int>(z.size()) - 1,
+            [&](entt::entity node, int i, int j, int k) {
+                registry.emplace<Component::InitialPosition>(node, double(i), double(j), z[k]);
+                registry.emplace<Component::Position>(node, double(i), double(j), z[k] * (1.0 + 1.0e-3));
+            },
+            [&](int, int, int) { return property; });
+    }
+
+}  // namespace test_mesh
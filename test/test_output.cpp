@@ -0,0 +1,312 @@
+// test_output.cpp
+// Unit tests for the result output: step profiler, VTU frames (async, binary,
+// partitioned) and the PVD series index
+
+#include <gtest/gtest.h>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Include the modules to test
+// Note: Using paths relative to include directories set in CMakeLists.txt
+// (data_center/ and system/ are in include directories)
+#include "NodalState.h"
+#include "ConnectivityStore.h"
+#include "explicit/NodalStateSystem.h"
+#include "profile/StepProfiler.h"
+#include "output/VtuExporter.h"
+#include "output/AsyncVtuWriter.h"
+#include "output/PvdWriter.h"
+#include "output/HistoryWriter.h"
+#include "mass/MassSystem.h"
+#include "parallel/ThreadPool.h"
+#include "material/mat1/LinearElasticMatrixSystem.h"
+#include "test_mesh_builder.h"
+
+// Small hexahedral bar whose nodal state is written as VTU frames
+class VtuOutputTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto material = test_mesh::add_linear_elastic_material(registry, 1, 7.85e-9);
+        auto property = test_mesh::add_solid_property(registry, 1, material);
+        LinearElasticMatrixSystem::compute_linear_elastic_matrix(registry);
+        test_mesh::build_thin_element_bar(registry, property);
+        MassSystem::compute_lumped_mass(registry);
+    }
+
+    entt::registry registry;
+};
+
+// Profiler accumulators: log2 histogram, quantiles and RAII recording
+TEST(StepProfilerTest, AccumulatesPhasesAndHistogram) {
+    StepProfiler profiler;
+    for (uint64_t ns : {1u, 3u, 1000u, 1000u, 1500u, 1000000u}) {
+        profiler.record(ProfilePhase::InternalForce, ns, 10);
+    }
+    const PhaseStats& s = profiler.stats(ProfilePhase::InternalForce);
+    EXPECT_EQ(s.calls, 6u);
+    EXPECT_EQ(s.total_ns, 1003504u);
+    EXPECT_EQ(s.min_ns, 1u);
+    EXPECT_EQ(s.max_ns, 1000000u);
+    EXPECT_EQ(s.items, 60u);
+    EXPECT_EQ(s.histogram[0], 1u);
+    EXPECT_EQ(s.histogram[1], 1u);
+    EXPECT_EQ(s.histogram[9], 2u);   // 1000 ns in [512, 1024)
+    EXPECT_EQ(s.histogram[10], 1u);  // 1500 ns in [1024, 2048)
+    EXPECT_EQ(s.histogram[19], 1u);  // 1e6 ns in [2^19, 2^20)
+    EXPECT_EQ(s.quantile_ns(0.5), 1024u);
+    EXPECT_EQ(s.quantile_ns(1.0), 1000000u);
+
+    {
+        ScopedPhaseTimer timer(profiler, ProfilePhase::Integrate, 5);
+    }
+    EXPECT_EQ(profiler.stats(ProfilePhase::Integrate).calls, 1u);
+    EXPECT_EQ(profiler.stats(ProfilePhase::Integrate).items, 5u);
+    EXPECT_EQ(profiler.stats(ProfilePhase::Output).calls, 0u);
+}
+
+// History restart: rows written after the checkpoint are dropped, not duplicated
+TEST(HistoryWriterTest, ResumeTruncatesToCheckpoint) {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "hyperfem_history_test";
+    std::filesystem::create_directories(dir);
+    const std::string path = (dir / "history.dat").string();
+    const std::vector<std::string> fields = {"Time", "Cycle"};
+    EnergyBalance balance;
+
+    uint64_t checkpoint_bytes = 0;
+    {
+        HistoryWriter history;
+        ASSERT_TRUE(history.open(path, fields));
+        history.write(0.0, 0, 1.0, balance);
+        history.write(1.0, 1, 1.0, balance);
+        checkpoint_bytes = history.size();
+        history.write(2.0, 2, 1.0, balance);
+        EXPECT_GT(history.size(), checkpoint_bytes);
+    }
+    {
+        HistoryWriter history;
+        ASSERT_TRUE(history.open(path, fields, checkpoint_bytes));
+        EXPECT_EQ(history.size(), checkpoint_bytes);
+        history.write(2.0, 2, 1.0, balance);
+    }
+
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 4u);
+    EXPECT_EQ(lines[0], "# Time Cycle");
+    EXPECT_EQ(lines[3].substr(lines[3].find(' ') + 1), "2");
+    std::filesystem::remove_all(dir);
+}
+
+// Asynchronous writer: frames written in the background are identical to
+// synchronous writes, and a single buffer still completes every frame
+TEST_F(VtuOutputTest, AsyncWriterMatchesSynchronousWrite) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    std::shared_ptr<const VtuTopology> topology = VtuExporter::build_topology(store);
+    ASSERT_EQ(topology->num_points, state.num_nodes());
+    ASSERT_EQ(topology->num_cells(), store.num_elements());
+    ASSERT_EQ(topology->offsets.back(), static_cast<int32_t>(topology->connectivity.size()));
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "hyperfem_async_vtu_test";
+    std::filesystem::create_directories(dir);
+    auto read_file = [](const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+
+    const std::vector<std::string> fields = {"Displacement", "Velocity"};
+    for (size_t num_buffers : {size_t(1), size_t(2)}) {
+        AsyncVtuWriter writer(num_buffers);
+        std::vector<int> written;  // appended by the writer thread, read after flush()
+        for (int frame_index = 0; frame_index < 5; ++frame_index) {
+            for (size_t k = 0; k < state.u.size(); ++k) {
+                state.u[k] = 1.0e-3 * frame_index + 1.0e-6 * static_cast<double>(k);
+            }
+            VtuFrame& frame = writer.acquire();
+            VtuExporter::capture_frame(state, topology, &fields, 0.1 * frame_index, frame);
+            ASSERT_EQ(frame.point_fields.size(), 2u);
+            const std::filesystem::path async_path = dir / ("async_" + std::to_string(frame_index) + ".vtu");
+            writer.submit(frame, async_path.string(), [&written, async_path, frame_index](bool ok) {
+                // The frame is on disk when the callback runs
+                if (ok && std::filesystem::file_size(async_path) > 0) {
+                    written.push_back(frame_index);
+                }
+            });
+
+            VtuFrame reference;
+            VtuExporter::capture_frame(state, topology, &fields, 0.1 * frame_index, reference);
+            ASSERT_TRUE(VtuExporter::write_frame((dir / ("sync_" + std::to_string(frame_index) + ".vtu")).string(),
+                                                 reference));
+        }
+        ASSERT_TRUE(writer.flush());
+        EXPECT_EQ(writer.frames_written(), 5u);
+        EXPECT_EQ(written, (std::vector<int>{0, 1, 2, 3, 4}));
+        for (int frame_index = 0; frame_index < 5; ++frame_index) {
+            const std::string async_text = read_file(dir / ("async_" + std::to_string(frame_index) + ".vtu"));
+            EXPECT_FALSE(async_text.empty());
+            EXPECT_EQ(async_text, read_file(dir / ("sync_" + std::to_string(frame_index) + ".vtu")));
+        }
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST_F(VtuOutputTest, BinaryRoundTripsArrays) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    for (size_t k = 0; k < state.u.size(); ++k) {
+        state.u[k] = 1.0e-3 + 1.0e-7 * static_cast<double>(k);
+    }
+    const std::vector<std::string> fields = {"Displacement"};
+    VtuFrame frame;
+    VtuExporter::capture_frame(state, VtuExporter::build_topology(store), &fields, 0.5, frame);
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "hyperfem_binary_vtu_test";
+    std::filesystem::create_directories(dir);
+    auto read_file = [](const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+    ASSERT_TRUE(VtuExporter::write_frame((dir / "ascii.vtu").string(), frame, VtuEncoding::Ascii));
+    ASSERT_TRUE(VtuExporter::write_frame((dir / "raw.vtu").string(), frame, VtuEncoding::Appended));
+    ASSERT_TRUE(VtuExporter::write_frame((dir / "base64.vtu").string(), frame, VtuEncoding::Base64));
+    const std::string raw = read_file(dir / "raw.vtu");
+    const std::string base64 = read_file(dir / "base64.vtu");
+    EXPECT_EQ(VtuExporter::parse_encoding("Binary"), VtuEncoding::Appended);
+    EXPECT_EQ(VtuExporter::parse_encoding("base64"), VtuEncoding::Base64);
+
+    // Raw appended: arrays in document order are Points, connectivity, offsets, types, Displacement
+    const size_t marker = raw.find("<AppendedData encoding=\"raw\">");
+    ASSERT_NE(marker, std::string::npos);
+    const size_t data_start = raw.find('_', marker) + 1;
+    std::vector<uint64_t> offsets;
+    for (size_t pos = raw.find("offset=\""); pos < marker; pos = raw.find("offset=\"", pos + 1)) {
+        offsets.push_back(std::stoull(raw.substr(pos + 8)));
+    }
+    ASSERT_EQ(offsets.size(), 5u);
+    auto appended_block = [&](size_t index) {
+        uint64_t nbytes = 0;
+        std::memcpy(&nbytes, raw.data() + data_start + offsets[index], sizeof(nbytes));
+        return raw.substr(data_start + offsets[index] + sizeof(nbytes), nbytes);
+    };
+    auto bytes_of = [](const auto& values) {
+        return std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(values[0]));
+    };
+    EXPECT_EQ(appended_block(0), bytes_of(frame.points));
+    EXPECT_EQ(appended_block(1), bytes_of(frame.topology->connectivity));
+    EXPECT_EQ(appended_block(2), bytes_of(frame.topology->offsets));
+    EXPECT_EQ(appended_block(3), bytes_of(frame.topology->types));
+    EXPECT_EQ(appended_block(4), bytes_of(frame.point_fields[0].values));
+
+    // Base64 inline: decode the Points array (UInt64 byte count + Float64 data)
+    const size_t points_tag = base64.find("format=\"binary\">");
+    ASSERT_NE(points_tag, std::string::npos);
+    const size_t begin = base64.find('\n', points_tag) + 1;
+    const std::string encoded = base64.substr(begin, base64.find('\n', begin) - begin);
+    const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string decoded;
+    for (size_t i = 0; i + 3 < encoded.size(); i += 4) {
+        uint32_t v = 0;
+        int pad = 0;
+        for (int c = 0; c < 4; ++c) {
+            const char ch = encoded[i + c];
+            v = (v << 6) | (ch == '=' ? 0u : static_cast<uint32_t>(alphabet.find(ch)));
+            pad += (ch == '=');
+        }
+        const char group[3] = {char(v >> 16), char(v >> 8), char(v)};
+        decoded.append(group, 3 - pad);
+    }
+    uint64_t nbytes = 0;
+    ASSERT_GE(decoded.size(), sizeof(nbytes));
+    std::memcpy(&nbytes, decoded.data(), sizeof(nbytes));
+    EXPECT_EQ(nbytes, frame.points.size() * sizeof(double));
+    EXPECT_EQ(decoded.substr(sizeof(nbytes)), bytes_of(frame.points));
+    std::filesystem::remove_all(dir);
+}
+
+TEST_F(VtuOutputTest, PartitionedPiecesCoverTheMesh) {
+    NodalState& state = NodalStateSystem::build(registry);
+    const ConnectivityStore& store = registry.ctx().get<ConnectivityStore>();
+    std::shared_ptr<const VtuTopology> topology = VtuExporter::build_topology(store);
+    std::shared_ptr<const VtuPartition> partition = VtuExporter::partition_topology(*topology, 4);
+    ASSERT_EQ(partition->pieces.size(), 4u);
+
+    // Pieces cover the cells contiguously and map back to the global connectivity
+    size_t next_cell = 0;
+    for (const VtuPiece& piece : partition->pieces) {
+        EXPECT_EQ(piece.cell_begin, next_cell);
+        next_cell = piece.cell_end;
+        const int32_t first = (piece.cell_begin > 0) ? topology->offsets[piece.cell_begin - 1] : 0;
+        ASSERT_EQ(piece.topology->num_cells(), piece.cell_end - piece.cell_begin);
+        ASSERT_EQ(piece.topology->num_points, piece.nodes.size());
+        for (size_t k = 0; k < piece.topology->connectivity.size(); ++k) {
+            EXPECT_EQ(static_cast<int32_t>(piece.nodes[piece.topology->connectivity[k]]),
+                      topology->connectivity[first + k]);
+        }
+    }
+    EXPECT_EQ(next_cell, topology->num_cells());
+
+    for (size_t k = 0; k < state.u.size(); ++k) {
+        state.u[k] = 1.0e-6 * static_cast<double>(k);
+    }
+    const std::vector<std::string> fields = {"Displacement"};
+    VtuFrame frame;
+    VtuExporter::capture_frame(state, topology, &fields, 0.25, frame);
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "hyperfem_pvtu_test";
+    std::filesystem::create_directories(dir);
+    auto read_file = [](const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+
+    // Concurrent and serial piece writing produce identical files
+    ThreadPool pool(4);
+    ASSERT_TRUE(VtuExporter::write_partitioned((dir / "par.pvtu").string(), frame, *partition,
+                                               VtuEncoding::Appended, &pool));
+    ASSERT_TRUE(VtuExporter::write_partitioned((dir / "ser.pvtu").string(), frame, *partition,
+                                               VtuEncoding::Appended, nullptr));
+    const std::string master = read_file(dir / "par.pvtu");
+    EXPECT_NE(master.find("PUnstructuredGrid"), std::string::npos);
+    EXPECT_NE(master.find("Name=\"Displacement\""), std::string::npos);
+    for (size_t p = 0; p < partition->pieces.size(); ++p) {
+        const std::string piece = "par_" + std::to_string(p) + ".vtu";
+        EXPECT_NE(master.find("Source=\"" + piece + "\""), std::string::npos);
+        const std::string bytes = read_file(dir / piece);
+        EXPECT_FALSE(bytes.empty());
+        EXPECT_EQ(bytes, read_file(dir / ("ser_" + std::to_string(p) + ".vtu")));
+    }
+
+    PvdWriter pvd((dir / "series.pvd").string());
+    ASSERT_TRUE(pvd.add(0.0, "par.pvtu"));
+    ASSERT_TRUE(pvd.add(0.25, "ser.pvtu"));
+    EXPECT_EQ(pvd.num_frames(), 2u);
+    const std::string series = read_file(dir / "series.pvd");
+    EXPECT_NE(series.find("timestep=\"0\" group=\"\" part=\"0\" file=\"par.pvtu\""), std::string::npos);
+    EXPECT_NE(series.find("timestep=\"0.25\" group=\"\" part=\"0\" file=\"ser.pvtu\""), std::string::npos);
+    const std::string tail = "  </Collection>\n</VTKFile>\n";
+    ASSERT_GE(series.size(), tail.size());
+    EXPECT_EQ(series.compare(series.size() - tail.size(), tail.size(), tail), 0);
+    EXPECT_EQ(series.find("</Collection>"), series.rfind("</Collection>"));
+
+    // Restart keeps the first frame and appends new frames after it
+    PvdWriter resumed((dir / "series.pvd").string());
+    EXPECT_EQ(resumed.resume(1), 1u);
+    ASSERT_TRUE(resumed.add(0.5, "next.pvtu"));
+    EXPECT_EQ(resumed.num_frames(), 2u);
+    const std::string restarted = read_file(dir / "series.pvd");
+    EXPECT_NE(restarted.find("file=\"par.pvtu\""), std::string::npos);
+    EXPECT_EQ(restarted.find("file=\"ser.pvtu\""), std::string::npos);
+    EXPECT_LT(restarted.find("file=\"par.pvtu\""), restarted.find("timestep=\"0.5\" group=\"\" part=\"0\" file=\"next.pvtu\""));
+    EXPECT_EQ(restarted.compare(restarted.size() - tail.size(), tail.size(), tail), 0);
+    std::filesystem::remove_all(dir);
+}
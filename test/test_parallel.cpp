@@ -0,0 +1,117 @@
+// test_parallel.cpp
+// Unit tests for the thread pool and the element coloring of the parallel element loop
+
+#include <gtest/gtest.h>
+#include <entt/entt.hpp>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// Include the modules to test
+// Note: Using paths relative to include directories set in CMakeLists.txt
+// (data_center/ and system/ are in include directories)
+#include "ConnectivityStore.h"
+#include "ElementColoring.h"
+#include "mesh/ConnectivitySystem.h"
+#include "parallel/ElementColoringSystem.h"
+#include "parallel/ThreadPool.h"
+#include "test_mesh_builder.h"
+
+// Every index of the range is visited exactly once, each thread gets at most one
+// contiguous chunk and the chunks follow the thread order
+TEST(ThreadPoolTest, ParallelForCoversRangeOnce) {
+    for (unsigned threads = 1; threads <= 8; ++threads) {
+        ThreadPool pool(threads);
+        ASSERT_EQ(pool.size(), threads);
+        for (size_t count : {size_t(0), size_t(1), size_t(2), size_t(7), size_t(64), size_t(1001)}) {
+            SCOPED_TRACE(testing::Message() << threads << " threads, " << count << " items");
+            const size_t begin = 5;
+            std::vector<std::atomic<int>> visits(count);
+            std::vector<size_t> chunk_begin(threads, 0), chunk_end(threads, 0);
+            std::vector<int> calls(threads, 0);
+            pool.parallel_for(begin, begin + count, [&](size_t b, size_t e, unsigned thread_index) {
+                ASSERT_LT(thread_index, threads);
+                calls[thread_index]++;
+                chunk_begin[thread_index] = b;
+                chunk_end[thread_index] = e;
+                for (size_t i = b; i < e; ++i) {
+                    visits[i - begin]++;
+                }
+            });
+            for (size_t i = 0; i < count; ++i) {
+                EXPECT_EQ(visits[i].load(), 1) << "index " << i;
+            }
+
+            size_t next = begin;
+            for (unsigned t = 0; t < threads; ++t) {
+                EXPECT_LE(calls[t], 1);
+                if (calls[t] == 0) {
+                    continue;
+                }
+                EXPECT_EQ(chunk_begin[t], next);
+                EXPECT_LT(chunk_begin[t], chunk_end[t]);
+                next = chunk_end[t];
+            }
+            EXPECT_EQ(next, begin + count);
+        }
+    }
+}
+
+// The pool can be reused for many loops in a row
+TEST(ThreadPoolTest, RepeatedLoopsComplete) {
+    ThreadPool pool(4);
+    std::atomic<size_t> total{0};
+    for (int loop = 0; loop < 200; ++loop) {
+        pool.parallel_for(0, 100, [&](size_t b, size_t e, unsigned) {
+            total += e - b;
+        });
+    }
+    EXPECT_EQ(total.load(), 200u * 100u);
+}
+
+// Elements of one color share no node, every element is colored exactly once and
+// each color stays within one connectivity block
+TEST(ElementColoringTest, ColorsShareNoNode) {
+    entt::registry registry;
+    auto material = test_mesh::add_linear_elastic_material(registry, 1, 7.85e-9);
+    auto reduced = test_mesh::add_solid_property(registry, 1, material, 1);
+    auto full = test_mesh::add_solid_property(registry, 2, material, 2);
+    test_mesh::build_hex_grid(registry, 9, 7, 5,
+        [&](entt::entity node, int i, int j, int k) {
+            registry.emplace<Component::Position>(node, double(i), double(j), double(k));
+        },
+        [&](int i, int j, int) { return (i + j) % 3 == 0 ? full : reduced; });
+
+    const ConnectivityStore& store = ConnectivitySystem::build(registry);
+    ASSERT_EQ(store.blocks.size(), 2u);
+    const ElementColoring& coloring = ElementColoringSystem::build(registry, store);
+    ASSERT_GT(coloring.num_colors(), 0u);
+    ASSERT_EQ(coloring.color_block.size(), coloring.num_colors());
+    EXPECT_EQ(coloring.color_offsets.front(), 0u);
+    EXPECT_EQ(coloring.color_offsets.back(), coloring.elements.size());
+    EXPECT_EQ(coloring.elements.size(), store.num_elements());
+
+    std::vector<std::vector<int>> colored(store.blocks.size());
+    for (size_t b = 0; b < store.blocks.size(); ++b) {
+        colored[b].assign(store.blocks[b].num_elements(), 0);
+    }
+    std::vector<size_t> node_color(store.num_nodes(), coloring.num_colors());
+    for (size_t c = 0; c < coloring.num_colors(); ++c) {
+        const ConnectivityBlock& block = store.blocks[coloring.color_block[c]];
+        for (size_t e = coloring.color_offsets[c]; e < coloring.color_offsets[c + 1]; ++e) {
+            const uint32_t k = coloring.elements[e];
+            ASSERT_LT(k, block.num_elements());
+            colored[coloring.color_block[c]][k]++;
+            for (int i = 0; i < block.nodes_per_element; ++i) {
+                const uint32_t node = block.nodes_of(k)[i];
+                EXPECT_NE(node_color[node], c) << "color " << c << " shares node " << node;
+                node_color[node] = c;
+            }
+        }
+    }
+    for (const auto& block_colored : colored) {
+        for (int count : block_colored) {
+            EXPECT_EQ(count, 1);
+        }
+    }
+}